@@ -26,18 +26,44 @@ along with RAVE.  If not, see <http://www.gnu.org/licenses/>.
 # @author Daniel Michelson and Peter Rodriquez, Environment and Climate Change Canada
 # @date 2017-06-14
 
-import sys, os, math, tarfile, mimetypes, gzip, datetime
+import sys, os, math, time, tarfile, mimetypes, gzip, datetime, logging
 import _rb52odim
 import _rave, _raveio, _polarvolume, _polarscan
 import rave_tempfile
 from copy import copy
 
+logger = logging.getLogger(__name__)
+
 ## Define $RAVECONFIG relative to this module
 RB52ODIMCONFIG = os.path.abspath(os.path.join(os.path.dirname(_rb52odim.__file__),'..','config'))
 os.environ["RB52ODIMCONFIG"] = RB52ODIMCONFIG
 
+## Awaitable decoding for asyncio code, rb52odim.aio.read(), see rb52odim_aio.py
+try:
+    import rb52odim_aio as aio
+except (ImportError, SyntaxError):  # asyncio needs Python 3
+    aio = None
+
 ACQUISITION_UPDATE_TIME = 6  # minutes
 
+## Top-level PolarVolumeCore members copied by \ref volumeShell
+VOLUME_SHELL_PROPERTIES = ['source', 'date', 'time', 'longitude', 'latitude',
+                           'height', 'beamwidth', 'beamwH', 'beamwV']
+
+## Sweep attributes copied to the top level of volumes assembled from sweeps
+SCAN_2_PVOL_ATTRIBUTES = ["how/TXtype",
+                          "how/beamwH", #optional
+                          "how/beamwV", #optional
+                          "how/polmode",
+                          "how/poltype",
+                          "how/software",
+                          "how/sw_version",
+                          "how/system",
+                          "how/wavelength",
+                          "how/comment",
+                          "how/time_res_downgrade",
+                          ]
+
 class RainbowDecodeError(Exception):
     pass
 
@@ -79,10 +105,30 @@ def roundDT(DATE, TIME, INTERVAL=ACQUISITION_UPDATE_TIME):
     return tm.strftime('%Y%m%d'), tm.strftime('%H%M%S')
 
 
+## Floors date and time to the start of their acquisition interval (minute
+#  past hour), so that all sweeps of one cycle share a nominal time. Unlike
+#  \ref roundDT, sweeps in the second half of a cycle stay in that cycle.
+# @param string date in YYYYMMDD format
+# @param string time in HHmmSS format
+# @param int update interval in minutes
+# @returns tuple containing date and time in the same format as input arguments
+def floorDT(DATE, TIME, INTERVAL=ACQUISITION_UPDATE_TIME):
+    tm = datetime.datetime(int(DATE[:4]), int(DATE[4:6]), int(DATE[6:8]),
+                           int(TIME[:2]), int(TIME[2:4]), int(TIME[4:]))
+    tm -= datetime.timedelta(minutes=tm.minute % INTERVAL,
+                             seconds=tm.second,microseconds=tm.microsecond)
+    return tm.strftime('%Y%m%d'), tm.strftime('%H%M%S')
+
+
 ## Reads RB5 files and merges their contents into an output ODIM_H5 file
 # @param string file name of input file
 # @param string file name of output file
-def singleRB5(inp_fullfile, out_fullfile=None, return_rio=False):
+# @param boolean return the RaveIO object
+# @param boolean return the ODIM_H5 image as bytes, built in memory without
+#  an output file, for handing products on without a disk round trip
+# @returns RaveIO object, bytes, or a (RaveIO, bytes) tuple if both are requested
+def singleRB5(inp_fullfile, out_fullfile=None, return_rio=False,
+              return_bytes=False):
     TMPFILE = False
     validate(inp_fullfile)
     orig_ifile = copy(inp_fullfile)
@@ -98,6 +144,11 @@ def singleRB5(inp_fullfile, out_fullfile=None, return_rio=False):
 
     if out_fullfile:
         rio.save(out_fullfile)
+    if return_bytes:
+        image = _rb52odim.saveODIMbuf(rio)
+        if return_rio:
+            return rio, image
+        return image
     if return_rio:
         return rio
 
@@ -133,43 +184,68 @@ def compileScanParameters(scans):
     oscan = scans[0].clone()
     
     for i in range(1, len(scans)):
-        scan = scans[i]
-        for pname in scan.getParameterNames():  # should only be one
-            if pname not in oscan.getParameterNames(): # should not be necessary
-                param = scan.getParameter(pname)
-                oscan.addParameter(param)
-
-        # Check whether there are any additional attributes in a given scan
-        # and add them to the output scan. No checking whether replicate
-        # attributes contain the same information.
-        anames = oscan.getAttributeNames()
-        for aname in scan.getAttributeNames():
-            if aname not in anames:
-                oscan.addAttribute(aname, scan.getAttribute(aname))
-            
-        #expand TXpower attributes by single- & dual-pol params
-        oscan=expand_txpower_by_pol(oscan,scan,pname)
+        oscan = mergeScanParameters(oscan, scans[i])
+
+    return oscan
+
+
+## Merges the parameters and attributes of one scan into another, in place.
+# @param PolarScanCore object receiving the parameters
+# @param PolarScanCore object, typically containing only one parameter
+# @returns the receiving PolarScanCore object
+def mergeScanParameters(oscan, scan):
+    pnames = scan.getParameterNames()
+    for pname in pnames:  # should only be one
+        if pname not in oscan.getParameterNames(): # should not be necessary
+            param = scan.getParameter(pname)
+            oscan.addParameter(param)
+
+    # Check whether there are any additional attributes in a given scan
+    # and add them to the output scan. No checking whether replicate
+    # attributes contain the same information.
+    anames = oscan.getAttributeNames()
+    for aname in scan.getAttributeNames():
+        if aname not in anames:
+            oscan.addAttribute(aname, scan.getAttribute(aname))
+
+    #expand TXpower attributes by single- & dual-pol params
+    if pnames:
+        oscan=expand_txpower_by_pol(oscan,scan,pnames[-1])
 
     return oscan
 
 
+## Creates an empty volume carrying only the top-level metadata of a template
+#  volume. Unlike clone() followed by removeScan(), no scan or moment data are
+#  ever copied.
+# @param PolarVolumeCore object used as template, left untouched
+# @return PolarVolumeCore object without scans
+def volumeShell(template):
+    volume = _polarvolume.new()
+    for pname in VOLUME_SHELL_PROPERTIES:
+        value = getattr(template, pname, None)
+        if value is not None:
+            setattr(volume, pname, value)
+    for aname in template.getAttributeNames():
+        volume.addAttribute(aname, template.getAttribute(aname))
+    return volume
+
+
 ## Compiles a multi-parameter volume from several single-parameter volumes.
 #  ASSUMES that the input files are all from the same data acquisition, that
 #  the scan strategies are identical, so no advanced validation is required.
 #  This function is deliberately structured to pair with 
 #  \ref compileScanParameters
-# @param list of input PolarVolumeCore objects
+# @param list of input PolarVolumeCore or \ref CompactVolume objects
 # @return PolarVolumeCore object
 def compileVolumeFromVolumes(volumes, adjustTime=True):
-    # Use the first volume to act as host for the others. Start by removing its 
-    # scans but preserving its top-level metadata attributes
-    ovolume = volumes[0].clone()  # If we don't clone, we mess up the original
-    nscans = ovolume.getNumberOfScans()
-    while 1:
-        try:
-            ovolume.removeScan(0)
-        except:
-            break
+    # Volumes kept compact while they waited are expanded now, one at a time
+    volumes = [v.expand() if isinstance(v, CompactVolume) else v for v in volumes]
+
+    # Use the first volume's top-level metadata attributes as host for the
+    # others, without copying its scans
+    ovolume = volumeShell(volumes[0])
+    nscans = volumes[0].getNumberOfScans()
 
     # Second iteration, pull out scans, merge their parameters, and add the 
     # multi-parameter scan to the output volume
@@ -191,15 +267,103 @@ def compileVolumeFromVolumes(volumes, adjustTime=True):
 
     # Adjust to closest nomimal time
     if adjustTime:
-        if ovolume.isAscendingScans():
-            ovolume.date, ovolume.time  = roundDT(ovolume.date, ovolume.time)
-        else:
-            lowest = ovolume.getScanClosestToElevation(-90.0, 0)
-            ovolume.date, ovolume.time  = roundDT(lowest.enddate, lowest.endtime)
+        adjustVolumeTime(ovolume)
 
     return ovolume
 
 
+## Adjusts the date and time of a volume to the closest nominal acquisition
+#  time, from its own date and time if its scans are ascending, otherwise from
+#  the end of its lowest scan.
+# @param PolarVolumeCore object, modified in place
+def adjustVolumeTime(volume):
+    if volume.isAscendingScans():
+        volume.date, volume.time  = roundDT(volume.date, volume.time)
+    else:
+        lowest = volume.getScanClosestToElevation(-90.0, 0)
+        volume.date, volume.time  = roundDT(lowest.enddate, lowest.endtime)
+
+
+## Keeps the moments of a sweep compressed in memory until they are needed,
+#  e.g. while the sweep waits for the other sweeps of its volume. The codes of
+#  each moment are run-length encoded per ray, runs of undetect and nodata
+#  becoming single counts (src/rb5_compact.c), so mostly empty clear-air
+#  sweeps shrink the most. The moments are taken out of the sweep, which keeps
+#  its metadata, and put back by \ref expand.
+class CompactScan(object):
+    ## Constructor
+    # @param PolarScanCore object, emptied of its parameters until expanded
+    def __init__(self, scan):
+        self.scan = scan
+        self.params = []  # (PolarScanParamCore, bytes or None if kept as it is)
+        self._compact()
+
+    ## Merges the moments and attributes of another sweep, as in
+    #  \ref mergeScanParameters, and compacts them too
+    # @param PolarScanCore object, emptied of its parameters
+    # @returns this CompactScan object
+    def add(self, scan):
+        pnames = self.getParameterNames()
+        for pname in scan.getParameterNames():
+            if pname in pnames:
+                scan.removeParameter(pname)
+        mergeScanParameters(self.scan, scan)
+        self._compact()
+        for pname in scan.getParameterNames():
+            scan.removeParameter(pname)
+        return self
+
+    ## Quantities of the moments held
+    # @returns list of strings
+    def getParameterNames(self):
+        return [param.quantity for param, compact in self.params]
+
+    ## Bytes of moment data held
+    # @returns int
+    def nbytes(self):
+        return sum(len(compact) for param, compact in self.params if compact is not None)
+
+    ## Puts the moments back into the sweep
+    # @returns PolarScanCore object
+    def expand(self):
+        params, self.params = self.params, []
+        for param, compact in params:
+            if compact is not None:
+                _rb52odim.expandParam(param, compact)
+            self.scan.addParameter(param)
+        return self.scan
+
+    def _compact(self):
+        for pname in self.scan.getParameterNames():
+            param = self.scan.getParameter(pname)
+            self.scan.removeParameter(pname)
+            self.params.append((param, _rb52odim.compactParam(param)))
+
+
+## A volume whose sweeps are kept as \ref CompactScan objects, e.g. a
+#  single-moment volume waiting for \ref compileVolumeFromVolumes, which
+#  expands it
+class CompactVolume(object):
+    ## Constructor
+    # @param PolarVolumeCore object, its scans emptied of their parameters until expanded
+    def __init__(self, volume):
+        self.volume = volume
+        self.scans = [CompactScan(volume.getScan(i)) for i in range(volume.getNumberOfScans())]
+
+    ## Bytes of moment data held
+    # @returns int
+    def nbytes(self):
+        return sum(scan.nbytes() for scan in self.scans)
+
+    ## Puts the moments back into the sweeps of the volume
+    # @returns PolarVolumeCore object
+    def expand(self):
+        scans, self.scans = self.scans, []
+        for scan in scans:
+            scan.expand()
+        return self.volume
+
+
 ## Generates a volume from scans, based on rave_pgf_volume_plugin.generateVolume
 # @param list of input PolarScanCore objects
 # @return PolarVolumeCore object
@@ -240,23 +404,21 @@ def compileVolumeFromScans(scans, adjustTime=True):
 ## High-level function for reading multiple input data files and merging them
 #  into either a scan or volume. The first object in the list will be read and
 #  its object type queried. This will determine whether the object being merged
-#  is a scan or a volume.
+#  is a scan or a volume. Decoding and merging are done in C (src/rb5_merge.c),
+#  one file at a time, following \ref compileScanParameters and
+#  \ref compileVolumeFromVolumes.
 # @param list containing input file strings
 # @returns RaveIOCore object
 def readRB5(filenamelist):
     if isinstance(filenamelist, str): #oops, not a list
         filenamelist = [filenamelist]
+    for ifile in filenamelist:
+        validate(ifile)
 
-    rio = _raveio.new() #object = NULL
-
-    objects = readParameterFiles(filenamelist)
-    if len(objects) == 0:
-        return rio
+    rio = _rb52odim.readRB5files(filenamelist)
 
-    if _polarscan.isPolarScan(objects[0]):
-        rio.object = compileScanParameters(objects)
-    elif _polarvolume.isPolarVolume(objects[0]):
-        rio.object = compileVolumeFromVolumes(objects)
+    if rio.object is not None and _polarvolume.isPolarVolume(rio.object):
+        adjustVolumeTime(rio.object)
     return rio
 
 
@@ -301,38 +463,11 @@ def combineRB5(ifiles, out_fullfile=None, return_rio=False):
 # @returns RaveIOCore if return_rio=True, otherwise nothing
 def combineRB5FromTarball(ifile, ofile, out_basedir=None, return_rio=False):
     validate(ifile)
-    big_obj=None
 
-    tar=tarfile.open(ifile)
-    member_arr=tar.getmembers()
-    nMEMBERs=len(member_arr)
-    for iMEMBER in range(nMEMBERs):
-        this_member=member_arr[iMEMBER]
-        inp_fullfile=this_member.name
-        mb=parse_tarball_member_name(inp_fullfile)
-
-#XAH DPATC_replay: Special filter out for ZPHI_ITER_DEFAULT.dpatc & ZDR
-        if (
-            (mb['rb5_ftype'] == "rawdata") and
-            not ((mb['rb5_ppdf'] == "ZPHI_ITER_DEFAULT.dpatc") and
-                 (mb['nam_sparam'] == "ZDR"))
-            ):
-
-            obj_mb=tar.extractfile(this_member) #EXTRACTED MEMBER OBJECT
-
-            rb5_buffer=obj_mb.read() #NOTE: once read(), buffer is detached from obj_mb
-            isrb5=_rb52odim.isRainbow5buf(rb5_buffer)
-            if not isrb5:
-                raise IOError("%s is not a proper RB5 buffer" % rb5_buffer)
-            else:
-                buffer_len=len(rb5_buffer)
-                rio=_rb52odim.readRB5buf(inp_fullfile,rb5_buffer,buffer_len) ## by BUFFER
-                this_obj=rio.object
-
-                if rio.objectType == _rave.Rave_ObjectType_PVOL:
-                    big_obj=compile_big_pvol(big_obj,this_obj,mb,iMEMBER)
-                else:
-                    big_obj=compile_big_scan(big_obj,this_obj,mb)
+    # Members are streamed, decoded and merged in C (src/rb5_tarball.c),
+    # following parse_tarball_member_name, compile_big_scan and compile_big_pvol
+    rio=_rb52odim.readRB5tarball(ifile)
+    big_obj=rio.object
 
     #auto output filename (as needed)
     if not ofile and not return_rio:
@@ -408,8 +543,6 @@ def mergeOdimScans2Pvol(rio_arr, out_fullfile=None, return_rio=False, interval=N
             #print(scan.getAttribute('how/task'))
 
             if pvol is None: #clone
-                pvol=_polarvolume.new()
-                pvol.source=scan.source
                 import datetime as dt
                 scan_iso8601="-".join([scan.date[0:4],scan.date[4:6],scan.date[6:9]])+"T"+\
                              ":".join([scan.time[0:2],scan.time[2:4],scan.time[4:7]])
@@ -418,32 +551,9 @@ def mergeOdimScans2Pvol(rio_arr, out_fullfile=None, return_rio=False, interval=N
                 cycle_systime=scan_systime - scan_systime%cycle_nsecs
                 cycle_iso8601=dt.datetime.fromtimestamp(cycle_systime).isoformat()
 
+                pvol=scanVolumeShell(scan, taskname)
                 pvol.date=''.join(cycle_iso8601[:10].split('-'))
                 pvol.time=''.join(cycle_iso8601[11:].split(':'))
-                pvol.longitude=scan.longitude
-                pvol.latitude=scan.latitude
-                pvol.height=scan.height
-                #rave-py3/modules/pypolarscan.c:1712 beamwidth - DEPRECATED, Use beamwH!
-                pvol.beamwidth=scan.beamwidth
-                if(hasattr(scan,'beamH')): pvol.beamwH = scan.beamwH
-                if(hasattr(scan,'beamV')): pvol.beamwV = scan.beamwV
-
-                pvol.addAttribute("how/task", taskname)
-                for s_attrib in [
-                    "how/TXtype",
-                    "how/beamwH", #optional
-                    "how/beamwV", #optional
-                    "how/polmode",
-                    "how/poltype",
-                    "how/software",
-                    "how/sw_version",
-                    "how/system",
-                    "how/wavelength",
-                    "how/comment",
-                    "how/time_res_downgrade",
-                    ]:
-                    if s_attrib in scan.getAttributeNames():
-                        pvol.addAttribute(s_attrib, scan.getAttribute(s_attrib))
 
             pvol.addScan(scan)
 
@@ -455,6 +565,181 @@ def mergeOdimScans2Pvol(rio_arr, out_fullfile=None, return_rio=False, interval=N
         return container
 
 
+## Creates an empty volume from the metadata of one of its sweeps, as
+#  \ref mergeOdimScans2Pvol does. Date and time are left to the caller.
+# @param PolarScanCore object
+# @param string combined task name
+# @returns PolarVolumeCore object without scans
+def scanVolumeShell(scan, taskname):
+    pvol=_polarvolume.new()
+    pvol.source=scan.source
+    pvol.longitude=scan.longitude
+    pvol.latitude=scan.latitude
+    pvol.height=scan.height
+    #rave-py3/modules/pypolarscan.c:1712 beamwidth - DEPRECATED, Use beamwH!
+    pvol.beamwidth=scan.beamwidth
+    if(hasattr(scan,'beamH')): pvol.beamwH = scan.beamwH
+    if(hasattr(scan,'beamV')): pvol.beamwV = scan.beamwV
+
+    pvol.addAttribute("how/task", taskname)
+    for s_attrib in SCAN_2_PVOL_ATTRIBUTES:
+        if s_attrib in scan.getAttributeNames():
+            pvol.addAttribute(s_attrib, scan.getAttribute(s_attrib))
+    return pvol
+
+
+## Assembles sweeps into volumes as they arrive, instead of waiting for all
+#  sweep files of a cycle to exist. Sweeps are grouped by source, task and
+#  nominal time (\ref floorDT). A volume is emitted as soon as the expected
+#  sweeps of its task are in or, with whatever has arrived, once its first
+#  sweep has waited longer than the timeout. Moments of one sweep arriving in
+#  separate files are merged as in \ref compileScanParameters.
+#
+#  Emitted volumes are returned by \ref add, \ref poll and \ref flush as
+#  (RaveIOCore, complete) tuples. \ref poll should be called regularly so
+#  that partial volumes are emitted even when no more sweeps arrive.
+#
+#  With compact=True, waiting sweeps are held as \ref CompactScan objects and
+#  only expanded when their volume is emitted, which bounds memory when many
+#  volumes of many radars are pending at once. Sweeps added are then emptied
+#  of their moments.
+class VolumeAssembler(object):
+    ## Constructor
+    # @param dictionary of expected sweeps per volume task, either a number of
+    #  sweeps or a list of elevation angles in degrees. Volumes of other tasks
+    #  are only emitted on timeout.
+    # @param dictionary or function mapping the how/task of a sweep to its
+    #  volume task, e.g. {'DOPVOL1_A':'DOPVOL'}. Unmapped tasks are kept.
+    # @param list of quantities a sweep must contain to count, e.g. ['DBZH','VRADH']
+    # @param int nominal time interval in minutes
+    # @param float seconds a volume waits for missing sweeps
+    # @param function returning the current time in seconds, monotonic by default
+    # @param Boolean if True, keep waiting sweeps compact in memory
+    def __init__(self, tasks=None, taskmap=None, moments=None,
+                 interval=ACQUISITION_UPDATE_TIME, timeout=300.0, clock=None,
+                 compact=False):
+        self.tasks = tasks or {}
+        self.taskmap = taskmap
+        self.moments = moments or []
+        self.interval = interval
+        self.timeout = timeout
+        self.clock = clock or getattr(time, 'monotonic', time.time)
+        self.compact = compact
+        self.volumes = {}  # key -> dictionary of pending sweeps
+        self.emitted = {}  # key -> emission time, to recognize late sweeps
+
+    ## Adds a sweep, a volume's sweeps, or the contents of an RB5 file
+    # @param string RB5 file name, RaveIOCore, PolarScanCore or PolarVolumeCore object
+    # @returns list of (RaveIOCore, complete) tuples, possibly empty
+    def add(self, item):
+        if isinstance(item, str):
+            validate(item)
+            item = readRB5([item])
+        obj = item.object if hasattr(item, 'objectType') else item
+        if obj is None:
+            raise IOError("Nothing to assemble")
+
+        if _polarvolume.isPolarVolume(obj):
+            task = self._attribute(obj, 'how/task')
+            scans = [(obj.getScan(i), task, obj.source) for i in range(obj.getNumberOfScans())]
+        else:
+            scans = [(obj, None, None)]
+
+        result = []
+        for scan, task, source in scans:
+            key = self._addSweep(scan, task, source)
+            if key is not None and self._isComplete(key):
+                result.append(self._emit(key, True))
+        return result + self.poll()
+
+    ## Emits the volumes whose first sweep has waited longer than the timeout.
+    # Emitted volumes are remembered for a volume interval beyond the timeout,
+    # so that their late sweeps do not start a second volume.
+    # @returns list of (RaveIOCore, complete) tuples, possibly empty
+    def poll(self):
+        now = self.clock()
+        for key in [k for k, t in self.emitted.items() if now - t > self.timeout + self.interval * 60]:
+            del self.emitted[key]
+        return [self._emit(key, False) for key in sorted(self.volumes)
+                if now - self.volumes[key]['first'] >= self.timeout]
+
+    ## Emits all pending volumes, e.g. at shutdown
+    # @returns list of (RaveIOCore, complete) tuples, possibly empty
+    def flush(self):
+        return [self._emit(key, self._isComplete(key)) for key in sorted(self.volumes)]
+
+    ## Number of volumes waiting for sweeps
+    def pending(self):
+        return len(self.volumes)
+
+    ## Bytes of moment data held by waiting sweeps, if compact
+    def nbytes(self):
+        return sum(scan.nbytes() for v in self.volumes.values() for scan in v['sweeps'].values()
+                   if isinstance(scan, CompactScan))
+
+    def _attribute(self, obj, aname):
+        if aname in obj.getAttributeNames():
+            return obj.getAttribute(aname)
+        return None
+
+    def _volumeTask(self, task):
+        if callable(self.taskmap):
+            return self.taskmap(task)
+        if self.taskmap and task in self.taskmap:
+            return self.taskmap[task]
+        return task
+
+    def _addSweep(self, scan, task, source):
+        task = self._volumeTask(self._attribute(scan, 'how/task') or task or 'unknown')
+        source = scan.source or source
+        date, tm = floorDT(scan.date, scan.time, self.interval)
+        key = (source, task, date, tm)
+        if key in self.emitted:
+            logger.warning("Late sweep ignored: %s %s %s%sZ elangle %.2f", source, task, date, tm, math.degrees(scan.elangle))
+            return None
+
+        if key not in self.volumes:
+            self.volumes[key] = {'first': self.clock(), 'sweeps': {}}
+        sweeps = self.volumes[key]['sweeps']
+        elangle = round(math.degrees(scan.elangle), 2)
+        if elangle in sweeps:
+            if self.compact:
+                sweeps[elangle].add(scan)
+            else:
+                sweeps[elangle] = mergeScanParameters(sweeps[elangle], scan)
+        else:
+            sweeps[elangle] = CompactScan(scan) if self.compact else scan
+        return key
+
+    def _isComplete(self, key):
+        expected = self.tasks.get(key[1])
+        if expected is None:
+            return False
+        sweeps = self.volumes[key]['sweeps']
+        for scan in sweeps.values():
+            pnames = scan.getParameterNames()
+            if any(moment not in pnames for moment in self.moments):
+                return False
+        if isinstance(expected, int):
+            return len(sweeps) >= expected
+        return all(any(abs(elangle - e) < 0.05 for e in sweeps) for elangle in expected)
+
+    def _emit(self, key, complete):
+        sweeps = self.volumes.pop(key)['sweeps']
+        self.emitted[key] = self.clock()
+        scans = [sweeps[e] for e in sorted(sweeps)]
+        if self.compact:
+            scans = [scan.expand() for scan in scans]
+        pvol = scanVolumeShell(scans[0], key[1])
+        pvol.date, pvol.time = key[2], key[3]
+        for scan in scans:
+            pvol.addScan(scan)
+        pvol.sortByElevations(1) # ascending
+        rio = _raveio.new()
+        rio.object = pvol
+        return rio, complete
+
+
 ### Convenience functions follow ###
 
 
@@ -604,21 +889,19 @@ def expand_txpower_by_pol(oscan,scan,sparam):
 
 def compile_big_pvol(big_pvol,pvol,mb,iMEMBER):
     nSCANs=pvol.getNumberOfScans()
-    if big_pvol is None: #clone
-        big_pvol=pvol.clone()
+    first=big_pvol is None
+    if first: #empty shell, the scans of this member become its scans
+        big_pvol=volumeShell(pvol)
 
     for iSCAN in range(nSCANs):
-        if iMEMBER == 0:
-            big_scan=None #begin with empty scans (removes existing param)
-        else:
-            big_scan=big_pvol.getScan(iSCAN)
-#            print('big_scan',iSCAN,np.degrees(big_scan.elangle),big_scan.nrays,big_scan.nbins)
         this_scan=pvol.getScan(iSCAN)
-#        print('this_scan',iSCAN,np.degrees(this_scan.elangle),this_scan.nrays,this_scan.nbins)
-        big_scan=compile_big_scan(big_scan,this_scan,mb)
-        big_pvol.removeScan(iSCAN)
-        big_pvol.addScan(big_scan)
-        big_pvol.sortByElevations(pvol.isAscendingScans()) # resort inside scan loop to match input pvol order
+        if first:
+            big_scan=compile_big_scan(None,this_scan,mb) #begin with empty scans
+            big_pvol.addScan(big_scan)
+        else:
+            big_scan=big_pvol.getScan(iSCAN) #merged in place
+            compile_big_scan(big_scan,this_scan,mb)
+    big_pvol.sortByElevations(pvol.isAscendingScans()) # match input pvol order
 
     return big_pvol
 
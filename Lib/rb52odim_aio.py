@@ -0,0 +1,124 @@
+'''
+Copyright (C) 2026 The Crown (i.e. Her Majesty the Queen in Right of Canada)
+
+This file is an add-on to RAVE.
+
+RAVE is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+RAVE and this software are distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with RAVE.  If not, see <http://www.gnu.org/licenses/>.
+
+'''
+## Decoding RB5 files from asyncio code, available as rb52odim.aio
+#
+# _rb52odim.readRB5() and readRB5buf() decode without holding the GIL, so
+# the decodes run in parallel on a pool of threads while the event loop
+# carries on. Python 3 only.
+#
+#   rio = await rb52odim.aio.read("CASRA_2017121520000300dBZ.vol.gz")
+#   rios = await asyncio.gather(*[rb52odim.aio.read(f) for f in files])
+
+##
+# @file
+# @author rb52odim contributors
+# @date 2026-10-19
+
+import os, asyncio
+from concurrent.futures import ThreadPoolExecutor
+import _rb52odim
+
+
+## Decodes in a thread of the pool
+# @param string file name, or bytes-like RB5 file contents
+# @param string name of a buffer, for messages
+# @param boolean also return per-phase conversion statistics
+# @param boolean read through the decoded-blob cache, file names only
+# @param boolean track heap allocations per phase too, implies statistics
+# @param boolean add per-moment QC statistics as how/qc_* attributes
+# @returns RaveIO object, or a (RaveIO, stats dictionary) tuple
+def _decode(path_or_buffer, name, stats, cache, memtrack, qc=False):
+    if isinstance(path_or_buffer, (bytes, bytearray, memoryview)):
+        if stats or cache or memtrack or qc:
+            raise ValueError("statistics, cache and QC are for file names only")
+        buf = bytes(path_or_buffer)
+        rio = _rb52odim.readRB5buf(name, buf, len(buf))
+    else:
+        name = os.fspath(path_or_buffer)
+        rio = _rb52odim.readRB5(name, stats, cache, memtrack, qc)
+    if rio is None:
+        raise IOError("Failed to read %s" % name)
+    return rio
+
+
+## A pool of decoding threads, at most max_workers decodes at once.
+#  Cancelling a read that has not started yet drops it from the pool; one
+#  already decoding runs to its end in the background and its result is
+#  released, the awaiting task sees CancelledError at once.
+class Reader(object):
+    ## Constructor
+    # @param int decodes at once, os.cpu_count() by default
+    def __init__(self, max_workers=None):
+        if max_workers is None:
+            max_workers = os.cpu_count() or 1
+        if max_workers < 1:
+            raise ValueError("max_workers must be at least 1")
+        self.max_workers = max_workers
+        self._executor = ThreadPoolExecutor(max_workers=max_workers,
+                                            thread_name_prefix="rb52odim")
+
+    ## Decodes an RB5 file or buffer without blocking the event loop
+    # @param string file name, or bytes-like RB5 file contents
+    # @param boolean also return per-phase conversion statistics
+    # @param boolean read through the decoded-blob cache next to the file
+    # @param boolean track heap allocations per phase too
+    # @param string name of a buffer, for messages
+    # @param boolean add per-moment QC statistics as how/qc_* attributes
+    # @returns awaitable resolving to the RaveIO object, or a (RaveIO, stats)
+    #  tuple if statistics were requested
+    async def read(self, path_or_buffer, stats=False, cache=False,
+                   memtrack=False, name="buffer", qc=False):
+        loop = asyncio.get_running_loop()
+        return await loop.run_in_executor(self._executor, _decode, path_or_buffer,
+                                          name, stats, cache, memtrack, qc)
+
+    ## Stops the pool, after the decodes already running when wait is True
+    def close(self, wait=True):
+        self._executor.shutdown(wait=wait)
+
+    async def __aenter__(self):
+        return self
+
+    async def __aexit__(self, *exc):
+        self.close(wait=False)
+
+
+## Shared by read(), created on first use
+_reader = None
+
+
+## Sets how many decodes read() runs at once. Reads already submitted
+#  finish on the previous pool.
+# @param int decodes at once
+def set_max_workers(max_workers):
+    global _reader
+    reader = Reader(max_workers)
+    if _reader is not None:
+        _reader.close(wait=False)
+    _reader = reader
+
+
+## Decodes an RB5 file or buffer on the shared pool, see Reader.read()
+async def read(path_or_buffer, stats=False, cache=False, memtrack=False,
+               name="buffer", qc=False):
+    global _reader
+    if _reader is None:
+        _reader = Reader()
+    return await _reader.read(path_or_buffer, stats, cache, memtrack, name, qc)
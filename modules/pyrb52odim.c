@@ -24,6 +24,7 @@ along with RAVE.  If not, see <http://www.gnu.org/licenses/>.
  * @author Peter Rodriguez, Environment Canada
  * @date 2020-09-01, upgrade to use Python >2.6 and Python 3 compatibility file
  */
+#define PY_SSIZE_T_CLEAN /* "s#" lengths are Py_ssize_t, required from Python 3.10 */
 #include "pyrb52odim_compat.h"
 #include "arrayobject.h"
 #include "rave.h"
@@ -31,8 +32,14 @@ along with RAVE.  If not, see <http://www.gnu.org/licenses/>.
 #include "pyraveio.h"
 #include "pypolarvolume.h"
 #include "pypolarscan.h"
+#include "pypolarscanparam.h"
 #include "pyrave_debug.h"
 #include "rb52odim.h"
+#include "rb5_tarball.h"
+#include "rb5_merge.h"
+#include "rb5_arrays.h"
+#include "rb5_odim_buf.h"
+#include "rb5_strategy.h"
 
 /**
  * Debug this module
@@ -130,6 +137,61 @@ static PyObject* _isRainbow5_func(PyObject* self, PyObject* args) {
 
 }
 
+/**
+ * Collects the conversion phase counters of the calling thread
+ * @param[in] If set, add the heap counters of the allocation tracker
+ * @returns Python dictionary {phase: {"wall_sec", "bytes", "calls"}}, with
+ * "allocs", "alloc_bytes", "peak_bytes", "retained_bytes" and "maxrss_kb"
+ * in each phase and a "memory" total if with_memory
+ */
+static PyObject* _profileStatsDict(int with_memory) {
+  int i;
+  PyObject* stats = PyDict_New();
+  if (stats == NULL) return NULL;
+
+  for (i = 0; i < RB5_PROFILE_NPHASES; i++) {
+    strRB5_PROFILE_PHASE ph = rb5_profile_get((RB5_PROFILE_PHASE)i);
+    PyObject* phase = NULL;
+    if (with_memory) {
+      phase = Py_BuildValue("{s:d,s:n,s:n,s:n,s:n,s:L,s:L,s:l}",
+                            "wall_sec", ph.wall_sec,
+                            "bytes", (Py_ssize_t)ph.nbytes,
+                            "calls", (Py_ssize_t)ph.ncalls,
+                            "allocs", (Py_ssize_t)ph.n_allocs,
+                            "alloc_bytes", (Py_ssize_t)ph.alloc_bytes,
+                            "peak_bytes", (long long)ph.peak_bytes,
+                            "retained_bytes", (long long)ph.retained_bytes,
+                            "maxrss_kb", ph.maxrss_kb);
+    } else {
+      phase = Py_BuildValue("{s:d,s:n,s:n}",
+                            "wall_sec", ph.wall_sec,
+                            "bytes", (Py_ssize_t)ph.nbytes,
+                            "calls", (Py_ssize_t)ph.ncalls);
+    }
+    if (phase == NULL || PyDict_SetItemString(stats, rb5_profile_phase_name((RB5_PROFILE_PHASE)i), phase) != 0) {
+      Py_XDECREF(phase);
+      Py_DECREF(stats);
+      return NULL;
+    }
+    Py_DECREF(phase);
+  }
+  if (with_memory) {
+    PyObject* memory = Py_BuildValue("{s:n,s:n,s:L,s:L,s:l}",
+                                     "allocs", (Py_ssize_t)rb5_memtrack.n_allocs,
+                                     "alloc_bytes", (Py_ssize_t)rb5_memtrack.alloc_bytes,
+                                     "peak_bytes", (long long)rb5_memtrack.peak,
+                                     "outstanding_bytes", (long long)rb5_memtrack.outstanding,
+                                     "maxrss_kb", rb5_memtrack_maxrss_kb());
+    if (memory == NULL || PyDict_SetItemString(stats, "memory", memory) != 0) {
+      Py_XDECREF(memory);
+      Py_DECREF(stats);
+      return NULL;
+    }
+    Py_DECREF(memory);
+  }
+  return stats;
+}
+
 /**
  * Reads an RB5 buffer
  * @param[in] Buffer with the RB5 file contents
@@ -150,37 +212,478 @@ static PyObject* _readRB5buf_func(PyObject* self, PyObject* args) {
   //Copy Python's buffer. Needed for close_rb5_info()'s free(rb5_info->buffer)
   /* my_rb5_buffer is freed in xml_utils.c:close_file_buffer, so we can't 
      allocate memory for it using RAVE_MALLOC */
-  char* my_rb5_buffer=malloc(sizeof(char)*(buffer_len));
+  char* my_rb5_buffer=rb5_mem_malloc(sizeof(char)*(buffer_len));
   memcpy(my_rb5_buffer,rb5_buffer,(size_t)buffer_len);
 
+  /* decoded without the GIL, so that rb52odim.aio can run several at once */
+  Py_BEGIN_ALLOW_THREADS
   raveio = getRaveIObuf((char *)filename,&my_rb5_buffer,(size_t)buffer_len);
+  Py_END_ALLOW_THREADS
   result = PyRaveIO_New(raveio);
   RAVE_OBJECT_RELEASE(raveio);
   if (result->raveio) return (PyObject*)result;
-  else return Py_None;
+  Py_DECREF(result);
+  Py_RETURN_NONE;
 }
 
 /**
  * Reads an RB5 file
  * @param[in] String with the RB5 file name
- * @returns PyRave_IO object containing a PolarVolume_t or PolarScan_t
+ * @param[in] Optional, if True also return per-phase conversion statistics
+ * @param[in] Optional, if True read through the decoded-blob cache next to the file, writing it if needed
+ * @param[in] Optional, if True track heap allocations per phase too, implies statistics;
+ *  libxml2 is not tracked from Python, its allocation hooks cannot be installed once it is in use
+ * @param[in] Optional, if True add per-moment QC statistics as how/qc_* attributes, see rb5_qc.c
+ * @returns PyRave_IO object containing a PolarVolume_t or PolarScan_t,
+ * or a (PyRave_IO, stats dictionary) tuple if statistics were requested;
+ * with statistics a failed read raises IOError
  */
 static PyObject* _readRB5_func(PyObject* self, PyObject* args) {
   const char* filename;
+  int with_stats = 0;
+  int use_cache = 0;
+  int memtrack = 0;
+  int qc = 0;
   PyRaveIO* result = NULL;
   RaveIO_t* raveio = NULL;
+  PyObject* stats = NULL;
 
-  if (!PyArg_ParseTuple(args, "s", &filename)) {
+  if (!PyArg_ParseTuple(args, "s|iiii", &filename, &with_stats, &use_cache, &memtrack, &qc)) {
     return Py_None;
   }
 
+  if (memtrack) {
+    with_stats = 1;
+    rb5_memtrack_reset();
+    rb5_memtrack_enable(1);
+  }
+  if (with_stats) {
+    rb5_profile_reset();
+    rb5_profile_enable(1);
+  }
+  /* profile, memtrack, cache and QC switches are per thread, so they hold across the GIL release */
+  Py_BEGIN_ALLOW_THREADS
+  rb52odim_use_cache(use_cache);
+  rb5_qc_enable(qc);
   raveio = getRaveIO(filename);
+  rb5_qc_enable(0);
+  rb52odim_use_cache(0);
+  Py_END_ALLOW_THREADS
+  if (with_stats) {
+    rb5_profile_enable(0);
+    stats = _profileStatsDict(memtrack);
+  }
+  if (memtrack) rb5_memtrack_enable(0);
+  if (with_stats && (raveio == NULL || RaveIO_getObjectType(raveio) == Rave_ObjectType_UNDEFINED)) {
+    /* no statistics of a failed read, it fails like the other readers */
+    RAVE_OBJECT_RELEASE(raveio);
+    Py_XDECREF(stats);
+    raiseException_returnNULL(PyExc_IOError, "Failed to read RB5 file");
+  }
   result = PyRaveIO_New(raveio);
   RAVE_OBJECT_RELEASE(raveio);
-  if (result->raveio) return (PyObject*)result;
-  else return Py_None;
+  if (!with_stats) {
+    if (result->raveio) return (PyObject*)result;
+    Py_DECREF(result);
+    Py_RETURN_NONE;
+  }
+  if (stats == NULL) {
+    Py_DECREF(result);
+    return NULL;
+  }
+  return Py_BuildValue("(NN)", (PyObject*)result, stats);
+}
+
+/**
+ * Reads an RB5 moment tarball and merges its rawdata members
+ * @param[in] String with the tarball file name
+ * @returns PyRave_IO object containing the merged PolarVolume_t or PolarScan_t
+ */
+static PyObject* _readRB5tarball_func(PyObject* self, PyObject* args) {
+  const char* filename;
+  PyRaveIO* result = NULL;
+  RaveIO_t* raveio = NULL;
+  RaveCoreObject* object = NULL;
+
+  if (!PyArg_ParseTuple(args, "s", &filename)) {
+    return NULL;
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  raveio = getRaveIOFromTarball(filename);
+  Py_END_ALLOW_THREADS
+
+  object = RaveIO_getObject(raveio);
+  if (object == NULL) {
+    RAVE_OBJECT_RELEASE(raveio);
+    raiseException_returnNULL(PyExc_IOError, "Failed to read RB5 tarball");
+  }
+  RAVE_OBJECT_RELEASE(object);
+
+  result = PyRaveIO_New(raveio);
+  RAVE_OBJECT_RELEASE(raveio);
+  return (PyObject*)result;
+}
+
+/**
+ * Reads single-moment RB5 files of the same scan or volume and merges them
+ * @param[in] List of RB5 file names
+ * @returns PyRave_IO object containing the merged PolarVolume_t or PolarScan_t,
+ * without an object if none of the files could be decoded
+ */
+static PyObject* _readRB5files_func(PyObject* self, PyObject* args) {
+  PyObject* inlist = NULL;
+  PyRaveIO* result = NULL;
+  RaveIO_t* raveio = NULL;
+  char** ifiles = NULL;
+  Py_ssize_t nfiles = 0, i = 0, j = 0;
+
+  if (!PyArg_ParseTuple(args, "O", &inlist)) {
+    return NULL;
+  }
+  if (!PySequence_Check(inlist)) {
+    raiseException_returnNULL(PyExc_TypeError, "Expecting a list of file names");
+  }
+  nfiles = PySequence_Size(inlist);
+  ifiles = RAVE_MALLOC(sizeof(char*) * (nfiles > 0 ? nfiles : 1));
+  if (ifiles == NULL) {
+    raiseException_returnNULL(PyExc_MemoryError, "Failed to allocate file name list");
+  }
+  /* copies, neither the items nor inlist are ours once the GIL is released */
+  for (i = 0; i < nfiles; i++) {
+    PyObject* item = PySequence_GetItem(inlist, i);
+    const char* name = (item != NULL) ? PyString_AsString(item) : NULL;
+    ifiles[i] = (name != NULL) ? RAVE_STRDUP(name) : NULL;
+    Py_XDECREF(item);
+    if (ifiles[i] == NULL) {
+      for (j = 0; j < i; j++) RAVE_FREE(ifiles[j]);
+      RAVE_FREE(ifiles);
+      raiseException_returnNULL(PyExc_TypeError, "File names must be strings");
+    }
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  raveio = getRaveIOFromFiles((const char**)ifiles, (int)nfiles);
+  Py_END_ALLOW_THREADS
+  for (i = 0; i < nfiles; i++) RAVE_FREE(ifiles[i]);
+  RAVE_FREE(ifiles);
+
+  if (raveio == NULL) {
+    raiseException_returnNULL(PyExc_IOError, "Failed to read and merge RB5 files");
+  }
+  result = PyRaveIO_New(raveio);
+  RAVE_OBJECT_RELEASE(raveio);
+  return (PyObject*)result;
+}
+
+/**
+ * Writes the ODIM_H5 image of a RaveIO object to memory instead of a file
+ * @param[in] PyRave_IO object, e.g. from readRB5()
+ * @returns bytes with the contents rio.save() would write
+ */
+static PyObject* _saveODIMbuf_func(PyObject* self, PyObject* args) {
+  PyObject* inio = NULL;
+  PyObject* result = NULL;
+  char* h5_buffer = NULL;
+  size_t h5_len = 0;
+
+  if (!PyArg_ParseTuple(args, "O", &inio)) {
+    return NULL;
+  }
+  if (!PyRaveIO_Check(inio)) {
+    raiseException_returnNULL(PyExc_TypeError, "Expecting a RaveIO object");
+  }
+  h5_len = saveRaveIObuf(((PyRaveIO*)inio)->raveio, &h5_buffer);
+  if (h5_len == 0) {
+    raiseException_returnNULL(PyExc_IOError, "Failed to write ODIM_H5 image");
+  }
+  result = PyBytes_FromStringAndSize(h5_buffer, (Py_ssize_t)h5_len);
+  RAVE_FREE(h5_buffer);
+  return result;
 }
 
+/**
+ * Capsule destructor, frees a decoder buffer once no array refers to it
+ */
+static void _freeArrayCapsule(PyObject* capsule) {
+  void* buffer = PyCapsule_GetPointer(capsule, "_rb52odim.buffer");
+  if (buffer != NULL) RAVE_FREE(buffer);
+}
+
+/**
+ * Wraps a decoder buffer into a numpy array without copying, the array owning
+ * the buffer through a capsule. On success the buffer pointer is set to NULL.
+ * @param[in] buffer pointer, taken over
+ * @param[in] nd number of dimensions
+ * @param[in] dims dimensions
+ * @param[in] typenum numpy type of the elements
+ * @returns numpy array (None for a NULL buffer), or NULL on failure
+ */
+static PyObject* _arrayFromBuffer(void** buffer, int nd, npy_intp* dims, int typenum) {
+  PyObject* array = NULL;
+  PyObject* capsule = NULL;
+
+  if (*buffer == NULL) Py_RETURN_NONE;
+  array = PyArray_SimpleNewFromData(nd, dims, typenum, *buffer);
+  if (array == NULL) return NULL;
+  capsule = PyCapsule_New(*buffer, "_rb52odim.buffer", _freeArrayCapsule);
+  if (capsule == NULL) {
+    Py_DECREF(array);
+    return NULL;
+  }
+  if (PyArray_SetBaseObject((PyArrayObject*)array, capsule) != 0) { /* steals capsule, even on failure */
+    *buffer = NULL;
+    Py_DECREF(array);
+    return NULL;
+  }
+  *buffer = NULL;
+  return array;
+}
+
+/**
+ * Wraps a view into a block already owned by a capsule into a numpy array
+ * without copying, the array holding a new reference to the capsule.
+ * @param[in] block capsule owning the buffer the view points into
+ * @param[in] view start of the array inside the block
+ * @param[in] nd number of dimensions
+ * @param[in] dims dimensions
+ * @param[in] typenum numpy type of the elements
+ * @returns numpy array, or NULL on failure
+ */
+static PyObject* _arrayFromBlock(PyObject* block, void* view, int nd, npy_intp* dims, int typenum) {
+  PyObject* array = PyArray_SimpleNewFromData(nd, dims, typenum, view);
+  if (array == NULL) return NULL;
+  Py_INCREF(block);
+  if (PyArray_SetBaseObject((PyArrayObject*)array, block) != 0) { /* steals block, even on failure */
+    Py_DECREF(array);
+    return NULL;
+  }
+  return array;
+}
+
+/**
+ * Sets a new reference into a dictionary, consuming it
+ * @returns 0 on success, -1 on failure (with value NULL or the dictionary insert failing)
+ */
+static int _dictSetNew(PyObject* dict, const char* key, PyObject* value) {
+  int ret = -1;
+  if (value != NULL) {
+    ret = PyDict_SetItemString(dict, key, value);
+    Py_DECREF(value);
+  }
+  return ret;
+}
+
+/**
+ * Builds the dictionary of one decoded sweep, taking over its buffers
+ * @returns {"metadata": {...}, "moments": {quantity: {...}}, angle and time arrays}
+ */
+static PyObject* _sweepDict(strRB5_ARRAYS* arrays, int s) {
+  strRB5_SWEEP_ARRAYS* sweep = &arrays->sweep_arr[s];
+  PyObject* result = PyDict_New();
+  PyObject* moments = PyDict_New();
+  PyObject* block = NULL;
+  npy_intp rdims[1] = { (npy_intp)sweep->nrays };
+  char yyyymmdd[MAX_YYYYMMDD_STRING] = "\0";
+  char hhmmss[MAX_HHMMSS_STRING] = "\0";
+  char enddate[MAX_YYYYMMDD_STRING] = "\0";
+  char endtime[MAX_HHMMSS_STRING] = "\0";
+  int L_ELE = (strcmp(arrays->scan_type, "ele") == 0);
+  size_t i;
+
+  if (result == NULL || moments == NULL) goto fail;
+  func_epoch_ms_2_yyyymmdd(sweep->epoch_ms_bgn, yyyymmdd);
+  func_epoch_ms_2_hhmmss(sweep->epoch_ms_bgn, hhmmss);
+  func_epoch_ms_2_yyyymmdd(sweep->epoch_ms_end, enddate);
+  func_epoch_ms_2_hhmmss(sweep->epoch_ms_end, endtime);
+  if (_dictSetNew(result, "metadata",
+                  Py_BuildValue("{s:n,s:n,s:d,s:d,s:d,s:l,s:s,s:s,s:s,s:s,s:L,s:L,s:i}",
+                                "nrays", (Py_ssize_t)sweep->nrays,
+                                "nbins", (Py_ssize_t)sweep->nbins,
+                                "elangle", (double)sweep->elangle_deg,
+                                "rstart", (double)sweep->rstart_km,
+                                "rscale", (double)sweep->rscale_m,
+                                "a1gate", sweep->a1gate,
+                                "startdate", yyyymmdd, "starttime", hhmmss,
+                                "enddate", enddate, "endtime", endtime,
+                                "start_epoch_ms", (long long)sweep->epoch_ms_bgn,
+                                "end_epoch_ms", (long long)sweep->epoch_ms_end,
+                                "scan_index", s+1)) != 0) goto fail;
+
+  /* azimuths are the moving angles, except for ele scans, all four views into one block */
+  if (sweep->angle_block != NULL) {
+    block = PyCapsule_New(sweep->angle_block, "_rb52odim.buffer", _freeArrayCapsule);
+    if (block == NULL) goto fail;
+    sweep->angle_block = NULL;
+    if (_dictSetNew(result, L_ELE ? "startelA" : "startazA", _arrayFromBlock(block, sweep->moving_angle_start_arr, 1, rdims, NPY_FLOAT32)) != 0 ||
+        _dictSetNew(result, L_ELE ? "stopelA"  : "stopazA",  _arrayFromBlock(block, sweep->moving_angle_stop_arr,  1, rdims, NPY_FLOAT32)) != 0 ||
+        _dictSetNew(result, L_ELE ? "startazA" : "startelA", _arrayFromBlock(block, sweep->fixed_angle_start_arr,  1, rdims, NPY_FLOAT32)) != 0 ||
+        _dictSetNew(result, L_ELE ? "stopazA"  : "stopelA",  _arrayFromBlock(block, sweep->fixed_angle_stop_arr,   1, rdims, NPY_FLOAT32)) != 0) goto fail;
+    Py_CLEAR(block);
+  }
+  if (_dictSetNew(result, "startazT", _arrayFromBuffer((void**)&sweep->startazT_arr, 1, rdims, NPY_FLOAT64)) != 0) goto fail;
+
+  for (i = 0; i < sweep->n_moments; i++) {
+    strRB5_MOMENT_ARRAYS* moment = &sweep->moment_arr[i];
+    npy_intp dims[2] = { (npy_intp)moment->nrays, (npy_intp)moment->nbins };
+    int typenum = (moment->raw_binary_depth == 8) ? NPY_UINT8 : (moment->raw_binary_depth == 16) ? NPY_UINT16 : NPY_UINT32;
+    PyObject* mdict = Py_BuildValue("{s:s,s:d,s:d,s:d,s:d}",
+                                    "sparam", moment->sparam,
+                                    "gain", moment->gain,
+                                    "offset", moment->offset,
+                                    "nodata", moment->nodata,
+                                    "undetect", moment->undetect);
+    if (_dictSetNew(moments, moment->quantity, mdict) != 0 ||
+        _dictSetNew(mdict, "data", _arrayFromBuffer(&moment->raw_arr, 2, dims, typenum)) != 0 ||
+        _dictSetNew(mdict, "physical", _arrayFromBuffer((void**)&moment->data_arr, 2, dims, NPY_FLOAT32)) != 0) goto fail;
+  }
+  if (PyDict_SetItemString(result, "moments", moments) != 0) goto fail;
+  Py_DECREF(moments);
+  return result;
+
+fail:
+  Py_XDECREF(block);
+  Py_XDECREF(moments);
+  Py_XDECREF(result);
+  return NULL;
+}
+
+/**
+ * Reads an RB5 file into numpy arrays, without building RAVE objects.
+ * The arrays share the decoder's buffers (no copies), freed with the last array referring to them.
+ * @param[in] String with the RB5 file name
+ * @param[in] Optional, if True also return float32 physical values per moment
+ * @param[in] Optional, if True read through the decoded-blob cache next to the file, writing it if needed
+ * @returns dictionary {"metadata": {...}, "sweeps": [{"metadata", "moments",
+ * "startazA", "stopazA", "startelA", "stopelA", "startazT"}, ...]}, with the
+ * raw "data" of each moment ordered as PolarScanParam data (first ray pointing north)
+ */
+static PyObject* _read_arrays_func(PyObject* self, PyObject* args) {
+  const char* filename;
+  int physical = 0;
+  int use_cache = 0;
+  strRB5_ARRAYS* arrays = NULL;
+  PyObject* result = NULL;
+  PyObject* sweeps = NULL;
+  int s;
+
+  if (!PyArg_ParseTuple(args, "s|ii", &filename, &physical, &use_cache)) {
+    return NULL;
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  arrays = getRB5Arrays(filename, physical, use_cache);
+  Py_END_ALLOW_THREADS
+
+  if (arrays == NULL) {
+    raiseException_returnNULL(PyExc_IOError, "Failed to read RB5 file");
+  }
+
+  sweeps = PyList_New(0);
+  result = Py_BuildValue("{s:{s:s,s:s,s:s,s:s,s:s,s:d,s:d,s:d,s:d,s:d,s:O}}",
+                         "metadata",
+                         "sensor_id", arrays->sensor_id,
+                         "sensor_name", arrays->sensor_name,
+                         "scan_type", arrays->scan_type,
+                         "scan_name", arrays->scan_name,
+                         "rainbow_version", arrays->rainbow_version,
+                         "lon", (double)arrays->sensor_lon_deg,
+                         "lat", (double)arrays->sensor_lat_deg,
+                         "height", (double)arrays->sensor_alt_m,
+                         "wavelength", (double)arrays->sensor_wavelength_cm,
+                         "beamwidth", (double)arrays->sensor_beamwidth_deg,
+                         "time_accuracy_downgrade", arrays->L_TIME_ACCURACY_DOWNGRADE ? Py_True : Py_False);
+  if (sweeps == NULL || result == NULL) goto fail;
+  for (s = 0; s < (int)arrays->n_sweeps; s++) {
+    PyObject* sweep = _sweepDict(arrays, s);
+    if (sweep == NULL || PyList_Append(sweeps, sweep) != 0) {
+      Py_XDECREF(sweep);
+      goto fail;
+    }
+    Py_DECREF(sweep);
+  }
+  if (PyDict_SetItemString(result, "sweeps", sweeps) != 0) goto fail;
+  Py_DECREF(sweeps);
+  freeRB5Arrays(arrays); /* only what was not taken over */
+  return result;
+
+fail:
+  Py_XDECREF(sweeps);
+  Py_XDECREF(result);
+  freeRB5Arrays(arrays);
+  return NULL;
+}
+
+/**
+ * Scan-strategy cache counters of this process, see rb5_strategy.c
+ * @param[in] Optional, if True forget all cached strategies after reading the counters
+ * @returns dictionary {"hits", "misses", "entries"}
+ */
+static PyObject* _strategy_stats_func(PyObject* self, PyObject* args) {
+  int clear = 0;
+  size_t hits = 0, misses = 0, entries = 0;
+
+  if (!PyArg_ParseTuple(args, "|i", &clear)) {
+    return NULL;
+  }
+  rb5_strategy_stats(&hits, &misses, &entries);
+  if (clear) rb5_strategy_clear();
+  return Py_BuildValue("{s:n,s:n,s:n}", "hits", (Py_ssize_t)hits, "misses", (Py_ssize_t)misses, "entries", (Py_ssize_t)entries);
+}
+
+/**
+ * Keeps the data of a moment compact in memory until expandParam(), see
+ * src/rb5_compact.c. The parameter must not be in a scan: its data are
+ * replaced by a 1x1 placeholder.
+ * @param[in] PolarScanParamCore object
+ * @returns bytes holding the data, or None if they are not 8, 16 or 32 bit codes
+ */
+static PyObject* _compactParam_func(PyObject* self, PyObject* args) {
+  PyObject* inparam = NULL;
+  PyObject* result = NULL;
+  PolarScanParam_t* param = NULL;
+  unsigned char* compact = NULL;
+  size_t size_compact = 0;
+
+  if (!PyArg_ParseTuple(args, "O", &inparam)) {
+    return NULL;
+  }
+  if (!PyPolarScanParam_Check(inparam)) {
+    raiseException_returnNULL(PyExc_TypeError, "Expecting a PolarScanParam object");
+  }
+  param = ((PyPolarScanParam*)inparam)->scanparam;
+  compact = compactScanParam(param, &size_compact);
+  if (compact == NULL) {
+    Py_RETURN_NONE;
+  }
+  result = PyBytes_FromStringAndSize((char*)compact, (Py_ssize_t)size_compact);
+  if (result == NULL) expandScanParam(param, compact, size_compact); /* data back in place */
+  free(compact);
+  return result;
+}
+
+/**
+ * Restores the data of a moment from compactParam()
+ * @param[in] PolarScanParamCore object given to compactParam()
+ * @param[in] bytes returned by compactParam()
+ * @returns None
+ */
+static PyObject* _expandParam_func(PyObject* self, PyObject* args) {
+  PyObject* inparam = NULL;
+  char* compact = NULL;
+  Py_ssize_t size_compact = 0;
+
+  if (!PyArg_ParseTuple(args, "Os#", &inparam, &compact, &size_compact)) {
+    return NULL;
+  }
+  if (!PyPolarScanParam_Check(inparam)) {
+    raiseException_returnNULL(PyExc_TypeError, "Expecting a PolarScanParam object");
+  }
+  if (!expandScanParam(((PyPolarScanParam*)inparam)->scanparam, (unsigned char*)compact, (size_t)size_compact)) {
+    raiseException_returnNULL(PyExc_ValueError, "Failed to expand compact moment");
+  }
+  Py_RETURN_NONE;
+}
 
 static struct PyMethodDef _rb52odim_functions[] =
 {
@@ -188,6 +691,13 @@ static struct PyMethodDef _rb52odim_functions[] =
   { "isRainbow5",    (PyCFunction) _isRainbow5_func,    METH_VARARGS },
   { "readRB5buf",    (PyCFunction) _readRB5buf_func,    METH_VARARGS },
   { "readRB5",       (PyCFunction) _readRB5_func,       METH_VARARGS },
+  { "readRB5tarball", (PyCFunction) _readRB5tarball_func, METH_VARARGS },
+  { "readRB5files",  (PyCFunction) _readRB5files_func,  METH_VARARGS },
+  { "read_arrays",   (PyCFunction) _read_arrays_func,   METH_VARARGS },
+  { "saveODIMbuf",   (PyCFunction) _saveODIMbuf_func,   METH_VARARGS },
+  { "strategy_stats", (PyCFunction) _strategy_stats_func, METH_VARARGS },
+  { "compactParam",  (PyCFunction) _compactParam_func,  METH_VARARGS },
+  { "expandParam",   (PyCFunction) _expandParam_func,   METH_VARARGS },
   { NULL, NULL }
 };
 
@@ -214,6 +724,7 @@ MOD_INIT(_rb52odim)
   import_pyraveio();
   import_pypolarvolume();
   import_pypolarscan();
+  import_pypolarscanparam();
   import_array(); /*To make sure I get access to numpy*/
   PYRAVE_DEBUG_INITIALIZE;
   return MOD_INIT_SUCCESS(module);
@@ -19,16 +19,22 @@
  *             - vi cmd: :27,$s/free(/RAVE_FREE(/g
  */
 
-#include "rave_alloc.h"
+#include "rb5_alloc.h"
 
 #include "time_utils.h"
 #include "xml_utils.h"
 #include "rb5_utils.h"
+#include "rb5_profile.h"
+#include "rb5_cache.h"
+#include "rb5_inflate.h"
+#include "rb5_strategy.h"
 
 //#############################################################################
 
 size_t uncompress_this_blob(unsigned char *buf, unsigned char** return_uncompressed_blob, size_t compressed_size_blob) {
 
+    strRB5_PROFILE_MARK prof=rb5_profile_begin();
+
     size_t expectedSize=(buf[0] << 24) |
                         (buf[1] << 16) |
                         (buf[2] <<  8) |
@@ -36,27 +42,26 @@ size_t uncompress_this_blob(unsigned char *buf, unsigned char** return_uncompres
 
     unsigned char *uncompressed_blob=(unsigned char *)RAVE_MALLOC(expectedSize);
 
-    int Z_result=uncompress(uncompressed_blob,&expectedSize,buf+4,compressed_size_blob-4);
+    int Z_result=rb5_inflate(uncompressed_blob,&expectedSize,buf+4,compressed_size_blob-4);
     if (Z_result != Z_OK) {
       fprintf(stderr,"zlib error: %d\n", Z_result);
     }
     
     *return_uncompressed_blob=uncompressed_blob;
+    rb5_profile_end(RB5_PROFILE_INFLATE,prof,expectedSize);
     return(expectedSize);
 }
 
 //#############################################################################
 
-size_t get_blobid_buffer(strRB5_INFO *rb5_info, int req_blobid, unsigned char** return_uncompressed_blob) {
+size_t get_blobid_compressed(strRB5_INFO *rb5_info, int req_blobid, unsigned char** return_compressed_blob) {
 
     size_t EXIT_NULL_VAL=0;
 
     char *xpath;
     int this_blobid;
     unsigned char *compressed_blob = NULL;
-    unsigned char *uncompressed_blob = NULL;
     size_t compressed_size_blob;
-    size_t uncompressed_size_blob;
 
     char *blobspace=NULL;
     size_t bs_size=(rb5_info->buffer_len) - (rb5_info->byte_offset_blobspace);
@@ -73,7 +78,8 @@ size_t get_blobid_buffer(strRB5_INFO *rb5_info, int req_blobid, unsigned char**
 
     while (bs_abs_off <= bs_size) {
 
-      BLOB_line=strstr(strtok(blobspace,"\n"),bgn_BLOB);
+      char *saveptr=NULL; //strtok_r(), decodes run concurrently
+      BLOB_line=strstr(strtok_r(blobspace,"\n",&saveptr),bgn_BLOB);
       bgn_BLOB_len=strlen(BLOB_line)+1; //with trailing '\n'
 //fprintf(stdout,"(%ld) BLOB_line=%s\n",strlen(BLOB_line),BLOB_line);
 //fprintf(stdout,"(%ld) end_BLOB=%s\n",strlen(end_BLOB),end_BLOB);
@@ -107,13 +113,10 @@ size_t get_blobid_buffer(strRB5_INFO *rb5_info, int req_blobid, unsigned char**
                 if(L_DEBUG_OUTPUT_1) fprintf(stdout,"  compressed_size_blob = %ld\n",compressed_size_blob);
                 compressed_blob=(unsigned char *)RAVE_MALLOC(compressed_size_blob);
                 memcpy(compressed_blob,blobspace+bgn_BLOB_len,compressed_size_blob);
-                    uncompressed_size_blob=uncompress_this_blob(compressed_blob, &uncompressed_blob, compressed_size_blob);
-                    if(L_DEBUG_OUTPUT_1) fprintf(stdout,"uncompressed_size_blob = %ld\n",uncompressed_size_blob);
-                    RAVE_FREE(compressed_blob);
                     xmlXPathFreeContext(blob_xpathCtx); //cleanup
                     xmlFreeDoc(blob_doc);
-                    *return_uncompressed_blob=uncompressed_blob;
-                    return(uncompressed_size_blob);
+                    *return_compressed_blob=compressed_blob;
+                    return(compressed_size_blob);
             } 
             bs_rel_jmp=bgn_BLOB_len+compressed_size_blob+end_BLOB_len;
             blobspace+=bs_rel_jmp;
@@ -133,13 +136,35 @@ size_t get_blobid_buffer(strRB5_INFO *rb5_info, int req_blobid, unsigned char**
 
 //#############################################################################
 
+size_t get_blobid_buffer(strRB5_INFO *rb5_info, int req_blobid, unsigned char** return_uncompressed_blob) {
+
+    size_t EXIT_NULL_VAL=0;
+
+    unsigned char *compressed_blob = NULL;
+    unsigned char *uncompressed_blob = NULL;
+    size_t compressed_size_blob;
+    size_t uncompressed_size_blob;
+    strRB5_PROFILE_MARK prof=rb5_profile_begin();
+
+    compressed_size_blob=get_blobid_compressed(&(*rb5_info), req_blobid, &compressed_blob);
+    if (compressed_blob == NULL) return(EXIT_NULL_VAL);
+
+    uncompressed_size_blob=uncompress_this_blob(compressed_blob, &uncompressed_blob, compressed_size_blob);
+    if(L_DEBUG_OUTPUT_1) fprintf(stdout,"uncompressed_size_blob = %ld\n",uncompressed_size_blob);
+    RAVE_FREE(compressed_blob);
+    *return_uncompressed_blob=uncompressed_blob;
+    rb5_profile_end(RB5_PROFILE_BLOB_LOOKUP,prof,compressed_size_blob);
+    return(uncompressed_size_blob);
+}
+
+//#############################################################################
+
 void convert_raw_to_data(strRB5_PARAM_INFO *rb5_param, void **input_raw_arr, float **return_data_arr){
 
+    strRB5_PROFILE_MARK prof=rb5_profile_begin();
+
     //local vars
-    char conversion[MAX_STRING]="\0";
-    char sparam[MAX_STRING]="\0";
-    strcpy(conversion,rb5_param->conversion);
-    strcpy(sparam,rb5_param->sparam);
+    RB5_CONVERSION conversion=rb5_param->conversion;
     size_t n_elems_data    =rb5_param->n_elems_data;
     size_t raw_binary_depth=rb5_param->raw_binary_depth;
     size_t raw_binary_min=-1L;
@@ -164,7 +189,7 @@ void convert_raw_to_data(strRB5_PARAM_INFO *rb5_param, void **input_raw_arr, flo
         uint32_t *buffer_32=((uint32_t *)deref_input_raw_arr);
         for (i = 0; i < n_elems_data; i++) raw_arr[i]=(unsigned int)buffer_32[i];
     }
-//fprintf(stdout,"### (%2ld) param=%s\n",raw_binary_depth,sparam);
+//fprintf(stdout,"### (%2ld) param=%s\n",raw_binary_depth,rb5_param->sparam);
 //for (i = 0; i < n_elems_data; i++) fprintf(stdout,"%d ",raw_arr[i]);
 //fprintf(stdout,"\n");
 
@@ -172,7 +197,7 @@ void convert_raw_to_data(strRB5_PARAM_INFO *rb5_param, void **input_raw_arr, flo
     data_arr=RAVE_MALLOC(n_elems_data*sizeof(float));
 
     //straight copy 
-    if (strcmp(conversion, "copy") == 0) {
+    if (conversion == RB5_CONVERSION_COPY) {
         raw_binary_min=0L;
         raw_binary_max=(1L<<raw_binary_depth)-1;
         raw_binary_width=raw_binary_max-raw_binary_min;
@@ -187,7 +212,7 @@ void convert_raw_to_data(strRB5_PARAM_INFO *rb5_param, void **input_raw_arr, flo
         if(L_DEBUG_OUTPUT_2) fprintf(stdout,"\n");
         NODATA_val = -999.9; //n/a?
     //RB5_FileFormat_5430.pdf, pg.47 (scaling) data_range_max 360.0 NOT mapped!
-    } else if (strcmp(conversion, "angular") == 0) {
+    } else if (conversion == RB5_CONVERSION_ANGULAR) {
         raw_binary_min=0L;
         raw_binary_max=(1L<<raw_binary_depth)-1;
         raw_binary_width=raw_binary_max-raw_binary_min+1; //above data_range_max by a data_step (then trimmed)
@@ -204,7 +229,7 @@ void convert_raw_to_data(strRB5_PARAM_INFO *rb5_param, void **input_raw_arr, flo
         if(L_DEBUG_OUTPUT_2) fprintf(stdout,"\n");
         NODATA_val = -999.9; //n/a?
     //RB5_FileFormat_5430.pdf, pg.22 (data types have 0x00 reserved for "no data" & data_range_max IS mapped)
-    } else if (strcmp(conversion, "moment_data") == 0) {
+    } else if (conversion == RB5_CONVERSION_MOMENT_DATA) {
         raw_binary_min=1L;
         raw_binary_max=(1L<<raw_binary_depth)-1;
         raw_binary_width=raw_binary_max-raw_binary_min;
@@ -220,7 +245,7 @@ void convert_raw_to_data(strRB5_PARAM_INFO *rb5_param, void **input_raw_arr, flo
         if(L_DEBUG_OUTPUT_2) fprintf(stdout,"\n");
         NODATA_val = (0 * data_step) - data_step + data_range_min;
     } else {
-        fprintf(stdout,"  ERROR : Unknown conversion method = %s\n",conversion);
+        fprintf(stdout,"  ERROR : Unknown conversion method = %s\n",rb5_conversion_name(conversion));
     }
     if(L_DEBUG_OUTPUT_1) fprintf(stdout,"  NODATA_val = %f\n",NODATA_val);
 
@@ -236,31 +261,21 @@ void convert_raw_to_data(strRB5_PARAM_INFO *rb5_param, void **input_raw_arr, flo
 
     RAVE_FREE(raw_arr); 
     *return_data_arr=data_arr;
+    rb5_profile_end(RB5_PROFILE_CONVERT,prof,n_elems_data*sizeof(float));
 }
 
 //#############################################################################
 
-size_t return_param_blobid_raw(strRB5_INFO *rb5_info, strRB5_PARAM_INFO* rb5_param, void **return_raw_arr){
-
-    size_t EXIT_NULL_VAL=0;
+/*
+ * Function name: swap_blob_to_raw
+ * Intent: decoded blob (big-endian) into raw_arr, in host order for 16 and
+ *         32 bit data; size_blob bytes each
+ */
+void swap_blob_to_raw(const unsigned char *blob_buffer, size_t size_blob, size_t raw_binary_depth, void *raw_arr){
 
-    //local vars
-    size_t blobid          =rb5_param->blobid;
-    size_t size_blob;
-    size_t n_elems_data;
-    size_t data_bytesize   =rb5_param->data_bytesize;    
-    size_t raw_binary_depth=rb5_param->raw_binary_depth;
+    size_t n_elems_data=size_blob/(raw_binary_depth/8);
     size_t i;
- 
-    unsigned char *blob_buffer=NULL;
-    size_blob=get_blobid_buffer(&(*rb5_info), blobid, &blob_buffer);
-    if (blob_buffer == NULL) {
-      fprintf(stdout,"ERROR: blobid = %ld NOT FOUND!!!\n",blobid);
-      return EXIT_NULL_VAL;
-    }
 
-    n_elems_data=size_blob/data_bytesize;
-    void *raw_arr=(void *)RAVE_MALLOC(size_blob);
     if (raw_binary_depth == 8 ) {
         /*8 bit data (copy blob_buffer)*/
         uint8_t *buffer_8=(uint8_t *)RAVE_MALLOC(size_blob);
@@ -289,6 +304,34 @@ size_t return_param_blobid_raw(strRB5_INFO *rb5_info, strRB5_PARAM_INFO* rb5_par
         memcpy(raw_arr,buffer_32,size_blob);
         RAVE_FREE(buffer_32);
     }
+}
+
+//#############################################################################
+
+size_t return_param_blobid_raw(strRB5_INFO *rb5_info, strRB5_PARAM_INFO* rb5_param, void **return_raw_arr){
+
+    size_t EXIT_NULL_VAL=0;
+
+    //local vars
+    size_t blobid          =rb5_param->blobid;
+    size_t size_blob;
+    size_t n_elems_data;
+    size_t data_bytesize   =rb5_param->data_bytesize;    
+    size_t raw_binary_depth=rb5_param->raw_binary_depth;
+
+    //already decoded, byte swapped and reordered (see rb5_cache.c)
+    if (rb5_info->cache != NULL) return(return_rb5_cache_raw((strRB5_CACHE *)rb5_info->cache,&(*rb5_param),return_raw_arr));
+ 
+    unsigned char *blob_buffer=NULL;
+    size_blob=get_blobid_buffer(&(*rb5_info), blobid, &blob_buffer);
+    if (blob_buffer == NULL) {
+      fprintf(stdout,"ERROR: blobid = %ld NOT FOUND!!!\n",blobid);
+      return EXIT_NULL_VAL;
+    }
+
+    n_elems_data=size_blob/data_bytesize;
+    void *raw_arr=(void *)RAVE_MALLOC(size_blob);
+    swap_blob_to_raw(blob_buffer,size_blob,raw_binary_depth,raw_arr);
     RAVE_FREE(blob_buffer);
 
     if(L_DEBUG_OUTPUT_1) fprintf(stdout,"  n_elems_data = %ld\n",n_elems_data);
@@ -298,6 +341,7 @@ size_t return_param_blobid_raw(strRB5_INFO *rb5_info, strRB5_PARAM_INFO* rb5_par
     if(rb5_param->n_elems_data != n_elems_data){
         fprintf(stdout,"  INCONSISTENT rb5_param->n_elems_data = %ld\n",rb5_param->n_elems_data);
         fprintf(stdout,"  INCONSISTENT n_elems_data = %ld\n",n_elems_data);
+        RAVE_FREE(raw_arr);
         return EXIT_NULL_VAL;
     }
     rb5_param->n_elems_data=n_elems_data;
@@ -315,47 +359,12 @@ size_t return_param_blobid_raw(strRB5_INFO *rb5_info, strRB5_PARAM_INFO* rb5_par
 
 char *map_rb5_to_h5_param(char *sparam){
 
-    static char return_string[MAX_STRING]="\0";
-
-    //reference:
-    // RB5_FileFormat_5510.pdf, 2.2.3.4.1 Array "datamap", pg 21-22, "Data types"
-    // RB5_UserGuide_5430.pdf, 4.10.2.4 Data Types, pg 81-82
-
-           if (strcmp(sparam, "dBZ"    ) == 0 ){; strcpy(return_string,"DBZH");
-    } else if (strcmp(sparam, "dBZv"   ) == 0 ){; strcpy(return_string,"DBZV");
-    } else if (strcmp(sparam, "dBuZ"   ) == 0 ){; strcpy(return_string,"TH");
-    } else if (strcmp(sparam, "dBuZv"  ) == 0 ){; strcpy(return_string,"TV");
-    } else if (strcmp(sparam, "V"      ) == 0 ){; strcpy(return_string,"VRADH");
-    } else if (strcmp(sparam, "Vv"     ) == 0 ){; strcpy(return_string,"VRADV");
-    } else if (strcmp(sparam, "Vu"     ) == 0 ){; strcpy(return_string,"UVRADH");
-    } else if (strcmp(sparam, "Vvu"    ) == 0 ){; strcpy(return_string,"UVRADV");
-    } else if (strcmp(sparam, "W"      ) == 0 ){; strcpy(return_string,"WRADH");
-    } else if (strcmp(sparam, "Wv"     ) == 0 ){; strcpy(return_string,"WRADV");
-    } else if (strcmp(sparam, "Wu"     ) == 0 ){; strcpy(return_string,"UWRADH");
-    } else if (strcmp(sparam, "Wvu"    ) == 0 ){; strcpy(return_string,"UWRADV");
-
-    } else if (strcmp(sparam, "ZDR"    ) == 0 ){; strcpy(return_string,"ZDR");
-    } else if (strcmp(sparam, "ZDRu"   ) == 0 ){; strcpy(return_string,"UZDR");
-    } else if (strcmp(sparam, "PhiDP"  ) == 0 ){; strcpy(return_string,"PHIDP");
-    } else if (strcmp(sparam, "uPhiDP" ) == 0 ){; strcpy(return_string,"UPHIDP");
-    } else if (strcmp(sparam, "uPhiDPu") == 0 ){; strcpy(return_string,"UPHIDPU");
-    } else if (strcmp(sparam, "KDP"    ) == 0 ){; strcpy(return_string,"KDP");
-    } else if (strcmp(sparam, "uKDP"   ) == 0 ){; strcpy(return_string,"UKDP");
-    } else if (strcmp(sparam, "uKDPu"  ) == 0 ){; strcpy(return_string,"UKDPU");
-    } else if (strcmp(sparam, "RhoHV"  ) == 0 ){; strcpy(return_string,"RHOHV");
-    } else if (strcmp(sparam, "RhoHVu" ) == 0 ){; strcpy(return_string,"URHOHV");
-
-    } else if (strcmp(sparam, "SQI"    ) == 0 ){; strcpy(return_string,"SQIH");
-    } else if (strcmp(sparam, "SQIv"   ) == 0 ){; strcpy(return_string,"SQIV");
-    } else if (strcmp(sparam, "SQIu"   ) == 0 ){; strcpy(return_string,"USQIH");
-    } else if (strcmp(sparam, "SQIvu"  ) == 0 ){; strcpy(return_string,"USQIV");
-    } else if (strcmp(sparam, "SNR"    ) == 0 ){; strcpy(return_string,"SNRH");
-    } else if (strcmp(sparam, "SNRv"   ) == 0 ){; strcpy(return_string,"SNRV");
-    } else if (strcmp(sparam, "SNRu"   ) == 0 ){; strcpy(return_string,"USNRH");
-    } else if (strcmp(sparam, "SNRvu"  ) == 0 ){; strcpy(return_string,"USNRV");
-
-    } else if (strcmp(sparam, "ET"     ) == 0 ){; strcpy(return_string,"CLASS");
+    static __thread char return_string[MAX_STRING]="\0";
 
+    //registry, see rb5_params.c; unknown types are upper-cased
+    const strRB5_PARAM_DEF *def=rb5_param_def(rb5_param_id(sparam));
+    if (def != NULL) {
+        strcpy(return_string,def->quantity);
     } else {
         strcpy(return_string,sparam);
         int i;
@@ -372,107 +381,26 @@ char *map_rb5_to_h5_param(char *sparam){
 
 int is_rb5_param_dualpol(char *sparam){
 
-           if (strcmp(sparam, "ZDR"    ) == 0 ){; return(1);
-    } else if (strcmp(sparam, "ZDRu"   ) == 0 ){; return(1);
-    } else if (strcmp(sparam, "PhiDP"  ) == 0 ){; return(1);
-    } else if (strcmp(sparam, "uPhiDP" ) == 0 ){; return(1);
-    } else if (strcmp(sparam, "uPhiDPu") == 0 ){; return(1);
-    } else if (strcmp(sparam, "KDP"    ) == 0 ){; return(1);
-    } else if (strcmp(sparam, "uKDP"   ) == 0 ){; return(1);
-    } else if (strcmp(sparam, "uKDPu"  ) == 0 ){; return(1);
-    } else if (strcmp(sparam, "RhoHV"  ) == 0 ){; return(1);
-    } else if (strcmp(sparam, "RhoHVu" ) == 0 ){; return(1);
-    } else {
-        return(0);
-    }
+    const strRB5_PARAM_DEF *def=rb5_param_def(rb5_param_id(sparam));
+    return(def != NULL ? def->L_DUALPOL : 0);
 }
 
 //#############################################################################
 
 strURPDATA what_is_this_param_to_urp(char *sparam){
     strURPDATA urp;
-    // see ~/Projects/IRIS/sigmet/include/sigtypes.h
-    // see /apps/urp/build/include/drpdecode.h
+    const strRB5_PARAM_DEF *def=rb5_param_def(rb5_param_id(sparam));
+    if (def == NULL) {
                    urp.type=-1;
             strcpy(urp.name,"n/a");
             strcpy(urp.unit,"n/a");
             strcpy(urp.desc,"n/a");
-               if (strcmp(sparam, "dataflag") == 0){
-        } else if (strcmp(sparam, "startangle") == 0){
-        } else if (strcmp(sparam, "stopangle") == 0){
-        } else if (strcmp(sparam, "startfixangle") == 0){
-        } else if (strcmp(sparam, "stopafixngle") == 0){
-        } else if (strcmp(sparam, "numpulses") == 0 ){
-        } else if (strcmp(sparam, "timestamp") == 0 ){
-        } else if (strcmp(sparam, "txpower") == 0 ){
-        } else if (strcmp(sparam, "noisepowerh") == 0 ){
-        } else if (strcmp(sparam, "noisepowerv") == 0 ){
-        } else if (strcmp(sparam, "dBuZ") == 0 ){
-                   urp.type=1;
-            strcpy(urp.name,"DBT");
-            strcpy(urp.unit,"dBZ");
-            strcpy(urp.desc,"Uncorrected Reflectivity");
-        } else if (strcmp(sparam, "dBZ") == 0 ){
-                   urp.type=2;
-            strcpy(urp.name,"DBZ");
-            strcpy(urp.unit,"dBZ");
-            strcpy(urp.desc,"Reflectivity");
-        } else if (strcmp(sparam, "V") == 0 ){
-                   urp.type=3;
-            strcpy(urp.name,"VEL");
-            strcpy(urp.unit,"m/s");
-            strcpy(urp.desc,"Velocity");
-        } else if (strcmp(sparam, "W") == 0 ){
-                   urp.type=4;
-            strcpy(urp.name,"WID");
-            strcpy(urp.unit,"m/s");
-            strcpy(urp.desc,"Width");
-        } else if (strcmp(sparam, "SNR") == 0 ){
-                   urp.type=100;
-            strcpy(urp.name,"SNR");
-            strcpy(urp.unit,"");
-            strcpy(urp.desc,"Signal to Noise");
-        } else if (strcmp(sparam, "SQI") == 0 ){
-                   urp.type=18;
-            strcpy(urp.name,"SQI");
-            strcpy(urp.unit,"");
-            strcpy(urp.desc,"Signal Quality Index");
-        } else if (strcmp(sparam, "ZDR") == 0 ){
-                   urp.type=5;
-            strcpy(urp.name,"ZDR");
-            strcpy(urp.unit,"dB");
-            strcpy(urp.desc,"Differential Reflectivity");
-        } else if (strcmp(sparam, "RhoHV") == 0 ){
-                   urp.type=19;
-            strcpy(urp.name,"RHOHV");
-            strcpy(urp.unit,"");
-            strcpy(urp.desc,"Correlation Coefficient");
-        } else if (strcmp(sparam, "uPhiDP") == 0 ){
-                   urp.type=216; //New URP decree 2017-Sep-12; was urp.type=16
-            strcpy(urp.name,"UPHIDP");
-            strcpy(urp.unit,"deg");
-            strcpy(urp.desc,"Uncorrected Differential Phase");
-        } else if (strcmp(sparam, "PhiDP") == 0 ){
-                   urp.type=16;
-            strcpy(urp.name,"PHIDP");
-            strcpy(urp.unit,"deg");
-            strcpy(urp.desc,"Differential Phase");
-        } else if (strcmp(sparam, "uKDP") == 0 ){
-                   urp.type=14;
-            strcpy(urp.name,"UKDP");
-            strcpy(urp.unit,"deg/km");
-            strcpy(urp.desc,"Uncorrected Specific Differential Phase");
-        } else if (strcmp(sparam, "KDP") == 0 ){
-                   urp.type=14;
-            strcpy(urp.name,"KDP");
-            strcpy(urp.unit,"deg/km");
-            strcpy(urp.desc,"Specific Differential Phase");
-        } else if (strcmp(sparam, "ET") == 0 ){
-                   urp.type=55; //Hydrometeor Class (1 byte)
-            strcpy(urp.name,"HCLASS");
-            strcpy(urp.unit,"");
-            strcpy(urp.desc,"Hydrometeor Class (was RB5 Echo Type))");
-        }
+    } else {
+                   urp.type=def->urp_type;
+            strcpy(urp.name,def->urp_name);
+            strcpy(urp.unit,def->urp_unit);
+            strcpy(urp.desc,def->urp_desc);
+    }
     return(urp);
 }
 
@@ -480,19 +408,19 @@ strURPDATA what_is_this_param_to_urp(char *sparam){
 
 void close_rb5_info(strRB5_INFO *rb5_info){
 
+  //cleared as freed, populate_rb5_info() closes on every failure
   if(rb5_info->xpathCtx != NULL) xmlXPathFreeContext(rb5_info->xpathCtx); //cleanup
   if(rb5_info->doc      != NULL) xmlFreeDoc(rb5_info->doc); // free the document
   if(rb5_info->buffer   != NULL) close_file_buffer(rb5_info->buffer); // free entire file buffer
+  rb5_info->xpathCtx=NULL;
+  rb5_info->doc=NULL;
+  rb5_info->buffer=NULL;
 
   int this_slice;  
-  for (this_slice = 0; this_slice < rb5_info->n_slices; this_slice++){
-    if(rb5_info->slice_moving_angle_start_arr[this_slice] != NULL) RAVE_FREE(rb5_info->slice_moving_angle_start_arr[this_slice]);
-    if(rb5_info->slice_moving_angle_stop_arr[this_slice] != NULL) RAVE_FREE(rb5_info->slice_moving_angle_stop_arr[this_slice]);
-    if(rb5_info->slice_fixed_angle_start_arr[this_slice] != NULL) RAVE_FREE(rb5_info->slice_fixed_angle_start_arr[this_slice]);
-    if(rb5_info->slice_fixed_angle_stop_arr[this_slice] != NULL) RAVE_FREE(rb5_info->slice_fixed_angle_stop_arr[this_slice]);
-
-    if(rb5_info->slice_moving_angle_arr[this_slice] != NULL) RAVE_FREE(rb5_info->slice_moving_angle_arr[this_slice]);
-    if(rb5_info->slice_fixed_angle_arr[this_slice] != NULL) RAVE_FREE(rb5_info->slice_fixed_angle_arr[this_slice]);
+  for (this_slice = 0; this_slice < MAX_SLICES; this_slice++){ //NULL or owned, whatever n_slices is so far
+    //the slice_*_angle_arr are views into the block
+    if(rb5_info->slice_angle_block[this_slice] != NULL) RAVE_FREE(rb5_info->slice_angle_block[this_slice]);
+    rb5_info->slice_angle_block[this_slice]=NULL;
   }
 
 }
@@ -503,7 +431,7 @@ char *get_xpath_slice_attrib(const xmlXPathContextPtr xpathCtx, size_t this_slic
 
   char xpath[MAX_STRING]="\0";
   char xpath_bgn[MAX_STRING]="\0";
-  static char return_string[MAX_STRING]="\0";
+  static __thread char return_string[MAX_STRING]="\0";
   int iSLICE=0;
   int ifoundSLICE=0;
   //compare this_SLICE vs iSLICE=0
@@ -525,6 +453,87 @@ if(L_DEBUG_OUTPUT_2) fprintf(stdout,"ifoundSLICE = %2d : %s = %s\n",ifoundSLICE,
 
 //#############################################################################
 
+/*
+ * Function name: populate_slice_statics
+ * Intent: slice parameters that only change with the scan strategy,
+ *         see rb5_strategy.c
+ */
+static void populate_slice_statics(strRB5_INFO *rb5_info, int this_slice){
+
+    const xmlXPathContextPtr xpathCtx=rb5_info->xpathCtx;
+
+           rb5_info->angle_deg_arr          [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/posangle"));
+           rb5_info->slice_nyquist_vel      [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/dynv/@max"));
+           rb5_info->slice_nyquist_wid      [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/dynw/@max"));
+           rb5_info->slice_bin_range_res_km [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/rangestep"));
+           rb5_info->slice_bin_range_bgn_km [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/start_range"));
+           rb5_info->slice_bin_range_end_km [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/stoprange"));
+           rb5_info->slice_ray_angle_res_deg[this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/anglestep"));
+           rb5_info->slice_ray_angle_bgn_deg[this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/startangle"));
+           rb5_info->slice_ray_angle_end_deg[this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/stopangle"));
+    //NOTE: since Rainbow v5.51 (re: CWRRP), pulse width determination via XML tag <pw_index> was replaced by <dynpw>
+    static __thread char tmp_a[MAX_STRING]="\0";
+    if(strcmp(strcpy(tmp_a,get_xpath_slice_attrib(xpathCtx,this_slice,"/dynpw")),"")) {
+           rb5_info->slice_pw_index         [this_slice]=0; //radconst now a scalar
+           rb5_info->slice_pw_microsec      [this_slice]=atof(tmp_a);
+    } else {
+           size_t slice_pw_index=atoi(get_xpath_slice_attrib(xpathCtx,this_slice,"/pw_index"));
+           rb5_info->slice_pw_index         [this_slice]=slice_pw_index;
+           if(slice_pw_index == 0){
+             rb5_info->slice_pw_microsec    [this_slice]=0.3;
+           } else if(slice_pw_index == 1) {
+             rb5_info->slice_pw_microsec    [this_slice]=1.0;
+           } else if(slice_pw_index == 2) {
+             rb5_info->slice_pw_microsec    [this_slice]=2.0;
+           } else if(slice_pw_index == 3) {
+             rb5_info->slice_pw_microsec    [this_slice]=3.3;
+           }
+    }
+
+           rb5_info->slice_antspeed_deg_sec [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/antspeed"));
+           rb5_info->slice_antspeed_rpm     [this_slice]= rb5_info->slice_antspeed_deg_sec [this_slice]/360.*60.;
+           rb5_info->slice_num_samples      [this_slice]= atoi(get_xpath_slice_attrib(xpathCtx,this_slice,"/timesamp"));
+    strcpy(rb5_info->slice_dual_prf_mode    [this_slice],      get_xpath_slice_attrib(xpathCtx,this_slice,"/dualprfmode"));
+    strcpy(rb5_info->slice_prf_stagger      [this_slice],      get_xpath_slice_attrib(xpathCtx,this_slice,"/stagger"));
+           rb5_info->slice_hi_prf           [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/highprf"));
+           rb5_info->slice_lo_prf           [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/lowprf"));
+           rb5_info->slice_csr_threshold    [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/csr"));
+           rb5_info->slice_sqi_threshold    [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/sqi"));
+           rb5_info->slice_zsqi_threshold   [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/zsqi"));
+           rb5_info->slice_log_threshold    [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/log"));
+
+    //NOTE: since Rainbow v5.51 (re: CWRRP), radconst is a scalar
+    char rspdphradconst[MAX_STRING]="\0";
+    char rspdpvradconst[MAX_STRING]="\0";
+    strcpy(rspdphradconst,get_xpath_slice_attrib(xpathCtx,this_slice,"/rspdphradconst"));
+    strcpy(rspdpvradconst,get_xpath_slice_attrib(xpathCtx,this_slice,"/rspdpvradconst"));
+    //get <pw_index>'th field
+    // code ref: http://stackoverflow.com/questions/11198604/c-split-string-into-an-array-of-strings
+    char *pw_array[MAX_PULSE_WIDTHS+1];
+    char delimiters[]=" ,\t\n";
+    char *token;
+    char *saveptr=NULL; //strtok_r(), decodes run concurrently
+    int i;
+    i=-1;
+    token=strtok_r(rspdphradconst,delimiters,&saveptr);
+    while(token != NULL && i < MAX_PULSE_WIDTHS){
+      pw_array[++i]=token;
+      token=strtok_r(NULL,delimiters,&saveptr);
+    }
+    rb5_info->slice_radconst_h[this_slice]=atof(pw_array[rb5_info->slice_pw_index[this_slice]]);
+    i=-1;
+    token=strtok_r(rspdpvradconst,delimiters,&saveptr);
+    while(token != NULL && i < MAX_PULSE_WIDTHS){
+      pw_array[++i]=token;
+      token=strtok_r(NULL,delimiters,&saveptr);
+    }
+    rb5_info->slice_radconst_v[this_slice]=atof(pw_array[rb5_info->slice_pw_index[this_slice]]);
+
+}
+
+//#############################################################################
+
+//on failure rb5_info is closed (close_rb5_info()), its document and buffer freed
 int populate_rb5_info(strRB5_INFO *rb5_info, int L_VERBOSE){
 
     const xmlXPathContextPtr xpathCtx=rb5_info->xpathCtx;
@@ -532,10 +541,15 @@ int populate_rb5_info(strRB5_INFO *rb5_info, int L_VERBOSE){
     char xpath_bgn[MAX_STRING]="\0";
 
     char stmpa[MAX_STRING]="\0";
-    strcpy(stmpa,rb5_info->inp_fullfile);
-    strcpy(rb5_info->inp_file_basename,basename(stmpa));
-    strcpy(stmpa,rb5_info->inp_fullfile);
-    strcpy(rb5_info->inp_file_dirname , dirname(stmpa));
+    char spath[MAX_PATH_STRING]="\0"; //basename() and dirname() may modify their argument
+    snprintf(spath,MAX_PATH_STRING,"%s",rb5_info->inp_fullfile);
+    snprintf(rb5_info->inp_file_basename,MAX_STRING,"%s",basename(spath));
+    snprintf(spath,MAX_PATH_STRING,"%s",rb5_info->inp_fullfile);
+    snprintf(rb5_info->inp_file_dirname,MAX_PATH_STRING,"%s",dirname(spath));
+
+    //nothing per slice is owned yet, close_rb5_info() may run on any failure below
+    rb5_info->n_slices=0;
+    memset(rb5_info->slice_angle_block,0,sizeof(rb5_info->slice_angle_block));
 
     //determine data type by file contents
     sprintf(xpath_bgn,"(/volume/scan/slice)[1]/slicedata/rawdata");
@@ -670,13 +684,18 @@ int populate_rb5_info(strRB5_INFO *rb5_info, int L_VERBOSE){
     strcpy(rb5_info->slice_iso8601_bgn      [this_slice],      get_xpath_slice_attrib(xpathCtx,this_slice,"/slicedata/@datetimehighaccuracy"));
            rb5_info->slice_iso8601_bgn      [this_slice][10]=' '; //blank T-delimiter
 
-    //RAYINFO (keep rayinfo_name_arr only)
+    //RAYINFO (keep rayinfo_name_arr only, and where each role is)
+    int this_role, this_param;
+    for (this_role = 0; this_role < RB5_N_RAYINFO_ROLES; this_role++) rb5_info->rayinfo_idx_by_role[this_role]=-1;
+    for (this_param = 0; this_param < RB5_N_PARAMS; this_param++) rb5_info->rawdata_idx_by_param[this_param]=-1;
     sprintf(xpath_bgn,"((/volume/scan/slice)[%2d]/slicedata/%s)",this_slice+1,"rayinfo");
     rb5_info->n_rayinfos=get_xpath_size(xpathCtx,xpath_bgn);
     for (this_rayinfo = 0; this_rayinfo < rb5_info->n_rayinfos; this_rayinfo++){
       sprintf(xpath_bgn,"((/volume/scan/slice)[%2d]/slicedata/%s)[%2ld]/",this_slice+1,"rayinfo",this_rayinfo+1);
       rb5_param=get_rb5_param_info(rb5_info,xpath_bgn,L_RB5_PARAM_VERBOSE);
       strcpy(rb5_info->rayinfo_name_arr[this_rayinfo],rb5_param.sparam);
+      const strRB5_PARAM_DEF *def=rb5_param_def(rb5_param.param_id);
+      if(def != NULL && def->rayinfo_role != RB5_RAYINFO_NONE) rb5_info->rayinfo_idx_by_role[def->rayinfo_role]=this_rayinfo;
     } //for (this_rayinfo = 0; this_rayinfo < rb5_info->n_rayinfos; this_rayinfo++){
 
     if(L_DEBUG_OUTPUT_1){
@@ -699,6 +718,7 @@ int populate_rb5_info(strRB5_INFO *rb5_info, int L_VERBOSE){
       sprintf(xpath_bgn,"((/volume/scan/slice)[%2d]/slicedata/%s)[%2ld]/",this_slice+1,"rawdata",this_rawdata+1);
       rb5_param=get_rb5_param_info(rb5_info,xpath_bgn,L_RB5_PARAM_QUIET);
       strcpy(rb5_info->rawdata_name_arr[this_rawdata],rb5_param.sparam);
+      if(rb5_param.param_id != RB5_PARAM_UNKNOWN) rb5_info->rawdata_idx_by_param[rb5_param.param_id]=this_rawdata;
     } //for (this_rawdata = 0; this_rawdata < rb5_info->n_rawdatas; this_rawdata++){
 
     if(L_DEBUG_OUTPUT_1) {
@@ -716,9 +736,18 @@ int populate_rb5_info(strRB5_INFO *rb5_info, int L_VERBOSE){
 
     strcpy(xpath,"/volume/scan/pargroup/numele");
     rb5_info->n_slices=atoi(return_xpath_value(xpathCtx,xpath));
+    if(rb5_info->n_slices > MAX_SLICES){
+        fprintf(stderr,"Error: %ld slices, at most %d are decoded\n",rb5_info->n_slices,MAX_SLICES);
+        close_rb5_info(&(*rb5_info));
+        return(EXIT_FAILURE);
+    }
     if(L_VERBOSE){
         fprintf(stdout,"%s = %ld\n", "rb5_info->n_slices", rb5_info->n_slices);
     }
+    int L_STRATEGY_HIT=(rb5_strategy_lookup(rb5_info) == EXIT_SUCCESS);
+    if(L_VERBOSE){
+        fprintf(stdout,"%s = %s\n", "scan strategy", L_STRATEGY_HIT ? "cached" : "parsed");
+    }
 
     char req_rawdata_name[MAX_STRING]="\0";
     int idx_req=-1;
@@ -737,78 +766,26 @@ int populate_rb5_info(strRB5_INFO *rb5_info, int L_VERBOSE){
         strcpy(rb5_info->slice_iso8601_bgn      [this_slice],      get_xpath_slice_attrib(xpathCtx,this_slice,"/slicedata/@datetimehighaccuracy"));
                rb5_info->slice_iso8601_bgn      [this_slice][10]=' '; //blank T-delimiter
 
-               rb5_info->angle_deg_arr          [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/posangle"));
-               rb5_info->slice_nyquist_vel      [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/dynv/@max"));
-               rb5_info->slice_nyquist_wid      [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/dynw/@max"));
-               rb5_info->slice_bin_range_res_km [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/rangestep"));
-               rb5_info->slice_bin_range_bgn_km [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/start_range"));
-               rb5_info->slice_bin_range_end_km [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/stoprange"));
-               rb5_info->slice_ray_angle_res_deg[this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/anglestep"));
-               rb5_info->slice_ray_angle_bgn_deg[this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/startangle"));
-               rb5_info->slice_ray_angle_end_deg[this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/stopangle"));
-        //NOTE: since Rainbow v5.51 (re: CWRRP), pulse width determination via XML tag <pw_index> was replaced by <dynpw>
-        static char tmp_a[MAX_STRING]="\0";
-        if(strcmp(strcpy(tmp_a,get_xpath_slice_attrib(xpathCtx,this_slice,"/dynpw")),"")) {
-               rb5_info->slice_pw_index         [this_slice]=0; //radconst now a scalar
-               rb5_info->slice_pw_microsec      [this_slice]=atof(tmp_a);
-        } else {
-               size_t slice_pw_index=atoi(get_xpath_slice_attrib(xpathCtx,this_slice,"/pw_index"));
-               rb5_info->slice_pw_index         [this_slice]=slice_pw_index;
-               if(slice_pw_index == 0){
-                 rb5_info->slice_pw_microsec    [this_slice]=0.3;
-               } else if(slice_pw_index == 1) {
-                 rb5_info->slice_pw_microsec    [this_slice]=1.0;
-               } else if(slice_pw_index == 2) {
-                 rb5_info->slice_pw_microsec    [this_slice]=2.0;
-               } else if(slice_pw_index == 3) {
-                 rb5_info->slice_pw_microsec    [this_slice]=3.3;
-               }
+        //parse once, all further slice time math is on integer epoch millisecs
+        if(func_iso8601_2_epoch_ms(rb5_info->slice_iso8601_bgn_low[this_slice],&rb5_info->slice_epoch_ms_bgn_low[this_slice]) != EXIT_SUCCESS ||
+           func_iso8601_2_epoch_ms(rb5_info->slice_iso8601_bgn    [this_slice],&rb5_info->slice_epoch_ms_bgn    [this_slice]) != EXIT_SUCCESS){
+            fprintf(stderr,"Error: Bad slice %d date/time, date time = '%s', datetimehighaccuracy = '%s'\n",
+                    this_slice,rb5_info->slice_iso8601_bgn_low[this_slice],rb5_info->slice_iso8601_bgn[this_slice]);
+            close_rb5_info(&(*rb5_info));
+            return(EXIT_FAILURE);
         }
 
-               rb5_info->slice_antspeed_deg_sec [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/antspeed"));
-               rb5_info->slice_antspeed_rpm     [this_slice]= rb5_info->slice_antspeed_deg_sec [this_slice]/360.*60.;
-               rb5_info->slice_num_samples      [this_slice]= atoi(get_xpath_slice_attrib(xpathCtx,this_slice,"/timesamp"));
-        strcpy(rb5_info->slice_dual_prf_mode    [this_slice],      get_xpath_slice_attrib(xpathCtx,this_slice,"/dualprfmode"));
-        strcpy(rb5_info->slice_prf_stagger      [this_slice],      get_xpath_slice_attrib(xpathCtx,this_slice,"/stagger"));
-               rb5_info->slice_hi_prf           [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/highprf"));
-               rb5_info->slice_lo_prf           [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/lowprf"));
-               rb5_info->slice_csr_threshold    [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/csr"));
-               rb5_info->slice_sqi_threshold    [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/sqi"));
-               rb5_info->slice_zsqi_threshold   [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/zsqi"));
-               rb5_info->slice_log_threshold    [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/log"));
+        //static slice parameters, from the strategy cache when this strategy was seen before
+        if(!L_STRATEGY_HIT) populate_slice_statics(rb5_info,this_slice);
+
                rb5_info->slice_noise_power_h    [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/noise_power_dbz"));
                rb5_info->slice_noise_power_v    [this_slice]= atof(get_xpath_slice_attrib(xpathCtx,this_slice,"/noise_power_dbz_dpv"));
 
         if (get_slice_end_iso8601(&(*rb5_info),this_slice) != EXIT_SUCCESS){ //needs rb5_info->slice_antspeed_deg_sec [this_slice]
+            close_rb5_info(&(*rb5_info));
             return EXIT_FAILURE;
         }
 
-        //NOTE: since Rainbow v5.51 (re: CWRRP), radconst is a scalar
-        static char rspdphradconst[MAX_STRING]="\0";
-        static char rspdpvradconst[MAX_STRING]="\0";
-        strcpy(rspdphradconst,get_xpath_slice_attrib(xpathCtx,this_slice,"/rspdphradconst"));
-        strcpy(rspdpvradconst,get_xpath_slice_attrib(xpathCtx,this_slice,"/rspdpvradconst"));
-        //get <pw_index>'th field
-        // code ref: http://stackoverflow.com/questions/11198604/c-split-string-into-an-array-of-strings
-        char *pw_array[MAX_PULSE_WIDTHS+1];
-        char delimiters[]=" ,\t\n";
-        char *token;
-        int i;
-        i=-1;
-        token=strtok(rspdphradconst,delimiters);
-        while(token != NULL){
-          pw_array[++i]=token;
-          token=strtok(NULL,delimiters);
-        }
-        rb5_info->slice_radconst_h[this_slice]=atof(pw_array[rb5_info->slice_pw_index[this_slice]]);
-        i=-1;
-        token=strtok(rspdpvradconst,delimiters);
-        while(token != NULL){
-          pw_array[++i]=token;
-          token=strtok(NULL,delimiters);
-        }
-        rb5_info->slice_radconst_v[this_slice]=atof(pw_array[rb5_info->slice_pw_index[this_slice]]);
-
         //update dims from rb5_param_info, with verbose option
             strcpy(req_rawdata_name,"dBZ"); //mandatory
         if(strcmp(rb5_info->inp_file_data_type, "ALL") == 0){
@@ -816,7 +793,7 @@ int populate_rb5_info(strRB5_INFO *rb5_info, int L_VERBOSE){
         } else {
             strcpy(req_rawdata_name,rb5_info->inp_file_data_type); //self
         }
-        idx_req=find_in_string_arr(rb5_info->rawdata_name_arr,rb5_info->n_rawdatas,req_rawdata_name);
+        idx_req=find_rb5_rawdata(rb5_info,req_rawdata_name);
         if(idx_req == -1) {
             fprintf(stdout,"IMPOSSIBLE: %s not found\n", req_rawdata_name);
         } else {
@@ -830,21 +807,18 @@ int populate_rb5_info(strRB5_INFO *rb5_info, int L_VERBOSE){
         //needed angle_deg_arr & slice_ray_angle_res_deg
         //calculate moving and fixed average ray readbacks
         if (get_slice_mid_angle_readbacks(&(*rb5_info),this_slice) != EXIT_SUCCESS){
+            close_rb5_info(&(*rb5_info));
             return EXIT_FAILURE;
         }
         //get iray_0degN, updates rb5_info->slice_moving_angle_arr
         get_slice_iray_0degN(&(*rb5_info),this_slice);
 
         // Consistency check for datetimehighaccuracy issue
-        double slice_systime_bgn_low=func_iso8601_2_systime(rb5_info->slice_iso8601_bgn_low[this_slice]);
-        double slice_systime_bgn    =func_iso8601_2_systime(rb5_info->slice_iso8601_bgn    [this_slice]);
-        double slice_systime_end_est=func_iso8601_2_systime(rb5_info->slice_iso8601_end_est[this_slice]);
-        double slice_systime_end    =func_iso8601_2_systime(rb5_info->slice_iso8601_end    [this_slice]);
-        double slice_systime_bgn_diff=fabs(slice_systime_bgn - slice_systime_bgn_low);
-        double slice_systime_end_diff=fabs(slice_systime_end - slice_systime_end_est);
-        double readback_time_diff_sec_threshold = 1.0;
-        if((slice_systime_bgn_diff >= readback_time_diff_sec_threshold) ||
-           (slice_systime_end_diff >= readback_time_diff_sec_threshold)){
+        int64_t slice_ms_bgn_diff=llabs(rb5_info->slice_epoch_ms_bgn[this_slice] - rb5_info->slice_epoch_ms_bgn_low[this_slice]);
+        int64_t slice_ms_end_diff=llabs(rb5_info->slice_epoch_ms_end[this_slice] - rb5_info->slice_epoch_ms_end_est[this_slice]);
+        int64_t readback_time_diff_ms_threshold = 1000;
+        if((slice_ms_bgn_diff >= readback_time_diff_ms_threshold) ||
+           (slice_ms_end_diff >= readback_time_diff_ms_threshold)){
             rb5_info->L_TIME_ACCURACY_DOWNGRADE=1; //flag for setRayAttributes() setting "how/startazT"
             if(L_VERBOSE){
                 fprintf(stdout,"Inconsistent datetimehighaccuracy...\n");
@@ -861,6 +835,8 @@ int populate_rb5_info(strRB5_INFO *rb5_info, int L_VERBOSE){
 
     } //for (this_slice = 0; this_slice < rb5_info->n_slices; this_slice++){
 
+    if(!L_STRATEGY_HIT) rb5_strategy_store(rb5_info);
+
     if(L_VERBOSE){
         fprintf(stdout,"\n");
     }
@@ -954,30 +930,11 @@ strRB5_PARAM_INFO get_rb5_param_info(strRB5_INFO *rb5_info, char *xpath_bgn, int
     // pre-calc, to be confirmed by return_param_blobid_raw()
     rb5_param.n_elems_data=rb5_param.nrays*rb5_param.nbins;
 
-            if((strcmp(rb5_param.sparam, "dataflag") == 0) ||
-               (strcmp(rb5_param.sparam, "numpulses") == 0 ) ||
-               (strcmp(rb5_param.sparam, "timestamp") == 0 ) ||
-               (strcmp(rb5_param.sparam, "txpower") == 0 ) ||
-               (strcmp(rb5_param.sparam, "noisepowerh") == 0 ) ||
-               (strcmp(rb5_param.sparam, "noisepowerv") == 0 )) {
-        strcpy(rb5_param.conversion,"copy");
-    } else  if((strcmp(rb5_param.sparam, "startangle") == 0) ||
-               (strcmp(rb5_param.sparam, "stopangle") == 0 ) ||
-               (strcmp(rb5_param.sparam, "startfixangle") == 0 ) ||
-               (strcmp(rb5_param.sparam, "stopfixangle") == 0 )) {
-        strcpy(rb5_param.conversion,"angular");
-    //removed special param packing check, 2017-Mar-23
-//    } else  if( (strcmp(rb5_param.sparam, "uPhiDP") == 0) ||
-//               (strcmp(rb5_param.sparam, "PhiDP") == 0 )) {
-//        strcpy(rb5_param.conversion,"phidp_data");
-//    } else  if( (strcmp(rb5_param.sparam, "uKDP") == 0) ||
-//               (strcmp(rb5_param.sparam, "KDP") == 0 )) {
-//        strcpy(rb5_param.conversion,"kdp_data");
-    } else  if((strcmp(rb5_param.sparam, "ET") == 0)) {
-        strcpy(rb5_param.conversion,"copy");
-    } else {
-        strcpy(rb5_param.conversion,"moment_data");
-    }
+    //registry lookup, unknown types are converted as moment data
+    //removed special param packing check (phidp_data, kdp_data), 2017-Mar-23
+    rb5_param.param_id=rb5_param_id(rb5_param.sparam);
+    const strRB5_PARAM_DEF *def=rb5_param_def(rb5_param.param_id);
+    rb5_param.conversion=(def != NULL) ? def->conversion : RB5_CONVERSION_MOMENT_DATA;
 
     rb5_param.NODATA_val=-999; //TBD
 
@@ -999,6 +956,28 @@ size_t find_in_string_arr(char arr[][MAX_NSTRINGS], size_t n, char *match){
 
 //#############################################################################
 
+/*
+ * Function name: find_rb5_rayinfo
+ * Intent: index of the rayinfo playing a role, from the table filled by
+ *         populate_rb5_info(), -1 if the file has none
+ */
+int find_rb5_rayinfo(strRB5_INFO *rb5_info, RB5_RAYINFO_ROLE role){
+    if(role <= RB5_RAYINFO_NONE || role >= RB5_N_RAYINFO_ROLES) return(-1);
+    return(rb5_info->rayinfo_idx_by_role[role]);
+}
+
+/*
+ * Function name: find_rb5_rawdata
+ * Intent: index of a rawdata type, registry types in O(1), others by name
+ */
+int find_rb5_rawdata(strRB5_INFO *rb5_info, char *sparam){
+    int param_id=rb5_param_id(sparam);
+    if(param_id != RB5_PARAM_UNKNOWN) return(rb5_info->rawdata_idx_by_param[param_id]);
+    return((int)find_in_string_arr(rb5_info->rawdata_name_arr,rb5_info->n_rawdatas,sparam));
+}
+
+//#############################################################################
+
 void dump_strRB5_PARAM_INFO(strRB5_PARAM_INFO rb5_param){
 
     fprintf(stdout,"### dump of _strRB5_PARAM_INFO\n");
@@ -1018,7 +997,7 @@ void dump_strRB5_PARAM_INFO(strRB5_PARAM_INFO rb5_param){
     fprintf(stdout,"--- nbins = %ld\n",rb5_param.nbins);
     fprintf(stdout,"--- iray_0degN = %ld\n",rb5_param.iray_0degN);
 
-    fprintf(stdout,"--- conversion = %s\n",rb5_param.conversion);
+    fprintf(stdout,"--- conversion = %s\n",rb5_conversion_name(rb5_param.conversion));
     fprintf(stdout,"--- data_range_min = %f\n",rb5_param.data_range_min);
     fprintf(stdout,"--- data_range_max = %f\n",rb5_param.data_range_max);
     fprintf(stdout,"--- data_range_width = %f\n",rb5_param.data_range_width);
@@ -1054,29 +1033,18 @@ void get_slice_iray_0degN(strRB5_INFO *rb5_info, int req_slice){
     if(iray_0degN != -1){
         size_t p=iray_0degN; // handles 1-d data
         size_t n=this_nrays;
-        float *org_arr=NULL;
-        float *mod_arr=NULL;
-        
-        org_arr=((float *)rb5_info->slice_moving_angle_start_arr[req_slice]);
-        mod_arr=(float *)RAVE_MALLOC(n*sizeof(float));
-        for (i=p;i<n;i++) mod_arr[i-   p ]=org_arr[i]; //output rays post 0-deg N
-        for (i=0;i<p;i++) mod_arr[i+(n-p)]=org_arr[i]; //output rays pre  0-deg N
-        rb5_info->slice_moving_angle_start_arr[req_slice]=mod_arr; //update
-        RAVE_FREE(org_arr);
-
-        org_arr=((float *)rb5_info->slice_moving_angle_stop_arr[req_slice]);
-        mod_arr=(float *)RAVE_MALLOC(n*sizeof(float));
-        for (i=p;i<n;i++) mod_arr[i-   p ]=org_arr[i]; //output rays post 0-deg N
-        for (i=0;i<p;i++) mod_arr[i+(n-p)]=org_arr[i]; //output rays pre  0-deg N
-        rb5_info->slice_moving_angle_stop_arr[req_slice]=mod_arr; //update
-        RAVE_FREE(org_arr);
-
-        org_arr=((float *)rb5_info->slice_moving_angle_arr[req_slice]);
-        mod_arr=(float *)RAVE_MALLOC(n*sizeof(float));
-        for (i=p;i<n;i++) mod_arr[i-   p ]=org_arr[i]; //output rays post 0-deg N
-        for (i=0;i<p;i++) mod_arr[i+(n-p)]=org_arr[i]; //output rays pre  0-deg N
-        rb5_info->slice_moving_angle_arr[req_slice]=mod_arr; //update
-        RAVE_FREE(org_arr);
+        float *tmp_arr=(float *)RAVE_MALLOC(n*sizeof(float));
+        float *org_arr_arr[3]={rb5_info->slice_moving_angle_start_arr[req_slice],
+                               rb5_info->slice_moving_angle_stop_arr [req_slice],
+                               rb5_info->slice_moving_angle_arr      [req_slice]};
+        int j;
+        for (j = 0; j < 3; j++) { //in place, they are views into slice_angle_block
+            float *org_arr=org_arr_arr[j];
+            memcpy(tmp_arr    ,org_arr+p,(n-p)*sizeof(float)); //output rays post 0-deg N
+            memcpy(tmp_arr+n-p,org_arr  ,   p *sizeof(float)); //output rays pre  0-deg N
+            memcpy(org_arr    ,tmp_arr  ,   n *sizeof(float)); //update
+        }
+        RAVE_FREE(tmp_arr);
    } 
 }
 
@@ -1090,6 +1058,7 @@ void reorder_by_iray_0degN(strRB5_PARAM_INFO *rb5_param, void **input_raw_arr){
     size_t n=this_n_elems_data;
 
     size_t raw_binary_depth=rb5_param->raw_binary_depth;
+    strRB5_PROFILE_MARK prof=rb5_profile_begin();
 
     if(rb5_param->iray_0degN != -1){
   
@@ -1119,16 +1088,14 @@ void reorder_by_iray_0degN(strRB5_PARAM_INFO *rb5_param, void **input_raw_arr){
       }
 
     } //if(rb5_param->iray_0degN != -1){
+    rb5_profile_end(RB5_PROFILE_REORDER,prof,n*(raw_binary_depth/8));
 }
 
 //#############################################################################
 
 int get_slice_end_iso8601(strRB5_INFO *rb5_info, int req_slice) {
 
-    static char iso8601_bgn[MAX_STRING]="\0";
-    strcpy(iso8601_bgn,rb5_info->slice_iso8601_bgn[req_slice]);
-    static char iso8601_end    [MAX_STRING]="\0";
-    static char iso8601_end_est[MAX_STRING]="\0";
+    int64_t epoch_ms_bgn=rb5_info->slice_epoch_ms_bgn[req_slice];
 
     char xpath_bgn[MAX_STRING]="\0";
 
@@ -1142,9 +1109,7 @@ int get_slice_end_iso8601(strRB5_INFO *rb5_info, int req_slice) {
     n_elapsed_secs_est=slice_span_deg/antspeed_deg_per_sec;
 
     //if rayinfo <timestamp> exists, then extract and find largest elapsed n_secs
-    char req_rayinfo_name[MAX_STRING]="\0";
-    strcpy(req_rayinfo_name,"timestamp");
-    int idx_req=find_in_string_arr(rb5_info->rayinfo_name_arr,rb5_info->n_rayinfos,req_rayinfo_name);
+    int idx_req=find_rb5_rayinfo(rb5_info,RB5_RAYINFO_TIMESTAMP);
     size_t n_elems;
     if(idx_req != -1) {
 
@@ -1181,186 +1146,173 @@ int get_slice_end_iso8601(strRB5_INFO *rb5_info, int req_slice) {
 
     rb5_info->slice_dur_secs    [req_slice]=n_elapsed_secs;
     rb5_info->slice_dur_secs_est[req_slice]=n_elapsed_secs_est;
-    strcpy(iso8601_end    ,func_add_nsecs_2_iso8601(iso8601_bgn,n_elapsed_secs    ));
-    strcpy(iso8601_end_est,func_add_nsecs_2_iso8601(iso8601_bgn,n_elapsed_secs_est));
-    strcpy(rb5_info->slice_iso8601_end    [req_slice],iso8601_end    );
-    strcpy(rb5_info->slice_iso8601_end_est[req_slice],iso8601_end_est);
+    rb5_info->slice_epoch_ms_end    [req_slice]=func_add_nsecs_2_epoch_ms(epoch_ms_bgn,n_elapsed_secs    );
+    rb5_info->slice_epoch_ms_end_est[req_slice]=func_add_nsecs_2_epoch_ms(epoch_ms_bgn,n_elapsed_secs_est);
+    func_epoch_ms_2_iso8601(rb5_info->slice_epoch_ms_end    [req_slice],rb5_info->slice_iso8601_end    [req_slice]);
+    func_epoch_ms_2_iso8601(rb5_info->slice_epoch_ms_end_est[req_slice],rb5_info->slice_iso8601_end_est[req_slice]);
     return EXIT_SUCCESS;
     
 }
 
 //#############################################################################
 
-int get_slice_mid_angle_readbacks(strRB5_INFO *rb5_info, int req_slice) {
+/*
+ * Function name: decode_ray_angle_codes
+ * Intent: the start/stop rayinfo of a role into its slot of the angle block,
+ *         "angular" raw codes straight to degrees, other conversions through
+ *         convert_raw_to_data(). Returns 1 if decoded, 0 if the rayinfo is
+ *         absent, -1 on failure.
+ */
+static int decode_ray_angle_codes(strRB5_INFO *rb5_info, int req_slice, RB5_RAYINFO_ROLE role, float *slot) {
 
-    char req_rayinfo_name[MAX_STRING]="\0";
-    int idx_req=-1;
     int L_RB5_PARAM_VERBOSE=0;
     char xpath_bgn[MAX_STRING]="\0";
     void *raw_arr=NULL;
-    float *data_arr=NULL;
-
     size_t this_nrays=rb5_info->nrays[req_slice];
-    int i;
-
-    //limit readback to 0.001 precision
-    float precision_factor=1000.;
-    float default_val=-999.;
-
-    rb5_info->slice_moving_angle_start_arr[req_slice]=RAVE_MALLOC(this_nrays*sizeof(float));
-    rb5_info->slice_moving_angle_stop_arr[req_slice]=RAVE_MALLOC(this_nrays*sizeof(float));
-    rb5_info->slice_fixed_angle_start_arr[req_slice]=RAVE_MALLOC(this_nrays*sizeof(float));
-    rb5_info->slice_fixed_angle_stop_arr[req_slice]=RAVE_MALLOC(this_nrays*sizeof(float));
+    size_t i;
 
-    rb5_info->slice_moving_angle_arr[req_slice]=RAVE_MALLOC(this_nrays*sizeof(float));
-    rb5_info->slice_fixed_angle_arr[req_slice]=RAVE_MALLOC(this_nrays*sizeof(float));
+    int idx_req=find_rb5_rayinfo(rb5_info,role);
+    if(idx_req == -1) return(0);
 
-    //moving_start_deg_arr
-    strcpy(req_rayinfo_name,"startangle"); //mandatory
-    idx_req=find_in_string_arr(rb5_info->rayinfo_name_arr,rb5_info->n_rayinfos,req_rayinfo_name);
-    size_t n_elems;
-    if(idx_req == -1) {
-        fprintf(stdout,"IMPOSSIBLE: %s not found\n", req_rayinfo_name);
-    } else {
-        sprintf(xpath_bgn,"((/volume/scan/slice)[%2d]/slicedata/%s)[%2d]/",req_slice+1,"rayinfo",idx_req+1);
-        strRB5_PARAM_INFO rb5_param=get_rb5_param_info(rb5_info,xpath_bgn,L_RB5_PARAM_VERBOSE);
-        n_elems = return_param_blobid_raw(&(*rb5_info), &rb5_param, &raw_arr);
-        if (n_elems == 0){
-            return EXIT_FAILURE;
-        }
-        convert_raw_to_data(&rb5_param,&raw_arr,&data_arr);
-        for (i = 0; i < this_nrays; i++) {
-            //handle RHI -'ve elevation angles as per RB5_FileFormat_5510.pdf, pg.48 "angle (ELE scan)"
-            if(strcmp(rb5_info->scan_type,"ele") == 0){
-                if(data_arr[i] > 225.){
-                    data_arr[i]-=360.0;
-                }
-            }
-            (rb5_info->slice_moving_angle_start_arr[req_slice])[i]=data_arr[i];
-            (rb5_info->slice_moving_angle_start_arr[req_slice])[i]=roundf((rb5_info->slice_moving_angle_start_arr[req_slice])[i]*precision_factor)/precision_factor;
-        } //for (i = 0; i < rb5_param.nrays; i++) {
-        if ( raw_arr != NULL ) RAVE_FREE( raw_arr);
-        if (data_arr != NULL ) RAVE_FREE(data_arr);
+    sprintf(xpath_bgn,"((/volume/scan/slice)[%2d]/slicedata/%s)[%2d]/",req_slice+1,"rayinfo",idx_req+1);
+    strRB5_PARAM_INFO rb5_param=get_rb5_param_info(rb5_info,xpath_bgn,L_RB5_PARAM_VERBOSE);
+    size_t n_elems=return_param_blobid_raw(&(*rb5_info), &rb5_param, &raw_arr);
+    if (n_elems < this_nrays) {
+        if (raw_arr != NULL) RAVE_FREE(raw_arr);
+        return(-1);
     }
 
-    //moving_stop_deg_arr
-    strcpy(req_rayinfo_name,"stopangle");
-    idx_req=find_in_string_arr(rb5_info->rayinfo_name_arr,rb5_info->n_rayinfos,req_rayinfo_name);
-    if(idx_req == -1) {
-        for (i = 0; i < this_nrays; i++) {
-            (rb5_info->slice_moving_angle_stop_arr[req_slice])[i]=(rb5_info->slice_moving_angle_start_arr[req_slice])[i]+rb5_info->slice_ray_angle_res_deg[req_slice];
-            (rb5_info->slice_moving_angle_stop_arr[req_slice])[i]=roundf((rb5_info->slice_moving_angle_stop_arr[req_slice])[i]*precision_factor)/precision_factor;
+    if (rb5_param.conversion == RB5_CONVERSION_ANGULAR) {
+        //as convert_raw_to_data(), RB5_FileFormat_5430.pdf, pg.47: 360.0/2^depth deg per code
+        float data_step=360.0/(float)(1L<<rb5_param.raw_binary_depth);
+        if (rb5_param.raw_binary_depth == 8) {
+            const uint8_t  *codes=(const uint8_t  *)raw_arr;
+            for (i = 0; i < this_nrays; i++) slot[i]=codes[i]*data_step;
+        } else if (rb5_param.raw_binary_depth == 16) {
+            const uint16_t *codes=(const uint16_t *)raw_arr;
+            for (i = 0; i < this_nrays; i++) slot[i]=codes[i]*data_step;
+        } else {
+            const uint32_t *codes=(const uint32_t *)raw_arr;
+            for (i = 0; i < this_nrays; i++) slot[i]=codes[i]*data_step;
         }
     } else {
-        sprintf(xpath_bgn,"((/volume/scan/slice)[%2d]/slicedata/%s)[%2d]/",req_slice+1,"rayinfo",idx_req+1);
-        strRB5_PARAM_INFO rb5_param=get_rb5_param_info(rb5_info,xpath_bgn,L_RB5_PARAM_VERBOSE);
-        return_param_blobid_raw(&(*rb5_info), &rb5_param, &raw_arr);
+        float *data_arr=NULL;
         convert_raw_to_data(&rb5_param,&raw_arr,&data_arr);
-        for (i = 0; i < this_nrays; i++) {
-            //handle RHI -'ve elevation angles
-            if(strcmp(rb5_info->scan_type,"ele") == 0){
-                if(data_arr[i] > 270.){
-                    data_arr[i]-=360.0;
-                }
-            }
-            (rb5_info->slice_moving_angle_stop_arr[req_slice])[i]=data_arr[i];
-            (rb5_info->slice_moving_angle_stop_arr[req_slice])[i]=roundf((rb5_info->slice_moving_angle_stop_arr[req_slice])[i]*precision_factor)/precision_factor;
-        } //for (i = 0; i < rb5_param.nrays; i++) {
-        if ( raw_arr != NULL ) RAVE_FREE( raw_arr);
-        if (data_arr != NULL ) RAVE_FREE(data_arr);
+        memcpy(slot,data_arr,this_nrays*sizeof(float));
+        RAVE_FREE(data_arr);
     }
-    
-    //fixed_start_deg_arr
-    default_val=rb5_info->angle_deg_arr[req_slice];
-    strcpy(req_rayinfo_name,"startfixangle");
-    idx_req=find_in_string_arr(rb5_info->rayinfo_name_arr,rb5_info->n_rayinfos,req_rayinfo_name);
-    if(idx_req == -1) {
-        for (i = 0; i < this_nrays; i++) {
-            (rb5_info->slice_fixed_angle_start_arr[req_slice])[i]=default_val;
-            (rb5_info->slice_fixed_angle_start_arr[req_slice])[i]=roundf((rb5_info->slice_fixed_angle_start_arr[req_slice])[i]*precision_factor)/precision_factor;
-        }
-    } else {
-        sprintf(xpath_bgn,"((/volume/scan/slice)[%2d]/slicedata/%s)[%2d]/",req_slice+1,"rayinfo",idx_req+1);
-        strRB5_PARAM_INFO rb5_param=get_rb5_param_info(rb5_info,xpath_bgn,L_RB5_PARAM_VERBOSE);
-        return_param_blobid_raw(&(*rb5_info), &rb5_param, &raw_arr);
-        convert_raw_to_data(&rb5_param,&raw_arr,&data_arr);
-        for (i = 0; i < this_nrays; i++) {
-            //handle PPI -'ve elevation angles
-            if(strcmp(rb5_info->scan_type,"ele") != 0){
-                if(data_arr[i] > 270.){
-                    data_arr[i]-=360.0;
-                }
-            }
-            (rb5_info->slice_fixed_angle_start_arr[req_slice])[i]=data_arr[i];
-            (rb5_info->slice_fixed_angle_start_arr[req_slice])[i]=roundf((rb5_info->slice_fixed_angle_start_arr[req_slice])[i]*precision_factor)/precision_factor;
-        } //for (i = 0; i < rb5_param.nrays; i++) {
-        if ( raw_arr != NULL ) RAVE_FREE( raw_arr);
-        if (data_arr != NULL ) RAVE_FREE(data_arr);
+    RAVE_FREE(raw_arr);
+    return(1);
+}
+
+/*
+ * Function name: rb5_ray_angle_kernel
+ * Intent: one pass over the rays of a slice, start/stop readbacks (or their
+ *         defaults) wrapped to negative angles, rounded, and the moving and
+ *         fixed mid angles. block holds RB5_N_RAY_ANGLES arrays of nrays, the
+ *         start/stop ones already decoded where kernel->L_READBACK is set.
+ *         Branch-free per ray so the compiler can vectorize it.
+ */
+void rb5_ray_angle_kernel(const strRB5_RAY_ANGLE_KERNEL *kernel, size_t nrays, float *block) {
+
+    float * restrict moving_start=block+RB5_RAY_MOVING_START*nrays;
+    float * restrict moving_stop =block+RB5_RAY_MOVING_STOP *nrays;
+    float * restrict fixed_start =block+RB5_RAY_FIXED_START *nrays;
+    float * restrict fixed_stop  =block+RB5_RAY_FIXED_STOP  *nrays;
+    float * restrict moving_mid  =block+RB5_RAY_MOVING_MID  *nrays;
+    float * restrict fixed_mid   =block+RB5_RAY_FIXED_MID   *nrays;
+
+    const int L_MOVING_STOP=kernel->L_READBACK[RB5_RAY_MOVING_STOP];
+    const int L_FIXED_START=kernel->L_READBACK[RB5_RAY_FIXED_START];
+    const int L_FIXED_STOP =kernel->L_READBACK[RB5_RAY_FIXED_STOP];
+    const float wrap_moving_start=kernel->wrap_above[RB5_RAY_MOVING_START];
+    const float wrap_moving_stop =kernel->wrap_above[RB5_RAY_MOVING_STOP];
+    const float wrap_fixed_start =kernel->wrap_above[RB5_RAY_FIXED_START];
+    const float wrap_fixed_stop  =kernel->wrap_above[RB5_RAY_FIXED_STOP];
+    const float res=kernel->moving_stop_res;
+    const float fixed_default=kernel->fixed_default;
+    const float f=kernel->precision_factor;
+    size_t i;
+
+    for (i = 0; i < nrays; i++) {
+        float ms=moving_start[i];
+        ms=(ms > wrap_moving_start) ? ms-360.0f : ms;
+        ms=roundf(ms*f)/f;
+
+        float me=L_MOVING_STOP ? moving_stop[i] : ms+res;
+        me=(L_MOVING_STOP && me > wrap_moving_stop) ? me-360.0f : me;
+        me=roundf(me*f)/f;
+
+        float fs=L_FIXED_START ? fixed_start[i] : fixed_default;
+        fs=(L_FIXED_START && fs > wrap_fixed_start) ? fs-360.0f : fs;
+        fs=roundf(fs*f)/f;
+
+        float fe=L_FIXED_STOP ? fixed_stop[i] : fixed_default;
+        fe=(L_FIXED_STOP && fe > wrap_fixed_stop) ? fe-360.0f : fe;
+        fe=roundf(fe*f)/f;
+
+        //across 0/360: fmodf(diff+360,360), exact as a subtraction since |diff| < 720
+        float moving_diff=me-ms;
+        float moving_wrap=moving_diff+360.0f;
+        moving_wrap=(moving_wrap >= 720.0f) ? moving_wrap-720.0f : (moving_wrap >= 360.0f) ? moving_wrap-360.0f : (moving_wrap <= -360.0f) ? moving_wrap+360.0f : moving_wrap;
+        moving_diff=(moving_diff < -180.0f || moving_diff > 180.0f) ? moving_wrap : moving_diff;
+
+        float fixed_diff=fe-fs;
+        float fixed_wrap=fixed_diff+360.0f;
+        fixed_wrap=(fixed_wrap >= 720.0f) ? fixed_wrap-720.0f : (fixed_wrap >= 360.0f) ? fixed_wrap-360.0f : (fixed_wrap <= -360.0f) ? fixed_wrap+360.0f : fixed_wrap;
+        fixed_diff=(fixed_diff < -180.0f || fixed_diff > 180.0f) ? fixed_wrap : fixed_diff;
+
+        moving_start[i]=ms;
+        moving_stop [i]=me;
+        fixed_start [i]=fs;
+        fixed_stop  [i]=fe;
+        moving_mid  [i]=ms+moving_diff*0.5f;
+        fixed_mid   [i]=fs+fixed_diff*0.5f;
     }
-    
-    //fixed_stop_deg_arr
-    default_val=rb5_info->angle_deg_arr[req_slice];
-    strcpy(req_rayinfo_name,"stopfixangle");
-    idx_req=find_in_string_arr(rb5_info->rayinfo_name_arr,rb5_info->n_rayinfos,req_rayinfo_name);
-    if(idx_req == -1) {
-        for (i = 0; i < this_nrays; i++) {
-            (rb5_info->slice_fixed_angle_stop_arr[req_slice])[i]=default_val;
-            (rb5_info->slice_fixed_angle_stop_arr[req_slice])[i]=roundf((rb5_info->slice_fixed_angle_stop_arr[req_slice])[i]*precision_factor)/precision_factor;
-        }
-    } else {
-        sprintf(xpath_bgn,"((/volume/scan/slice)[%2d]/slicedata/%s)[%2d]/",req_slice+1,"rayinfo",idx_req+1);
-        strRB5_PARAM_INFO rb5_param=get_rb5_param_info(rb5_info,xpath_bgn,L_RB5_PARAM_VERBOSE);
-        return_param_blobid_raw(&(*rb5_info), &rb5_param, &raw_arr);
-        convert_raw_to_data(&rb5_param,&raw_arr,&data_arr);
-        for (i = 0; i < this_nrays; i++) {
-            //handle PPI -'ve elevation angles
-            if(strcmp(rb5_info->scan_type,"ele") != 0){
-                if(data_arr[i] > 270.){
-                    data_arr[i]-=360.0;
-                }
-            }
-            (rb5_info->slice_fixed_angle_stop_arr[req_slice])[i]=data_arr[i];
-            (rb5_info->slice_fixed_angle_stop_arr[req_slice])[i]=roundf((rb5_info->slice_fixed_angle_stop_arr[req_slice])[i]*precision_factor)/precision_factor;
-        } //for (i = 0; i < rb5_param.nrays; i++) {
-        if ( raw_arr != NULL ) RAVE_FREE( raw_arr);
-        if (data_arr != NULL ) RAVE_FREE(data_arr);
+}
+
+int get_slice_mid_angle_readbacks(strRB5_INFO *rb5_info, int req_slice) {
+
+    size_t this_nrays=rb5_info->nrays[req_slice];
+    int L_ELE=(strcmp(rb5_info->scan_type,"ele") == 0);
+    strRB5_RAY_ANGLE_KERNEL kernel;
+    int ret;
+
+    strRB5_PROFILE_MARK prof=rb5_profile_begin();
+    //one block for all six readback arrays, the slice_*_arr are views into it
+    float *block=RAVE_MALLOC(RB5_N_RAY_ANGLES*this_nrays*sizeof(float));
+    if (block == NULL) return EXIT_FAILURE;
+    rb5_info->slice_angle_block[req_slice]=block;
+    rb5_info->slice_moving_angle_start_arr[req_slice]=block+RB5_RAY_MOVING_START*this_nrays;
+    rb5_info->slice_moving_angle_stop_arr [req_slice]=block+RB5_RAY_MOVING_STOP *this_nrays;
+    rb5_info->slice_fixed_angle_start_arr [req_slice]=block+RB5_RAY_FIXED_START *this_nrays;
+    rb5_info->slice_fixed_angle_stop_arr  [req_slice]=block+RB5_RAY_FIXED_STOP  *this_nrays;
+    rb5_info->slice_moving_angle_arr      [req_slice]=block+RB5_RAY_MOVING_MID  *this_nrays;
+    rb5_info->slice_fixed_angle_arr       [req_slice]=block+RB5_RAY_FIXED_MID   *this_nrays;
+
+    //handle RHI (moving) & PPI (fixed) -'ve elevation angles as per RB5_FileFormat_5510.pdf, pg.48 "angle (ELE scan)"
+    kernel.wrap_above[RB5_RAY_MOVING_START]=L_ELE ? 225. : FLT_MAX;
+    kernel.wrap_above[RB5_RAY_MOVING_STOP ]=L_ELE ? 270. : FLT_MAX;
+    kernel.wrap_above[RB5_RAY_FIXED_START ]=L_ELE ? FLT_MAX : 270.;
+    kernel.wrap_above[RB5_RAY_FIXED_STOP  ]=L_ELE ? FLT_MAX : 270.;
+    kernel.moving_stop_res=rb5_info->slice_ray_angle_res_deg[req_slice];
+    kernel.fixed_default=rb5_info->angle_deg_arr[req_slice];
+    kernel.precision_factor=1000.; //limit readback to 0.001 precision
+
+    ret=decode_ray_angle_codes(rb5_info,req_slice,RB5_RAYINFO_STARTANGLE,rb5_info->slice_moving_angle_start_arr[req_slice]);
+    if (ret != 1) { //mandatory
+        if (ret == 0) fprintf(stdout,"IMPOSSIBLE: %s not found\n", "startangle");
+        return EXIT_FAILURE;
     }
-   
-//    fprintf(stdout,"angle_deg_arr[%3d]=%f\n",req_slice,default_val);
-    float diff;
-    for (i = 0; i < this_nrays; i++) {
-        diff=(rb5_info->slice_moving_angle_stop_arr[req_slice])[i]-
-             (rb5_info->slice_moving_angle_start_arr[req_slice])[i];
-        if((diff < -180) || (diff > 180)) diff=fmodf(diff+360.0,360.0);
-        (rb5_info->slice_moving_angle_arr[req_slice])[i]=(rb5_info->slice_moving_angle_start_arr[req_slice])[i]+diff/2.;
-//        fprintf(stdout,"[%3d]=%10.5f, %10.5f, %10.5f, %10.5f\n",
-//            i,
-//            (rb5_info->slice_moving_angle_start_arr[req_slice])[i],
-//            (rb5_info->slice_moving_angle_stop_arr[req_slice])[i],
-//            diff,
-//            (rb5_info->slice_moving_angle_arr[req_slice])[i]);
-
-        diff=(rb5_info->slice_fixed_angle_stop_arr[req_slice])[i]-
-             (rb5_info->slice_fixed_angle_start_arr[req_slice])[i];
-        if((diff < -180) || (diff > 180)) diff=fmodf(diff+360.0,360.0);
-        (rb5_info->slice_fixed_angle_arr[req_slice])[i]=(rb5_info->slice_fixed_angle_start_arr[req_slice])[i]+diff/2.;
-//        fprintf(stdout,"[%3d]=%10.5f, %10.5f, %10.5f, %10.5f\n",
-//            i,
-//            (rb5_info->slice_fixed_angle_start_arr[req_slice])[i],
-//            (rb5_info->slice_fixed_angle_stop_arr[req_slice])[i],
-//            diff,
-//            (rb5_info->slice_fixed_angle_arr[req_slice])[i]);
-
-// handled above in individual start/stop readbacks
-//        if(strcmp(rb5_info->scan_type,"ele") == 0){
-//            //handle RHI -'ve elevation angles
-//            if((rb5_info->slice_moving_angle_arr[req_slice])[i] > 270.)
-//               (rb5_info->slice_moving_angle_arr[req_slice])[i]-=360.0;
-//        } else {
-//            //handle PPI -'ve elevation angles
-//            if((rb5_info->slice_fixed_angle_arr[req_slice])[i] > 270.)
-//               (rb5_info->slice_fixed_angle_arr[req_slice])[i]-=360.0;
-//        }
-    }    
+    kernel.L_READBACK[RB5_RAY_MOVING_START]=1;
+    kernel.L_READBACK[RB5_RAY_MOVING_STOP ]=decode_ray_angle_codes(rb5_info,req_slice,RB5_RAYINFO_STOPANGLE,    rb5_info->slice_moving_angle_stop_arr[req_slice]);
+    kernel.L_READBACK[RB5_RAY_FIXED_START ]=decode_ray_angle_codes(rb5_info,req_slice,RB5_RAYINFO_STARTFIXANGLE,rb5_info->slice_fixed_angle_start_arr[req_slice]);
+    kernel.L_READBACK[RB5_RAY_FIXED_STOP  ]=decode_ray_angle_codes(rb5_info,req_slice,RB5_RAYINFO_STOPFIXANGLE, rb5_info->slice_fixed_angle_stop_arr[req_slice]);
+    if (kernel.L_READBACK[RB5_RAY_MOVING_STOP] == -1 ||
+        kernel.L_READBACK[RB5_RAY_FIXED_START] == -1 ||
+        kernel.L_READBACK[RB5_RAY_FIXED_STOP ] == -1) return EXIT_FAILURE;
+
+    rb5_ray_angle_kernel(&kernel,this_nrays,block);
+    rb5_profile_end(RB5_PROFILE_ANGLES,prof,RB5_N_RAY_ANGLES*this_nrays*sizeof(float));
     return EXIT_SUCCESS;
 }
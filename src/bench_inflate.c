@@ -0,0 +1,276 @@
+/* --------------------------------------------------------------------
+Copyright (C) 2016 The Crown (i.e. Her Majesty the Queen in Right of Canada)
+
+This file is part of RAVE.
+
+RAVE is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+RAVE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with RAVE.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------*/
+/**
+ * Command-line binary "bench_inflate", inflate backends compared on RB5 data
+ * @file src/bench_inflate.c
+ * @author rb52odim contributors
+ * @date 2026-10-19
+ *
+ * Compile:
+ *   make -f Makefile.w_rb5_2_odim_main
+ *
+ * Every BLOB of every RB5 file given (directories are recursed), and every
+ * gzipped file as a whole, inflated with each backend compiled in; outputs
+ * are checked against zlib:
+ * ./bench_inflate [-n repeats] [-j results.json] ../test/org
+ */
+
+#define _GNU_SOURCE //nftw()
+#include "rb5_inflate.h"
+#include "xml_utils.h"
+
+#include <ftw.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct{
+    const unsigned char *src; // zlib stream, or whole gzip file if L_GZIP
+    size_t src_len;
+    size_t dst_len;           // from the BLOB size prefix or gzip ISIZE
+    int L_GZIP;
+} strINFLATE_ITEM;
+
+static strINFLATE_ITEM *item_arr=NULL;
+static size_t n_items=0;
+static size_t max_items=0;
+
+static char **keep_arr=NULL; // file buffers the items point into, close_file_buffer() at exit
+static size_t n_keep=0;
+
+static int add_item(const unsigned char *src, size_t src_len, size_t dst_len, int L_GZIP) {
+    if (n_items == max_items) {
+        size_t grown_max=max_items ? max_items*2 : 1024;
+        strINFLATE_ITEM *grown=realloc(item_arr,grown_max*sizeof(strINFLATE_ITEM));
+        if (grown == NULL) return(EXIT_FAILURE);
+        item_arr=grown;
+        max_items=grown_max;
+    }
+    item_arr[n_items].src=src;
+    item_arr[n_items].src_len=src_len;
+    item_arr[n_items].dst_len=dst_len;
+    item_arr[n_items].L_GZIP=L_GZIP;
+    n_items++;
+    return(EXIT_SUCCESS);
+}
+
+static int keep_buffer(char *buffer) {
+    char **grown=realloc(keep_arr,(n_keep+1)*sizeof(char *));
+    if (grown == NULL) return(EXIT_FAILURE);
+    keep_arr=grown;
+    keep_arr[n_keep++]=buffer;
+    return(EXIT_SUCCESS);
+}
+
+//#############################################################################
+
+/*
+ * Function name: add_blobs
+ * Intent: walk the blobspace after the XML header, one item per BLOB,
+ *         <BLOB blobid="N" size="S" ...>\n S bytes \n</BLOB>\n
+ */
+static size_t add_blobs(char *buffer, size_t buffer_len) {
+    size_t n_found=0;
+    size_t off=find_buffer_end_of_xml(buffer);
+    while (off < buffer_len) {
+      char *line=memmem(buffer+off,buffer_len-off,"<BLOB ",6);
+      if (line == NULL) break;
+      char *eol=memchr(line,'\n',buffer_len-(line-buffer));
+      if (eol == NULL) break;
+      char *size_attr=memmem(line,eol-line,"size=\"",6);
+      if (size_attr == NULL) break;
+      size_t blob_len=strtoul(size_attr+6,NULL,10);
+      const unsigned char *blob=(unsigned char *)eol+1;
+      if (blob_len <= 4 || blob+blob_len > (unsigned char *)buffer+buffer_len) break;
+      size_t dst_len=((size_t)blob[0]<<24) | ((size_t)blob[1]<<16) | ((size_t)blob[2]<<8) | (size_t)blob[3];
+      if (add_item(blob+4,blob_len-4,dst_len,0) != EXIT_SUCCESS) break;
+      n_found++;
+      off=(blob-(unsigned char *)buffer)+blob_len;
+    }
+    return(n_found);
+}
+
+/*
+ * Function name: add_file
+ * Intent: the gzip file itself, as read from disk, and the blobs of its
+ *         decoded contents
+ */
+static int add_file(const char *path) {
+    FILE *fp=fopen(path,"rb");
+    if (fp == NULL) return(EXIT_FAILURE);
+    char *raw=NULL;
+    size_t raw_len=0;
+    if (fseek(fp,0,SEEK_END) == 0) {
+      long len=ftell(fp);
+      if (len > 18 && fseek(fp,0,SEEK_SET) == 0 && (raw=malloc(len)) != NULL) {
+        raw_len=fread(raw,1,len,fp);
+      }
+    }
+    fclose(fp);
+    if (raw != NULL && raw_len > 18 && (unsigned char)raw[0] == 0x1f && (unsigned char)raw[1] == 0x8b) {
+      const unsigned char *isize=(unsigned char *)raw+raw_len-4;
+      size_t dst_len=(size_t)isize[0] | ((size_t)isize[1]<<8) | ((size_t)isize[2]<<16) | ((size_t)isize[3]<<24);
+      add_item((unsigned char *)raw,raw_len,dst_len,1);
+      keep_buffer(raw);
+    } else {
+      close_file_buffer(raw);
+    }
+
+    char *buffer=NULL;
+    size_t buffer_len=read_file_2_buffer((char *)path,&buffer);
+    if (buffer == NULL || buffer_len == 0) return(EXIT_FAILURE);
+    keep_buffer(buffer);
+    return(add_blobs(buffer,buffer_len) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+static int walk_cb(const char *fpath, const struct stat *sb, int typeflag, struct FTW *ftwbuf) {
+    (void)sb;
+    if (typeflag == FTW_F && fpath[ftwbuf->base] != '.') add_file(fpath); //no dot files
+    return(0);
+}
+
+//#############################################################################
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    return(ts.tv_sec+ts.tv_nsec*1e-9);
+}
+
+typedef struct{
+    size_t n_items;
+    size_t bytes_in;
+    size_t bytes_out;
+    double sec;
+    size_t n_mismatch;
+} strINFLATE_RESULT;
+
+/*
+ * Function name: bench_backend
+ * Intent: inflate all items of one kind (blobs or gzip files) n_repeat times,
+ *         checking each output against the zlib crc32 in crc_arr
+ */
+static strINFLATE_RESULT bench_backend(RB5_INFLATE_BACKEND backend, int L_GZIP, int n_repeat, uLong *crc_arr) {
+    strINFLATE_RESULT res={0,0,0,0.0,0};
+    size_t max_dst=0;
+    size_t i;
+    int r;
+    for (i = 0; i < n_items; i++) if (item_arr[i].dst_len > max_dst) max_dst=item_arr[i].dst_len;
+    unsigned char *dst=malloc(max_dst ? max_dst : 1);
+    if (dst == NULL) return(res);
+
+    for (r = 0; r < n_repeat; r++) {
+      for (i = 0; i < n_items; i++) {
+        strINFLATE_ITEM *it=&item_arr[i];
+        if (it->L_GZIP != L_GZIP) continue;
+        size_t dst_len=it->dst_len;
+        double t0=now_sec();
+        int Z_result=rb5_inflate_with(backend,L_GZIP,dst,&dst_len,it->src,it->src_len);
+        res.sec+=now_sec()-t0;
+        if (r == 0) {
+          uLong crc=(Z_result == Z_OK && dst_len == it->dst_len) ? crc32(0L,dst,dst_len) : 0L;
+          if (backend == RB5_INFLATE_ZLIB) crc_arr[i]=crc;
+          else if (crc != crc_arr[i]) res.n_mismatch++;
+          res.n_items++;
+          res.bytes_in+=it->src_len;
+          res.bytes_out+=it->dst_len;
+        }
+      }
+    }
+    free(dst);
+    return(res);
+}
+
+//#############################################################################
+
+int main(int argc, char *argv[]) {
+
+    int n_repeat=3;
+    char *json_fname=NULL;
+    int c;
+    while ((c=getopt(argc,argv,"n:j:h")) != -1) {
+      switch (c) {
+        case 'n': n_repeat=atoi(optarg); break;
+        case 'j': json_fname=optarg; break;
+        default:
+          fprintf(stderr,"Usage: %s [-n repeats] [-j results.json] <RB5 files or dirs>\n",argv[0]);
+          return(EXIT_FAILURE);
+      }
+    }
+    if (optind >= argc || n_repeat < 1) {
+      fprintf(stderr,"Usage: %s [-n repeats] [-j results.json] <RB5 files or dirs>\n",argv[0]);
+      return(EXIT_FAILURE);
+    }
+    for (c = optind; c < argc; c++) {
+      struct stat sb;
+      if (stat(argv[c],&sb) == 0 && S_ISDIR(sb.st_mode)) nftw(argv[c],walk_cb,16,FTW_PHYS);
+      else add_file(argv[c]);
+    }
+    if (n_items == 0) {
+      fprintf(stderr,"Error: no RB5 blobs found\n");
+      return(EXIT_FAILURE);
+    }
+
+    uLong *crc_arr=calloc(n_items,sizeof(uLong));
+    strINFLATE_RESULT res_arr[2][RB5_INFLATE_NBACKENDS];
+    int L_GZIP;
+    int b;
+    FILE *fp_json=NULL;
+    if (json_fname != NULL && (fp_json=fopen(json_fname,"w")) == NULL) {
+      fprintf(stderr,"Error: cannot write %s\n",json_fname);
+      return(EXIT_FAILURE);
+    }
+    if (fp_json) fprintf(fp_json,"{\n  \"repeats\": %d,\n  \"results\": [",n_repeat);
+
+    fprintf(stdout,"%-6s %-11s %7s %10s %10s %9s %9s %8s %s\n","kind","backend","items","MB in","MB out","sec","MB/s out","speedup","identical");
+    int n_json=0;
+    int rc=EXIT_SUCCESS;
+    for (L_GZIP = 0; L_GZIP <= 1; L_GZIP++) {
+      const char *kind=L_GZIP ? "gzip" : "blob";
+      for (b = 0; b < RB5_INFLATE_NBACKENDS; b++) {
+        if (!rb5_inflate_available(b)) continue;
+        strINFLATE_RESULT *res=&res_arr[L_GZIP][b];
+        *res=bench_backend(b,L_GZIP,n_repeat,crc_arr);
+        if (res->n_items == 0) continue;
+        double sec=res->sec/n_repeat;
+        double mbps=(sec > 0) ? res->bytes_out/1e6/sec : 0.0;
+        double speedup=(res->sec > 0) ? res_arr[L_GZIP][RB5_INFLATE_ZLIB].sec/res->sec : 0.0;
+        if (res->n_mismatch) rc=EXIT_FAILURE;
+        fprintf(stdout,"%-6s %-11s %7ld %10.2f %10.2f %9.4f %9.1f %8.2f %s\n",
+                kind, rb5_inflate_name(b), res->n_items, res->bytes_in/1e6, res->bytes_out/1e6,
+                sec, mbps, speedup, res->n_mismatch ? "NO" : "yes");
+        if (fp_json) {
+          fprintf(fp_json,"%s\n    {\"kind\": \"%s\", \"backend\": \"%s\", \"items\": %ld, \"bytes_in\": %ld, \"bytes_out\": %ld, \"sec\": %.6f, \"mb_per_s\": %.1f, \"speedup_vs_zlib\": %.3f, \"mismatches\": %ld}",
+                  n_json++ ? "," : "", kind, rb5_inflate_name(b), res->n_items, res->bytes_in, res->bytes_out,
+                  sec, mbps, speedup, res->n_mismatch);
+        }
+      }
+    }
+    if (fp_json) {
+      fprintf(fp_json,"\n  ]\n}\n");
+      fclose(fp_json);
+    }
+
+    rb5_inflate_cleanup();
+    free(crc_arr);
+    size_t i;
+    for (i = 0; i < n_keep; i++) close_file_buffer(keep_arr[i]);
+    free(keep_arr);
+    free(item_arr);
+    return(rc);
+}
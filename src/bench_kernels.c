@@ -0,0 +1,499 @@
+/* --------------------------------------------------------------------
+Copyright (C) 2016 The Crown (i.e. Her Majesty the Queen in Right of Canada)
+
+This file is part of RAVE.
+
+RAVE is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+RAVE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with RAVE.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------*/
+/**
+ * Command-line binary "bench_kernels", decode primitives timed one by one
+ * @file src/bench_kernels.c
+ * @author rb52odim contributors
+ * @date 2026-10-19
+ *
+ * Compile:
+ *   make -f Makefile.w_rb5_2_odim_main
+ *
+ * Every RB5 file given (directories are recursed) is opened once; its BLOBs,
+ * raw arrays, slices and timestamps become the inputs of each kernel, so a
+ * change to one primitive can be measured without the rest of the pipeline.
+ * Only the kernel call is timed, not the copies and frees around it; each
+ * repeat runs enough passes over the inputs to last RB5_BENCH_MIN_SEC:
+ * ./bench_kernels [-n repeats] [-k kernel] [-j results.json] ../test/org
+ */
+
+#define _GNU_SOURCE //nftw()
+#include "rb5_alloc.h"
+#include "rb5_utils.h"
+#include "xml_utils.h"
+#include "time_utils.h"
+#include "rb5_inflate.h"
+
+#include <math.h> //sqrt()
+#include <ftw.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RB5_BENCH_MIN_SEC 0.02  // calibrated per kernel, passes in a repeat
+#define RB5_BENCH_MAX_PASSES 100000
+
+typedef enum {
+    KERNEL_UNCOMPRESS=0,      // uncompress_this_blob(), per rawdata and rayinfo BLOB
+    KERNEL_BYTE_SWAP,         // swap_blob_to_raw(), per BLOB
+    KERNEL_CONVERT_COPY,      // convert_raw_to_data(), per raw array of each conversion
+    KERNEL_CONVERT_ANGULAR,
+    KERNEL_CONVERT_MOMENT,
+    KERNEL_REORDER,           // reorder_by_iray_0degN(), per raw array
+    KERNEL_MID_ANGLES,        // get_slice_mid_angle_readbacks(), per slice
+    KERNEL_END_OF_XML,        // find_buffer_end_of_xml(), per file
+    KERNEL_ISO8601_2_EPOCH,   // func_iso8601_2_epoch_ms(), per file, its slice times
+    KERNEL_EPOCH_2_ISO8601,   // func_epoch_ms_2_iso8601(), likewise
+    KERNEL_OFFSETS_2_SYSTIME, // func_epoch_ms_offsets_2_systime(), per slice, a time per ray
+    N_KERNELS
+} BENCH_KERNEL;
+
+static const char *kernel_name_arr[N_KERNELS]={
+    "uncompress", "byte_swap", "convert_copy", "convert_angular", "convert_moment",
+    "reorder", "mid_angles", "end_of_xml", "iso8601_2_epoch", "epoch_2_iso8601", "offsets_2_systime"
+};
+
+// input of one kernel call, set up before timing
+typedef struct{
+    strRB5_INFO *rb5_info;
+    strRB5_PARAM_INFO param;
+    int slice;
+    unsigned char *src;      // BLOB, decoded BLOB or raw array, as the kernel takes it
+    size_t src_len;
+    float *offset_arr;       // KERNEL_OFFSETS_2_SYSTIME
+    double *systime_arr;
+    size_t n_elems;          // counted for ns/element
+    size_t n_bytes;          // counted for GB/s, what the kernel writes
+} strKERNEL_ITEM;
+
+static strKERNEL_ITEM *item_arr[N_KERNELS];
+static size_t n_items[N_KERNELS];
+static size_t max_items[N_KERNELS];
+
+static strRB5_INFO **info_arr=NULL; // files the items point into, close_rb5_info() at exit
+static size_t n_infos=0;
+
+static strKERNEL_ITEM *add_item(BENCH_KERNEL k, strRB5_INFO *rb5_info) {
+    if (n_items[k] == max_items[k]) {
+        size_t grown_max=max_items[k] ? max_items[k]*2 : 256;
+        strKERNEL_ITEM *grown=realloc(item_arr[k],grown_max*sizeof(strKERNEL_ITEM));
+        if (grown == NULL) return(NULL);
+        item_arr[k]=grown;
+        max_items[k]=grown_max;
+    }
+    strKERNEL_ITEM *it=&item_arr[k][n_items[k]++];
+    memset(it,0,sizeof(strKERNEL_ITEM));
+    it->rb5_info=rb5_info;
+    return(it);
+}
+
+//#############################################################################
+
+/*
+ * Function name: add_param
+ * Intent: one rawdata or rayinfo param of a slice, as the BLOB, decoded BLOB
+ *         and raw array inputs of uncompress, byte swap, reorder and convert
+ */
+static void add_param(strRB5_INFO *rb5_info, int slice, char *kind, int idx) {
+    char xpath_bgn[MAX_STRING];
+    sprintf(xpath_bgn,"((/volume/scan/slice)[%2d]/slicedata/%s)[%2d]/",slice+1,kind,idx+1);
+    strRB5_PARAM_INFO param=get_rb5_param_info(rb5_info,xpath_bgn,0);
+    size_t depth_bytes=param.raw_binary_depth/8;
+    if (depth_bytes != 1 && depth_bytes != 2 && depth_bytes != 4) return;
+
+    unsigned char *compressed=NULL;
+    size_t compressed_len=get_blobid_compressed(rb5_info,param.blobid,&compressed);
+    if (compressed == NULL || compressed_len <= 4) return;
+    unsigned char *blob=NULL;
+    size_t blob_len=uncompress_this_blob(compressed,&blob,compressed_len);
+    if (blob == NULL || blob_len != param.n_elems_data*depth_bytes) {
+      RAVE_FREE(compressed);
+      RAVE_FREE(blob);
+      return;
+    }
+
+    strKERNEL_ITEM *it=add_item(KERNEL_UNCOMPRESS,rb5_info);
+    if (it != NULL) {
+      it->src=compressed; it->src_len=compressed_len;
+      it->n_elems=blob_len; it->n_bytes=blob_len;
+    }
+    it=add_item(KERNEL_BYTE_SWAP,rb5_info);
+    if (it != NULL) {
+      it->param=param; it->src=blob; it->src_len=blob_len;
+      it->n_elems=param.n_elems_data; it->n_bytes=blob_len;
+    }
+
+    //raw array in host order, as return_param_blobid_raw() hands it on
+    unsigned char *raw=RAVE_MALLOC(blob_len);
+    swap_blob_to_raw(blob,blob_len,param.raw_binary_depth,raw);
+    it=add_item(KERNEL_REORDER,rb5_info);
+    if (it != NULL) {
+      it->param=param; it->src=raw; it->src_len=blob_len;
+      //a scan starting at 0-deg N is not reordered, time it as if half way round
+      if (it->param.iray_0degN == -1) it->param.iray_0degN=param.nrays/2;
+      it->n_elems=param.n_elems_data; it->n_bytes=blob_len;
+    }
+    BENCH_KERNEL k= param.conversion == RB5_CONVERSION_COPY    ? KERNEL_CONVERT_COPY
+                  : param.conversion == RB5_CONVERSION_ANGULAR ? KERNEL_CONVERT_ANGULAR
+                  :                                              KERNEL_CONVERT_MOMENT;
+    it=add_item(k,rb5_info);
+    if (it != NULL) {
+      it->param=param; it->src=raw; it->src_len=blob_len;
+      it->n_elems=param.n_elems_data; it->n_bytes=param.n_elems_data*sizeof(float);
+    }
+}
+
+/*
+ * Function name: add_file
+ * Intent: a volume opened as getRaveIO() does, kept until exit
+ */
+static int add_file(const char *path) {
+    strXML_FILE_INFO xml_info;
+    memset(&xml_info,0,sizeof(xml_info));
+    snprintf(xml_info.inp_fullfile,MAX_STRING,"%s",path);
+    if (open_xml_buffer(&xml_info) != 0) return(EXIT_FAILURE);
+
+    strRB5_INFO *rb5_info=calloc(1,sizeof(strRB5_INFO));
+    if (rb5_info == NULL) {
+      close_xml_buffer(&xml_info);
+      return(EXIT_FAILURE);
+    }
+    snprintf(rb5_info->inp_fullfile,MAX_STRING,"%s",path);
+    rb5_info->buffer=xml_info.buffer;
+    rb5_info->buffer_len=xml_info.buffer_len;
+    rb5_info->byte_offset_blobspace=xml_info.byte_offset_end_of_xml;
+    rb5_info->doc=xml_info.doc;
+    rb5_info->xpathCtx=xml_info.xpathCtx;
+    rb5_info->cache=NULL;
+    rb5_info->passthrough=NULL;
+
+    //tarballs and the like are not volumes
+    char *root=return_xpath_name(rb5_info->xpathCtx,"/*[1]");
+    if (root == NULL || strcmp(root,"volume") != 0 || populate_rb5_info(rb5_info,0) != EXIT_SUCCESS) {
+      close_rb5_info(rb5_info);
+      free(rb5_info);
+      return(EXIT_FAILURE);
+    }
+    strRB5_INFO **grown=realloc(info_arr,(n_infos+1)*sizeof(strRB5_INFO *));
+    if (grown == NULL) {
+      close_rb5_info(rb5_info);
+      free(rb5_info);
+      return(EXIT_FAILURE);
+    }
+    info_arr=grown;
+    info_arr[n_infos++]=rb5_info;
+
+    strKERNEL_ITEM *it=add_item(KERNEL_END_OF_XML,rb5_info);
+    if (it != NULL) {
+      it->n_elems=rb5_info->byte_offset_blobspace; it->n_bytes=rb5_info->byte_offset_blobspace;
+    }
+    it=add_item(KERNEL_ISO8601_2_EPOCH,rb5_info);
+    if (it != NULL) {
+      it->n_elems=4*rb5_info->n_slices; it->n_bytes=4*rb5_info->n_slices*sizeof(int64_t);
+    }
+    it=add_item(KERNEL_EPOCH_2_ISO8601,rb5_info);
+    if (it != NULL) {
+      it->n_elems=4*rb5_info->n_slices; it->n_bytes=4*rb5_info->n_slices*(MAX_ISO8601_STRING-1);
+    }
+
+    int slice;
+    size_t idx;
+    for (slice = 0; slice < rb5_info->n_slices; slice++) {
+      size_t nrays=rb5_info->nrays[slice];
+      it=add_item(KERNEL_MID_ANGLES,rb5_info);
+      if (it != NULL) {
+        it->slice=slice;
+        it->n_elems=RB5_N_RAY_ANGLES*nrays; it->n_bytes=RB5_N_RAY_ANGLES*nrays*sizeof(float);
+      }
+      it=add_item(KERNEL_OFFSETS_2_SYSTIME,rb5_info);
+      if (it != NULL) {
+        it->slice=slice;
+        it->offset_arr=RAVE_MALLOC(nrays*sizeof(float));
+        it->systime_arr=RAVE_MALLOC(nrays*sizeof(double));
+        for (idx = 0; idx < nrays && it->offset_arr != NULL; idx++) {
+          it->offset_arr[idx]=(float)(1e3*rb5_info->slice_dur_secs[slice]*idx/nrays);
+        }
+        it->n_elems=nrays; it->n_bytes=nrays*sizeof(double);
+      }
+      for (idx = 0; idx < rb5_info->n_rawdatas; idx++) add_param(rb5_info,slice,"rawdata",idx);
+      for (idx = 0; idx < rb5_info->n_rayinfos; idx++) add_param(rb5_info,slice,"rayinfo",idx);
+    }
+    return(EXIT_SUCCESS);
+}
+
+static int walk_cb(const char *fpath, const struct stat *sb, int typeflag, struct FTW *ftwbuf) {
+    (void)sb;
+    if (typeflag == FTW_F && fpath[ftwbuf->base] != '.') add_file(fpath); //no dot files
+    return(0);
+}
+
+//#############################################################################
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    return(ts.tv_sec+ts.tv_nsec*1e-9);
+}
+
+/*
+ * Function name: run_item
+ * Intent: one kernel call on one item, returns the seconds spent in the
+ *         kernel itself
+ */
+static double run_item(BENCH_KERNEL k, strKERNEL_ITEM *it) {
+    strRB5_INFO *rb5_info=it->rb5_info;
+    char iso8601[MAX_ISO8601_STRING];
+    int64_t epoch_ms;
+    void *raw=NULL;
+    float *data=NULL;
+    unsigned char *out=NULL;
+    size_t s;
+    double t0, sec=0.0;
+
+    switch (k) {
+      case KERNEL_UNCOMPRESS:
+        t0=now_sec();
+        uncompress_this_blob(it->src,&out,it->src_len);
+        sec=now_sec()-t0;
+        RAVE_FREE(out);
+        break;
+      case KERNEL_BYTE_SWAP:
+        raw=RAVE_MALLOC(it->src_len);
+        t0=now_sec();
+        swap_blob_to_raw(it->src,it->src_len,it->param.raw_binary_depth,raw);
+        sec=now_sec()-t0;
+        RAVE_FREE(raw);
+        break;
+      case KERNEL_CONVERT_COPY:
+      case KERNEL_CONVERT_ANGULAR:
+      case KERNEL_CONVERT_MOMENT:
+        raw=it->src;
+        t0=now_sec();
+        convert_raw_to_data(&it->param,&raw,&data);
+        sec=now_sec()-t0;
+        RAVE_FREE(data);
+        break;
+      case KERNEL_REORDER:
+        //frees its input, so on a copy
+        raw=RAVE_MALLOC(it->src_len);
+        memcpy(raw,it->src,it->src_len);
+        t0=now_sec();
+        reorder_by_iray_0degN(&it->param,&raw);
+        sec=now_sec()-t0;
+        RAVE_FREE(raw);
+        break;
+      case KERNEL_MID_ANGLES:
+        RAVE_FREE(rb5_info->slice_angle_block[it->slice]);
+        t0=now_sec();
+        get_slice_mid_angle_readbacks(rb5_info,it->slice);
+        sec=now_sec()-t0;
+        break;
+      case KERNEL_END_OF_XML:
+        t0=now_sec();
+        find_buffer_end_of_xml(rb5_info->buffer);
+        sec=now_sec()-t0;
+        break;
+      case KERNEL_ISO8601_2_EPOCH:
+        t0=now_sec();
+        for (s = 0; s < rb5_info->n_slices; s++) {
+          func_iso8601_2_epoch_ms(rb5_info->slice_iso8601_bgn_low[s],&epoch_ms);
+          func_iso8601_2_epoch_ms(rb5_info->slice_iso8601_bgn[s],&epoch_ms);
+          func_iso8601_2_epoch_ms(rb5_info->slice_iso8601_end_est[s],&epoch_ms);
+          func_iso8601_2_epoch_ms(rb5_info->slice_iso8601_end[s],&epoch_ms);
+        }
+        sec=now_sec()-t0;
+        break;
+      case KERNEL_EPOCH_2_ISO8601:
+        t0=now_sec();
+        for (s = 0; s < rb5_info->n_slices; s++) {
+          func_epoch_ms_2_iso8601(rb5_info->slice_epoch_ms_bgn_low[s],iso8601);
+          func_epoch_ms_2_iso8601(rb5_info->slice_epoch_ms_bgn[s],iso8601);
+          func_epoch_ms_2_iso8601(rb5_info->slice_epoch_ms_end_est[s],iso8601);
+          func_epoch_ms_2_iso8601(rb5_info->slice_epoch_ms_end[s],iso8601);
+        }
+        sec=now_sec()-t0;
+        break;
+      case KERNEL_OFFSETS_2_SYSTIME:
+        if (it->offset_arr == NULL || it->systime_arr == NULL) break;
+        t0=now_sec();
+        func_epoch_ms_offsets_2_systime(rb5_info->slice_epoch_ms_bgn[it->slice],it->offset_arr,it->n_elems,it->systime_arr);
+        sec=now_sec()-t0;
+        break;
+      default:
+        break;
+    }
+    return(sec);
+}
+
+static double run_pass(BENCH_KERNEL k) {
+    double sec=0.0;
+    size_t i;
+    for (i = 0; i < n_items[k]; i++) sec+=run_item(k,&item_arr[k][i]);
+    return(sec);
+}
+
+typedef struct{
+    size_t n_items;
+    size_t n_elems;  // per pass
+    size_t n_bytes;
+    int n_passes;    // per repeat
+    double ns_per_elem_mean;
+    double ns_per_elem_sd;
+    double gbps_mean;
+    double gbps_sd;
+} strKERNEL_RESULT;
+
+/*
+ * Function name: bench_kernel
+ * Intent: passes per repeat calibrated on a warm-up pass, then n_repeat
+ *         repeats; mean and sample standard deviation over the repeats
+ */
+static strKERNEL_RESULT bench_kernel(BENCH_KERNEL k, int n_repeat) {
+    strKERNEL_RESULT res;
+    memset(&res,0,sizeof(res));
+    size_t i;
+    int r, p;
+    res.n_items=n_items[k];
+    for (i = 0; i < n_items[k]; i++) {
+      res.n_elems+=item_arr[k][i].n_elems;
+      res.n_bytes+=item_arr[k][i].n_bytes;
+    }
+    if (res.n_items == 0 || res.n_elems == 0) return(res);
+
+    double warm=run_pass(k);
+    res.n_passes=(warm > 0) ? (int)ceil(RB5_BENCH_MIN_SEC/warm) : RB5_BENCH_MAX_PASSES;
+    if (res.n_passes < 1) res.n_passes=1;
+    if (res.n_passes > RB5_BENCH_MAX_PASSES) res.n_passes=RB5_BENCH_MAX_PASSES;
+
+    double sum_ns=0.0, sum2_ns=0.0, sum_gbps=0.0, sum2_gbps=0.0;
+    for (r = 0; r < n_repeat; r++) {
+      double sec=0.0;
+      for (p = 0; p < res.n_passes; p++) sec+=run_pass(k);
+      double ns=sec*1e9/((double)res.n_elems*res.n_passes);
+      double gbps=(sec > 0) ? (double)res.n_bytes*res.n_passes/sec/1e9 : 0.0;
+      sum_ns+=ns; sum2_ns+=ns*ns;
+      sum_gbps+=gbps; sum2_gbps+=gbps*gbps;
+    }
+    res.ns_per_elem_mean=sum_ns/n_repeat;
+    res.gbps_mean=sum_gbps/n_repeat;
+    if (n_repeat > 1) {
+      double var_ns=(sum2_ns-n_repeat*res.ns_per_elem_mean*res.ns_per_elem_mean)/(n_repeat-1);
+      double var_gbps=(sum2_gbps-n_repeat*res.gbps_mean*res.gbps_mean)/(n_repeat-1);
+      res.ns_per_elem_sd=(var_ns > 0) ? sqrt(var_ns) : 0.0;
+      res.gbps_sd=(var_gbps > 0) ? sqrt(var_gbps) : 0.0;
+    }
+    return(res);
+}
+
+//#############################################################################
+
+static void usage(const char *prog) {
+    fprintf(stderr,"Usage: %s [-n repeats] [-k kernel] [-j results.json] <RB5 files or dirs>\n",prog);
+    fprintf(stderr,"  kernels:");
+    int k;
+    for (k = 0; k < N_KERNELS; k++) fprintf(stderr," %s",kernel_name_arr[k]);
+    fprintf(stderr,"\n");
+}
+
+int main(int argc, char *argv[]) {
+
+    int n_repeat=5;
+    char *json_fname=NULL;
+    int only_kernel=-1;
+    int c, k;
+    while ((c=getopt(argc,argv,"n:k:j:h")) != -1) {
+      switch (c) {
+        case 'n': n_repeat=atoi(optarg); break;
+        case 'j': json_fname=optarg; break;
+        case 'k':
+          for (k = 0; k < N_KERNELS; k++) if (strcmp(optarg,kernel_name_arr[k]) == 0) only_kernel=k;
+          if (only_kernel == -1) {
+            fprintf(stderr,"Error: unknown kernel %s\n",optarg);
+            usage(argv[0]);
+            return(EXIT_FAILURE);
+          }
+          break;
+        default:
+          usage(argv[0]);
+          return(EXIT_FAILURE);
+      }
+    }
+    if (optind >= argc || n_repeat < 1) {
+      usage(argv[0]);
+      return(EXIT_FAILURE);
+    }
+    for (c = optind; c < argc; c++) {
+      struct stat sb;
+      if (stat(argv[c],&sb) == 0 && S_ISDIR(sb.st_mode)) nftw(argv[c],walk_cb,16,FTW_PHYS);
+      else add_file(argv[c]);
+    }
+    if (n_infos == 0) {
+      fprintf(stderr,"Error: no RB5 volumes found\n");
+      return(EXIT_FAILURE);
+    }
+
+    FILE *fp_json=NULL;
+    if (json_fname != NULL && (fp_json=fopen(json_fname,"w")) == NULL) {
+      fprintf(stderr,"Error: cannot write %s\n",json_fname);
+      return(EXIT_FAILURE);
+    }
+    if (fp_json) fprintf(fp_json,"{\n  \"files\": %ld,\n  \"repeats\": %d,\n  \"results\": [",n_infos,n_repeat);
+
+    fprintf(stdout,"%ld files, %d repeats\n",n_infos,n_repeat);
+    fprintf(stdout,"%-18s %7s %11s %7s %11s %9s %6s %9s %9s\n","kernel","items","elements","passes","ns/elem","sd","cv%","GB/s","sd");
+    int n_json=0;
+    for (k = 0; k < N_KERNELS; k++) {
+      if (only_kernel != -1 && k != only_kernel) continue;
+      strKERNEL_RESULT res=bench_kernel(k,n_repeat);
+      if (res.n_items == 0) {
+        fprintf(stdout,"%-18s %7s\n",kernel_name_arr[k],"-");
+        continue;
+      }
+      double cv=(res.ns_per_elem_mean > 0) ? 100.0*res.ns_per_elem_sd/res.ns_per_elem_mean : 0.0;
+      fprintf(stdout,"%-18s %7ld %11ld %7d %11.3f %9.3f %6.1f %9.3f %9.3f\n",
+              kernel_name_arr[k], res.n_items, res.n_elems, res.n_passes,
+              res.ns_per_elem_mean, res.ns_per_elem_sd, cv, res.gbps_mean, res.gbps_sd);
+      if (fp_json) {
+        fprintf(fp_json,"%s\n    {\"kernel\": \"%s\", \"items\": %ld, \"elements\": %ld, \"bytes\": %ld, \"passes\": %d, \"ns_per_elem\": %.4f, \"ns_per_elem_sd\": %.4f, \"gb_per_s\": %.4f, \"gb_per_s_sd\": %.4f}",
+                n_json++ ? "," : "", kernel_name_arr[k], res.n_items, res.n_elems, res.n_bytes, res.n_passes,
+                res.ns_per_elem_mean, res.ns_per_elem_sd, res.gbps_mean, res.gbps_sd);
+      }
+    }
+    if (fp_json) {
+      fprintf(fp_json,"\n  ]\n}\n");
+      fclose(fp_json);
+    }
+
+    //raw arrays are shared by the reorder and convert items, freed once
+    size_t i;
+    for (i = 0; i < n_items[KERNEL_UNCOMPRESS]; i++) RAVE_FREE(item_arr[KERNEL_UNCOMPRESS][i].src);
+    for (i = 0; i < n_items[KERNEL_BYTE_SWAP]; i++) RAVE_FREE(item_arr[KERNEL_BYTE_SWAP][i].src);
+    for (i = 0; i < n_items[KERNEL_REORDER]; i++) RAVE_FREE(item_arr[KERNEL_REORDER][i].src);
+    for (i = 0; i < n_items[KERNEL_OFFSETS_2_SYSTIME]; i++) {
+      RAVE_FREE(item_arr[KERNEL_OFFSETS_2_SYSTIME][i].offset_arr);
+      RAVE_FREE(item_arr[KERNEL_OFFSETS_2_SYSTIME][i].systime_arr);
+    }
+    for (k = 0; k < N_KERNELS; k++) free(item_arr[k]);
+    for (i = 0; i < n_infos; i++) {
+      close_rb5_info(info_arr[i]);
+      free(info_arr[i]);
+    }
+    free(info_arr);
+    rb5_inflate_cleanup();
+    return(EXIT_SUCCESS);
+}
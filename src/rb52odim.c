@@ -53,7 +53,11 @@ int populateParam(PolarScanParam_t* param, strRB5_INFO *rb5_info, strRB5_PARAM_I
     //convert_raw_to_data() populates rb5_param structure as per conversion type
     void *raw_arr=NULL;
     float *data_arr=NULL;
-    return_param_blobid_raw(&(*rb5_info), &(*rb5_param), &raw_arr);
+    int L_DECODED=0;
+    //blobs kept compressed for apply_rb5_passthrough() come back as zeros
+    if (take_rb5_passthrough_blob(&(*rb5_info), &(*rb5_param), &raw_arr) == 0) {
+      L_DECODED=(return_param_blobid_raw(&(*rb5_info), &(*rb5_param), &raw_arr) != 0);
+    }
 
     // fake n_elems_data = 0 to skip converted data_arr creation/return (more efficient; not necessary)
     size_t orig_n_elems_data=rb5_param->n_elems_data;
@@ -61,6 +65,17 @@ int populateParam(PolarScanParam_t* param, strRB5_INFO *rb5_info, strRB5_PARAM_I
     convert_raw_to_data(&(*rb5_param),&raw_arr,&data_arr);
     rb5_param->n_elems_data=orig_n_elems_data; //restore
 
+    //QC statistics while the codes just decoded are at hand, instead of a second pass over the ODIM data
+    strRB5_QC_STATS qc;
+    double *ray_coverage=NULL;
+    int L_QC=0;
+    if (rb5_qc_on && L_DECODED) {
+      ray_coverage=RAVE_MALLOC(rb5_param->nrays*sizeof(double));
+      strRB5_PROFILE_MARK prof=rb5_profile_begin();
+      L_QC=(ray_coverage != NULL && rb5_qc_moment(&(*rb5_param), raw_arr, &qc, ray_coverage) == EXIT_SUCCESS);
+      rb5_profile_end(RB5_PROFILE_QC,prof,rb5_param->n_elems_data*(rb5_param->raw_binary_depth/8));
+    }
+
     /* Figure out what data depth this moment of data is in, ie. 8, 16, 32, or 64-bit (u)int or float.
      * Map to Toolbox equivalent. This example is for 16-bit unsigned int */
            if(rb5_param->raw_binary_depth ==  8) {
@@ -105,6 +120,9 @@ int populateParam(PolarScanParam_t* param, strRB5_INFO *rb5_info, strRB5_PARAM_I
     /* Value for 'undetected', ie. areas radiated but with no echo, with a convention used for reflectivity */
     PolarScanParam_setUndetect(param, 0);
 
+    if (L_QC) ret = addQcAttributes(param, &(*rb5_param), &qc, ray_coverage);
+    if (ray_coverage != NULL) RAVE_FREE(ray_coverage);
+
     /* We'll add appropriate exception handling later */
     return ret;
 }
@@ -121,29 +139,31 @@ int populateScan(PolarScan_t* scan, strRB5_INFO *rb5_info, int this_slice) {
     //rb5_util vars
     strRB5_PARAM_INFO rb5_param;
 //    static char xpath[MAX_STRING]="\0";
-    static char xpath_bgn[MAX_STRING]="\0";
-    static char iso8601[MAX_STRING]="\0";
-    static char tmp_a[MAX_STRING*4]="\0"; //expanded to accomodate longer sprintf()
+    static __thread char xpath_bgn[MAX_STRING]="\0";
+    char yyyymmdd[MAX_YYYYMMDD_STRING]="\0";
+    char hhmmss[MAX_HHMMSS_STRING]="\0";
+    int64_t epoch_ms;
+    static __thread char tmp_a[MAX_STRING*4]="\0"; //expanded to accomodate longer sprintf()
     int L_RB5_PARAM_VERBOSE=0;
 
     //#############################################################################//
     /* Set select mandatory 'what' attributes. See Table 13 in the ODIM_H5 spec. */
 
     if (rb5_info->L_TIME_ACCURACY_DOWNGRADE){
-        strcpy(iso8601,rb5_info->slice_iso8601_bgn_low[this_slice]);
+        epoch_ms=rb5_info->slice_epoch_ms_bgn_low[this_slice];
     } else {
-        strcpy(iso8601,rb5_info->slice_iso8601_bgn    [this_slice]);
+        epoch_ms=rb5_info->slice_epoch_ms_bgn    [this_slice];
     }
-    ret = PolarScan_setStartDate(scan, func_iso8601_2_yyyymmdd(iso8601)); //"YYYYMMDD"
-    ret = PolarScan_setStartTime(scan, func_iso8601_2_hhmmss(iso8601)); //"HHmmss"
+    ret = PolarScan_setStartDate(scan, func_epoch_ms_2_yyyymmdd(epoch_ms,yyyymmdd)); //"YYYYMMDD"
+    ret = PolarScan_setStartTime(scan, func_epoch_ms_2_hhmmss(epoch_ms,hhmmss)); //"HHmmss"
 
     if (rb5_info->L_TIME_ACCURACY_DOWNGRADE){
-        strcpy(iso8601,rb5_info->slice_iso8601_end_est[this_slice]);
+        epoch_ms=rb5_info->slice_epoch_ms_end_est[this_slice];
     } else {
-        strcpy(iso8601,rb5_info->slice_iso8601_end    [this_slice]);
+        epoch_ms=rb5_info->slice_epoch_ms_end    [this_slice];
     }
-    ret = PolarScan_setEndDate(scan, func_iso8601_2_yyyymmdd(iso8601)); //"YYYYMMDD"
-    ret = PolarScan_setEndTime(scan, func_iso8601_2_hhmmss(iso8601)); //"HHmmss"
+    ret = PolarScan_setEndDate(scan, func_epoch_ms_2_yyyymmdd(epoch_ms,yyyymmdd)); //"YYYYMMDD"
+    ret = PolarScan_setEndTime(scan, func_epoch_ms_2_hhmmss(epoch_ms,hhmmss)); //"HHmmss"
 
     //#############################################################################//
     /* Set optional 'how' attributes. There are lots! See Table 8 in the ODIM_H5 spec. */
@@ -240,9 +260,7 @@ int populateScan(PolarScan_t* scan, strRB5_INFO *rb5_info, int this_slice) {
 
     // from <txpower> determine max & avg; <txpower> storage in setRayAttributes()
     L_RB5_PARAM_VERBOSE=0;
-    char req_rayinfo_name[MAX_STRING]="\0";
-    strcpy(req_rayinfo_name,"txpower");
-    int idx_req=find_in_string_arr(rb5_info->rayinfo_name_arr,rb5_info->n_rayinfos,req_rayinfo_name);
+    int idx_req=find_rb5_rayinfo(rb5_info,RB5_RAYINFO_TXPOWER);
     if(idx_req != -1) {
         sprintf(xpath_bgn,"((/volume/scan/slice)[%2d]/slicedata/%s)[%2d]/",this_slice+1,"rayinfo",idx_req+1);
         rb5_param=get_rb5_param_info(rb5_info,xpath_bgn,L_RB5_PARAM_VERBOSE);
@@ -306,6 +324,7 @@ int populateScan(PolarScan_t* scan, strRB5_INFO *rb5_info, int this_slice) {
 
     /* Loop through the moments, populating a Toolbox object for each */
     L_RB5_PARAM_VERBOSE=0;
+    if (rb5_info->passthrough != NULL) ((strRB5_PASSTHROUGH *)rb5_info->passthrough)->this_slice=this_slice;
     for (i=0;i<np;i++) {
         PolarScanParam_t* param = RAVE_OBJECT_NEW(&PolarScanParam_TYPE);
 
@@ -328,6 +347,70 @@ if(L_RB52ODIM_DEBUG) fprintf(stdout,"Adding rawdata = %s to scan...\n",rb5_param
     return ret;
 }
 
+/*
+ * Warm state: when enabled in a thread, the parsed radar table is kept for
+ * the following files decoded by that thread, and re-read only if the table
+ * file changes. Thread-local since XPath contexts are not shared across threads.
+ */
+static __thread int L_KEEP_WARM=0;
+static __thread strXML_FILE_INFO warm_radar_table;
+static __thread time_t warm_radar_table_mtime=0;
+
+static void dropWarmRadarTable(void) {
+    if (warm_radar_table.doc != NULL) close_xml_buffer(&warm_radar_table);
+    memset(&warm_radar_table,0,sizeof(strXML_FILE_INFO));
+}
+
+void rb52odim_keep_warm(int on) {
+    if (!on) dropWarmRadarTable();
+    L_KEEP_WARM=(on != 0);
+}
+
+/*
+ * Cache state: when enabled in a thread, getRaveIO() reads through the
+ * decoded-blob cache next to each input (see rb5_cache.c), writing it first if needed.
+ */
+static __thread int L_USE_CACHE=0;
+
+void rb52odim_use_cache(int on) {
+    L_USE_CACHE=(on != 0);
+}
+
+/*
+ * Function name: openRadarTable
+ * Intent: Parse the radar table, or hand out the warm copy of this thread
+ */
+int openRadarTable(const char* inp_fname, strXML_FILE_INFO *radar_table) {
+    struct stat tstat;
+    if (L_KEEP_WARM && warm_radar_table.doc != NULL &&
+        strcmp(warm_radar_table.inp_fullfile,inp_fname) == 0 &&
+        stat(inp_fname,&tstat) == 0 && tstat.st_mtime == warm_radar_table_mtime) {
+      *radar_table=warm_radar_table;
+      return(EXIT_SUCCESS);
+    }
+
+    strcpy(radar_table->inp_fullfile,inp_fname);
+    if(open_xml_buffer(radar_table) != 0) {
+      fprintf(stderr,"Error cannot process file = %s\n", inp_fname);
+      return(EXIT_FAILURE);
+    }
+    if (L_KEEP_WARM && stat(inp_fname,&tstat) == 0) {
+      dropWarmRadarTable(); //stale table
+      warm_radar_table=*radar_table;
+      warm_radar_table_mtime=tstat.st_mtime;
+    }
+    return(EXIT_SUCCESS);
+}
+
+/*
+ * Function name: closeRadarTable
+ * Intent: Free a radar table from openRadarTable(), unless it is the warm copy
+ */
+void closeRadarTable(strXML_FILE_INFO *radar_table) {
+    if (radar_table->doc != NULL && radar_table->doc == warm_radar_table.doc) return;
+    close_xml_buffer(radar_table);
+}
+
 /*
  * Input object is an empty Toolbox core object ((object type to be determined below)).
  */
@@ -337,10 +420,13 @@ int populateObject(RaveCoreObject* object, strRB5_INFO *rb5_info) {
 
     /* Determine number of scans == n_slices */
     nscans = rb5_info->n_slices;
+    rb5_latency_note_sweeps(rb5_info); //data age is measured from the sweep end times
 
     //rb5_util vars
-    static char iso8601[MAX_STRING]="\0";
-    static char tmp_a[MAX_STRING]="\0";
+    char yyyymmdd[MAX_YYYYMMDD_STRING]="\0";
+    char hhmmss[MAX_HHMMSS_STRING]="\0";
+    int64_t epoch_ms;
+    static __thread char tmp_a[MAX_STRING]="\0";
 
     //#############################################################################//
     /*  Top-level 'what' attributes, Table 1 of the ODIM_H5 spec. */
@@ -354,19 +440,19 @@ int populateObject(RaveCoreObject* object, strRB5_INFO *rb5_info) {
      * If bottom-up volume or scan, it's the start of the (first/lowest) scan.
      * Otherwise, it's a top-down volume and it's the end of the last/lowest scan. */
     if (rb5_info->L_TIME_ACCURACY_DOWNGRADE){
-        strcpy(iso8601,rb5_info->slice_iso8601_bgn_low[0]);
+        epoch_ms=rb5_info->slice_epoch_ms_bgn_low[0];
         strcpy(tmp_a,"True");
     } else {
-        strcpy(iso8601,rb5_info->slice_iso8601_bgn    [0]);
+        epoch_ms=rb5_info->slice_epoch_ms_bgn    [0];
         strcpy(tmp_a,"False");
     }
     ret = addStringAttribute(object, "how/time_accuracy_downgrade", tmp_a);
     if (RAVE_OBJECT_CHECK_TYPE(object, &PolarVolume_TYPE)) {
         if (! PolarVolume_isAscendingScans((PolarVolume_t*)object)) {
             if (rb5_info->L_TIME_ACCURACY_DOWNGRADE){
-                strcpy(iso8601,rb5_info->slice_iso8601_end_est[nscans-1]);
+                epoch_ms=rb5_info->slice_epoch_ms_end_est[nscans-1];
             } else {
-                strcpy(iso8601,rb5_info->slice_iso8601_end    [nscans-1]);
+                epoch_ms=rb5_info->slice_epoch_ms_end    [nscans-1];
             }
         }
     }
@@ -392,9 +478,7 @@ int populateObject(RaveCoreObject* object, strRB5_INFO *rb5_info) {
     }
 
     strXML_FILE_INFO radar_table;
-    strcpy(radar_table.inp_fullfile,inp_fname);
-    if(open_xml_buffer(&radar_table) != 0) {
-      fprintf(stderr,"Error cannot process file = %s\n", inp_fname);
+    if(openRadarTable(inp_fname,&radar_table) != EXIT_SUCCESS) {
       return(EXIT_FAILURE);
     }
 
@@ -430,8 +514,8 @@ int populateObject(RaveCoreObject* object, strRB5_INFO *rb5_info) {
     }
     if(L_RB52ODIM_DEBUG) printf("\n%s: odim_source = %s\n",rb5_info->sensor_id,tmp_a);
     if(RAVE_OBJECT_CHECK_TYPE(object, &PolarVolume_TYPE)) {
-      PolarVolume_setDate     ((PolarVolume_t*)object,func_iso8601_2_yyyymmdd(iso8601));
-      PolarVolume_setTime     ((PolarVolume_t*)object,func_iso8601_2_hhmmss(iso8601));
+      PolarVolume_setDate     ((PolarVolume_t*)object,func_epoch_ms_2_yyyymmdd(epoch_ms,yyyymmdd));
+      PolarVolume_setTime     ((PolarVolume_t*)object,func_epoch_ms_2_hhmmss(epoch_ms,hhmmss));
       PolarVolume_setSource   ((PolarVolume_t*)object,tmp_a);
       PolarVolume_setLongitude((PolarVolume_t*)object,rb5_info->sensor_lon_deg*DEG_TO_RAD);
       PolarVolume_setLatitude ((PolarVolume_t*)object,rb5_info->sensor_lat_deg*DEG_TO_RAD);
@@ -449,8 +533,8 @@ int populateObject(RaveCoreObject* object, strRB5_INFO *rb5_info) {
         }
       }
     } else {
-      PolarScan_setDate     ((PolarScan_t*)object,func_iso8601_2_yyyymmdd(iso8601));
-      PolarScan_setTime     ((PolarScan_t*)object,func_iso8601_2_hhmmss(iso8601));
+      PolarScan_setDate     ((PolarScan_t*)object,func_epoch_ms_2_yyyymmdd(epoch_ms,yyyymmdd));
+      PolarScan_setTime     ((PolarScan_t*)object,func_epoch_ms_2_hhmmss(epoch_ms,hhmmss));
       PolarScan_setSource   ((PolarScan_t*)object,tmp_a);
       PolarScan_setLongitude((PolarScan_t*)object,rb5_info->sensor_lon_deg*DEG_TO_RAD);
       PolarScan_setLatitude ((PolarScan_t*)object,rb5_info->sensor_lat_deg*DEG_TO_RAD);
@@ -499,7 +583,7 @@ int populateObject(RaveCoreObject* object, strRB5_INFO *rb5_info) {
     ret = addStringAttribute(object, "how/simulated", "False");
     ret = addDoubleAttribute(object, "how/wavelength", rb5_info->sensor_wavelength_cm);
 
-    close_xml_buffer(&radar_table);
+    closeRadarTable(&radar_table);
     
     // NOTE: attributes may not exist in the original RB5 raw file, thus check w/ strcmp(returned copied str,"") != 0
     // WARNING: watch for value=atof(str(''))=0.0
@@ -573,7 +657,8 @@ RaveIO_t* getRaveIObuf(const char* ifile, char **inp_buffer, size_t buffer_len)
 
     //get RB5 top level info
     strRB5_INFO rb5_info;
-    strcpy(rb5_info.inp_fullfile,inp_fname);
+    memset(&rb5_info,0,sizeof(strRB5_INFO)); //no slice_angle_block[] owned yet
+    snprintf(rb5_info.inp_fullfile,sizeof(rb5_info.inp_fullfile),"%s",inp_fname);
 //printf("GOT inp_fname = %s\n", inp_fname);
 //printf("buffer_len= %ld\n", buffer_len);
 //printf("READ buffer = %.250s\n",*inp_buffer);
@@ -581,15 +666,19 @@ RaveIO_t* getRaveIObuf(const char* ifile, char **inp_buffer, size_t buffer_len)
 
     rb5_info.buffer=*inp_buffer;
     rb5_info.buffer_len=buffer_len;
+    rb5_info.cache=NULL;
+    rb5_info.passthrough=NULL;
 
     //find end of XML
     rb5_info.byte_offset_blobspace=find_buffer_end_of_xml(*inp_buffer);
 
     // parse the XML and get the DOM
+    strRB5_PROFILE_MARK prof=rb5_profile_begin();
     rb5_info.doc=xmlReadMemory(rb5_info.buffer, rb5_info.byte_offset_blobspace, "noname.xml", NULL, 0);
 
     // create xpath evaluation context
     rb5_info.xpathCtx = xmlXPathNewContext(rb5_info.doc);
+    rb5_profile_end(RB5_PROFILE_XML_PARSE,prof,rb5_info.byte_offset_blobspace);
     if(rb5_info.xpathCtx == NULL) {
         fprintf(stderr,"Error: unable to create new XPath context\n");
         close_rb5_info(&rb5_info);
@@ -597,10 +686,12 @@ RaveIO_t* getRaveIObuf(const char* ifile, char **inp_buffer, size_t buffer_len)
     }
 
     int L_VERBOSE=0;
+    prof=rb5_profile_begin();
     if(populate_rb5_info(&rb5_info,L_VERBOSE) != EXIT_SUCCESS) {
       fprintf(stderr,"Error cannot process file = %s\n", inp_fname);
       return raveio;
     }
+    rb5_profile_end(RB5_PROFILE_POPULATE_INFO,prof,rb5_info.byte_offset_blobspace);
 
 //#############################################################################
     /* If the RB5 file contains a scan or a pvol, create equivalent object */
@@ -610,11 +701,14 @@ RaveIO_t* getRaveIObuf(const char* ifile, char **inp_buffer, size_t buffer_len)
     } else if(rot == Rave_ObjectType_SCAN) {
       object = (RaveCoreObject*)RAVE_OBJECT_NEW(&PolarScan_TYPE);
     } else {
+      close_rb5_info(&rb5_info);
       return raveio; //unknown
     }
 
     /* Map RB5 object(s) to Toolbox ones. */
+    prof=rb5_profile_begin();
     populateObject(object, &rb5_info);
+    rb5_profile_end(RB5_PROFILE_RAVE_BUILD,prof,rb5_info.buffer_len-rb5_info.byte_offset_blobspace);
     close_rb5_info(&rb5_info);
 
     /* Set the object into the I/O container */
@@ -636,8 +730,23 @@ RaveIO_t* getRaveIO(const char* ifile) {
 
 //#############################################################################
 
-   //use open_xml_buffer() to ingest file
     char *inp_fname=(char *)ifile;
+    strRB5_INFO rb5_info;
+    strRB5_CACHE cache;
+    int L_VERBOSE=0;
+    strRB5_PROFILE_MARK prof;
+    memset(&rb5_info,0,sizeof(strRB5_INFO)); //no slice_angle_block[] owned yet
+    cache.map=NULL;
+
+    if (L_USE_CACHE) {
+      //XML header and decoded blobs from <ifile>.rb5c, written first if missing or stale
+      if(open_rb5_info_cached(inp_fname,&rb5_info,&cache,L_VERBOSE) != EXIT_SUCCESS) {
+        fprintf(stderr,"Error cannot process file = %s\n", inp_fname);
+        return raveio;
+      }
+    } else {
+
+   //use open_xml_buffer() to ingest file
     strXML_FILE_INFO xml_info;
     strcpy(xml_info.inp_fullfile,inp_fname);
     if(open_xml_buffer(&xml_info) != 0) {
@@ -647,20 +756,23 @@ RaveIO_t* getRaveIO(const char* ifile) {
 
     //get RB5 top level info
     //init with xml_info
-    strRB5_INFO rb5_info;
     strcpy(rb5_info.inp_fullfile,xml_info.inp_fullfile);
     rb5_info.buffer=xml_info.buffer;
     rb5_info.buffer_len=xml_info.buffer_len;
     rb5_info.byte_offset_blobspace=xml_info.byte_offset_end_of_xml;
     rb5_info.doc=xml_info.doc;
     rb5_info.xpathCtx=xml_info.xpathCtx;
+    rb5_info.cache=NULL;
+    rb5_info.passthrough=NULL;
 
 //#############################################################################
-    int L_VERBOSE=0;
+    prof=rb5_profile_begin();
     if(populate_rb5_info(&rb5_info,L_VERBOSE) != EXIT_SUCCESS) {
       fprintf(stderr,"Error cannot process file = %s\n", inp_fname);
       return raveio;
     }
+    rb5_profile_end(RB5_PROFILE_POPULATE_INFO,prof,rb5_info.byte_offset_blobspace);
+    }
 
 //#############################################################################
     /* If the RB5 file contains a scan or a pvol, create equivalent object */
@@ -670,12 +782,17 @@ RaveIO_t* getRaveIO(const char* ifile) {
     } else if(rot == Rave_ObjectType_SCAN) {
       object = (RaveCoreObject*)RAVE_OBJECT_NEW(&PolarScan_TYPE);
     } else {
+      close_rb5_info(&rb5_info);
+      close_rb5_cache(&cache);
       return raveio; //unknown
     }
 
     /* Map RB5 object(s) to Toolbox ones. */
+    prof=rb5_profile_begin();
     populateObject(object, &rb5_info);
+    rb5_profile_end(RB5_PROFILE_RAVE_BUILD,prof,rb5_info.buffer_len-rb5_info.byte_offset_blobspace);
     close_rb5_info(&rb5_info);
+    close_rb5_cache(&cache);
 //    xmlCleanupParser(); // free globals in main() only for thread safety & valgrind
 
     /* Set the object into the I/O container */
@@ -763,19 +880,20 @@ int isRainbow5(const char* inp_fname) {
     static const unsigned BUFLEN = 1024;
     char buf[BUFLEN];
     line=gzgets(fp,buf,sizeof(buf));
-    size_t len=strlen(line);
     gzclose(fp);
+    if (line == NULL) return RETURN_no; //empty file
+    size_t len=strlen(line);
 
     //Note, gzgets() strips trailing '\n', old method non-gz getline() kept it
     //trailing \'n' needed for subsequent proper header line extraction in isRainbow5buf()
     len+=1;
-    char *test_line=malloc(len); //extend to restore trailing '/n'
+    char *test_line=rb5_mem_malloc(len+1); //extend to restore trailing '\n', plus terminator
     strcpy(test_line,line);
     strcat(test_line,"\n");
 //    fprintf(stdout,"test_line : %s\n",test_line);
 
     int RETURN_val=isRainbow5buf(&test_line);
-    free(test_line);
+    rb5_mem_free(test_line);
     return RETURN_val;
 }
 
@@ -788,17 +906,9 @@ int setRayAttributes(PolarScan_t* scan, strRB5_INFO *rb5_info, int this_slice) {
     int ret = 0;
 //    long nrays = PolarScan_getNrays(scan); // use rb5_info.nrays
 
-    static char iso8601_0[MAX_STRING]="\0";
-    if (rb5_info->L_TIME_ACCURACY_DOWNGRADE){
-        strcpy(iso8601_0,rb5_info->slice_iso8601_bgn_low[this_slice]);
-    } else {
-        strcpy(iso8601_0,rb5_info->slice_iso8601_bgn    [this_slice]);
-    }
-    double systime_0=func_iso8601_2_systime(iso8601_0);
-
     //rb5_util vars
     strRB5_PARAM_INFO rb5_param;
-    static char xpath_bgn[MAX_STRING]="\0";
+    static __thread char xpath_bgn[MAX_STRING]="\0";
     void *raw_arr=NULL;
     float *data_arr=NULL;
     int i;
@@ -877,7 +987,9 @@ if(L_RB52ODIM_DEBUG) fprintf(stdout,"Adding rayinfo = %s to scan...\n",rb5_param
 
       // Note: angle readback not done here anymore, see above
       // added capture and logic to decode-side
-      if(strcmp(rb5_param.sparam,"dataflag") == 0){
+      const strRB5_PARAM_DEF *def=rb5_param_def(rb5_param.param_id);
+      RB5_RAYINFO_ROLE role=(def != NULL) ? def->rayinfo_role : RB5_RAYINFO_NONE;
+      if(role == RB5_RAYINFO_DATAFLAG){
         for (i=0;i<this_nrays;i++) ldata_arr[i]=data_arr[i];
 if(L_RB52ODIM_DEBUG) fprintf(stdout,"Creating how/dataflag...\n");
         RaveAttribute_t* dataflag_attr = RaveAttributeHelp_createLongArray("how/dataflag", ldata_arr, this_nrays); //custom extra
@@ -906,31 +1018,26 @@ if(L_RB52ODIM_DEBUG) fprintf(stdout,"Creating how/dataflag...\n");
             "  0x8000 = not used\n"
             "<noisepowerh>, <noisepowerv> range corrected noise power at 1 km range [dBZ]");
 
-      }else if(strcmp(rb5_param.sparam,"numpulses") == 0){
+      }else if(role == RB5_RAYINFO_NUMPULSES){
         for (i=0;i<this_nrays;i++) ldata_arr[i]=data_arr[i];
         RaveAttribute_t* numpulses_attr = RaveAttributeHelp_createLongArray("how/numpulses", ldata_arr, this_nrays); //custom extra
         ret = PolarScan_addAttribute(scan, numpulses_attr);
         RAVE_OBJECT_RELEASE(numpulses_attr);
 
-      }else if(strcmp(rb5_param.sparam,"timestamp") == 0){ //EPOCH SECONDS
-        if (rb5_info->L_TIME_ACCURACY_DOWNGRADE){ //populate using estimated elapsed ms
-            double ms_dur_per_ray=(double)rb5_info->slice_dur_secs_est[this_slice]/(double)(this_nrays-1)*1000.;
-            for (i=0;i<this_nrays;i++) data_arr[i]=ms_dur_per_ray*i;
-            reorder_by_iray_0degN(&rb5_param,(void*)(&data_arr));
-        }
-        for (i=0;i<this_nrays;i++) ddata_arr[i]=(double)data_arr[i]/1000. + systime_0;
+      }else if(role == RB5_RAYINFO_TIMESTAMP){ //EPOCH SECONDS
+        getRayTimestamps(&(*rb5_info), this_slice, &rb5_param, &data_arr, ddata_arr);
         RaveAttribute_t* startazT_attr = RaveAttributeHelp_createDoubleArray("how/startazT", ddata_arr, this_nrays);
         ret = PolarScan_addAttribute(scan, startazT_attr);
         RAVE_OBJECT_RELEASE(startazT_attr);
 
-      }else if(strcmp(rb5_param.sparam,"txpower") == 0){ //KILOWATTS
+      }else if(role == RB5_RAYINFO_TXPOWER){ //KILOWATTS
         for (i=0;i<this_nrays;i++) ddata_arr[i]=kW_2_dBm((double)data_arr[i]/1000.); //ODIM_2_4 is now dBm
         RaveAttribute_t* txpower_attr = RaveAttributeHelp_createDoubleArray("how/TXpower", ddata_arr, this_nrays);
         ret = PolarScan_addAttribute(scan, txpower_attr);
         RAVE_OBJECT_RELEASE(txpower_attr);
 
       //2023-Apr: to use NEZ(H/V)_A (array) instead of custom "noisepower(h/v)"
-      }else if(strcmp(rb5_param.sparam,"noisepowerh") == 0){ //added in v5.44.0, noise power at 100 km range in dBZ
+      }else if(role == RB5_RAYINFO_NOISEPOWERH){ //added in v5.44.0, noise power at 100 km range in dBZ
 //        for (i=0;i<this_nrays;i++) ldata_arr[i]=data_arr[i];
 //        RaveAttribute_t* noisepowerh_attr = RaveAttributeHelp_createLongArray("how/noisepowerh", ldata_arr, this_nrays);
         //convert IEEE 754 "single format" bit layout to 32 bit floating-point
@@ -940,7 +1047,7 @@ if(L_RB52ODIM_DEBUG) fprintf(stdout,"Creating how/dataflag...\n");
         ret = PolarScan_addAttribute(scan, noisepowerh_attr);
         RAVE_OBJECT_RELEASE(noisepowerh_attr);
 
-      }else if(strcmp(rb5_param.sparam,"noisepowerv") == 0){ //added in v5.44.0, noise power at 100 km range in dBZ
+      }else if(role == RB5_RAYINFO_NOISEPOWERV){ //added in v5.44.0, noise power at 100 km range in dBZ
 //        for (i=0;i<this_nrays;i++) ldata_arr[i]=data_arr[i];
 //        RaveAttribute_t* noisepowerv_attr = RaveAttributeHelp_createLongArray("how/noisepowerv", ldata_arr, this_nrays);
         //convert IEEE 754 "single format" bit layout to 32 bit floating-point
@@ -965,6 +1072,58 @@ if(L_RB52ODIM_DEBUG) fprintf(stdout,"Creating how/dataflag...\n");
     return ret;
 }
 
+/*
+ * Per-ray acquisition times in epoch seconds (how/startazT) from the decoded <timestamp> rayinfo.
+ * With a time accuracy downgrade, the ms offsets in data_arr are replaced by estimated ones.
+ */
+void getRayTimestamps(strRB5_INFO *rb5_info, int this_slice, strRB5_PARAM_INFO *rb5_param, float **data_arr, double *ddata_arr) {
+    size_t this_nrays=rb5_info->nrays[this_slice];
+    int64_t epoch_ms_0;
+    size_t i;
+
+    if (rb5_info->L_TIME_ACCURACY_DOWNGRADE){ //populate using estimated elapsed ms
+        epoch_ms_0=rb5_info->slice_epoch_ms_bgn_low[this_slice];
+        double ms_dur_per_ray=(double)rb5_info->slice_dur_secs_est[this_slice]/(double)(this_nrays-1)*1000.;
+        for (i=0;i<this_nrays;i++) (*data_arr)[i]=ms_dur_per_ray*i;
+        reorder_by_iray_0degN(rb5_param,(void*)data_arr);
+    } else {
+        epoch_ms_0=rb5_info->slice_epoch_ms_bgn    [this_slice];
+    }
+    func_epoch_ms_offsets_2_systime(epoch_ms_0, *data_arr, this_nrays, ddata_arr);
+}
+
+/*
+ * Helper to add the QC statistics of a moment (see rb5_qc.c) as how/ attributes.
+ * min/max/mean are of the echoes, in physical units; the histogram counts every
+ * sample, qc_histogram_binwidth raw codes per bin; coverage is the fraction of
+ * bins with an echo, overall and per ray.
+ */
+int addQcAttributes(PolarScanParam_t* param, strRB5_PARAM_INFO *rb5_param, strRB5_QC_STATS *qc, double *ray_coverage) {
+    int ret = 0;
+    RaveCoreObject* object = (RaveCoreObject*)param;
+    long hist[RB5_QC_NBINS];
+    size_t i;
+
+    ret = addDoubleAttribute(object, "how/qc_nodata_fraction",   (double)qc->n_nodata/qc->n_samples);
+    ret = addDoubleAttribute(object, "how/qc_undetect_fraction", (double)qc->n_undetect/qc->n_samples);
+    ret = addDoubleAttribute(object, "how/qc_coverage",          (double)qc->n_echo/qc->n_samples);
+    if (qc->n_echo) {
+        ret = addDoubleAttribute(object, "how/qc_min",  rb5_qc_raw_2_value(rb5_param, qc->raw_min));
+        ret = addDoubleAttribute(object, "how/qc_max",  rb5_qc_raw_2_value(rb5_param, qc->raw_max));
+        ret = addDoubleAttribute(object, "how/qc_mean", rb5_qc_raw_2_value(rb5_param, qc->raw_sum/qc->n_echo));
+    }
+    for (i = 0; i < RB5_QC_NBINS; i++) hist[i] = (long)qc->hist[i];
+    RaveAttribute_t* hist_attr = RaveAttributeHelp_createLongArray("how/qc_histogram", hist, RB5_QC_NBINS);
+    ret = addAttribute(object, hist_attr);
+    RAVE_OBJECT_RELEASE(hist_attr);
+    ret = addLongAttribute(object, "how/qc_histogram_binwidth", qc->hist_binwidth);
+    RaveAttribute_t* cov_attr = RaveAttributeHelp_createDoubleArray("how/qc_ray_coverage", ray_coverage, qc->nrays);
+    ret = addAttribute(object, cov_attr);
+    RAVE_OBJECT_RELEASE(cov_attr);
+
+    return ret;
+}
+
 /*
  * Helper to add a long integer attribute to a Toolbox object.
  */
@@ -35,10 +35,15 @@ along with RAVE.  If not, see <http://www.gnu.org/licenses/>.
 #include "polarscan.h"
 #include "polarvolume.h"
 
-#include "rave_alloc.h"
+#include "rb5_alloc.h"
 #include "time_utils.h"
 #include "rb5_utils.h"
 #include "xml_utils.h"
+#include "rb5_profile.h"
+#include "rb5_latency.h"
+#include "rb5_cache.h"
+#include "rb5_passthrough.h"
+#include "rb5_qc.h"
 
 #include <zlib.h> //for gzopen(), gzread(), gzclose()
 #include <ctype.h> //for tolower() & isalnum()
@@ -66,6 +71,10 @@ int objectTypeFromRB5(strRB5_INFO rb5_info);
 int populateParam(PolarScanParam_t* param, strRB5_INFO *rb5_info, strRB5_PARAM_INFO *rb5_param);
 int populateScan(PolarScan_t* scan, strRB5_INFO *rb5_info, int this_slice);
 int populateObject(RaveCoreObject* object, strRB5_INFO *rb5_info);
+void rb52odim_keep_warm(int on);
+void rb52odim_use_cache(int on);
+int openRadarTable(const char* inp_fname, strXML_FILE_INFO *radar_table);
+void closeRadarTable(strXML_FILE_INFO *radar_table);
 RaveIO_t* getRaveIObuf(const char* ifile, char **inp_buffer, size_t buffer_len);
 RaveIO_t* getRaveIO(const char* ifile);
 int is_regular_file(const char *path);
@@ -73,10 +82,12 @@ int isRainbow5buf(char **inp_buffer);
 int isRainbow5(const char* ifile);
 /* START HELPER FUNCTIONS */
 int setRayAttributes(PolarScan_t* scan, strRB5_INFO *rb5_info, int this_slice);
+void getRayTimestamps(strRB5_INFO *rb5_info, int this_slice, strRB5_PARAM_INFO *rb5_param, float **data_arr, double *ddata_arr);
 int addLongAttribute(RaveCoreObject* object, const char* name, long value);
 int addDoubleAttribute(RaveCoreObject* object, const char* name, double value);
 int addStringAttribute(RaveCoreObject* object, const char* name, const char* value);
 int addAttribute(RaveCoreObject* object, RaveAttribute_t* attr);
+int addQcAttributes(PolarScanParam_t* param, strRB5_PARAM_INFO *rb5_param, strRB5_QC_STATS *qc, double *ray_coverage);
 /* END HELPER FUNCTIONS */
 
 //################################################################################
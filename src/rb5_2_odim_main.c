@@ -32,34 +32,176 @@ along with RAVE.  If not, see <http://www.gnu.org/licenses/>.
  *
  * Example:
  * ./rb5_2_odim -i ../test/org/CASRA_2017121520000300dBZ.vol.gz -o CASRA_20171215200003_dBZ.test.h5
+ *
+ * Profile (per-phase wall time, bytes and calls, written to stderr):
+ * ./rb5_2_odim -i ../test/org/CASRA_2017121520000300dBZ.vol.gz -o dummy.h5 --profile
+ * ./rb5_2_odim -i ../test/org/CASRA_2017121520000300dBZ.vol.gz -o dummy.h5 --profile=json
+ * Add per-phase heap allocations, high-water mark and peak RSS (see rb5_memtrack.c):
+ * ./rb5_2_odim -i ../test/org/CASRA_2017121520000300dBZ.vol.gz -o dummy.h5 --memtrack
+ *
+ * Data age, from the end of acquisition to file seen/decoded/written, one JSON line to stderr
+ * and optionally histograms as a Prometheus text file (see rb5_latency.c):
+ * ./rb5_2_odim -i ../test/org/CASRA_2017121520000300dBZ.vol.gz -o dummy.h5 --latency
+ * ./rb5_2_odim --watch /tmp/rb5_in --out /tmp/odim_out --latency-prom /var/lib/node_exporter/rb52odim.prom
  * h5dump --attribute=/dataset1/how/astart CASRA_20171215200003_dBZ.test.h5
+ *
+ * Per-moment QC statistics (histogram over raw codes, nodata/undetect fractions, coverage per ray)
+ * counted while decoding and written as dataset1/data1/how/qc_* attributes (see rb5_qc.c):
+ * ./rb5_2_odim -i ../test/org/CASRA_2017121520000300dBZ.vol.gz -o dummy.h5 --qc
+ *
+ * Read through a decoded-blob cache next to the input (written on first use, see rb5_cache.c):
+ * ./rb5_2_odim -i ../test/org/CASRA_2017121520000300dBZ.vol.gz -o dummy.h5 --cache --profile
+ *
+ * Write the ODIM_H5 image to stdout instead of a file (log output goes to stderr):
+ * ./rb5_2_odim -i ../test/org/CASRA_2017121520000300dBZ.vol.gz -o - | h5dump -H /dev/stdin
+ *
+ * Copy unrotated rawdata blobs into the ODIM_H5 chunks as they are, without inflate/re-deflate:
+ * ./rb5_2_odim -i ../test/org/2016092614304000dBZ.vol -o dummy.h5 --passthrough --profile
+ *
+ * Inflate with another backend, if built in (zlib is the default, see rb5_inflate.c):
+ * RB5_INFLATE=libdeflate ./rb5_2_odim -i ../test/org/CASRA_2017121520000300dBZ.vol.gz -o dummy.h5 --profile
+ *
+ * Watch a directory, converting every RB5 file that lands in it (Ctrl-C to stop):
+ * ./rb5_2_odim --watch /tmp/rb5_in --out /tmp/odim_out --workers 4
+ * cp ../test/org/CASRA_2017121520000300dBZ.vol.gz /tmp/rb5_in/
+ *
+ * Convert a batch of files with the same worker pool:
+ * ./rb5_2_odim -i ../test/org/2016081612320300dBZ.azi -i ../test/org/2016092614304000dBZ.vol --out /tmp/odim_out --workers 4
+ * Either of them keeps the decode working sets, estimated from each file's header, under a memory
+ * budget with --mem-budget MB; smaller files go ahead of a large one waiting for memory (see rb5_watch.c)
+ * After an outage, convert the current cycle first, newest scan first, and the backlog on a quarter of the workers:
+ * ./rb5_2_odim -i ../test/org/2016081612320300dBZ.azi -i ../test/org/2016092614304000dBZ.vol --out /tmp/odim_out --workers 4 --cycle 600 --backfill-share 25
+ * Files of a scan strategy seen before reuse its static slice parameters (see rb5_strategy.c),
+ * RB5_STRATEGY_CACHE=off to parse every file in full
  */
 
 //#include "rave_debug.h"
 #include <rb52odim.h>
+#include "rb5_watch.h"
+#include "rb5_odim_buf.h"
+#include "rb5_inflate.h"
 
 int main(int argc,char *argv[]) {
     int RETURN_FAILURE = -1;
     int ret = 0;
     int i;
     const char *ifile=NULL, *ofile=NULL;
-
-    if (argc!=5) {
-      printf("usage: %s -i RB5_file -o ODIM_H5_file\n", argv[0]);
-      return 1;
-    }
+    char *ifile_arr[argc]; // -i, several with --out
+    size_t n_ifiles=0;
+    const char *watch_dir=NULL, *out_dir=NULL;
+    int nworkers=2;
+    long mem_budget_mb=0;
+    int cycle_sec=0;
+    int backfill_share=RB5_WATCH_BACKFILL_SHARE;
+    const char *usage="usage: %s -i RB5_file -o ODIM_H5_file|- [--cache] [--passthrough (not with --qc)]\n"
+                      "       %s -i RB5_file [-i RB5_file ...] --out ODIM_H5_dir [--workers N] [--mem-budget MB] [--cycle SEC [--backfill-share PCT]]\n"
+                      "       %s --watch RB5_dir --out ODIM_H5_dir [--workers N] [--mem-budget MB] [--cycle SEC [--backfill-share PCT]]\n"
+                      "       all with [--profile[=text|json]] [--memtrack] [--latency] [--latency-prom prom_file] [--qc]\n";
+    int L_PROFILE=0;
+    int L_PROFILE_JSON=0;
+    int L_MEMTRACK=0;
+    int L_LATENCY=0;
+    int L_QC=0;
+    char *latency_prom=NULL;
+    int L_USE_CACHE=0;
+    int L_PASSTHROUGH=0;
+    int out_fd=-1; // -o -, stdout as it was before being pointed at stderr
 
     for (i=1;i<argc;i++) {
-      if (strcmp(argv[i], "-i") == 0) {
+      if ((strcmp(argv[i], "-i") == 0) && (i+1 < argc)) {
         i++;
         ifile = argv[i];
+        ifile_arr[n_ifiles++] = argv[i];
       }
-      else if (strcmp(argv[i], "-o") == 0) {
+      else if ((strcmp(argv[i], "-o") == 0) && (i+1 < argc)) {
         i++;
         ofile = argv[i];
       }
+      else if ((strcmp(argv[i], "--watch") == 0) && (i+1 < argc)) {
+        i++;
+        watch_dir = argv[i];
+      }
+      else if ((strcmp(argv[i], "--out") == 0) && (i+1 < argc)) {
+        i++;
+        out_dir = argv[i];
+      }
+      else if ((strcmp(argv[i], "--workers") == 0) && (i+1 < argc)) {
+        i++;
+        nworkers = atoi(argv[i]);
+      }
+      else if ((strcmp(argv[i], "--mem-budget") == 0) && (i+1 < argc)) {
+        i++;
+        mem_budget_mb = atol(argv[i]);
+      }
+      else if ((strcmp(argv[i], "--cycle") == 0) && (i+1 < argc)) {
+        i++;
+        cycle_sec = atoi(argv[i]);
+      }
+      else if ((strcmp(argv[i], "--backfill-share") == 0) && (i+1 < argc)) {
+        i++;
+        backfill_share = atoi(argv[i]);
+      }
+      else if (strcmp(argv[i], "--profile") == 0 || strcmp(argv[i], "--profile=text") == 0) {
+        L_PROFILE=1;
+      }
+      else if (strcmp(argv[i], "--memtrack") == 0) {
+        L_PROFILE=1; //reported per phase
+        L_MEMTRACK=1;
+      }
+      else if (strcmp(argv[i], "--latency") == 0) {
+        L_LATENCY=1;
+      }
+      else if ((strcmp(argv[i], "--latency-prom") == 0) && (i+1 < argc)) {
+        i++;
+        L_LATENCY=1;
+        latency_prom = argv[i];
+      }
+      else if (strcmp(argv[i], "--qc") == 0) {
+        L_QC=1;
+      }
+      else if (strcmp(argv[i], "--cache") == 0) {
+        L_USE_CACHE=1;
+      }
+      else if (strcmp(argv[i], "--passthrough") == 0) {
+        L_PASSTHROUGH=1;
+      }
+      else if (strcmp(argv[i], "--profile=json") == 0) {
+        L_PROFILE=1;
+        L_PROFILE_JSON=1;
+      }
       else {
-        printf("usage: %s -i RB5_file -o ODIM_H5_file\n", argv[0]);
+        printf(usage, argv[0], argv[0], argv[0]);
+        return RETURN_FAILURE;
+      }
+    }
+    if (watch_dir != NULL || out_dir != NULL) {
+      if (out_dir == NULL || (watch_dir == NULL) == (n_ifiles == 0) || ofile != NULL || nworkers < 1 || mem_budget_mb < 0 || cycle_sec < 0 || backfill_share < 1 || backfill_share > 100 || L_USE_CACHE || L_PASSTHROUGH) {
+        printf(usage, argv[0], argv[0], argv[0]);
+        return RETURN_FAILURE;
+      }
+    } else if (n_ifiles != 1 || ofile == NULL || mem_budget_mb != 0 || cycle_sec != 0 || (L_PASSTHROUGH && strcmp(ofile, "-") == 0)) {
+      printf(usage, argv[0], argv[0], argv[0]);
+      return RETURN_FAILURE;
+    }
+    if (L_PASSTHROUGH && L_QC) { //passed-through moments are never decoded, so they would get no how/qc_*
+      fprintf(stderr, "Error: --passthrough and --qc can not be combined\n");
+      printf(usage, argv[0], argv[0], argv[0]);
+      return RETURN_FAILURE;
+    }
+    rb5_profile_enable(L_PROFILE);
+    if (L_MEMTRACK) rb5_memtrack_xml_hooks(); //process-global, before libxml2 is used and any thread starts
+    rb5_memtrack_enable(L_MEMTRACK);
+    rb5_memtrack_reset();
+    rb5_latency_enable(L_LATENCY, latency_prom);
+    rb5_qc_enable(L_QC);
+    rb5_latency_begin(rb5_latency_wallclock()); //single file: seen now
+
+    // -o -: keep the real stdout for the ODIM_H5 image only, everything printed goes to stderr
+    if (ofile != NULL && strcmp(ofile, "-") == 0) {
+      fflush(stdout);
+      out_fd = dup(STDOUT_FILENO);
+      if (out_fd == -1 || dup2(STDERR_FILENO, STDOUT_FILENO) == -1) {
+        perror("stdout");
         return RETURN_FAILURE;
       }
     }
@@ -79,6 +221,23 @@ int main(int argc,char *argv[]) {
       putenv(sCMD);
     }
 
+//#############################################################################
+
+    if (out_dir != NULL) {
+      strRB5_WATCH_OPTIONS watch_opts;
+      init_rb5_watch_options(&watch_opts);
+      watch_opts.nworkers=nworkers;
+      watch_opts.L_PROFILE=L_PROFILE;
+      watch_opts.L_PROFILE_JSON=L_PROFILE_JSON;
+      watch_opts.L_MEMTRACK=L_MEMTRACK;
+      watch_opts.L_QC=L_QC;
+      watch_opts.mem_budget_bytes=(size_t)mem_budget_mb << 20;
+      watch_opts.cycle_sec=cycle_sec;
+      watch_opts.backfill_share=backfill_share;
+      if (watch_dir != NULL) return rb5_watch(watch_dir, out_dir, &watch_opts);
+      return rb5_watch_batch(ifile_arr, n_ifiles, out_dir, &watch_opts);
+    }
+
 //#############################################################################
 
 //    /* call this before any of your RAVE code */
@@ -96,8 +255,22 @@ int main(int argc,char *argv[]) {
 
 //#############################################################################
 
-    //use open_xml_buffer() to ingest file
     char *inp_fname=(char *)ifile;
+    strRB5_INFO rb5_info;
+    strRB5_CACHE cache;
+    int L_VERBOSE=1;
+    strRB5_PROFILE_MARK prof;
+    memset(&rb5_info,0,sizeof(strRB5_INFO)); //no slice_angle_block[] owned yet
+    cache.map=NULL;
+
+    if (L_USE_CACHE) {
+      if(open_rb5_info_cached(inp_fname,&rb5_info,&cache,L_VERBOSE) != EXIT_SUCCESS) {
+        fprintf(stderr,"Error cannot process file = %s\n", inp_fname);
+        return RETURN_FAILURE;
+      }
+    } else {
+
+    //use open_xml_buffer() to ingest file
     strXML_FILE_INFO xml_info;
     strcpy(xml_info.inp_fullfile,inp_fname);
     if(open_xml_buffer(&xml_info) != 0) {
@@ -107,20 +280,23 @@ int main(int argc,char *argv[]) {
 
     //get RB5 top level info
     //init with xml_info
-    strRB5_INFO rb5_info;
     strcpy(rb5_info.inp_fullfile,xml_info.inp_fullfile);
     rb5_info.buffer=xml_info.buffer;
     rb5_info.buffer_len=xml_info.buffer_len;
     rb5_info.byte_offset_blobspace=xml_info.byte_offset_end_of_xml;
     rb5_info.doc=xml_info.doc;
     rb5_info.xpathCtx=xml_info.xpathCtx;
+    rb5_info.cache=NULL;
+    rb5_info.passthrough=NULL;
 
-    int L_VERBOSE=1;
+    prof=rb5_profile_begin();
     if(populate_rb5_info(&rb5_info,L_VERBOSE) != EXIT_SUCCESS) {
       fprintf(stderr,"Error cannot process file = %s\n", inp_fname);
       return RETURN_FAILURE;
 //      return raveio;
     }
+    rb5_profile_end(RB5_PROFILE_POPULATE_INFO,prof,rb5_info.byte_offset_blobspace);
+    }
 
     printf("Successfully ingested : %s\n", inp_fname);
 
@@ -133,13 +309,24 @@ int main(int argc,char *argv[]) {
     } else if (rot == Rave_ObjectType_SCAN) {
       object = (RaveCoreObject*)RAVE_OBJECT_NEW(&PolarScan_TYPE);
     } else {
+      close_rb5_info(&rb5_info);
+      close_rb5_cache(&cache);
       return RETURN_FAILURE;
     }
 
+    /* Keep unrotated rawdata compressed, see rb5_passthrough.c */
+    strRB5_PASSTHROUGH passthrough;
+    init_rb5_passthrough(&passthrough, rot == Rave_ObjectType_PVOL);
+    if (L_PASSTHROUGH) rb5_info.passthrough=&passthrough;
+
     /* Map RB5 object(s) to Toolbox ones. */
+    prof=rb5_profile_begin();
     ret = populateObject(object, &rb5_info);
+    rb5_profile_end(RB5_PROFILE_RAVE_BUILD,prof,rb5_info.buffer_len-rb5_info.byte_offset_blobspace);
     close_rb5_info(&rb5_info);
+    close_rb5_cache(&cache);
     xmlCleanupParser(); // free globals in main() only for thread safety & valgrind
+    rb5_latency_mark_decoded();
 
     /* Set the object into the I/O container */
     RaveIO_setObject(raveio, object);
@@ -148,9 +335,40 @@ int main(int argc,char *argv[]) {
 //#############################################################################
 
     /* write to ODIM_H5 file */
-    ret = RaveIO_save(raveio, ofile);
+    prof=rb5_profile_begin();
+    if (out_fd != -1) {
+      size_t nbytes=0;
+      ret = (saveRaveIOfd(raveio, out_fd, &nbytes) == EXIT_SUCCESS);
+      close(out_fd);
+      rb5_profile_end(RB5_PROFILE_SAVE,prof,nbytes);
+    } else {
+      ret = RaveIO_save(raveio, ofile);
+      struct stat ostat;
+      rb5_profile_end(RB5_PROFILE_SAVE,prof,(stat(ofile,&ostat) == 0) ? (size_t)ostat.st_size : 0);
+    }
+    if (ret && passthrough.n_blobs > 0) {
+      size_t n_chunks=0;
+      if (apply_rb5_passthrough(&passthrough, ofile, &n_chunks) != EXIT_SUCCESS) {
+        unlink(ofile); // holds placeholder zeros
+        ret = 0;
+      } else {
+        printf("Passed through : %ld of %ld rawdata blobs as compressed chunks\n", n_chunks, passthrough.n_blobs);
+      }
+    }
+    free_rb5_passthrough(&passthrough);
+    if (ret) {
+      rb5_latency_mark_written();
+      rb5_latency_finish(ifile, ofile, stderr);
+    }
     RaveIO_close(raveio);
     RAVE_OBJECT_RELEASE(raveio);
 
+    rb5_inflate_cleanup();
+
+    if (rb5_profile_on) {
+      if (L_PROFILE_JSON) rb5_profile_dump_json(stderr);
+      else                rb5_profile_dump_text(stderr);
+    }
+
     return ret;
 }
@@ -0,0 +1,23 @@
+#ifndef RB5_ALLOC_H
+#define RB5_ALLOC_H
+
+// RAVE_MALLOC and friends, routed through the allocation tracker (rb5_memtrack.c);
+// include instead of rave_alloc.h. RAVE's own leak checker takes precedence
+// when built with RAVE_MEMORY_DEBUG.
+#include "rave_alloc.h"
+#include "rb5_memtrack.h"
+
+#ifndef RAVE_MEMORY_DEBUG
+#undef RAVE_MALLOC
+#undef RAVE_CALLOC
+#undef RAVE_REALLOC
+#undef RAVE_STRDUP
+#undef RAVE_FREE
+#define RAVE_MALLOC(sz) rb5_mem_malloc(sz)
+#define RAVE_CALLOC(npts,sz) rb5_mem_calloc(npts,sz)
+#define RAVE_REALLOC(ptr,sz) rb5_mem_realloc(ptr,sz)
+#define RAVE_STRDUP(x) rb5_mem_strdup(x)
+#define RAVE_FREE(x) if (x != NULL) {rb5_mem_free(x); x=NULL;}
+#endif
+
+#endif
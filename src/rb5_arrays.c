@@ -0,0 +1,213 @@
+/*
+ * rb5_arrays.c
+ *
+ * Decodes an RB5 file straight into plain arrays, for consumers that only
+ * want the moments and ray readbacks (e.g. _rb52odim.read_arrays()):
+ * same decode path as getRaveIO()/populateScan(), but no RAVE objects are
+ * built and the decoder's own buffers are handed over, not copied.
+ *
+ * compile only: gcc -g -I/usr/include/libxml2 -c rb5_arrays.c -o rb5_arrays.o
+ *
+ */
+
+#include "rb5_arrays.h"
+
+//#############################################################################
+
+/* rawdata i of a slice, raw values and scaling as populateParam() */
+static int decode_moment(strRB5_INFO *rb5_info, int this_slice, int i, int L_PHYSICAL, strRB5_MOMENT_ARRAYS *moment) {
+    char xpath_bgn[MAX_STRING]="\0";
+    strRB5_PARAM_INFO rb5_param;
+    void *raw_arr=NULL;
+    float *data_arr=NULL;
+
+    sprintf(xpath_bgn,"((/volume/scan/slice)[%2d]/slicedata/%s)[%2d]/",this_slice+1,"rawdata",i+1);
+    rb5_param=get_rb5_param_info(rb5_info,xpath_bgn,0);
+    if (return_param_blobid_raw(rb5_info,&rb5_param,&raw_arr) == 0 || raw_arr == NULL) {
+      if (raw_arr != NULL) RAVE_FREE(raw_arr);
+      return(EXIT_FAILURE);
+    }
+
+    // fake n_elems_data = 0 to skip converted data_arr unless physical values are requested
+    size_t orig_n_elems_data=rb5_param.n_elems_data;
+    if (!L_PHYSICAL) rb5_param.n_elems_data=0;
+    convert_raw_to_data(&rb5_param,&raw_arr,&data_arr);
+    rb5_param.n_elems_data=orig_n_elems_data; //restore
+    if (!L_PHYSICAL && data_arr != NULL) {
+      RAVE_FREE(data_arr);
+      data_arr=NULL;
+    }
+
+    snprintf(moment->sparam,sizeof(moment->sparam),"%s",rb5_param.sparam);
+    snprintf(moment->quantity,sizeof(moment->quantity),"%s",map_rb5_to_h5_param(rb5_param.sparam));
+    moment->nrays=rb5_param.nrays;
+    moment->nbins=rb5_param.nbins;
+    moment->raw_binary_depth=rb5_param.raw_binary_depth;
+    moment->raw_arr=raw_arr;
+    moment->data_arr=data_arr;
+    moment->gain=rb5_param.data_step;
+    moment->offset=rb5_param.data_range_min;
+    moment->nodata=rb5_param.raw_binary_max;
+    moment->undetect=0;
+    return(EXIT_SUCCESS);
+}
+
+/* <timestamp> rayinfo of a slice, if any, as how/startazT */
+static double *decode_startazT(strRB5_INFO *rb5_info, int this_slice) {
+    char xpath_bgn[MAX_STRING]="\0";
+    strRB5_PARAM_INFO rb5_param;
+    void *raw_arr=NULL;
+    float *data_arr=NULL;
+    double *startazT_arr=NULL;
+
+    int idx_req=find_rb5_rayinfo(rb5_info,RB5_RAYINFO_TIMESTAMP);
+    if (idx_req == -1) return(NULL);
+
+    sprintf(xpath_bgn,"((/volume/scan/slice)[%2d]/slicedata/%s)[%2d]/",this_slice+1,"rayinfo",idx_req+1);
+    rb5_param=get_rb5_param_info(rb5_info,xpath_bgn,0);
+    if (return_param_blobid_raw(rb5_info,&rb5_param,&raw_arr) != 0) {
+      convert_raw_to_data(&rb5_param,&raw_arr,&data_arr);
+      startazT_arr=RAVE_MALLOC(rb5_info->nrays[this_slice]*sizeof(double));
+      if (startazT_arr != NULL) getRayTimestamps(rb5_info,this_slice,&rb5_param,&data_arr,startazT_arr);
+    }
+    if ( raw_arr != NULL) RAVE_FREE( raw_arr);
+    if (data_arr != NULL) RAVE_FREE(data_arr);
+    return(startazT_arr);
+}
+
+//#############################################################################
+
+/*
+ * Function name: getRB5Arrays
+ * Intent: decode all sweeps of an RB5 file into plain arrays, raw moments only
+ *         unless L_PHYSICAL, without RAVE objects, through the decoded-blob
+ *         cache if L_USE_CACHE. Returns NULL on failure, otherwise free with
+ *         freeRB5Arrays().
+ */
+strRB5_ARRAYS* getRB5Arrays(const char* ifile, int L_PHYSICAL, int L_USE_CACHE) {
+
+    strXML_FILE_INFO xml_info;
+    strRB5_INFO rb5_info;
+    strRB5_CACHE cache;
+    int this_slice;
+    size_t i;
+
+    memset(&rb5_info,0,sizeof(strRB5_INFO)); //no slice_angle_block[] owned yet
+    cache.map=NULL;
+    if (L_USE_CACHE) {
+      if(open_rb5_info_cached(ifile,&rb5_info,&cache,0) != EXIT_SUCCESS) {
+        fprintf(stderr,"Error cannot process file = %s\n", ifile);
+        return NULL;
+      }
+    } else {
+      snprintf(xml_info.inp_fullfile,sizeof(xml_info.inp_fullfile),"%s",ifile);
+      if(open_xml_buffer(&xml_info) != 0) {
+        fprintf(stderr,"Error cannot process file = %s\n", ifile);
+        return NULL;
+      }
+      strcpy(rb5_info.inp_fullfile,xml_info.inp_fullfile);
+      rb5_info.buffer=xml_info.buffer;
+      rb5_info.buffer_len=xml_info.buffer_len;
+      rb5_info.byte_offset_blobspace=xml_info.byte_offset_end_of_xml;
+      rb5_info.doc=xml_info.doc;
+      rb5_info.xpathCtx=xml_info.xpathCtx;
+      rb5_info.cache=NULL;
+      rb5_info.passthrough=NULL;
+
+      strRB5_PROFILE_MARK prof=rb5_profile_begin();
+      if(populate_rb5_info(&rb5_info,0) != EXIT_SUCCESS) {
+        fprintf(stderr,"Error cannot process file = %s\n", ifile);
+        return NULL;
+      }
+      rb5_profile_end(RB5_PROFILE_POPULATE_INFO,prof,rb5_info.byte_offset_blobspace);
+    }
+
+    strRB5_ARRAYS *arrays=NULL;
+    if (objectTypeFromRB5(rb5_info) == Rave_ObjectType_UNDEFINED || (arrays=RAVE_MALLOC(sizeof(strRB5_ARRAYS))) == NULL) {
+      close_rb5_info(&rb5_info);
+      close_rb5_cache(&cache);
+      return NULL;
+    }
+    memset(arrays,0,sizeof(strRB5_ARRAYS));
+
+    strcpy(arrays->sensor_id,rb5_info.sensor_id);
+    strcpy(arrays->sensor_name,rb5_info.sensor_name);
+    strcpy(arrays->scan_type,rb5_info.scan_type);
+    strcpy(arrays->scan_name,rb5_info.scan_name);
+    strcpy(arrays->rainbow_version,rb5_info.rainbow_version);
+    arrays->sensor_lon_deg=rb5_info.sensor_lon_deg;
+    arrays->sensor_lat_deg=rb5_info.sensor_lat_deg;
+    arrays->sensor_alt_m=rb5_info.sensor_alt_m;
+    arrays->sensor_wavelength_cm=rb5_info.sensor_wavelength_cm;
+    arrays->sensor_beamwidth_deg=rb5_info.sensor_beamwidth_deg;
+    arrays->L_TIME_ACCURACY_DOWNGRADE=rb5_info.L_TIME_ACCURACY_DOWNGRADE;
+    arrays->n_sweeps=rb5_info.n_slices;
+
+    int ret=EXIT_SUCCESS;
+    for (this_slice = 0; this_slice < rb5_info.n_slices && ret == EXIT_SUCCESS; this_slice++) {
+      strRB5_SWEEP_ARRAYS *sweep=&arrays->sweep_arr[this_slice];
+      sweep->nrays=rb5_info.nrays[this_slice];
+      sweep->nbins=rb5_info.nbins[this_slice];
+      sweep->elangle_deg=rb5_info.angle_deg_arr[this_slice];
+      sweep->rstart_km=rb5_info.slice_bin_range_bgn_km[this_slice];
+      sweep->rscale_m=rb5_info.slice_bin_range_res_km[this_slice]*1000.;
+      if (strcmp(rb5_info.scan_type,"ele") == 0) {
+        sweep->a1gate=0;
+      } else {
+        sweep->a1gate=rb5_info.nrays[this_slice]-rb5_info.iray_0degN[this_slice];
+      }
+      if (rb5_info.L_TIME_ACCURACY_DOWNGRADE) {
+        sweep->epoch_ms_bgn=rb5_info.slice_epoch_ms_bgn_low[this_slice];
+        sweep->epoch_ms_end=rb5_info.slice_epoch_ms_end_est[this_slice];
+      } else {
+        sweep->epoch_ms_bgn=rb5_info.slice_epoch_ms_bgn[this_slice];
+        sweep->epoch_ms_end=rb5_info.slice_epoch_ms_end[this_slice];
+      }
+
+      //take over the angle readbacks block from get_slice_mid_angle_readbacks(), close_rb5_info() skips NULLs
+      sweep->angle_block           =rb5_info.slice_angle_block           [this_slice];
+      sweep->moving_angle_start_arr=rb5_info.slice_moving_angle_start_arr[this_slice];
+      sweep->moving_angle_stop_arr =rb5_info.slice_moving_angle_stop_arr [this_slice];
+      sweep->fixed_angle_start_arr =rb5_info.slice_fixed_angle_start_arr [this_slice];
+      sweep->fixed_angle_stop_arr  =rb5_info.slice_fixed_angle_stop_arr  [this_slice];
+      rb5_info.slice_angle_block[this_slice]=NULL;
+
+      sweep->startazT_arr=decode_startazT(&rb5_info,this_slice);
+
+      for (i = 0; i < rb5_info.n_rawdatas && ret == EXIT_SUCCESS; i++) {
+        ret=decode_moment(&rb5_info,this_slice,i,L_PHYSICAL,&sweep->moment_arr[i]);
+        if (ret == EXIT_SUCCESS) sweep->n_moments++;
+      }
+    }
+    close_rb5_info(&rb5_info);
+    close_rb5_cache(&cache);
+
+    if (ret != EXIT_SUCCESS) {
+      fprintf(stderr,"Error cannot decode moments of file = %s\n", ifile);
+      freeRB5Arrays(arrays);
+      return NULL;
+    }
+    return arrays;
+}
+
+//#############################################################################
+
+/*
+ * Function name: freeRB5Arrays
+ * Intent: free whatever buffers were not taken over, then the container itself
+ */
+void freeRB5Arrays(strRB5_ARRAYS* arrays) {
+    size_t s, i;
+
+    if (arrays == NULL) return;
+    for (s = 0; s < arrays->n_sweeps; s++) {
+      strRB5_SWEEP_ARRAYS *sweep=&arrays->sweep_arr[s];
+      if (sweep->angle_block            != NULL) RAVE_FREE(sweep->angle_block); //angle arrays are views
+      if (sweep->startazT_arr           != NULL) RAVE_FREE(sweep->startazT_arr);
+      for (i = 0; i < sweep->n_moments; i++) {
+        if (sweep->moment_arr[i].raw_arr  != NULL) RAVE_FREE(sweep->moment_arr[i].raw_arr);
+        if (sweep->moment_arr[i].data_arr != NULL) RAVE_FREE(sweep->moment_arr[i].data_arr);
+      }
+    }
+    RAVE_FREE(arrays);
+}
@@ -0,0 +1,68 @@
+#ifndef RB5_ARRAYS_H
+#define RB5_ARRAYS_H
+
+#include "rb52odim.h"
+
+//#############################################################################
+// one decoded moment of a sweep, nrays x nbins with the first ray pointing north
+// raw_arr/data_arr are RAVE_MALLOC'd, a consumer may take them over (and NULL them)
+typedef struct{
+    char sparam[MAX_STRING];     // RB5 name, e.g. dBZ
+    char quantity[MAX_STRING];   // ODIM name, e.g. DBZH
+    size_t nrays;
+    size_t nbins;
+    size_t raw_binary_depth;     // 8, 16 or 32 bit unsigned
+    void *raw_arr;
+    float *data_arr;             // physical values as convert_raw_to_data(), NULL unless requested
+    double gain;                 // as populateParam()
+    double offset;
+    double nodata;
+    double undetect;
+} strRB5_MOMENT_ARRAYS;
+
+//#############################################################################
+// one sweep, as populateScan() without the RAVE objects
+// moving angles are azimuths (elevations for ele scans), fixed angles the other
+typedef struct{
+    size_t nrays;
+    size_t nbins;
+    float elangle_deg;
+    float rstart_km;
+    float rscale_m;
+    long a1gate;
+    int64_t epoch_ms_bgn;
+    int64_t epoch_ms_end;
+    float *angle_block;          // strRB5_INFO.slice_angle_block, owns the four views below
+    float *moving_angle_start_arr;
+    float *moving_angle_stop_arr;
+    float *fixed_angle_start_arr;
+    float *fixed_angle_stop_arr;
+    double *startazT_arr;        // epoch seconds per ray, NULL without <timestamp> rayinfo
+    size_t n_moments;
+    strRB5_MOMENT_ARRAYS moment_arr[MAX_PARAMS];
+} strRB5_SWEEP_ARRAYS;
+
+//#############################################################################
+// a whole RB5 file, see getRB5Arrays()
+typedef struct{
+    char sensor_id[MAX_STRING];
+    char sensor_name[MAX_STRING];
+    char scan_type[MAX_STRING];
+    char scan_name[MAX_STRING];
+    char rainbow_version[MAX_STRING];
+    float sensor_lon_deg;
+    float sensor_lat_deg;
+    float sensor_alt_m;
+    float sensor_wavelength_cm;
+    float sensor_beamwidth_deg;
+    int L_TIME_ACCURACY_DOWNGRADE;
+    size_t n_sweeps;
+    strRB5_SWEEP_ARRAYS sweep_arr[MAX_SLICES];
+} strRB5_ARRAYS;
+
+//#############################################################################
+// function declarations
+strRB5_ARRAYS* getRB5Arrays(const char* ifile, int L_PHYSICAL, int L_USE_CACHE);
+void freeRB5Arrays(strRB5_ARRAYS* arrays);
+
+#endif
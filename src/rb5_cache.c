@@ -0,0 +1,364 @@
+/*
+ * rb5_cache.c
+ *
+ * Persistent cache of decoded RB5 blobs, for archives that are read over and
+ * over: the XML header and every blob, as return_param_blobid_raw() returns
+ * it (inflated, byte swapped, rotated to 0 deg N), are written once to
+ * <input>.rb5c, and later reads mmap() that file instead of inflating again.
+ * A cache is only used while the input size, mtime and the crc32 of its first
+ * bytes (the XML header) match the ones stamped in its header, and while its
+ * format and decoder versions are current. The key is taken once per read, so
+ * a hit costs a stat() and one short read of the input, not a full one.
+ *
+ * compile only: gcc -g -I/usr/include/libxml2 -c rb5_cache.c -o rb5_cache.o
+ *
+ */
+
+#include "rb5_alloc.h"
+#include "xml_utils.h"
+#include "rb5_profile.h"
+#include "rb5_cache.h"
+
+#define RB5_CACHE_ALIGNED(x) (((x) + RB5_CACHE_ALIGN - 1) & ~((uint64_t)RB5_CACHE_ALIGN - 1))
+
+_Static_assert(sizeof(strRB5_CACHE_HEADER) == 128, "strRB5_CACHE_HEADER layout");
+_Static_assert(sizeof(strRB5_CACHE_BLOB) == 64, "strRB5_CACHE_BLOB layout");
+
+//#############################################################################
+
+/*
+ * Function name: rb5_cache_key
+ * Intent: size, mtime and crc32 of the first RB5_CACHE_KEY_PREFIX bytes of the
+ *         input, what a cache is valid for
+ */
+int rb5_cache_key(const char *inp_fname, strRB5_CACHE_KEY *key) {
+    struct stat sb;
+    unsigned char prefix[RB5_CACHE_KEY_PREFIX];
+
+    memset(key,0,sizeof(strRB5_CACHE_KEY));
+    if (stat(inp_fname,&sb) != 0 || !S_ISREG(sb.st_mode)) return(EXIT_FAILURE);
+    FILE *fp=fopen(inp_fname,"rb");
+    if (fp == NULL) return(EXIT_FAILURE);
+    size_t n=fread(prefix,1,sizeof(prefix),fp);
+    int ret=ferror(fp) ? EXIT_FAILURE : EXIT_SUCCESS;
+    fclose(fp);
+
+    key->inp_size=(uint64_t)sb.st_size;
+    key->inp_mtime=(int64_t)sb.st_mtim.tv_sec;
+    key->inp_mtime_nsec=(int64_t)sb.st_mtim.tv_nsec;
+    key->inp_crc32=(uint32_t)crc32(crc32(0L,Z_NULL,0),prefix,(uInt)n);
+    return(ret);
+}
+
+/* zero fill up to an absolute offset */
+static int rb5_cache_pad(FILE *fp, uint64_t offset) {
+    static const char zeros[RB5_CACHE_ALIGN]={0};
+    long pos=ftell(fp);
+    if (pos < 0 || (uint64_t)pos > offset || offset-(uint64_t)pos > RB5_CACHE_ALIGN) return(EXIT_FAILURE);
+    return(fwrite(zeros,1,offset-(uint64_t)pos,fp) == offset-(uint64_t)pos ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+//#############################################################################
+
+int rb5_cache_fname(const char *inp_fname, char *cache_fname, size_t len) {
+    int n=snprintf(cache_fname,len,"%s%s",inp_fname,RB5_CACHE_SUFFIX);
+    return((n < 0 || (size_t)n >= len) ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+//#############################################################################
+
+/*
+ * Function name: write_rb5_cache
+ * Intent: decode every rawdata and rayinfo blob of a populated rb5_info and
+ *         write them with the XML header to cache_fname (via a temporary file
+ *         and rename(), so readers never see a partial cache), stamped with
+ *         the key of the input taken before it was read
+ */
+int write_rb5_cache(strRB5_INFO *rb5_info, const char *cache_fname, const strRB5_CACHE_KEY *key) {
+
+    strRB5_CACHE_HEADER header;
+    strRB5_PARAM_INFO rb5_param;
+    char xpath_bgn[MAX_STRING]="\0";
+    char tmp_fname[MAX_STRING*2]="\0";
+    size_t n_blobs=0;
+    size_t max_blobs=rb5_info->n_slices*(rb5_info->n_rawdatas+rb5_info->n_rayinfos);
+    size_t this_slice, k, i;
+    int ret=EXIT_SUCCESS;
+
+    if (rb5_info->buffer == NULL || max_blobs == 0) return(EXIT_FAILURE);
+    memset(&header,0,sizeof(header));
+    memcpy(header.magic,RB5_CACHE_MAGIC,sizeof(header.magic));
+    header.format_version=RB5_CACHE_FORMAT_VERSION;
+    header.decoder_version=RB5_CACHE_DECODER_VERSION;
+    header.inp_size=key->inp_size;
+    header.inp_mtime=key->inp_mtime;
+    header.inp_mtime_nsec=key->inp_mtime_nsec;
+    header.inp_crc32=key->inp_crc32;
+
+    strRB5_CACHE_BLOB *blob_arr=RAVE_MALLOC(max_blobs*sizeof(strRB5_CACHE_BLOB));
+    void **raw_arr_arr=RAVE_MALLOC(max_blobs*sizeof(void *));
+    if (blob_arr == NULL || raw_arr_arr == NULL) {
+      if (blob_arr != NULL) RAVE_FREE(blob_arr);
+      if (raw_arr_arr != NULL) RAVE_FREE(raw_arr_arr);
+      return(EXIT_FAILURE);
+    }
+    memset(blob_arr,0,max_blobs*sizeof(strRB5_CACHE_BLOB));
+
+    //decode from the buffer, whatever cache may be attached
+    void *attached_cache=rb5_info->cache;
+    rb5_info->cache=NULL;
+    for (this_slice = 0; this_slice < rb5_info->n_slices && ret == EXIT_SUCCESS; this_slice++) {
+      for (k = 0; k < rb5_info->n_rawdatas+rb5_info->n_rayinfos && ret == EXIT_SUCCESS; k++) {
+        if (k < rb5_info->n_rawdatas) {
+          sprintf(xpath_bgn,"((/volume/scan/slice)[%2ld]/slicedata/%s)[%2ld]/",this_slice+1,"rawdata",k+1);
+        } else {
+          sprintf(xpath_bgn,"((/volume/scan/slice)[%2ld]/slicedata/%s)[%2ld]/",this_slice+1,"rayinfo",k-rb5_info->n_rawdatas+1);
+        }
+        rb5_param=get_rb5_param_info(rb5_info,xpath_bgn,0);
+        void *raw_arr=NULL;
+        if (return_param_blobid_raw(rb5_info,&rb5_param,&raw_arr) == 0) {
+          if (raw_arr != NULL) RAVE_FREE(raw_arr);
+          ret=EXIT_FAILURE;
+          break;
+        }
+        strRB5_CACHE_BLOB *blob=&blob_arr[n_blobs];
+        blob->blobid=(uint32_t)rb5_param.blobid;
+        blob->slice=(int32_t)this_slice;
+        blob->iray_0degN=(int32_t)rb5_param.iray_0degN; //(size_t)-1 to -1
+        blob->raw_binary_depth=(uint32_t)rb5_param.raw_binary_depth;
+        blob->nrays=rb5_param.nrays;
+        blob->nbins=rb5_param.nbins;
+        blob->nbytes=rb5_param.n_elems_data*rb5_param.data_bytesize;
+        memcpy(blob->sparam,rb5_param.sparam,strnlen(rb5_param.sparam,sizeof(blob->sparam)-1));
+        raw_arr_arr[n_blobs++]=raw_arr;
+      }
+    }
+    rb5_info->cache=attached_cache;
+
+    //layout
+    header.n_blobs=(uint32_t)n_blobs;
+    header.buffer_len=rb5_info->buffer_len;
+    header.xml_offset=sizeof(strRB5_CACHE_HEADER);
+    header.xml_len=rb5_info->byte_offset_blobspace;
+    header.table_offset=RB5_CACHE_ALIGNED(header.xml_offset+header.xml_len);
+    uint64_t offset=RB5_CACHE_ALIGNED(header.table_offset+n_blobs*sizeof(strRB5_CACHE_BLOB));
+    for (i = 0; i < n_blobs; i++) {
+      blob_arr[i].offset=offset;
+      offset=RB5_CACHE_ALIGNED(offset+blob_arr[i].nbytes);
+    }
+    header.cache_size=offset;
+
+    FILE *fp=NULL;
+    if (ret == EXIT_SUCCESS) {
+      snprintf(tmp_fname,sizeof(tmp_fname),"%s.XXXXXX",cache_fname);
+      int fd=mkstemp(tmp_fname);
+      if (fd < 0 || (fp=fdopen(fd,"wb")) == NULL) {
+        if (fd >= 0) close(fd);
+        ret=EXIT_FAILURE;
+      }
+    }
+    if (ret == EXIT_SUCCESS) {
+      if (fwrite(&header,sizeof(header),1,fp) != 1 ||
+          fwrite(rb5_info->buffer,1,header.xml_len,fp) != header.xml_len ||
+          rb5_cache_pad(fp,header.table_offset) != EXIT_SUCCESS ||
+          fwrite(blob_arr,sizeof(strRB5_CACHE_BLOB),n_blobs,fp) != n_blobs) ret=EXIT_FAILURE;
+      for (i = 0; i < n_blobs && ret == EXIT_SUCCESS; i++) {
+        if (rb5_cache_pad(fp,blob_arr[i].offset) != EXIT_SUCCESS ||
+            fwrite(raw_arr_arr[i],1,blob_arr[i].nbytes,fp) != blob_arr[i].nbytes) ret=EXIT_FAILURE;
+      }
+      if (ret == EXIT_SUCCESS) ret=rb5_cache_pad(fp,header.cache_size);
+      if (fclose(fp) != 0) ret=EXIT_FAILURE;
+      chmod(tmp_fname,0644); //mkstemp() creates 0600
+      if (ret != EXIT_SUCCESS || rename(tmp_fname,cache_fname) != 0) {
+        unlink(tmp_fname);
+        ret=EXIT_FAILURE;
+      }
+    }
+
+    for (i = 0; i < n_blobs; i++) RAVE_FREE(raw_arr_arr[i]);
+    RAVE_FREE(raw_arr_arr);
+    RAVE_FREE(blob_arr);
+    return(ret);
+}
+
+//#############################################################################
+
+/*
+ * Function name: open_rb5_cache
+ * Intent: mmap() the cache of inp_fname, if there is one and it is still valid
+ *         for the input key and this decoder. Close with close_rb5_cache() either way.
+ */
+int open_rb5_cache(const char *inp_fname, const strRB5_CACHE_KEY *key, strRB5_CACHE *cache) {
+
+    char cache_fname[MAX_STRING*2]="\0";
+    struct stat sb;
+    size_t i;
+
+    cache->map=NULL;
+    cache->map_len=0;
+    cache->header=NULL;
+    cache->blob_arr=NULL;
+    if (rb5_cache_fname(inp_fname,cache_fname,sizeof(cache_fname)) != EXIT_SUCCESS) return(EXIT_FAILURE);
+
+    int fd=open(cache_fname,O_RDONLY);
+    if (fd < 0) return(EXIT_FAILURE);
+    if (fstat(fd,&sb) != 0 || sb.st_size < (off_t)sizeof(strRB5_CACHE_HEADER)) {
+      close(fd);
+      return(EXIT_FAILURE);
+    }
+    void *map=mmap(NULL,sb.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+    close(fd);
+    if (map == MAP_FAILED) return(EXIT_FAILURE);
+    cache->map=map;
+    cache->map_len=sb.st_size;
+
+    const strRB5_CACHE_HEADER *h=(const strRB5_CACHE_HEADER *)map;
+    int L_VALID=(memcmp(h->magic,RB5_CACHE_MAGIC,sizeof(h->magic)) == 0 &&
+                 h->format_version == RB5_CACHE_FORMAT_VERSION &&
+                 h->decoder_version == RB5_CACHE_DECODER_VERSION &&
+                 h->cache_size == cache->map_len &&
+                 h->xml_offset+h->xml_len <= cache->map_len &&
+                 h->table_offset+h->n_blobs*sizeof(strRB5_CACHE_BLOB) <= cache->map_len);
+    for (i = 0; L_VALID && i < h->n_blobs; i++) {
+      const strRB5_CACHE_BLOB *blob=(const strRB5_CACHE_BLOB *)(cache->map+h->table_offset)+i;
+      L_VALID=(blob->offset+blob->nbytes <= cache->map_len);
+    }
+    L_VALID=L_VALID && (h->inp_size == key->inp_size &&
+                        h->inp_mtime == key->inp_mtime &&
+                        h->inp_mtime_nsec == key->inp_mtime_nsec &&
+                        h->inp_crc32 == key->inp_crc32);
+    if (!L_VALID) {
+      close_rb5_cache(cache);
+      return(EXIT_FAILURE);
+    }
+    cache->header=h;
+    cache->blob_arr=(const strRB5_CACHE_BLOB *)(cache->map+h->table_offset);
+    return(EXIT_SUCCESS);
+}
+
+//#############################################################################
+
+void close_rb5_cache(strRB5_CACHE *cache) {
+    if (cache->map != NULL) munmap(cache->map,cache->map_len);
+    cache->map=NULL;
+    cache->map_len=0;
+    cache->header=NULL;
+    cache->blob_arr=NULL;
+}
+
+//#############################################################################
+
+/*
+ * Function name: return_rb5_cache_raw
+ * Intent: the cached equivalent of return_param_blobid_raw(), a copy of the
+ *         blob rotated from the stored iray_0degN to the requested one
+ */
+size_t return_rb5_cache_raw(const strRB5_CACHE *cache, strRB5_PARAM_INFO *rb5_param, void **return_raw_arr) {
+
+    size_t EXIT_NULL_VAL=0;
+    const strRB5_CACHE_BLOB *blob=NULL;
+    size_t i;
+
+    strRB5_PROFILE_MARK prof=rb5_profile_begin();
+    for (i = 0; i < cache->header->n_blobs && blob == NULL; i++) {
+      if (cache->blob_arr[i].blobid == rb5_param->blobid) blob=&cache->blob_arr[i];
+    }
+    if (blob == NULL) {
+      fprintf(stdout,"ERROR: blobid = %ld NOT FOUND in cache!!!\n",rb5_param->blobid);
+      return EXIT_NULL_VAL;
+    }
+    size_t n_elems_data=blob->nrays*blob->nbins;
+    if (rb5_param->n_elems_data != n_elems_data || rb5_param->raw_binary_depth != blob->raw_binary_depth) {
+      fprintf(stdout,"  INCONSISTENT rb5_param->n_elems_data = %ld\n",rb5_param->n_elems_data);
+      fprintf(stdout,"  INCONSISTENT n_elems_data = %ld\n",n_elems_data);
+      return EXIT_NULL_VAL;
+    }
+
+    // stored rays start at blob->iray_0degN, requested ones at rb5_param->iray_0degN
+    size_t nbytes=blob->nbytes;
+    size_t rotate_bytes=0;
+    if (blob->nrays > 0) {
+      long stored=(blob->iray_0degN < 0) ? 0 : blob->iray_0degN;
+      long requested=(rb5_param->iray_0degN == (size_t)-1) ? 0 : (long)rb5_param->iray_0degN;
+      long nrays=(long)blob->nrays;
+      rotate_bytes=(size_t)((((requested-stored) % nrays) + nrays) % nrays)*(nbytes/blob->nrays);
+    }
+    const char *src=cache->map+blob->offset;
+    char *raw_arr=RAVE_MALLOC(nbytes > 0 ? nbytes : 1);
+    if (raw_arr == NULL) return EXIT_NULL_VAL;
+    memcpy(raw_arr,src+rotate_bytes,nbytes-rotate_bytes);
+    memcpy(raw_arr+(nbytes-rotate_bytes),src,rotate_bytes);
+
+    rb5_param->size_blob=nbytes;
+    *return_raw_arr=raw_arr;
+    rb5_profile_end(RB5_PROFILE_BLOB_LOOKUP,prof,nbytes);
+    return(n_elems_data);
+}
+
+//#############################################################################
+
+/*
+ * Function name: open_rb5_info_cached
+ * Intent: open_xml_buffer() + populate_rb5_info() through the cache of inp_fname.
+ *         A valid cache provides the XML header and all blobs; otherwise the
+ *         input is decoded as usual, the cache (re)written, and the blobs of
+ *         this read are already served from it. The input key is taken once,
+ *         before the input is read. Call close_rb5_cache() after close_rb5_info().
+ */
+int open_rb5_info_cached(const char *inp_fname, strRB5_INFO *rb5_info, strRB5_CACHE *cache, int L_VERBOSE) {
+
+    strXML_FILE_INFO xml_info;
+    strRB5_PROFILE_MARK prof;
+    strRB5_CACHE_KEY key;
+    char cache_fname[MAX_STRING*2]="\0";
+
+    snprintf(rb5_info->inp_fullfile,sizeof(rb5_info->inp_fullfile),"%s",inp_fname);
+    rb5_info->passthrough=NULL;
+    int L_KEY=(rb5_cache_key(inp_fname,&key) == EXIT_SUCCESS);
+    memset(cache,0,sizeof(strRB5_CACHE));
+    if (L_KEY && open_rb5_cache(inp_fname,&key,cache) == EXIT_SUCCESS) {
+      rb5_info->buffer=NULL;
+      rb5_info->buffer_len=cache->header->buffer_len;
+      rb5_info->byte_offset_blobspace=cache->header->xml_len;
+      prof=rb5_profile_begin();
+      rb5_info->doc=xmlReadMemory(cache->map+cache->header->xml_offset,cache->header->xml_len,"noname.xml",NULL,0);
+      rb5_info->xpathCtx=(rb5_info->doc != NULL) ? xmlXPathNewContext(rb5_info->doc) : NULL;
+      rb5_profile_end(RB5_PROFILE_XML_PARSE,prof,cache->header->xml_len);
+      if (rb5_info->xpathCtx == NULL) {
+        fprintf(stderr,"Error: unable to parse cached XML of %s\n", inp_fname);
+        if (rb5_info->doc != NULL) xmlFreeDoc(rb5_info->doc);
+        close_rb5_cache(cache);
+        return(EXIT_FAILURE);
+      }
+      rb5_info->cache=cache;
+    } else {
+      snprintf(xml_info.inp_fullfile,sizeof(xml_info.inp_fullfile),"%s",rb5_info->inp_fullfile);
+      if (open_xml_buffer(&xml_info) != 0) return(EXIT_FAILURE);
+      rb5_info->buffer=xml_info.buffer;
+      rb5_info->buffer_len=xml_info.buffer_len;
+      rb5_info->byte_offset_blobspace=xml_info.byte_offset_end_of_xml;
+      rb5_info->doc=xml_info.doc;
+      rb5_info->xpathCtx=xml_info.xpathCtx;
+      rb5_info->cache=NULL;
+    }
+
+    prof=rb5_profile_begin();
+    if (populate_rb5_info(rb5_info,L_VERBOSE) != EXIT_SUCCESS) {
+      close_rb5_cache(cache);
+      return(EXIT_FAILURE);
+    }
+    rb5_profile_end(RB5_PROFILE_POPULATE_INFO,prof,rb5_info->byte_offset_blobspace);
+
+    //the fresh cache is only mmap()ed, its key is the one just written
+    if (rb5_info->cache == NULL) {
+      if (L_KEY &&
+          rb5_cache_fname(inp_fname,cache_fname,sizeof(cache_fname)) == EXIT_SUCCESS &&
+          write_rb5_cache(rb5_info,cache_fname,&key) == EXIT_SUCCESS &&
+          open_rb5_cache(inp_fname,&key,cache) == EXIT_SUCCESS) {
+        rb5_info->cache=cache;
+      } else {
+        fprintf(stderr,"Warning: cannot write cache for %s\n", inp_fname);
+      }
+    }
+    return(EXIT_SUCCESS);
+}
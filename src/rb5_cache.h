@@ -0,0 +1,81 @@
+#ifndef RB5_CACHE_H
+#define RB5_CACHE_H
+
+#include "rb5_utils.h"
+
+#include <sys/stat.h>
+#include <sys/mman.h> //mmap()
+#include <fcntl.h>
+#include <unistd.h>
+
+// decoded-blob cache, written next to the RB5 input as <input>RB5_CACHE_SUFFIX
+// layout: header | XML header of the input | blob table | blobs, each RB5_CACHE_ALIGN aligned
+// integers in host byte order, the cache is not meant to be shared across architectures
+#define RB5_CACHE_MAGIC "RB5CACHE"
+#define RB5_CACHE_FORMAT_VERSION 2  // bump when the layout below or the key changes
+#define RB5_CACHE_DECODER_VERSION 1 // bump when decoded blob contents change (byte swap, rotation, ...)
+#define RB5_CACHE_SUFFIX ".rb5c"
+#define RB5_CACHE_ALIGN 64
+#define RB5_CACHE_KEY_PREFIX 0x10000 // input bytes hashed into the key, the XML header of most files
+
+//#############################################################################
+typedef struct{
+    char magic[8];
+    uint32_t format_version;
+    uint32_t decoder_version;
+    uint64_t inp_size;        // key (strRB5_CACHE_KEY): input file size,
+    int64_t inp_mtime;        //      mtime,
+    int64_t inp_mtime_nsec;   //      its nanoseconds
+    uint32_t inp_crc32;       //      and zlib crc32 of its first RB5_CACHE_KEY_PREFIX bytes
+    uint32_t n_blobs;
+    uint64_t buffer_len;      // decoded input length, as strRB5_INFO.buffer_len
+    uint64_t xml_offset;
+    uint64_t xml_len;         // up to and including END XML
+    uint64_t table_offset;    // n_blobs strRB5_CACHE_BLOB
+    uint64_t cache_size;      // whole cache file, catches truncated writes
+    char pad[40];
+} strRB5_CACHE_HEADER;
+
+//#############################################################################
+// what a cache is valid for, taken once per read of the input
+typedef struct{
+    uint64_t inp_size;
+    int64_t inp_mtime;
+    int64_t inp_mtime_nsec;
+    uint32_t inp_crc32;
+} strRB5_CACHE_KEY;
+
+//#############################################################################
+// one blob as return_param_blobid_raw() returns it: byte swapped, rays rotated by iray_0degN
+typedef struct{
+    uint32_t blobid;
+    int32_t slice;
+    int32_t iray_0degN;       // rotation of the stored rays, -1 for none
+    uint32_t raw_binary_depth;
+    uint64_t nrays;
+    uint64_t nbins;
+    uint64_t offset;
+    uint64_t nbytes;
+    char sparam[16];          // informational
+} strRB5_CACHE_BLOB;
+
+//#############################################################################
+// an open, validated cache file
+typedef struct{
+    char *map;
+    size_t map_len;
+    const strRB5_CACHE_HEADER *header;
+    const strRB5_CACHE_BLOB *blob_arr;
+} strRB5_CACHE;
+
+//#############################################################################
+// function declarations
+int rb5_cache_fname(const char *inp_fname, char *cache_fname, size_t len);
+int rb5_cache_key(const char *inp_fname, strRB5_CACHE_KEY *key);
+int write_rb5_cache(strRB5_INFO *rb5_info, const char *cache_fname, const strRB5_CACHE_KEY *key);
+int open_rb5_cache(const char *inp_fname, const strRB5_CACHE_KEY *key, strRB5_CACHE *cache);
+void close_rb5_cache(strRB5_CACHE *cache);
+size_t return_rb5_cache_raw(const strRB5_CACHE *cache, strRB5_PARAM_INFO *rb5_param, void **return_raw_arr);
+int open_rb5_info_cached(const char *inp_fname, strRB5_INFO *rb5_info, strRB5_CACHE *cache, int L_VERBOSE);
+
+#endif
@@ -0,0 +1,204 @@
+/*
+ * rb5_compact.c
+ *
+ * Compact in-memory storage of a decoded moment, for sweeps that wait in
+ * memory before they are merged or written, e.g. in rb52odim.VolumeAssembler
+ * during multi-radar reprocessing. Clear-air sweeps are mostly undetect and
+ * nodata, so each ray is stored as runs: a run of one of the two fill codes
+ * is a single count, the codes between runs are kept as they are. Every
+ * moment is run-length encoded the same way whatever its source, rotated to
+ * 0-deg N or not; a moment that would not shrink is stored as it is.
+ *
+ * Layout after the header: per ray, tokens of 32 bits (host order), the top
+ * two bits telling what follows, the lower 30 bits a number of codes:
+ *   0  that many codes as they are
+ *   1  a run of fill[0]
+ *   2  a run of fill[1]
+ *
+ * compactScanParam() and expandScanParam() (rb5_merge.c) apply it to RAVE
+ * parameters.
+ *
+ * compile only: gcc -g -c rb5_compact.c -o rb5_compact.o
+ *
+ */
+
+#include "rb5_compact.h"
+
+#define RB5_COMPACT_TOKEN_SHIFT 30
+#define RB5_COMPACT_TOKEN_COUNT ((1U << RB5_COMPACT_TOKEN_SHIFT)-1)
+
+//#############################################################################
+
+/* appends n bytes, fails where the buffer (the size of the codes as they are) would overflow */
+static int put_bytes(unsigned char *buf, size_t *pos, size_t limit, const void *src, size_t n) {
+    if (*pos+n > limit) return(EXIT_FAILURE);
+    memcpy(buf+*pos,src,n);
+    *pos+=n;
+    return(EXIT_SUCCESS);
+}
+
+static int put_token(unsigned char *buf, size_t *pos, size_t limit, uint32_t kind, size_t count) {
+    uint32_t token=(kind << RB5_COMPACT_TOKEN_SHIFT) | (uint32_t)count;
+    return(put_bytes(buf,pos,limit,&token,sizeof(token)));
+}
+
+static int put_codes(unsigned char *buf, size_t *pos, size_t limit, const void *codes, size_t count, size_t bytes) {
+    if (put_token(buf,pos,limit,0,count) != EXIT_SUCCESS) return(EXIT_FAILURE);
+    return(put_bytes(buf,pos,limit,codes,count*bytes));
+}
+
+//#############################################################################
+
+// the runs of one ray of nbins codes of the given type; the loop is the same for all depths
+#define RB5_COMPACT_RUNS(type) { \
+    const type *arr=(const type *)raw_arr; \
+    for (iray = 0; iray < nrays && ret == EXIT_SUCCESS; iray++) { \
+      const type *ray=arr+iray*nbins; \
+      size_t ibin=0, lit=0; \
+      while (ibin < nbins && ret == EXIT_SUCCESS) { \
+        uint32_t code=ray[ibin]; \
+        uint32_t kind=(code == fill0) ? 1 : (code == fill1) ? 2 : 0; \
+        size_t run=ibin+1; \
+        if (kind == 0) { ibin++; continue; } \
+        while (run < nbins && ray[run] == ray[ibin]) run++; \
+        if (run-ibin >= RB5_COMPACT_MIN_RUN) { \
+          if (ibin > lit) ret=put_codes(buf,&pos,limit,ray+lit,ibin-lit,sizeof(type)); \
+          if (ret == EXIT_SUCCESS) ret=put_token(buf,&pos,limit,kind,run-ibin); \
+          lit=run; \
+        } \
+        ibin=run; \
+      } \
+      if (ret == EXIT_SUCCESS && nbins > lit) ret=put_codes(buf,&pos,limit,ray+lit,nbins-lit,sizeof(type)); \
+    } \
+}
+
+/*
+ * Function name: rb5_compact_encode
+ * Intent: compact copy of a moment's raw codes (nrays x nbins of depth bits,
+ *         host order); fill0 and fill1 are the codes worth run-length
+ *         encoding, any value is lossless. Returns a malloc() buffer of
+ *         size_compact bytes, NULL on failure.
+ */
+unsigned char *rb5_compact_encode(const void *raw_arr, size_t nrays, size_t nbins, size_t depth, uint32_t fill0, uint32_t fill1, size_t *size_compact) {
+
+    size_t bytes=depth/8;
+    size_t iray;
+    int ret=EXIT_SUCCESS;
+
+    *size_compact=0;
+    if (raw_arr == NULL || nrays == 0 || nbins == 0) return(NULL);
+    if (depth != 8 && depth != 16 && depth != 32) return(NULL);
+    if (nrays > UINT32_MAX || nbins > RB5_COMPACT_TOKEN_COUNT) return(NULL);
+
+    size_t size_raw=nrays*nbins*bytes;
+    size_t limit=sizeof(strRB5_COMPACT_HEADER)+size_raw;
+    unsigned char *buf=malloc(limit);
+    if (buf == NULL) return(NULL);
+    size_t pos=sizeof(strRB5_COMPACT_HEADER);
+
+           if (depth ==  8) RB5_COMPACT_RUNS(uint8_t)
+      else if (depth == 16) RB5_COMPACT_RUNS(uint16_t)
+      else                  RB5_COMPACT_RUNS(uint32_t)
+
+    strRB5_COMPACT_HEADER header;
+    memset(&header,0,sizeof(header));
+    header.magic=RB5_COMPACT_MAGIC;
+    header.stored=RB5_COMPACT_RLE;
+    header.depth=(uint32_t)depth;
+    header.nrays=(uint32_t)nrays;
+    header.nbins=(uint32_t)nbins;
+    header.fill[0]=fill0;
+    header.fill[1]=fill1;
+    if (ret != EXIT_SUCCESS) { //runs would not be smaller
+      header.stored=RB5_COMPACT_RAW;
+      pos=limit;
+      memcpy(buf+sizeof(header),raw_arr,size_raw);
+    }
+    header.size=pos;
+    memcpy(buf,&header,sizeof(header));
+
+    if (pos < limit) {
+      unsigned char *shrunk=realloc(buf,pos);
+      if (shrunk != NULL) buf=shrunk;
+    }
+    *size_compact=pos;
+    return(buf);
+
+}
+
+//#############################################################################
+
+/*
+ * Function name: rb5_compact_header
+ * Intent: header of a buffer from rb5_compact_encode(), checked against its size
+ */
+int rb5_compact_header(const unsigned char *compact, size_t size_compact, strRB5_COMPACT_HEADER *header) {
+
+    if (compact == NULL || size_compact < sizeof(strRB5_COMPACT_HEADER)) return(EXIT_FAILURE);
+    memcpy(header,compact,sizeof(strRB5_COMPACT_HEADER));
+    if (header->magic != RB5_COMPACT_MAGIC || header->size != size_compact) return(EXIT_FAILURE);
+    if (header->depth != 8 && header->depth != 16 && header->depth != 32) return(EXIT_FAILURE);
+    if (header->stored != RB5_COMPACT_RLE && header->stored != RB5_COMPACT_RAW) return(EXIT_FAILURE);
+    if (header->nrays == 0 || header->nbins == 0) return(EXIT_FAILURE);
+    return(EXIT_SUCCESS);
+
+}
+
+//#############################################################################
+
+// count codes of the given type set to code
+#define RB5_COMPACT_FILL(type) { \
+    type *out=(type *)(raw+filled*bytes); \
+    size_t i; \
+    for (i = 0; i < count; i++) out[i]=(type)code; \
+}
+
+/*
+ * Function name: rb5_compact_decode
+ * Intent: the raw codes back from a buffer of rb5_compact_encode(), into
+ *         raw_arr of size_raw bytes (nrays*nbins*depth/8)
+ */
+int rb5_compact_decode(const unsigned char *compact, size_t size_compact, void *raw_arr, size_t size_raw) {
+
+    strRB5_COMPACT_HEADER header;
+    unsigned char *raw=(unsigned char *)raw_arr;
+    size_t pos=sizeof(strRB5_COMPACT_HEADER);
+    size_t iray;
+
+    if (rb5_compact_header(compact,size_compact,&header) != EXIT_SUCCESS) return(EXIT_FAILURE);
+    size_t bytes=header.depth/8;
+    size_t nbins=header.nbins;
+    if (raw_arr == NULL || size_raw != (size_t)header.nrays*nbins*bytes) return(EXIT_FAILURE);
+
+    if (header.stored == RB5_COMPACT_RAW) {
+      if (size_compact != pos+size_raw) return(EXIT_FAILURE);
+      memcpy(raw_arr,compact+pos,size_raw);
+      return(EXIT_SUCCESS);
+    }
+
+    for (iray = 0; iray < header.nrays; iray++) {
+      size_t filled=iray*nbins, end=filled+nbins;
+      while (filled < end) {
+        uint32_t token;
+        if (pos+sizeof(token) > size_compact) return(EXIT_FAILURE);
+        memcpy(&token,compact+pos,sizeof(token));
+        pos+=sizeof(token);
+        uint32_t kind=token >> RB5_COMPACT_TOKEN_SHIFT;
+        size_t count=token & RB5_COMPACT_TOKEN_COUNT;
+        if (count == 0 || count > end-filled || kind > 2) return(EXIT_FAILURE);
+        if (kind == 0) {
+          if (pos+count*bytes > size_compact) return(EXIT_FAILURE);
+          memcpy(raw+filled*bytes,compact+pos,count*bytes);
+          pos+=count*bytes;
+        } else {
+          uint32_t code=header.fill[kind-1];
+                 if (bytes == 1) RB5_COMPACT_FILL(uint8_t)
+            else if (bytes == 2) RB5_COMPACT_FILL(uint16_t)
+            else                 RB5_COMPACT_FILL(uint32_t)
+        }
+        filled+=count;
+      }
+    }
+    return(pos == size_compact ? EXIT_SUCCESS : EXIT_FAILURE);
+
+}
@@ -0,0 +1,35 @@
+#ifndef RB5_COMPACT_H
+#define RB5_COMPACT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+//#############################################################################
+// a moment's raw codes (nrays x nbins, host order) kept compact in memory:
+// per ray, runs of the fill codes (undetect and nodata) become one count,
+// everything else is kept as it is; one malloc() buffer, header first
+#define RB5_COMPACT_MAGIC 0x43354252 // "RB5C"
+#define RB5_COMPACT_RLE 1            // per-ray runs, see rb5_compact.c
+#define RB5_COMPACT_RAW 2            // codes as they are, runs would not be smaller
+#define RB5_COMPACT_MIN_RUN 8        // shorter fill runs stay within the codes around them
+
+typedef struct{
+    uint32_t magic;
+    uint32_t stored;    // RB5_COMPACT_RLE or RB5_COMPACT_RAW
+    uint32_t depth;     // bits per code, 8, 16 or 32
+    uint32_t nrays;
+    uint32_t nbins;
+    uint32_t fill[2];   // run-length encoded codes, e.g. undetect and nodata
+    uint32_t reserved;
+    uint64_t size;      // bytes of the whole buffer, header included
+} strRB5_COMPACT_HEADER;
+
+//#############################################################################
+// function declarations
+unsigned char *rb5_compact_encode(const void *raw_arr, size_t nrays, size_t nbins, size_t depth, uint32_t fill0, uint32_t fill1, size_t *size_compact);
+int rb5_compact_header(const unsigned char *compact, size_t size_compact, strRB5_COMPACT_HEADER *header);
+int rb5_compact_decode(const unsigned char *compact, size_t size_compact, void *raw_arr, size_t size_raw);
+
+#endif
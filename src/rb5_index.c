@@ -0,0 +1,476 @@
+/*
+ * rb5_index.c
+ *
+ * Metadata catalog of RB5 archives. Only the XML header of each file is
+ * read: reading (and, for .gz files, inflating) stops as soon as the
+ * <!-- END XML --> marker has been seen, so no blob is ever touched.
+ * One record per file is kept as a tab-separated line, sorted by sensor
+ * id and scan time, and queries on the index never open the RB5 files:
+ *
+ *   sensor_id  datetime  scan_type  scan_name  sdf  angles_deg  moment:bytes,...  xml_bytes  path
+ *
+ * The catalog is built by a pool of worker threads over any number of files.
+ *
+ * compile only: gcc -g -I/usr/include/libxml2 -c rb5_index.c -o rb5_index.o
+ *
+ */
+
+#include "rb5_index.h"
+#include "rb5_profile.h"
+
+#include <unistd.h> //unlink()
+
+#define RB5_INDEX_BATCH 64 // files handed to a worker at a time
+#define RB5_INDEX_NFIELDS 9
+
+static const char END_XML_MARKER[]="<!-- END XML -->";
+
+//#############################################################################
+// shared state of build_rb5_index() workers
+typedef struct{
+    char **path_arr;
+    char **line_arr;  // one formatted record per path, NULL if it failed
+    size_t n_paths;
+    size_t next;      // next path to hand out
+    size_t n_failed;
+    pthread_mutex_t lock;
+} strRB5_INDEX_BUILD;
+
+//#############################################################################
+
+/*
+ * Reads a (gz-compressed) RB5 file up to and including the END XML marker,
+ * into a NUL-terminated rb5_mem_malloc() buffer. Reading stops at the first chunk
+ * holding the marker, the blobs that follow are not inflated. Returns the
+ * number of bytes read, 0 if this is not an RB5 header.
+ */
+size_t read_rb5_header_2_buffer(const char *inp_fname, char **return_buffer) {
+
+    size_t EXIT_NULL_VAL=0;
+    size_t marker_len=strlen(END_XML_MARKER);
+    size_t buffer_size=RB5_INDEX_CHUNK;
+    size_t buffer_len=0;
+    strRB5_PROFILE_MARK prof=rb5_profile_begin();
+
+    gzFile fp=gzopen(inp_fname, "r");
+    if (! fp) {
+        fprintf(stderr,"gzopen of '%s' failed: %s.\n", inp_fname, strerror(errno));
+        return(EXIT_NULL_VAL);
+    }
+    gzbuffer(fp,RB5_INDEX_CHUNK);
+
+    char *buffer=rb5_mem_malloc(buffer_size+1);
+    while (buffer != NULL) {
+        int bytes_read=gzread(fp,buffer+buffer_len,buffer_size-buffer_len);
+        if (bytes_read <= 0) {
+            fprintf(stderr,"Error: no END XML marker in %s\n", inp_fname);
+            break;
+        }
+        //the marker may straddle two reads
+        size_t search_from=buffer_len > marker_len ? buffer_len-marker_len : 0;
+        buffer_len+=bytes_read;
+        buffer[buffer_len]='\0';
+
+        if (search_from == 0 && strstr(buffer,"<volume") == NULL) {
+            fprintf(stderr,"Error: %s is not an RB5 raw file\n", inp_fname);
+            break;
+        }
+        if (strstr(buffer+search_from,END_XML_MARKER) != NULL) {
+            gzclose(fp);
+            *return_buffer=buffer;
+            rb5_profile_end(RB5_PROFILE_GZ_READ,prof,buffer_len);
+            return(buffer_len);
+        }
+        if (buffer_len == buffer_size) {
+            if (buffer_size >= RB5_INDEX_MAX_XML) {
+                fprintf(stderr,"Error: no END XML marker in the first %d bytes of %s\n", RB5_INDEX_MAX_XML, inp_fname);
+                break;
+            }
+            buffer_size*=2;
+            char *grown=rb5_mem_realloc(buffer,buffer_size+1);
+            if (grown == NULL) rb5_mem_free(buffer);
+            buffer=grown;
+        }
+    }
+    if (buffer == NULL) fprintf(stderr,"Error: cannot allocate %ld bytes for %s\n", buffer_size, inp_fname);
+    rb5_mem_free(buffer);
+    gzclose(fp);
+    return(EXIT_NULL_VAL);
+}
+
+//#############################################################################
+
+/* copies an xpath value, empty if missing */
+static void copy_xpath_value(const xmlXPathContextPtr xpathCtx, char *xpath, char *dst, size_t len) {
+    char *value=return_xpath_value(xpathCtx,xpath);
+    snprintf(dst,len,"%s",value ? value : "");
+}
+
+/* slice value, inherited from the first slice when absent (cf. get_xpath_slice_attrib()) */
+static void copy_slice_value(const xmlXPathContextPtr xpathCtx, size_t this_slice, char *xpath_end, char *dst, size_t len) {
+    char xpath[MAX_STRING]="\0";
+    snprintf(xpath,MAX_STRING,"(/volume/scan/slice)[%ld]%s",this_slice+1,xpath_end);
+    if (get_xpath_size(xpathCtx,xpath) == 0) {
+        snprintf(xpath,MAX_STRING,"(/volume/scan/slice)[1]%s",xpath_end);
+    }
+    copy_xpath_value(xpathCtx,xpath,dst,len);
+}
+
+/* index of a moment in the entry, appended if new, -1 if full */
+static int find_rb5_index_moment(strRB5_INDEX_ENTRY *entry, const char *sparam) {
+    size_t i;
+    for (i = 0; i < entry->n_moments; i++) {
+        if (strcmp(entry->moment_arr[i],sparam) == 0) return(i);
+    }
+    if (entry->n_moments == MAX_PARAMS) return(-1);
+    snprintf(entry->moment_arr[entry->n_moments],MAX_NSTRINGS,"%s",sparam);
+    entry->moment_bytes[entry->n_moments]=0;
+    return(entry->n_moments++);
+}
+
+static int populate_rb5_index_entry(const xmlXPathContextPtr xpathCtx, strRB5_INDEX_ENTRY *entry) {
+
+    char xpath[MAX_STRING]="\0";
+    char stmpa[MAX_STRING]="\0";
+    char stmpb[MAX_STRING]="\0";
+
+    if (strcmp(return_xpath_name(xpathCtx,"/*[1]"),"volume") != 0) {
+        fprintf(stderr,"Error: This is not a Rainbow raw file, expecting <volume> in %s\n", entry->path);
+        return(EXIT_FAILURE);
+    }
+    copy_xpath_value(xpathCtx,"/volume/@type",entry->scan_type,MAX_NSTRINGS);
+    copy_xpath_value(xpathCtx,"/volume/sensorinfo/@id",entry->sensor_id,MAX_STRING);
+
+    //scan start, as the basis of the file name (cf. slice_iso8601_bgn)
+    copy_xpath_value(xpathCtx,"/volume/scan/@datetimehighaccuracy",stmpa,MAX_STRING);
+    if (stmpa[0] == '\0') {
+        copy_xpath_value(xpathCtx,"/volume/scan/@date",stmpa,MAX_STRING);
+        copy_xpath_value(xpathCtx,"/volume/scan/@time",stmpb,MAX_STRING);
+        strcat(strcat(stmpa," "),stmpb);
+    }
+    if (func_iso8601_2_epoch_ms(stmpa,&entry->epoch_ms) != EXIT_SUCCESS) {
+        fprintf(stderr,"Error: no scan datetime in %s\n", entry->path);
+        return(EXIT_FAILURE);
+    }
+
+    //scan name is "<name>.<type>"
+    copy_xpath_value(xpathCtx,"/volume/scan/@name",stmpa,MAX_STRING);
+    size_t name_len=strlen(stmpa);
+    size_t type_len=strlen(entry->scan_type);
+    if (name_len > type_len && stmpa[name_len-type_len-1] == '.' && strcmp(stmpa+name_len-type_len,entry->scan_type) == 0) {
+        name_len-=type_len+1;
+    }
+    snprintf(entry->scan_name,MAX_STRING,"%.*s",(int)name_len,stmpa);
+    copy_xpath_value(xpathCtx,"/volume/history/@sdfname",entry->sdf,MAX_STRING);
+    if (entry->sdf[0] == '\0') snprintf(entry->sdf,MAX_STRING,"%s",stmpa);
+
+    entry->n_slices=get_xpath_size(xpathCtx,"/volume/scan/slice");
+    if (entry->n_slices > MAX_SLICES) {
+        fprintf(stderr,"Warning: only the first %d of %ld slices indexed in %s\n", MAX_SLICES, entry->n_slices, entry->path);
+        entry->n_slices=MAX_SLICES;
+    }
+
+    size_t this_slice;
+    for (this_slice = 0; this_slice < entry->n_slices; this_slice++) {
+        copy_slice_value(xpathCtx,this_slice,"/posangle",stmpa,MAX_STRING);
+        entry->angle_deg_arr[this_slice]=atof(stmpa);
+
+        //decoded blob size of each moment: rays * bins * depth
+        char xpath_bgn[MAX_NSTRINGS*2]="\0";
+        snprintf(xpath_bgn,sizeof(xpath_bgn),"(/volume/scan/slice)[%ld]/slicedata/rawdata",this_slice+1);
+        size_t n_rawdatas=get_xpath_size(xpathCtx,xpath_bgn);
+        size_t this_rawdata;
+        for (this_rawdata = 0; this_rawdata < n_rawdatas; this_rawdata++) {
+            snprintf(xpath,MAX_STRING,"(%s)[%ld]/@type",xpath_bgn,this_rawdata+1);
+            copy_xpath_value(xpathCtx,xpath,stmpa,MAX_STRING);
+            int i=find_rb5_index_moment(entry,stmpa);
+            if (i < 0) continue;
+            snprintf(xpath,MAX_STRING,"(%s)[%ld]/@rays",xpath_bgn,this_rawdata+1);
+            copy_xpath_value(xpathCtx,xpath,stmpa,MAX_STRING);
+            size_t nrays=atol(stmpa);
+            snprintf(xpath,MAX_STRING,"(%s)[%ld]/@bins",xpath_bgn,this_rawdata+1);
+            copy_xpath_value(xpathCtx,xpath,stmpa,MAX_STRING);
+            size_t nbins=atol(stmpa);
+            snprintf(xpath,MAX_STRING,"(%s)[%ld]/@depth",xpath_bgn,this_rawdata+1);
+            copy_xpath_value(xpathCtx,xpath,stmpa,MAX_STRING);
+            size_t depth=atol(stmpa);
+            entry->moment_bytes[i]+=nrays*nbins*depth/8;
+        }
+    }
+    return(EXIT_SUCCESS);
+}
+
+//#############################################################################
+
+int read_rb5_index_entry(const char *inp_fname, strRB5_INDEX_ENTRY *entry) {
+
+    memset(entry,0,sizeof(strRB5_INDEX_ENTRY));
+    if ((size_t)snprintf(entry->path,RB5_INDEX_PATH_LEN,"%s",inp_fname) >= RB5_INDEX_PATH_LEN ||
+        strpbrk(inp_fname,"\t\n") != NULL) {
+        fprintf(stderr,"Error: cannot index path %s\n", inp_fname);
+        return(EXIT_FAILURE);
+    }
+
+    char *buffer=NULL;
+    size_t buffer_len=read_rb5_header_2_buffer(inp_fname,&buffer);
+    if (buffer_len == 0) return(EXIT_FAILURE);
+
+    //find end of XML, its trailing \n may not have been read
+    size_t xml_len=find_buffer_end_of_xml(buffer);
+    entry->xml_bytes=xml_len;
+    if (xml_len > buffer_len) xml_len=buffer_len;
+
+    // parse the XML and get the DOM
+    strRB5_PROFILE_MARK prof=rb5_profile_begin();
+    xmlDoc *doc=xmlReadMemory(buffer, xml_len, "noname.xml", NULL, 0);
+    xmlXPathContextPtr xpathCtx=doc ? xmlXPathNewContext(doc) : NULL;
+    rb5_profile_end(RB5_PROFILE_XML_PARSE,prof,xml_len);
+
+    int ret=EXIT_FAILURE;
+    if (xpathCtx == NULL) {
+        fprintf(stderr,"Error: cannot parse XML header of %s\n", inp_fname);
+    } else {
+        prof=rb5_profile_begin();
+        ret=populate_rb5_index_entry(xpathCtx,entry);
+        rb5_profile_end(RB5_PROFILE_POPULATE_INFO,prof,xml_len);
+    }
+
+    if (xpathCtx != NULL) xmlXPathFreeContext(xpathCtx);
+    if (doc != NULL) xmlFreeDoc(doc);
+    rb5_mem_free(buffer);
+    return(ret);
+}
+
+//#############################################################################
+
+/* one index line, without trailing newline */
+int format_rb5_index_entry(const strRB5_INDEX_ENTRY *entry, char *line, size_t len) {
+
+    char iso8601[MAX_ISO8601_STRING+1];
+    func_epoch_ms_2_iso8601(entry->epoch_ms,iso8601);
+    iso8601[10]='T';
+
+    size_t n=snprintf(line,len,"%s\t%sZ\t%s\t%s\t%s\t",
+        entry->sensor_id,iso8601,entry->scan_type,entry->scan_name,entry->sdf);
+    size_t i;
+    for (i = 0; i < entry->n_slices && n < len; i++) {
+        n+=snprintf(line+n,len-n,"%s%.2f",i ? "," : "",entry->angle_deg_arr[i]);
+    }
+    if (n < len) n+=snprintf(line+n,len-n,"\t");
+    for (i = 0; i < entry->n_moments && n < len; i++) {
+        n+=snprintf(line+n,len-n,"%s%s:%ld",i ? "," : "",entry->moment_arr[i],entry->moment_bytes[i]);
+    }
+    if (n < len) n+=snprintf(line+n,len-n,"\t%ld\t%s",entry->xml_bytes,entry->path);
+    if (n >= len) {
+        fprintf(stderr,"Error: index record too long for %s\n", entry->path);
+        return(EXIT_FAILURE);
+    }
+    return(EXIT_SUCCESS);
+}
+
+//#############################################################################
+
+int parse_rb5_index_line(const char *line, strRB5_INDEX_ENTRY *entry) {
+
+    char buf[RB5_INDEX_LINE_LEN];
+    char *field_arr[RB5_INDEX_NFIELDS];
+    int nFIELDs=0;
+
+    memset(entry,0,sizeof(strRB5_INDEX_ENTRY));
+    if (line[0] == '#' || (size_t)snprintf(buf,RB5_INDEX_LINE_LEN,"%s",line) >= RB5_INDEX_LINE_LEN) return(EXIT_FAILURE);
+    buf[strcspn(buf,"\r\n")]='\0';
+
+    //empty fields are significant, no strtok()
+    char *p=buf;
+    while (nFIELDs < RB5_INDEX_NFIELDS) {
+        field_arr[nFIELDs++]=p;
+        p=strchr(p,'\t');
+        if (p == NULL) break;
+        *p++='\0';
+    }
+    if (nFIELDs != RB5_INDEX_NFIELDS || p != NULL) return(EXIT_FAILURE);
+
+    snprintf(entry->sensor_id,MAX_STRING,"%s",field_arr[0]);
+    if (func_iso8601_2_epoch_ms(field_arr[1],&entry->epoch_ms) != EXIT_SUCCESS) return(EXIT_FAILURE);
+    snprintf(entry->scan_type,MAX_NSTRINGS,"%s",field_arr[2]);
+    snprintf(entry->scan_name,MAX_STRING,"%s",field_arr[3]);
+    snprintf(entry->sdf,MAX_STRING,"%s",field_arr[4]);
+
+    for (p = field_arr[5]; *p != '\0' && entry->n_slices < MAX_SLICES; p+=(*p == ',')) {
+        char *end=NULL;
+        entry->angle_deg_arr[entry->n_slices++]=strtof(p,&end);
+        if (end == p) return(EXIT_FAILURE);
+        p=end;
+    }
+    for (p = field_arr[6]; *p != '\0' && entry->n_moments < MAX_PARAMS; p+=(*p == ',')) {
+        char *colon=strchr(p,':');
+        if (colon == NULL) return(EXIT_FAILURE);
+        snprintf(entry->moment_arr[entry->n_moments],MAX_NSTRINGS,"%.*s",(int)(colon-p),p);
+        entry->moment_bytes[entry->n_moments++]=strtoul(colon+1,&p,10);
+    }
+
+    entry->xml_bytes=strtoul(field_arr[7],NULL,10);
+    snprintf(entry->path,RB5_INDEX_PATH_LEN,"%s",field_arr[8]);
+    return(EXIT_SUCCESS);
+}
+
+//#############################################################################
+
+void init_rb5_index_query(strRB5_INDEX_QUERY *query) {
+
+    query->sensor_id=NULL;
+    query->epoch_ms_bgn=INT64_MIN;
+    query->epoch_ms_end=INT64_MAX;
+    query->moment=NULL;
+}
+
+/* 1 if the entry is selected by the query */
+int match_rb5_index_entry(const strRB5_INDEX_ENTRY *entry, const strRB5_INDEX_QUERY *query) {
+
+    if (query->sensor_id != NULL && strcmp(entry->sensor_id,query->sensor_id) != 0) return(0);
+    if (entry->epoch_ms < query->epoch_ms_bgn || entry->epoch_ms >= query->epoch_ms_end) return(0);
+    if (query->moment == NULL) return(1);
+    size_t i;
+    for (i = 0; i < entry->n_moments; i++) {
+        if (strcmp(entry->moment_arr[i],query->moment) == 0) return(1);
+    }
+    return(0);
+}
+
+//#############################################################################
+
+static void *build_rb5_index_worker(void *arg) {
+
+    strRB5_INDEX_BUILD *build=(strRB5_INDEX_BUILD *)arg;
+    strRB5_INDEX_ENTRY *entry=rb5_mem_malloc(sizeof(strRB5_INDEX_ENTRY));
+    char line[RB5_INDEX_LINE_LEN];
+    size_t n_failed=0;
+
+    while (entry != NULL) {
+        pthread_mutex_lock(&build->lock);
+        size_t bgn=build->next;
+        build->next+=RB5_INDEX_BATCH;
+        pthread_mutex_unlock(&build->lock);
+        if (bgn >= build->n_paths) break;
+
+        size_t end=bgn+RB5_INDEX_BATCH < build->n_paths ? bgn+RB5_INDEX_BATCH : build->n_paths;
+        size_t i;
+        for (i = bgn; i < end; i++) {
+            if (read_rb5_index_entry(build->path_arr[i],entry) == EXIT_SUCCESS &&
+                format_rb5_index_entry(entry,line,RB5_INDEX_LINE_LEN) == EXIT_SUCCESS) {
+                build->line_arr[i]=rb5_mem_strdup(line);
+            }
+            if (build->line_arr[i] == NULL) n_failed++;
+        }
+    }
+    rb5_mem_free(entry);
+
+    pthread_mutex_lock(&build->lock);
+    build->n_failed+=n_failed;
+    pthread_mutex_unlock(&build->lock);
+    return(NULL);
+}
+
+static int compare_rb5_index_lines(const void *a, const void *b) {
+    return(strcmp(*(char * const *)a,*(char * const *)b));
+}
+
+/*
+ * Indexes the RB5 files in path_arr with nworkers threads and writes the
+ * sorted catalog to out_fname, via a temporary file and rename(). Files
+ * that cannot be indexed are reported and left out.
+ */
+int build_rb5_index(char **path_arr, size_t n_paths, const char *out_fname, int nworkers) {
+
+    strRB5_INDEX_BUILD build;
+    pthread_t thread_arr[RB5_INDEX_MAX_WORKERS];
+    int nthreads=0;
+    int ret=EXIT_FAILURE;
+
+    if (nworkers < 1) nworkers=1;
+    if (nworkers > RB5_INDEX_MAX_WORKERS) nworkers=RB5_INDEX_MAX_WORKERS;
+
+    memset(&build,0,sizeof(strRB5_INDEX_BUILD));
+    build.path_arr=path_arr;
+    build.n_paths=n_paths;
+    build.line_arr=rb5_mem_calloc(n_paths ? n_paths : 1,sizeof(char *));
+    if (build.line_arr == NULL) {
+        fprintf(stderr,"Error: cannot allocate index of %ld files\n", n_paths);
+        return(EXIT_FAILURE);
+    }
+    pthread_mutex_init(&build.lock,NULL);
+
+    xmlInitParser(); //once, before any worker parses
+    while (nthreads < nworkers) {
+        if (pthread_create(&thread_arr[nthreads],NULL,build_rb5_index_worker,&build) != 0) break;
+        nthreads++;
+    }
+    if (nthreads == 0) build_rb5_index_worker(&build);
+    int i;
+    for (i = 0; i < nthreads; i++) pthread_join(thread_arr[i],NULL);
+    pthread_mutex_destroy(&build.lock);
+
+    //sensor id, then scan time, then path
+    size_t n_lines=0;
+    size_t k;
+    for (k = 0; k < n_paths; k++) {
+        if (build.line_arr[k] != NULL) build.line_arr[n_lines++]=build.line_arr[k];
+    }
+    qsort(build.line_arr,n_lines,sizeof(char *),compare_rb5_index_lines);
+
+    char tmpfile[RB5_INDEX_PATH_LEN+8];
+    snprintf(tmpfile,sizeof(tmpfile),"%s.tmp",out_fname);
+    FILE *fp=fopen(tmpfile,"w");
+    if (fp == NULL) {
+        fprintf(stderr,"Error: cannot create %s: %s\n", tmpfile, strerror(errno));
+    } else {
+        fprintf(fp,"#rb5_index\t%d\tsensor_id\tdatetime\tscan_type\tscan_name\tsdf\tangles_deg\tmoment:bytes\txml_bytes\tpath\n", RB5_INDEX_VERSION);
+        for (k = 0; k < n_lines; k++) fprintf(fp,"%s\n",build.line_arr[k]);
+        if (fclose(fp) != 0 || rename(tmpfile,out_fname) != 0) {
+            fprintf(stderr,"Error: cannot write %s: %s\n", out_fname, strerror(errno));
+            unlink(tmpfile);
+        } else {
+            fprintf(stdout,"Indexed : %s (%ld files, %ld failed)\n", out_fname, n_lines, build.n_failed);
+            ret=EXIT_SUCCESS;
+        }
+    }
+
+    for (k = 0; k < n_lines; k++) rb5_mem_free(build.line_arr[k]);
+    rb5_mem_free(build.line_arr);
+    return(ret);
+}
+
+//#############################################################################
+
+/*
+ * Writes the index lines (or only their paths) selected by the query to
+ * out. Returns the number of matches, -1 if the index cannot be read.
+ */
+long query_rb5_index(const char *index_fname, const strRB5_INDEX_QUERY *query, int L_PATHS_ONLY, FILE *out) {
+
+    FILE *fp=fopen(index_fname,"r");
+    if (fp == NULL) {
+        fprintf(stderr,"Error: cannot open index %s: %s\n", index_fname, strerror(errno));
+        return(-1);
+    }
+
+    strRB5_INDEX_ENTRY *entry=rb5_mem_malloc(sizeof(strRB5_INDEX_ENTRY));
+    char *line=NULL;
+    size_t line_size=0;
+    long n_matches=0;
+    while (entry != NULL && getline(&line,&line_size,fp) != -1) {
+        if (line[0] == '#') continue;
+        if (parse_rb5_index_line(line,entry) != EXIT_SUCCESS) {
+            fprintf(stderr,"Warning: skipping bad index line in %s\n", index_fname);
+            continue;
+        }
+        if (!match_rb5_index_entry(entry,query)) continue;
+        if (L_PATHS_ONLY) fprintf(out,"%s\n",entry->path);
+        else              fputs(line,out);
+        n_matches++;
+    }
+    free(line); //getline()'s
+    rb5_mem_free(entry);
+    fclose(fp);
+    return(n_matches);
+}
@@ -0,0 +1,57 @@
+#ifndef RB5_INDEX_H
+#define RB5_INDEX_H
+
+#include "time_utils.h"
+#include "xml_utils.h"
+#include "rb5_utils.h"
+#include "rb5_memtrack.h" //index buffers are rb5_mem_*(), counted by --memtrack
+
+#include <sys/stat.h>
+#include <pthread.h> //add -lpthread to compile
+
+#define RB5_INDEX_VERSION 1
+#define RB5_INDEX_PATH_LEN 1024
+#define RB5_INDEX_LINE_LEN 4096
+#define RB5_INDEX_MAX_WORKERS 64
+#define RB5_INDEX_MAX_XML 0x1000000 // give up on files without END XML marker
+#define RB5_INDEX_CHUNK 0x4000      // first header read, doubled as needed
+
+//#############################################################################
+// catalog record of one RB5 file, from its XML header only
+// one tab-separated line in the index file, see format_rb5_index_entry()
+typedef struct{
+    char sensor_id[MAX_STRING];
+    int64_t epoch_ms;            // scan start, /volume/scan/@datetimehighaccuracy
+    char scan_type[MAX_NSTRINGS];
+    char scan_name[MAX_STRING];
+    char sdf[MAX_STRING];        // history/@sdfname, else scan/@name
+    size_t n_slices;
+    float angle_deg_arr[MAX_SLICES];
+    size_t n_moments;
+    char moment_arr[MAX_PARAMS][MAX_NSTRINGS];
+    size_t moment_bytes[MAX_PARAMS]; // decoded blob bytes over all slices
+    size_t xml_bytes;            // header length, up to and including END XML
+    char path[RB5_INDEX_PATH_LEN];
+} strRB5_INDEX_ENTRY;
+
+//#############################################################################
+// selection on an index file, NULL or open bounds match everything
+typedef struct{
+    const char *sensor_id;
+    int64_t epoch_ms_bgn; // inclusive
+    int64_t epoch_ms_end; // exclusive
+    const char *moment;
+} strRB5_INDEX_QUERY;
+
+//#############################################################################
+// function declarations
+size_t read_rb5_header_2_buffer(const char *inp_fname, char **return_buffer); //rb5_mem_free() the buffer
+int read_rb5_index_entry(const char *inp_fname, strRB5_INDEX_ENTRY *entry);
+int format_rb5_index_entry(const strRB5_INDEX_ENTRY *entry, char *line, size_t len);
+int parse_rb5_index_line(const char *line, strRB5_INDEX_ENTRY *entry);
+void init_rb5_index_query(strRB5_INDEX_QUERY *query);
+int match_rb5_index_entry(const strRB5_INDEX_ENTRY *entry, const strRB5_INDEX_QUERY *query);
+int build_rb5_index(char **path_arr, size_t n_paths, const char *out_fname, int nworkers);
+long query_rb5_index(const char *index_fname, const strRB5_INDEX_QUERY *query, int L_PATHS_ONLY, FILE *out);
+
+#endif
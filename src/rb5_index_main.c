@@ -0,0 +1,164 @@
+/* --------------------------------------------------------------------
+Copyright (C) 2016 The Crown (i.e. Her Majesty the Queen in Right of Canada)
+
+This file is part of RAVE.
+
+RAVE is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+RAVE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with RAVE.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------*/
+/**
+ * Command-line binary "rb5_index", header-only catalog of RB5 archives
+ * @file src/rb5_index_main.c
+ * @author rb52odim contributors
+ * @date 2026-10-19
+ *
+ * Compile:
+ *   make -f Makefile.w_rb5_2_odim_main
+ *
+ * Build an index over files and directories (recursed), or a list of paths on stdin:
+ * ./rb5_index -o archive.idx --workers 8 ../test/org
+ * find /data/rb5 -name '*.vol.gz' | ./rb5_index -o archive.idx -
+ *
+ * Query it, without touching the RB5 files (--from inclusive, --to exclusive):
+ * ./rb5_index -q archive.idx --site CASRA --from 2017-12-15T20:00:00 --to 2017-12-15T20:10:00 --moment KDP
+ * ./rb5_index -q archive.idx --site CASRA --paths | xargs -n1 ./rb5_2_odim ...
+ */
+
+#define _GNU_SOURCE //nftw()
+#include "rb5_index.h"
+
+#include <ftw.h>
+
+//paths collected from the command line, stdin and directory walks
+static char **path_arr=NULL;
+static size_t n_paths=0;
+static size_t max_paths=0;
+
+static int add_path(const char *path) {
+    if (n_paths == max_paths) {
+        size_t grown_max=max_paths ? max_paths*2 : 1024;
+        char **grown=realloc(path_arr,grown_max*sizeof(char *));
+        if (grown == NULL) return(EXIT_FAILURE);
+        path_arr=grown;
+        max_paths=grown_max;
+    }
+    path_arr[n_paths]=strdup(path);
+    return(path_arr[n_paths++] ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+/* *.vol, *.azi, *.ele, optionally .gz, but no tarballs or dot files */
+static int is_rb5_name(const char *name) {
+    size_t len=strlen(name);
+    if (name[0] == '.') return(0);
+    if (len > 3 && strcmp(name+len-3,".gz") == 0) len-=3;
+    if (len < 4) return(0);
+    return(strncmp(name+len-4,".vol",4) == 0 || strncmp(name+len-4,".azi",4) == 0 || strncmp(name+len-4,".ele",4) == 0);
+}
+
+static int walk_path(const char *fpath, const struct stat *sb, int typeflag, struct FTW *ftwbuf) {
+    (void)sb;
+    if (typeflag == FTW_F && is_rb5_name(fpath+ftwbuf->base)) return(add_path(fpath) == EXIT_SUCCESS ? 0 : -1);
+    return(0);
+}
+
+int main(int argc,char *argv[]) {
+    int RETURN_FAILURE = -1;
+    int i;
+    const char *ofile=NULL, *qfile=NULL;
+    int nworkers=4;
+    int L_PATHS_ONLY=0;
+    strRB5_INDEX_QUERY query;
+    const char *usage="usage: %s -o index_file [--workers N] RB5_file|RB5_dir|- ...\n"
+                      "       %s -q index_file [--site ID] [--from ISO8601] [--to ISO8601] [--moment NAME] [--paths]\n";
+
+    init_rb5_index_query(&query);
+    for (i=1;i<argc;i++) {
+      if ((strcmp(argv[i], "-o") == 0) && (i+1 < argc)) {
+        i++;
+        ofile = argv[i];
+      }
+      else if ((strcmp(argv[i], "-q") == 0) && (i+1 < argc)) {
+        i++;
+        qfile = argv[i];
+      }
+      else if ((strcmp(argv[i], "--workers") == 0) && (i+1 < argc)) {
+        i++;
+        nworkers = atoi(argv[i]);
+      }
+      else if ((strcmp(argv[i], "--site") == 0) && (i+1 < argc)) {
+        i++;
+        query.sensor_id = argv[i];
+      }
+      else if ((strcmp(argv[i], "--from") == 0) && (i+1 < argc)) {
+        i++;
+        if (func_iso8601_2_epoch_ms(argv[i],&query.epoch_ms_bgn) != EXIT_SUCCESS) {
+          fprintf(stderr,"Error: --from %s is not YYYY-mm-ddTHH:MM:SS\n", argv[i]);
+          return RETURN_FAILURE;
+        }
+      }
+      else if ((strcmp(argv[i], "--to") == 0) && (i+1 < argc)) {
+        i++;
+        if (func_iso8601_2_epoch_ms(argv[i],&query.epoch_ms_end) != EXIT_SUCCESS) {
+          fprintf(stderr,"Error: --to %s is not YYYY-mm-ddTHH:MM:SS\n", argv[i]);
+          return RETURN_FAILURE;
+        }
+      }
+      else if ((strcmp(argv[i], "--moment") == 0) && (i+1 < argc)) {
+        i++;
+        query.moment = argv[i];
+      }
+      else if (strcmp(argv[i], "--paths") == 0) {
+        L_PATHS_ONLY=1;
+      }
+      else if (ofile != NULL && argv[i][0] != '-') {
+        struct stat sb;
+        int ret=(stat(argv[i],&sb) == 0 && S_ISDIR(sb.st_mode)) ? nftw(argv[i],walk_path,64,FTW_PHYS) : add_path(argv[i]);
+        if (ret != 0) {
+          fprintf(stderr,"Error: cannot collect %s\n", argv[i]);
+          return RETURN_FAILURE;
+        }
+      }
+      else if (ofile != NULL && strcmp(argv[i], "-") == 0) {
+        char *line=NULL;
+        size_t line_size=0;
+        while (getline(&line,&line_size,stdin) != -1) {
+          line[strcspn(line,"\r\n")]='\0';
+          if (line[0] != '\0' && add_path(line) != EXIT_SUCCESS) break;
+        }
+        free(line);
+      }
+      else {
+        printf(usage, argv[0], argv[0]);
+        return RETURN_FAILURE;
+      }
+    }
+    if ((ofile == NULL) == (qfile == NULL) || nworkers < 1) {
+      printf(usage, argv[0], argv[0]);
+      return RETURN_FAILURE;
+    }
+
+//#############################################################################
+
+    if (qfile != NULL) {
+      long n_matches = query_rb5_index(qfile, &query, L_PATHS_ONLY, stdout);
+      return (n_matches < 0) ? RETURN_FAILURE : EXIT_SUCCESS;
+    }
+
+    int ret = build_rb5_index(path_arr, n_paths, ofile, nworkers);
+    size_t k;
+    for (k = 0; k < n_paths; k++) free(path_arr[k]);
+    free(path_arr);
+    xmlCleanupParser(); // free globals in main() only for thread safety & valgrind
+
+    return ret;
+}
@@ -0,0 +1,208 @@
+/*
+ * rb5_inflate.c
+ *
+ * Inflate backends for RB5 blobs (zlib streams) and gzipped RB5 files.
+ * Both are decoded in one call into a buffer of known size, so whole-buffer
+ * decompressors apply. zlib is the default; libdeflate and the native
+ * zlib-ng API are compiled in when the Makefiles find their headers
+ * (RB5_HAVE_LIBDEFLATE, RB5_HAVE_ZLIBNG) and chosen at run time with
+ * rb5_inflate_select() or $RB5_INFLATE, looked at once (pthread_once()).
+ * Select before starting threads.
+ *
+ * compile only: gcc -g -c rb5_inflate.c -o rb5_inflate.o
+ *
+ */
+
+#include "rb5_inflate.h"
+
+#include <pthread.h>
+
+#ifdef RB5_HAVE_LIBDEFLATE
+#include <libdeflate.h>
+#endif
+#ifdef RB5_HAVE_ZLIBNG
+#include <zlib-ng.h>
+#endif
+
+static const char *inflate_backend_names[RB5_INFLATE_NBACKENDS]={
+    "zlib",
+    "libdeflate",
+    "zlib-ng"
+};
+
+static int inflate_selected=RB5_INFLATE_ZLIB;
+static pthread_once_t inflate_env_once=PTHREAD_ONCE_INIT; // $RB5_INFLATE, looked at once in any thread
+
+#ifdef RB5_HAVE_LIBDEFLATE
+static __thread struct libdeflate_decompressor *inflate_ld=NULL; //not thread-safe, one per thread
+#endif
+
+//#############################################################################
+
+/*
+ * Function name: rb5_inflate_name
+ * Intent: backend name as accepted by rb5_inflate_select()
+ */
+const char *rb5_inflate_name(RB5_INFLATE_BACKEND backend) {
+    if (backend < 0 || backend >= RB5_INFLATE_NBACKENDS) return("unknown");
+    return(inflate_backend_names[backend]);
+}
+
+/*
+ * Function name: rb5_inflate_available
+ * Intent: whether the backend was compiled in
+ */
+int rb5_inflate_available(RB5_INFLATE_BACKEND backend) {
+    switch (backend) {
+      case RB5_INFLATE_ZLIB: return(1);
+#ifdef RB5_HAVE_LIBDEFLATE
+      case RB5_INFLATE_LIBDEFLATE: return(1);
+#endif
+#ifdef RB5_HAVE_ZLIBNG
+      case RB5_INFLATE_ZLIBNG: return(1);
+#endif
+      default: return(0);
+    }
+}
+
+/* backend compiled in under that name, -1 if none; warns otherwise */
+static int inflate_lookup(const char *name) {
+    int i;
+    for (i = 0; i < RB5_INFLATE_NBACKENDS; i++) {
+      if (name != NULL && strcmp(name,inflate_backend_names[i]) == 0 && rb5_inflate_available(i)) return(i);
+    }
+    fprintf(stderr,"Warning: inflate backend %s not available, using %s\n", (name != NULL) ? name : "(null)", rb5_inflate_name(inflate_selected));
+    return(-1);
+}
+
+/* pthread_once() routine, $RB5_INFLATE over the zlib default */
+static void inflate_select_env(void) {
+    const char *name=getenv(RB5_INFLATE_ENV);
+    if (name == NULL || *name == '\0') return;
+    int backend=inflate_lookup(name);
+    if (backend != -1) inflate_selected=backend;
+}
+
+/*
+ * Function name: rb5_inflate_select
+ * Intent: choose the backend by name for all following inflates, in all
+ *         threads, over $RB5_INFLATE. EXIT_FAILURE, keeping the current
+ *         one, if the name is unknown or not compiled in.
+ */
+int rb5_inflate_select(const char *name) {
+    pthread_once(&inflate_env_once,inflate_select_env); //so that $RB5_INFLATE cannot override it later
+    int backend=inflate_lookup(name);
+    if (backend == -1) return(EXIT_FAILURE);
+    inflate_selected=backend;
+    return(EXIT_SUCCESS);
+}
+
+/*
+ * Function name: rb5_inflate_backend
+ * Intent: the backend in use, from $RB5_INFLATE on first call unless selected
+ */
+RB5_INFLATE_BACKEND rb5_inflate_backend(void) {
+    pthread_once(&inflate_env_once,inflate_select_env);
+    return((RB5_INFLATE_BACKEND)inflate_selected);
+}
+
+//#############################################################################
+
+/* zlib or gzip stream with zlib, uncompress() cannot do gzip */
+static int inflate_zlib(int L_GZIP, unsigned char *dst, size_t *dst_len, const unsigned char *src, size_t src_len) {
+    if (!L_GZIP) {
+      uLongf len=*dst_len;
+      int Z_result=uncompress(dst,&len,src,src_len);
+      *dst_len=len;
+      return(Z_result);
+    }
+    z_stream zs;
+    memset(&zs,0,sizeof(zs));
+    int Z_result=inflateInit2(&zs,16+MAX_WBITS);
+    if (Z_result != Z_OK) return(Z_result);
+    zs.next_in=(Bytef *)src;
+    zs.avail_in=src_len;
+    zs.next_out=dst;
+    zs.avail_out=*dst_len;
+    Z_result=inflate(&zs,Z_FINISH);
+    *dst_len=zs.total_out;
+    inflateEnd(&zs);
+    return((Z_result == Z_STREAM_END) ? Z_OK : (Z_result == Z_OK ? Z_BUF_ERROR : Z_result));
+}
+
+#ifdef RB5_HAVE_LIBDEFLATE
+static int inflate_libdeflate(int L_GZIP, unsigned char *dst, size_t *dst_len, const unsigned char *src, size_t src_len) {
+    size_t actual=0;
+    enum libdeflate_result result;
+    if (inflate_ld == NULL && (inflate_ld=libdeflate_alloc_decompressor()) == NULL) return(Z_MEM_ERROR);
+    if (L_GZIP) result=libdeflate_gzip_decompress(inflate_ld,src,src_len,dst,*dst_len,&actual);
+    else        result=libdeflate_zlib_decompress(inflate_ld,src,src_len,dst,*dst_len,&actual);
+    *dst_len=actual;
+    return((result == LIBDEFLATE_SUCCESS) ? Z_OK : Z_DATA_ERROR);
+}
+#endif
+
+#ifdef RB5_HAVE_ZLIBNG
+static int inflate_zlibng(int L_GZIP, unsigned char *dst, size_t *dst_len, const unsigned char *src, size_t src_len) {
+    if (!L_GZIP) return(zng_uncompress(dst,dst_len,src,src_len));
+    zng_stream zs;
+    memset(&zs,0,sizeof(zs));
+    int Z_result=zng_inflateInit2(&zs,16+MAX_WBITS);
+    if (Z_result != Z_OK) return(Z_result);
+    zs.next_in=src;
+    zs.avail_in=src_len;
+    zs.next_out=dst;
+    zs.avail_out=*dst_len;
+    Z_result=zng_inflate(&zs,Z_FINISH);
+    *dst_len=zs.total_out;
+    zng_inflateEnd(&zs);
+    return((Z_result == Z_STREAM_END) ? Z_OK : (Z_result == Z_OK ? Z_BUF_ERROR : Z_result));
+}
+#endif
+
+//#############################################################################
+
+/*
+ * Function name: rb5_inflate_with
+ * Intent: inflate a whole zlib (or, if L_GZIP, single-member gzip) stream
+ *         into dst, *dst_len bytes available on input and written on
+ *         output. Returns Z_OK or a zlib error code.
+ */
+int rb5_inflate_with(RB5_INFLATE_BACKEND backend, int L_GZIP, unsigned char *dst, size_t *dst_len, const unsigned char *src, size_t src_len) {
+    switch (backend) {
+#ifdef RB5_HAVE_LIBDEFLATE
+      case RB5_INFLATE_LIBDEFLATE: return(inflate_libdeflate(L_GZIP,dst,dst_len,src,src_len));
+#endif
+#ifdef RB5_HAVE_ZLIBNG
+      case RB5_INFLATE_ZLIBNG: return(inflate_zlibng(L_GZIP,dst,dst_len,src,src_len));
+#endif
+      default: return(inflate_zlib(L_GZIP,dst,dst_len,src,src_len));
+    }
+}
+
+/*
+ * Function name: rb5_inflate
+ * Intent: zlib stream (RB5 BLOB after its size prefix) with the selected backend
+ */
+int rb5_inflate(unsigned char *dst, size_t *dst_len, const unsigned char *src, size_t src_len) {
+    return(rb5_inflate_with(rb5_inflate_backend(),0,dst,dst_len,src,src_len));
+}
+
+/*
+ * Function name: rb5_gunzip
+ * Intent: single-member gzip file contents with the selected backend
+ */
+int rb5_gunzip(unsigned char *dst, size_t *dst_len, const unsigned char *src, size_t src_len) {
+    return(rb5_inflate_with(rb5_inflate_backend(),1,dst,dst_len,src,src_len));
+}
+
+/*
+ * Function name: rb5_inflate_cleanup
+ * Intent: free the calling thread's backend state, if any
+ */
+void rb5_inflate_cleanup(void) {
+#ifdef RB5_HAVE_LIBDEFLATE
+    if (inflate_ld != NULL) libdeflate_free_decompressor(inflate_ld);
+    inflate_ld=NULL;
+#endif
+}
@@ -0,0 +1,33 @@
+#ifndef RB5_INFLATE_H
+#define RB5_INFLATE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zlib.h>
+
+// whole-buffer inflate backends, the output size is always known up front
+// (RB5 BLOB 4-byte size prefix, gzip ISIZE trailer)
+// zlib is always built in, the others when their headers are found at build time
+typedef enum {
+    RB5_INFLATE_ZLIB=0,        // uncompress(), also zlib-ng in zlib compat mode
+    RB5_INFLATE_LIBDEFLATE,    // -DRB5_HAVE_LIBDEFLATE, libdeflate_zlib_decompress()
+    RB5_INFLATE_ZLIBNG,        // -DRB5_HAVE_ZLIBNG, zng_uncompress() of the native zlib-ng API
+    RB5_INFLATE_NBACKENDS
+} RB5_INFLATE_BACKEND;
+
+#define RB5_INFLATE_ENV "RB5_INFLATE" // run-time choice by name, e.g. RB5_INFLATE=libdeflate
+
+//#############################################################################
+// function declarations
+const char *rb5_inflate_name(RB5_INFLATE_BACKEND backend);
+int rb5_inflate_available(RB5_INFLATE_BACKEND backend);
+int rb5_inflate_select(const char *name);
+RB5_INFLATE_BACKEND rb5_inflate_backend(void);
+int rb5_inflate_with(RB5_INFLATE_BACKEND backend, int L_GZIP, unsigned char *dst, size_t *dst_len, const unsigned char *src, size_t src_len);
+int rb5_inflate(unsigned char *dst, size_t *dst_len, const unsigned char *src, size_t src_len);
+int rb5_gunzip(unsigned char *dst, size_t *dst_len, const unsigned char *src, size_t src_len);
+void rb5_inflate_cleanup(void);
+
+#endif
@@ -0,0 +1,285 @@
+/*
+ * rb5_latency.c
+ *
+ * Data age of the converted files: the end of acquisition of the last sweep
+ * in a file (as ODIM what/enddate+endtime) compared with the wall clock when
+ * the file was seen, decoded and written, and each sweep's age when written.
+ *
+ * Every converted file gives one structured log line (JSON) and adds to
+ * per-series histograms, shared by all worker threads, which can be
+ * rewritten as a Prometheus text file (node_exporter textfile collector)
+ * after each file. p50/p95/p99 come from the most recent samples.
+ *
+ * The data ages assume the radar and this host keep the same (NTP) time.
+ *
+ * compile only: gcc -g -I/usr/include/libxml2 -c rb5_latency.c -o rb5_latency.o
+ *
+ */
+
+#include "rb5_latency.h"
+#include "time_utils.h"
+
+#include <math.h> //ceil()
+#include <time.h> //clock_gettime()
+#include <unistd.h> //unlink()
+
+int rb5_latency_on=0;
+__thread strRB5_LATENCY_FILE rb5_latency_file;
+
+static char latency_prom_file[4*MAX_STRING]="\0";
+static strRB5_LATENCY_HIST latency_hists[RB5_LATENCY_NSERIES];
+static pthread_mutex_t latency_lock=PTHREAD_MUTEX_INITIALIZER;
+
+static const double latency_buckets_sec[RB5_LATENCY_NBUCKETS]={
+    1.0, 2.0, 5.0, 10.0, 15.0, 30.0, 60.0, 120.0, 300.0, 600.0, 1800.0, 3600.0
+};
+
+static const char *latency_series_names[RB5_LATENCY_NSERIES]={
+    "seen",
+    "decoded",
+    "written",
+    "sweep_written"
+};
+
+//#############################################################################
+
+/*
+ * Function name: rb5_latency_enable
+ * Intent: switch data age measurement on for the whole process, before any
+ *         conversion starts; prom_file, if not NULL, is rewritten after every
+ *         file
+ */
+void rb5_latency_enable(int on, const char *prom_file) {
+    rb5_latency_on=(on != 0);
+    snprintf(latency_prom_file,sizeof(latency_prom_file),"%s",(prom_file != NULL) ? prom_file : "");
+}
+
+double rb5_latency_wallclock(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME,&ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec*1e-9;
+}
+
+const char *rb5_latency_series_name(RB5_LATENCY_SERIES series) {
+    if(series < 0 || series >= RB5_LATENCY_NSERIES) return("unknown");
+    return(latency_series_names[series]);
+}
+
+void rb5_latency_clear(void) {
+    pthread_mutex_lock(&latency_lock);
+    memset(latency_hists,0,sizeof(latency_hists));
+    pthread_mutex_unlock(&latency_lock);
+}
+
+//#############################################################################
+// per-file record, filled in as the conversion goes
+
+void rb5_latency_begin(double t_seen) {
+    memset(&rb5_latency_file,0,sizeof(rb5_latency_file));
+    rb5_latency_file.t_seen=t_seen;
+}
+
+/*
+ * Function name: rb5_latency_note_sweeps
+ * Intent: take the sweep end times of a populated rb5_info, those written as
+ *         what/enddate+endtime (estimated if time accuracy was downgraded)
+ */
+void rb5_latency_note_sweeps(const strRB5_INFO *rb5_info) {
+
+    if(!rb5_latency_on) return;
+    size_t n=(rb5_info->n_slices < MAX_SLICES) ? rb5_info->n_slices : MAX_SLICES;
+    size_t i;
+    rb5_latency_file.n_sweeps=n;
+    rb5_latency_file.acq_end_ms=0;
+    for (i = 0; i < n; i++) {
+        int64_t end_ms=(rb5_info->L_TIME_ACCURACY_DOWNGRADE) ? rb5_info->slice_epoch_ms_end_est[i]
+                                                             : rb5_info->slice_epoch_ms_end[i];
+        rb5_latency_file.sweep_end_ms[i]=end_ms;
+        if (end_ms > rb5_latency_file.acq_end_ms) rb5_latency_file.acq_end_ms=end_ms;
+    }
+}
+
+void rb5_latency_mark_decoded(void) {
+    if(rb5_latency_on) rb5_latency_file.t_decoded=rb5_latency_wallclock();
+}
+
+void rb5_latency_mark_written(void) {
+    if(rb5_latency_on) rb5_latency_file.t_written=rb5_latency_wallclock();
+}
+
+//#############################################################################
+
+/* with latency_lock held */
+static void add_sample(RB5_LATENCY_SERIES series, double age_sec) {
+    strRB5_LATENCY_HIST *hist=&latency_hists[series];
+    int b=0;
+    while (b < RB5_LATENCY_NBUCKETS && age_sec > latency_buckets_sec[b]) b++;
+    hist->bucket_counts[b]++;
+    hist->window[hist->count % RB5_LATENCY_WINDOW]=age_sec;
+    hist->sum_sec+=age_sec;
+    hist->count++;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double da=*(const double *)a, db=*(const double *)b;
+    return((da > db) - (da < db));
+}
+
+/* nearest rank of sorted samples */
+static double rank_quantile(const double *sorted, size_t n, double q) {
+    if (n == 0) return(0.0);
+    size_t rank=(size_t)ceil(q*n);
+    if (rank < 1) rank=1;
+    return(sorted[rank-1]);
+}
+
+/* with latency_lock held */
+static void window_quantiles(RB5_LATENCY_SERIES series, double *p50, double *p95, double *p99) {
+    static double sorted[RB5_LATENCY_WINDOW];
+    const strRB5_LATENCY_HIST *hist=&latency_hists[series];
+    size_t n=(hist->count < RB5_LATENCY_WINDOW) ? hist->count : RB5_LATENCY_WINDOW;
+    memcpy(sorted,hist->window,n*sizeof(double));
+    qsort(sorted,n,sizeof(double),compare_double);
+    *p50=rank_quantile(sorted,n,0.50);
+    *p95=rank_quantile(sorted,n,0.95);
+    *p99=rank_quantile(sorted,n,0.99);
+}
+
+/*
+ * Function name: rb5_latency_quantiles
+ * Intent: p50/p95/p99 data age of a series over its RB5_LATENCY_WINDOW most
+ *         recent samples, 0.0 if none
+ */
+void rb5_latency_quantiles(RB5_LATENCY_SERIES series, double *p50, double *p95, double *p99) {
+    *p50=*p95=*p99=0.0;
+    if(series < 0 || series >= RB5_LATENCY_NSERIES) return;
+    pthread_mutex_lock(&latency_lock);
+    window_quantiles(series,p50,p95,p99);
+    pthread_mutex_unlock(&latency_lock);
+}
+
+//#############################################################################
+
+static void fprint_json_string(FILE *fp, const char *str) {
+    fputc('"',fp);
+    for (; str != NULL && *str != '\0'; str++) {
+        if (*str == '"' || *str == '\\') fprintf(fp,"\\%c",*str);
+        else if ((unsigned char)*str < 0x20) fprintf(fp,"\\u%04x",(unsigned char)*str);
+        else fputc(*str,fp);
+    }
+    fputc('"',fp);
+}
+
+static void fprint_json_age(FILE *fp, const char *key, double t, double t_acq) {
+    if (t > 0.0) fprintf(fp,", \"%s\": %.3f",key,t-t_acq);
+    else         fprintf(fp,", \"%s\": null",key);
+}
+
+/* with latency_lock held, to a temporary file renamed into place */
+static int write_prometheus(const char *path) {
+
+    char tmpfile[4*MAX_STRING+8];
+    int i, b;
+    snprintf(tmpfile,sizeof(tmpfile),"%s.tmp",path);
+    FILE *fp=fopen(tmpfile,"w");
+    if (fp == NULL) {
+        fprintf(stderr,"Error: cannot write %s\n", tmpfile);
+        return(EXIT_FAILURE);
+    }
+
+    fprintf(fp,"# HELP rb52odim_data_age_seconds Wall clock minus end of radar acquisition, at each conversion stage.\n");
+    fprintf(fp,"# TYPE rb52odim_data_age_seconds histogram\n");
+    for (i = 0; i < RB5_LATENCY_NSERIES; i++) {
+        const strRB5_LATENCY_HIST *hist=&latency_hists[i];
+        size_t cumulative=0;
+        for (b = 0; b < RB5_LATENCY_NBUCKETS; b++) {
+            cumulative+=hist->bucket_counts[b];
+            fprintf(fp,"rb52odim_data_age_seconds_bucket{stage=\"%s\",le=\"%g\"} %zu\n",
+                latency_series_names[i],latency_buckets_sec[b],cumulative);
+        }
+        cumulative+=hist->bucket_counts[RB5_LATENCY_NBUCKETS];
+        fprintf(fp,"rb52odim_data_age_seconds_bucket{stage=\"%s\",le=\"+Inf\"} %zu\n",latency_series_names[i],cumulative);
+        fprintf(fp,"rb52odim_data_age_seconds_sum{stage=\"%s\"} %.3f\n",latency_series_names[i],hist->sum_sec);
+        fprintf(fp,"rb52odim_data_age_seconds_count{stage=\"%s\"} %zu\n",latency_series_names[i],hist->count);
+    }
+
+    fprintf(fp,"# HELP rb52odim_data_age_quantile_seconds Data age quantiles over the %d most recent samples.\n",RB5_LATENCY_WINDOW);
+    fprintf(fp,"# TYPE rb52odim_data_age_quantile_seconds gauge\n");
+    for (i = 0; i < RB5_LATENCY_NSERIES; i++) {
+        double p50, p95, p99;
+        if (latency_hists[i].count == 0) continue;
+        window_quantiles((RB5_LATENCY_SERIES)i,&p50,&p95,&p99);
+        fprintf(fp,"rb52odim_data_age_quantile_seconds{stage=\"%s\",quantile=\"0.5\"} %.3f\n",latency_series_names[i],p50);
+        fprintf(fp,"rb52odim_data_age_quantile_seconds{stage=\"%s\",quantile=\"0.95\"} %.3f\n",latency_series_names[i],p95);
+        fprintf(fp,"rb52odim_data_age_quantile_seconds{stage=\"%s\",quantile=\"0.99\"} %.3f\n",latency_series_names[i],p99);
+    }
+
+    if (fclose(fp) != 0 || rename(tmpfile,path) != 0) {
+        fprintf(stderr,"Error: cannot write %s\n", path);
+        unlink(tmpfile);
+        return(EXIT_FAILURE);
+    }
+    return(EXIT_SUCCESS);
+}
+
+/*
+ * Function name: rb5_latency_write_prometheus
+ * Intent: write all series as a Prometheus text file, replaced atomically
+ */
+int rb5_latency_write_prometheus(const char *path) {
+    pthread_mutex_lock(&latency_lock);
+    int ret=write_prometheus(path);
+    pthread_mutex_unlock(&latency_lock);
+    return(ret);
+}
+
+//#############################################################################
+
+/*
+ * Function name: rb5_latency_finish
+ * Intent: close the record of this thread's file: one JSON line to log (if
+ *         not NULL), the stages reached added to the histograms, and the
+ *         Prometheus file rewritten if enabled. EXIT_FAILURE if no sweep end
+ *         time was noted, e.g. the file failed to decode.
+ */
+int rb5_latency_finish(const char *inp_fname, const char *ofile, FILE *log) {
+
+    strRB5_LATENCY_FILE *rec=&rb5_latency_file;
+    size_t i;
+    int ret=EXIT_SUCCESS;
+
+    if(!rb5_latency_on || rec->acq_end_ms == 0) return(EXIT_FAILURE);
+    double t_acq=rec->acq_end_ms/1e3;
+
+    if (log != NULL) {
+        char acq_iso8601[MAX_STRING]="\0";
+        func_epoch_ms_2_iso8601(rec->acq_end_ms,acq_iso8601);
+        fprintf(log,"{\"event\": \"data_age\", \"file\": ");
+        fprint_json_string(log,inp_fname);
+        fprintf(log,", \"output\": ");
+        fprint_json_string(log,ofile);
+        fprintf(log,", \"acq_end\": \"%s\"",acq_iso8601);
+        fprint_json_age(log,"seen_sec",rec->t_seen,t_acq);
+        fprint_json_age(log,"decoded_sec",rec->t_decoded,t_acq);
+        fprint_json_age(log,"written_sec",rec->t_written,t_acq);
+        fprintf(log,", \"sweeps_written_sec\": [");
+        for (i = 0; i < rec->n_sweeps; i++) {
+            if (rec->t_written > 0.0) fprintf(log,"%s%.3f",(i == 0) ? "" : ", ",rec->t_written-rec->sweep_end_ms[i]/1e3);
+        }
+        fprintf(log,"]}\n");
+        fflush(log);
+    }
+
+    pthread_mutex_lock(&latency_lock);
+    if (rec->t_seen    > 0.0) add_sample(RB5_LATENCY_SEEN,rec->t_seen-t_acq);
+    if (rec->t_decoded > 0.0) add_sample(RB5_LATENCY_DECODED,rec->t_decoded-t_acq);
+    if (rec->t_written > 0.0) {
+        add_sample(RB5_LATENCY_WRITTEN,rec->t_written-t_acq);
+        for (i = 0; i < rec->n_sweeps; i++) add_sample(RB5_LATENCY_SWEEP_WRITTEN,rec->t_written-rec->sweep_end_ms[i]/1e3);
+    }
+    if (latency_prom_file[0] != '\0') ret=write_prometheus(latency_prom_file);
+    pthread_mutex_unlock(&latency_lock);
+
+    memset(rec,0,sizeof(strRB5_LATENCY_FILE));
+    return(ret);
+}
@@ -0,0 +1,64 @@
+#ifndef RB5_LATENCY_H
+#define RB5_LATENCY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h> //for int64_t
+
+#include <pthread.h> //add -lpthread to compile
+
+#include "rb5_utils.h" //strRB5_INFO, MAX_SLICES
+
+//#############################################################################
+// data age series: wall clock minus the end of acquisition, at each stage of
+// the conversion; the last is per sweep, one sample for each sweep in a file
+typedef enum {
+    RB5_LATENCY_SEEN=0,      // file landed (--watch) or picked up (single file)
+    RB5_LATENCY_DECODED,     // RAVE object built
+    RB5_LATENCY_WRITTEN,     // ODIM_H5 file in place
+    RB5_LATENCY_SWEEP_WRITTEN,
+    RB5_LATENCY_NSERIES
+} RB5_LATENCY_SERIES;
+
+#define RB5_LATENCY_NBUCKETS 12  // histogram upper bounds, seconds, see rb5_latency.c
+#define RB5_LATENCY_WINDOW 1024  // most recent samples kept per series for p50/p95/p99
+
+// timestamps of the file being converted by this thread
+typedef struct{
+    int64_t acq_end_ms;               // end of the last sweep acquired, epoch ms, 0 until noted
+    size_t n_sweeps;
+    int64_t sweep_end_ms[MAX_SLICES]; // as ODIM what/enddate+endtime of each sweep
+    double t_seen;                    // wall clock, epoch seconds, 0.0 if not reached
+    double t_decoded;
+    double t_written;
+} strRB5_LATENCY_FILE;
+
+// one data age series, shared by all threads
+typedef struct{
+    size_t bucket_counts[RB5_LATENCY_NBUCKETS+1]; // last is +Inf, not cumulative
+    double sum_sec;
+    size_t count;
+    double window[RB5_LATENCY_WINDOW];             // ring of the most recent samples
+} strRB5_LATENCY_HIST;
+
+//#############################################################################
+// process-wide switch, set once before any conversion; per-thread file record
+extern int rb5_latency_on;
+extern __thread strRB5_LATENCY_FILE rb5_latency_file;
+
+//#############################################################################
+// function declarations
+void rb5_latency_enable(int on, const char *prom_file);
+double rb5_latency_wallclock(void);
+void rb5_latency_begin(double t_seen);
+void rb5_latency_note_sweeps(const strRB5_INFO *rb5_info);
+void rb5_latency_mark_decoded(void);
+void rb5_latency_mark_written(void);
+int rb5_latency_finish(const char *inp_fname, const char *ofile, FILE *log);
+const char *rb5_latency_series_name(RB5_LATENCY_SERIES series);
+void rb5_latency_quantiles(RB5_LATENCY_SERIES series, double *p50, double *p95, double *p99);
+int rb5_latency_write_prometheus(const char *path);
+void rb5_latency_clear(void);
+
+#endif
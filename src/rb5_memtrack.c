@@ -0,0 +1,181 @@
+/*
+ * rb5_memtrack.c
+ *
+ * Heap accounting for sizing container memory limits and checking
+ * allocation-reduction work: allocation count, bytes, outstanding bytes and
+ * their high-water mark, per thread. rb5_profile.c takes snapshots at phase
+ * boundaries to split them per decode phase.
+ *
+ * Blocks are sized with malloc_usable_size(), there is no header, so a block
+ * may be allocated by one family and freed by the other, or allocated before
+ * tracking was switched on. When off, the only cost is a test of
+ * rb5_memtrack_on.
+ *
+ * libxml2 allocates and frees on whatever thread runs it, so its blocks
+ * are counted apart, process-wide, and are not in the per-thread (and
+ * per-phase) numbers. Its hooks are process-global too (xmlMemSetup()):
+ * rb5_memtrack_xml_hooks() installs them once, at the start of main(),
+ * before libxml2 is initialized and before any thread starts. Where that
+ * is not possible, e.g. in Python, libxml2 is not tracked.
+ *
+ * compile only: gcc -g -I/usr/include/libxml2 -c rb5_memtrack.c -o rb5_memtrack.o
+ *
+ */
+
+#include "rb5_memtrack.h"
+
+#include <malloc.h> //malloc_usable_size()
+#include <sys/resource.h> //getrusage()
+
+#include <libxml/xmlmemory.h> //xmlMemSetup()
+
+__thread int rb5_memtrack_on=0;
+__thread strRB5_MEMTRACK rb5_memtrack;
+
+static int L_XML_HOOKS=0;              //set once, before any thread starts
+static strRB5_MEMTRACK xml_memtrack;   //libxml2, process-wide, updated atomically
+
+//#############################################################################
+
+static inline void note_alloc(void *ptr) {
+    if (ptr == NULL) return;
+    size_t size=malloc_usable_size(ptr);
+    rb5_memtrack.n_allocs++;
+    rb5_memtrack.alloc_bytes+=size;
+    rb5_memtrack.outstanding+=size;
+    if (rb5_memtrack.outstanding > rb5_memtrack.peak) rb5_memtrack.peak=rb5_memtrack.outstanding;
+    if (rb5_memtrack.outstanding > rb5_memtrack.phase_peak) rb5_memtrack.phase_peak=rb5_memtrack.outstanding;
+}
+
+static inline void note_free(void *ptr) {
+    if (ptr == NULL) return;
+    rb5_memtrack.outstanding-=malloc_usable_size(ptr);
+}
+
+//#############################################################################
+
+void *rb5_mem_malloc(size_t size) {
+    void *ptr=malloc(size);
+    if (rb5_memtrack_on) note_alloc(ptr);
+    return(ptr);
+}
+
+void *rb5_mem_calloc(size_t n, size_t size) {
+    void *ptr=calloc(n,size);
+    if (rb5_memtrack_on) note_alloc(ptr);
+    return(ptr);
+}
+
+void *rb5_mem_realloc(void *ptr, size_t size) {
+    if (!rb5_memtrack_on) return(realloc(ptr,size));
+    size_t old_size=(ptr != NULL) ? malloc_usable_size(ptr) : 0;
+    void *grown=realloc(ptr,size);
+    if (grown == NULL && size > 0) return(NULL); //ptr untouched
+    rb5_memtrack.outstanding-=old_size;
+    note_alloc(grown);
+    return(grown);
+}
+
+char *rb5_mem_strdup(const char *str) {
+    char *dup=strdup(str);
+    if (rb5_memtrack_on) note_alloc(dup);
+    return(dup);
+}
+
+void rb5_mem_free(void *ptr) {
+    if (rb5_memtrack_on) note_free(ptr);
+    free(ptr);
+}
+
+//#############################################################################
+
+static inline void note_xml_alloc(void *ptr) {
+    if (ptr == NULL) return;
+    int64_t size=(int64_t)malloc_usable_size(ptr);
+    __atomic_add_fetch(&xml_memtrack.n_allocs,1,__ATOMIC_RELAXED);
+    __atomic_add_fetch(&xml_memtrack.alloc_bytes,size,__ATOMIC_RELAXED);
+    int64_t outstanding=__atomic_add_fetch(&xml_memtrack.outstanding,size,__ATOMIC_RELAXED);
+    int64_t peak=__atomic_load_n(&xml_memtrack.peak,__ATOMIC_RELAXED);
+    while (outstanding > peak &&
+           !__atomic_compare_exchange_n(&xml_memtrack.peak,&peak,outstanding,1,__ATOMIC_RELAXED,__ATOMIC_RELAXED));
+}
+
+static inline void note_xml_free(void *ptr) {
+    if (ptr == NULL) return;
+    __atomic_sub_fetch(&xml_memtrack.outstanding,(int64_t)malloc_usable_size(ptr),__ATOMIC_RELAXED);
+}
+
+static void *xml_mem_malloc(size_t size) {
+    void *ptr=malloc(size);
+    note_xml_alloc(ptr);
+    return(ptr);
+}
+
+static void *xml_mem_realloc(void *ptr, size_t size) {
+    size_t old_size=(ptr != NULL) ? malloc_usable_size(ptr) : 0;
+    void *grown=realloc(ptr,size);
+    if (grown == NULL && size > 0) return(NULL); //ptr untouched
+    __atomic_sub_fetch(&xml_memtrack.outstanding,(int64_t)old_size,__ATOMIC_RELAXED);
+    note_xml_alloc(grown);
+    return(grown);
+}
+
+static char *xml_mem_strdup(const char *str) {
+    char *dup=strdup(str);
+    note_xml_alloc(dup);
+    return(dup);
+}
+
+static void xml_mem_free(void *ptr) {
+    note_xml_free(ptr);
+    free(ptr);
+}
+
+/*
+ * Function name: rb5_memtrack_xml_hooks
+ * Intent: count libxml2 allocations, process-wide, from now on. xmlMemSetup()
+ *         is process-global and not thread-safe: call once at the start of
+ *         main(), before libxml2 is initialized and before any thread starts.
+ */
+void rb5_memtrack_xml_hooks(void) {
+    if (L_XML_HOOKS) return;
+    if (xmlMemSetup(xml_mem_free,xml_mem_malloc,xml_mem_realloc,xml_mem_strdup) == 0) L_XML_HOOKS=1;
+}
+
+/*
+ * Function name: rb5_memtrack_xml
+ * Intent: libxml2 counters since rb5_memtrack_xml_hooks(), all threads;
+ *         0 if the hooks are not installed
+ */
+int rb5_memtrack_xml(strRB5_MEMTRACK *xml) {
+    memset(xml,0,sizeof(strRB5_MEMTRACK));
+    if (!L_XML_HOOKS) return(0);
+    xml->n_allocs=__atomic_load_n(&xml_memtrack.n_allocs,__ATOMIC_RELAXED);
+    xml->alloc_bytes=__atomic_load_n(&xml_memtrack.alloc_bytes,__ATOMIC_RELAXED);
+    xml->outstanding=__atomic_load_n(&xml_memtrack.outstanding,__ATOMIC_RELAXED);
+    xml->peak=__atomic_load_n(&xml_memtrack.peak,__ATOMIC_RELAXED);
+    return(1);
+}
+
+/*
+ * Function name: rb5_memtrack_enable
+ * Intent: switch tracking on or off for the calling thread
+ */
+void rb5_memtrack_enable(int on) {
+    rb5_memtrack_on=(on != 0);
+}
+
+void rb5_memtrack_reset(void) {
+    memset(&rb5_memtrack,0,sizeof(rb5_memtrack));
+}
+
+/*
+ * Function name: rb5_memtrack_maxrss_kb
+ * Intent: peak resident set size of the process so far, kB; covers what the
+ *         tracker does not see (RAVE objects, HDF5, Python)
+ */
+long rb5_memtrack_maxrss_kb(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF,&usage) != 0) return(0);
+    return(usage.ru_maxrss);
+}
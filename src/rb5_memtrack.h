@@ -0,0 +1,38 @@
+#ifndef RB5_MEMTRACK_H
+#define RB5_MEMTRACK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h> //for int64_t
+
+// opt-in heap accounting of the decoder: RAVE_MALLOC/RAVE_FREE (see rb5_alloc.h) and
+// the plain malloc()/free() of the RB5 file buffers, per thread; libxml2 apart, process-wide
+// sizes are malloc_usable_size(), so blocks may be freed by either family
+typedef struct{
+    size_t n_allocs;     // malloc, calloc, realloc and strdup calls
+    size_t alloc_bytes;  // bytes handed out by them
+    int64_t outstanding; // allocated minus freed since rb5_memtrack_reset(), may go negative
+    int64_t peak;        // high-water mark of outstanding
+    int64_t phase_peak;  // same, restarted at every phase start by rb5_profile_begin()
+} strRB5_MEMTRACK;
+
+//#############################################################################
+// per-thread state, as rb5_profile.h
+extern __thread int rb5_memtrack_on;
+extern __thread strRB5_MEMTRACK rb5_memtrack;
+
+//#############################################################################
+// function declarations
+void rb5_memtrack_xml_hooks(void);
+int rb5_memtrack_xml(strRB5_MEMTRACK *xml);
+void rb5_memtrack_enable(int on);
+void rb5_memtrack_reset(void);
+long rb5_memtrack_maxrss_kb(void);
+void *rb5_mem_malloc(size_t size);
+void *rb5_mem_calloc(size_t n, size_t size);
+void *rb5_mem_realloc(void *ptr, size_t size);
+char *rb5_mem_strdup(const char *str);
+void rb5_mem_free(void *ptr);
+
+#endif
@@ -0,0 +1,373 @@
+/*
+ * rb5_merge.c
+ *
+ * Native merging of single-moment RB5 decodes into one multi-moment
+ * PolarScan/PolarVolume, the equivalent of rb52odim.compileScanParameters(),
+ * compileVolumeFromVolumes() and, for tarballs, compile_big_scan() and
+ * compile_big_pvol().
+ *
+ * The first decoded input is the host object: its geometry, ray metadata
+ * and how/ attributes are kept, later inputs only contribute parameters and
+ * attributes the host does not have yet. Parameters and attributes are
+ * moved by reference, so moment data are never cloned, and inputs are
+ * decoded and released one at a time.
+ *
+ * compile only: gcc -g -I/usr/include/libxml2 -c rb5_merge.c -o rb5_merge.o
+ *
+ */
+
+#include "rb5_merge.h"
+
+//#############################################################################
+
+/* does sparam begin with one of the names in list, followed by one of suffixes? */
+static int param_matches(const char *sparam, const char **list, const char *suffixes) {
+    int i;
+    for (i = 0; list[i] != NULL; i++) {
+        size_t len=strlen(list[i]);
+        if (strncmp(sparam,list[i],len) != 0) continue;
+        if (suffixes == NULL) return 1;
+        if (sparam[len] != '\0' && strchr(suffixes,sparam[len]) != NULL) return 1;
+    }
+    return 0;
+}
+
+/*
+ * Copies how/TXpower, how/peakpwr and how/avgpwr of a single-moment scan to
+ * how/single-pol_* or how/dual-pol_* of the merged scan, once per polarization.
+ */
+int expandTXpowerByPol(PolarScan_t* oscan, PolarScan_t* scan, const char* sparam) {
+    static const char *dual_pol_param_list[]={"ZDR","RHOHV","PHIDP","KDP",NULL};
+    static const char *sing_pol_param_list[]={"T","DBZ","VRAD","WRAD","SNR","SQI",NULL};
+    static const char *aroot_list[]={"TXpower","peakpwr","avgpwr",NULL};
+    int ret = 1;
+    int i;
+
+    int is_dual=param_matches(sparam,dual_pol_param_list,NULL) ||
+                (sparam[0] == 'U' && param_matches(sparam+1,dual_pol_param_list,NULL));
+    if (param_matches(sparam,sing_pol_param_list,"HV")) is_dual=0;
+    const char *aprefix=is_dual ? "dual-pol_" : "single-pol_";
+
+    for (i = 0; aroot_list[i] != NULL && ret; i++) {
+        char org_aname[MAX_STRING];
+        char new_aname[MAX_STRING];
+        snprintf(org_aname,MAX_STRING,"how/%s",aroot_list[i]);
+        snprintf(new_aname,MAX_STRING,"how/%s%s",aprefix,aroot_list[i]);
+        if (PolarScan_hasAttribute(oscan,new_aname)) continue;
+
+        RaveAttribute_t* attr = PolarScan_getAttribute(scan,org_aname);
+        if (attr == NULL) continue;
+        RaveAttribute_t* new_attr = RAVE_OBJECT_CLONE(attr);
+        ret = (new_attr != NULL) && RaveAttribute_setName(new_attr,new_aname) && PolarScan_addAttribute(oscan,new_attr);
+        RAVE_OBJECT_RELEASE(new_attr);
+        RAVE_OBJECT_RELEASE(attr);
+    }
+    return ret;
+}
+
+//#############################################################################
+
+/*
+ * Merges the single moment of scan into *big_scan. If *big_scan is NULL,
+ * scan itself becomes the host. A non-empty ppdf (product directory, e.g.
+ * ZPHI_ITER_DEFAULT.dpatc) suffixes the quantity with its extension.
+ */
+int mergeScanParameter(PolarScan_t** big_scan, PolarScan_t* scan, const char* ppdf) {
+    int ret = 0;
+    char sparam[MAX_STRING]="\0";
+
+    RaveList_t* names = PolarScan_getParameterNames(scan);
+    if (names == NULL || RaveList_size(names) != 1) { //assume 1 param per scan of input tar_member
+        fprintf(stderr,"Error: expecting 1 parameter per tarball member scan, got %d\n", names ? RaveList_size(names) : 0);
+        if (names != NULL) RaveList_freeAndDestroy(&names);
+        return ret;
+    }
+    snprintf(sparam,MAX_STRING,"%s",(char*)RaveList_get(names,0));
+    RaveList_freeAndDestroy(&names);
+
+    PolarScanParam_t* param = PolarScan_getParameter(scan,sparam);
+
+    if (ppdf != NULL && ppdf[0] != '\0' && strchr(ppdf,'.') != NULL) {
+        PolarScanParam_t* orphan = PolarScan_removeParameter(scan,sparam); //make orphan
+        RAVE_OBJECT_RELEASE(orphan);
+        strncat(sparam,strchr(ppdf,'.'),MAX_STRING-strlen(sparam)-1);
+        PolarScanParam_setQuantity(param,sparam); //update orphan
+        PolarScan_addParameter(scan,param); //add orphan
+    }
+
+    if (*big_scan == NULL) {
+        *big_scan = RAVE_OBJECT_COPY(scan);
+        ret = 1;
+    } else {
+        //Different number of rays/bins for various parameters are not allowed
+        ret = PolarScan_addParameter(*big_scan,param);
+        if (!ret) fprintf(stderr,"Error: failed to add parameter %s to scan\n", sparam);
+    }
+
+    //expand TXpower attributes by single- & dual-pol params
+    if (ret) ret = expandTXpowerByPol(*big_scan,scan,sparam);
+
+    RAVE_OBJECT_RELEASE(param);
+    return ret;
+}
+
+//#############################################################################
+
+/*
+ * Merges the moment of every scan of pvol into the scan of *big_pvol with
+ * the same index. If *big_pvol is NULL, pvol itself becomes the host.
+ */
+int mergeVolumeParameters(PolarVolume_t** big_pvol, PolarVolume_t* pvol, const char* ppdf) {
+    int ret = 1;
+    int iSCAN;
+    int nSCANs = PolarVolume_getNumberOfScans(pvol);
+
+    if (*big_pvol != NULL && PolarVolume_getNumberOfScans(*big_pvol) != nSCANs) {
+        fprintf(stderr,"Error: cannot merge volumes of %d and %d scans\n", PolarVolume_getNumberOfScans(*big_pvol), nSCANs);
+        return 0;
+    }
+
+    for (iSCAN = 0; iSCAN < nSCANs && ret; iSCAN++) {
+        PolarScan_t* this_scan = PolarVolume_getScan(pvol,iSCAN);
+        PolarScan_t* big_scan = (*big_pvol != NULL) ? PolarVolume_getScan(*big_pvol,iSCAN) : NULL;
+        ret = mergeScanParameter(&big_scan,this_scan,ppdf);
+        RAVE_OBJECT_RELEASE(big_scan);
+        RAVE_OBJECT_RELEASE(this_scan);
+    }
+
+    if (ret && *big_pvol == NULL) *big_pvol = RAVE_OBJECT_COPY(pvol);
+    if (ret) PolarVolume_sortByElevations(*big_pvol,PolarVolume_isAscendingScans(pvol));
+    return ret;
+}
+
+
+//#############################################################################
+
+/* adds every attribute of src that dst does not have, by reference */
+static int merge_attributes(RaveCoreObject* dst, RaveObjectList_t* src_attrs) {
+    int ret = 1;
+    int i;
+    int n = src_attrs ? RaveObjectList_size(src_attrs) : 0;
+
+    for (i = 0; i < n && ret; i++) {
+        RaveAttribute_t* attr = (RaveAttribute_t*)RaveObjectList_get(src_attrs,i);
+        const char* aname = RaveAttribute_getName(attr);
+        int has = RAVE_OBJECT_CHECK_TYPE(dst, &PolarVolume_TYPE) ?
+                  PolarVolume_hasAttribute((PolarVolume_t*)dst,aname) :
+                  PolarScan_hasAttribute((PolarScan_t*)dst,aname);
+        //identical how/ arrays of every moment are kept once, from the host
+        if (!has) ret = addAttribute(dst,attr);
+        RAVE_OBJECT_RELEASE(attr);
+    }
+    return ret;
+}
+
+//#############################################################################
+
+/*
+ * Adds the parameters and attributes of scan that oscan does not have yet.
+ * As in compileScanParameters(), TXpower attributes are expanded by
+ * polarization for every scan but the host.
+ */
+int mergeScanMoments(PolarScan_t* oscan, PolarScan_t* scan) {
+    int ret = 1;
+    int i;
+    char sparam[MAX_STRING]="\0";
+
+    if (oscan == scan) return ret;
+
+    RaveObjectList_t* params = PolarScan_getParameters(scan);
+    int nparams = params ? RaveObjectList_size(params) : 0;
+    for (i = 0; i < nparams && ret; i++) {
+        PolarScanParam_t* param = (PolarScanParam_t*)RaveObjectList_get(params,i);
+        snprintf(sparam,MAX_STRING,"%s",PolarScanParam_getQuantity(param));
+        if (!PolarScan_hasParameter(oscan,sparam)) {
+            //Different number of rays/bins for various parameters are not allowed
+            ret = PolarScan_addParameter(oscan,param);
+            if (!ret) fprintf(stderr,"Error: failed to add parameter %s to scan\n", sparam);
+        }
+        RAVE_OBJECT_RELEASE(param);
+    }
+    RAVE_OBJECT_RELEASE(params);
+
+    if (ret) {
+        RaveObjectList_t* attrs = PolarScan_getAttributeValues(scan);
+        ret = merge_attributes((RaveCoreObject*)oscan,attrs);
+        RAVE_OBJECT_RELEASE(attrs);
+    }
+
+    //expand TXpower attributes by single- & dual-pol params
+    if (ret && sparam[0] != '\0') ret = expandTXpowerByPol(oscan,scan,sparam);
+
+    return ret;
+}
+
+//#############################################################################
+
+/*
+ * Merges every scan of volume into the scan of ovolume with the same index,
+ * then adds the top-level attributes ovolume does not have yet.
+ */
+int mergeVolumeMoments(PolarVolume_t* ovolume, PolarVolume_t* volume) {
+    int ret = 1;
+    int iSCAN;
+    int nSCANs = PolarVolume_getNumberOfScans(ovolume);
+
+    if (ovolume == volume) return ret;
+    if (PolarVolume_getNumberOfScans(volume) != nSCANs) {
+        fprintf(stderr,"Error: cannot merge volumes of %d and %d scans\n", nSCANs, PolarVolume_getNumberOfScans(volume));
+        return 0;
+    }
+
+    for (iSCAN = 0; iSCAN < nSCANs && ret; iSCAN++) {
+        PolarScan_t* oscan = PolarVolume_getScan(ovolume,iSCAN);
+        PolarScan_t* scan = PolarVolume_getScan(volume,iSCAN);
+        ret = mergeScanMoments(oscan,scan);
+        RAVE_OBJECT_RELEASE(scan);
+        RAVE_OBJECT_RELEASE(oscan);
+    }
+
+    if (ret) {
+        RaveObjectList_t* attrs = PolarVolume_getAttributeValues(volume);
+        ret = merge_attributes((RaveCoreObject*)ovolume,attrs);
+        RAVE_OBJECT_RELEASE(attrs);
+    }
+    return ret;
+}
+
+//#############################################################################
+
+static int compare_names_nocase(const void *a, const void *b) {
+    return strcasecmp(*(const char **)a, *(const char **)b);
+}
+
+/*
+ * Function name: getRaveIOFromFiles
+ * Intent: Decode N single-moment RB5 files of the same scan or volume and
+ * merge them into one object. Files are ordered case-insensitively, as in
+ * rb52odim.readParameterFiles(), so the output parameter order is stable.
+ * Files that fail to decode are skipped. Returns NULL if a file is missing,
+ * is not RB5, or cannot be merged.
+ */
+RaveIO_t* getRaveIOFromFiles(const char** ifiles, int nfiles) {
+
+    RaveIO_t* raveio = NULL;
+    RaveCoreObject* oobj = NULL;
+    int ret = 1;
+    int i;
+
+    const char** sorted = RAVE_MALLOC(sizeof(char*) * (nfiles > 0 ? nfiles : 1));
+    if (sorted == NULL) return NULL;
+    memcpy(sorted,ifiles,sizeof(char*) * nfiles);
+    qsort(sorted,nfiles,sizeof(char*),compare_names_nocase);
+
+    for (i = 0; i < nfiles && ret; i++) {
+        if (!is_regular_file(sorted[i]) || isRainbow5(sorted[i])) {
+            fprintf(stderr,"Error: %s is not a proper RB5 raw file\n", sorted[i]);
+            ret = 0;
+            break;
+        }
+        RaveIO_t* rio = getRaveIO(sorted[i]);
+        RaveCoreObject* object = RaveIO_getObject(rio);
+        RAVE_OBJECT_RELEASE(rio);
+        if (object == NULL) {
+            fprintf(stderr,"Failed to read file: %s\n", sorted[i]);
+            continue;
+        }
+
+        if (oobj == NULL) {
+            oobj = RAVE_OBJECT_COPY(object); //host
+        } else if (RAVE_OBJECT_CHECK_TYPE(oobj, &PolarVolume_TYPE) && RAVE_OBJECT_CHECK_TYPE(object, &PolarVolume_TYPE)) {
+            ret = mergeVolumeMoments((PolarVolume_t*)oobj,(PolarVolume_t*)object);
+        } else if (RAVE_OBJECT_CHECK_TYPE(oobj, &PolarScan_TYPE) && RAVE_OBJECT_CHECK_TYPE(object, &PolarScan_TYPE)) {
+            ret = mergeScanMoments((PolarScan_t*)oobj,(PolarScan_t*)object);
+        } else {
+            fprintf(stderr,"Error: cannot merge %s, scans and volumes are mixed\n", sorted[i]);
+            ret = 0;
+        }
+        RAVE_OBJECT_RELEASE(object); //moment data now only referenced by the host
+    }
+    RAVE_FREE(sorted);
+
+    if (ret) {
+        raveio = RAVE_OBJECT_NEW(&RaveIO_TYPE);
+        if (raveio != NULL && oobj != NULL) RaveIO_setObject(raveio, oobj);
+    }
+    RAVE_OBJECT_RELEASE(oobj);
+
+    return raveio;
+}
+
+//#############################################################################
+
+/* a nodata or undetect value as a code of depth bits, 0 if it is none */
+static uint32_t fill_code(double value, size_t depth) {
+    double max=(double)(((uint64_t)1 << depth)-1);
+    if (value < 0.0 || value > max || value != floor(value)) return 0;
+    return (uint32_t)value;
+}
+
+static size_t type_depth(RaveDataType type) {
+    if (type == RaveDataType_UCHAR) return 8;
+    if (type == RaveDataType_USHORT) return 16;
+    if (type == RaveDataType_UINT) return 32;
+    return 0;
+}
+
+/*
+ * Function name: compactScanParam
+ * Intent: Compact copy (rb5_compact.c) of the data of a parameter that is in
+ * no scan, runs of its undetect and nodata codes run-length encoded per ray.
+ * The data are then replaced by a 1x1 placeholder until expandScanParam()
+ * restores them. Returns a malloc() buffer of size_compact bytes, or NULL,
+ * the parameter left as it is, for data other than 8, 16 or 32 bit codes.
+ */
+unsigned char* compactScanParam(PolarScanParam_t* param, size_t* size_compact) {
+
+    RaveDataType type = PolarScanParam_getDataType(param);
+    size_t depth = type_depth(type);
+    uint32_t placeholder = 0;
+
+    *size_compact = 0;
+    void* data = PolarScanParam_getData(param);
+    if (depth == 0 || data == NULL) return NULL;
+
+    unsigned char* compact = rb5_compact_encode(data,
+                                                PolarScanParam_getNrays(param),
+                                                PolarScanParam_getNbins(param),
+                                                depth,
+                                                fill_code(PolarScanParam_getUndetect(param),depth),
+                                                fill_code(PolarScanParam_getNodata(param),depth),
+                                                size_compact);
+    if (compact == NULL) return NULL;
+    if (!PolarScanParam_setData(param, 1, 1, &placeholder, type)) {
+        free(compact);
+        *size_compact = 0;
+        return NULL;
+    }
+    return compact;
+}
+
+/*
+ * Function name: expandScanParam
+ * Intent: Restores the data of a parameter from compactScanParam(). Returns
+ * 0 if the buffer is damaged or of another data type.
+ */
+int expandScanParam(PolarScanParam_t* param, const unsigned char* compact, size_t size_compact) {
+
+    strRB5_COMPACT_HEADER header;
+    int ret = 0;
+
+    if (rb5_compact_header(compact,size_compact,&header) != EXIT_SUCCESS) return 0;
+    RaveDataType type = PolarScanParam_getDataType(param);
+    if (type_depth(type) != header.depth) return 0;
+
+    size_t size_raw = (size_t)header.nrays*header.nbins*header.depth/8;
+    void* raw_arr = RAVE_MALLOC(size_raw);
+    if (raw_arr == NULL) return 0;
+    if (rb5_compact_decode(compact,size_compact,raw_arr,size_raw) == EXIT_SUCCESS) {
+        ret = PolarScanParam_setData(param, header.nbins, header.nrays, raw_arr, type);
+    }
+    RAVE_FREE(raw_arr);
+    return ret;
+}
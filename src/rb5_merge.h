@@ -0,0 +1,26 @@
+#ifndef RB5_MERGE_H
+#define RB5_MERGE_H
+
+#include "rb52odim.h"
+#include "raveobject_list.h"
+#include "rb5_compact.h"
+#include <strings.h> //strcasecmp()
+
+//#############################################################################
+// function declarations
+int expandTXpowerByPol(PolarScan_t* oscan, PolarScan_t* scan, const char* sparam);
+
+// tarball members: each input carries one moment, renamed by its ppdf
+int mergeScanParameter(PolarScan_t** big_scan, PolarScan_t* scan, const char* ppdf);
+int mergeVolumeParameters(PolarVolume_t** big_pvol, PolarVolume_t* pvol, const char* ppdf);
+
+// per-moment files of the same scan or volume
+int mergeScanMoments(PolarScan_t* oscan, PolarScan_t* scan);
+int mergeVolumeMoments(PolarVolume_t* ovolume, PolarVolume_t* volume);
+RaveIO_t* getRaveIOFromFiles(const char** ifiles, int nfiles);
+
+// compact in-memory moments (rb5_compact.c), of parameters in no scan
+unsigned char* compactScanParam(PolarScanParam_t* param, size_t* size_compact);
+int expandScanParam(PolarScanParam_t* param, const unsigned char* compact, size_t size_compact);
+
+#endif
@@ -0,0 +1,130 @@
+/*
+ * rb5_odim_buf.c
+ *
+ * ODIM_H5 output without an output file, for callers that push the product
+ * elsewhere (rb5_2_odim -o -, _rb52odim.saveODIMbuf()). RaveIO_save() only
+ * takes a file name and opens it through HLHDF's default file driver, so the
+ * image is written to an anonymous memory-backed file (memfd_create(), reached
+ * by name through /proc/self/fd) and read back from there: no disk I/O and
+ * nothing left to clean up. Where memfd_create() is not available, a file
+ * under $TMPDIR is used and unlinked.
+ *
+ * compile only: gcc -g -I/usr/include/libxml2 -c rb5_odim_buf.c -o rb5_odim_buf.o
+ *
+ */
+
+#define _GNU_SOURCE //memfd_create()
+#include "rb5_odim_buf.h"
+#include "rb5_alloc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h> //memfd_create()
+#include <sys/stat.h>
+#include <unistd.h>
+
+//#############################################################################
+
+/* an empty read/write file that RaveIO_save() can open by name */
+static int open_image_file(char *fname, size_t len) {
+    int fd;
+#ifdef MFD_CLOEXEC
+    fd=memfd_create("rb52odim.h5",MFD_CLOEXEC);
+    if (fd != -1) {
+      snprintf(fname,len,"/proc/self/fd/%d",fd);
+      if (access(fname,F_OK) == 0) return(fd); // no /proc, fall through
+      close(fd);
+    }
+#endif
+    const char *tmpdir=getenv("TMPDIR");
+    snprintf(fname,len,"%s/rb52odim.XXXXXX",(tmpdir != NULL && *tmpdir != '\0') ? tmpdir : "/tmp");
+    fd=mkstemp(fname);
+    if (fd == -1) perror(fname);
+    return(fd);
+}
+
+/* RaveIO_save() into a fresh image file, fd and size of the result */
+static int save_image(RaveIO_t* raveio, char *fname, size_t len, size_t *return_nbytes) {
+    struct stat istat;
+    int fd=open_image_file(fname,len);
+    if (fd == -1) return(-1);
+
+    int ret=RaveIO_save(raveio,fname);
+    if (strncmp(fname,"/proc/",6) != 0) unlink(fname); //the open fd keeps it readable
+    if (!ret || fstat(fd,&istat) != 0 || istat.st_size <= 0) {
+      fprintf(stderr,"Error cannot write ODIM_H5 image\n");
+      close(fd);
+      return(-1);
+    }
+    *return_nbytes=(size_t)istat.st_size;
+    return(fd);
+}
+
+//#############################################################################
+
+/*
+ * Function name: saveRaveIObuf
+ * Intent: the bytes RaveIO_save() would write to an ODIM_H5 file, in a
+ *         RAVE_MALLOC'd buffer for the caller to RAVE_FREE. Returns the
+ *         length, 0 on failure.
+ */
+size_t saveRaveIObuf(RaveIO_t* raveio, char **return_buffer) {
+    char fname[4096]="\0";
+    size_t nbytes=0, nread=0;
+
+    *return_buffer=NULL;
+    int fd=save_image(raveio,fname,sizeof(fname),&nbytes);
+    if (fd == -1) return(0);
+
+    char *buffer=RAVE_MALLOC(nbytes);
+    while (buffer != NULL && nread < nbytes) {
+      ssize_t n=pread(fd,buffer+nread,nbytes-nread,(off_t)nread);
+      if (n <= 0) break;
+      nread+=(size_t)n;
+    }
+    close(fd);
+    if (buffer == NULL || nread != nbytes) {
+      fprintf(stderr,"Error cannot read back ODIM_H5 image (%ld of %ld bytes)\n",nread,nbytes);
+      if (buffer != NULL) RAVE_FREE(buffer);
+      return(0);
+    }
+    *return_buffer=buffer;
+    return(nbytes);
+}
+
+/*
+ * Function name: saveRaveIOfd
+ * Intent: write the ODIM_H5 image to an already open descriptor (a pipe,
+ *         socket or stdout) without staging it on disk or in a user buffer.
+ *         Returns EXIT_SUCCESS once all bytes are written.
+ */
+int saveRaveIOfd(RaveIO_t* raveio, int out_fd, size_t *return_nbytes) {
+    char fname[4096]="\0";
+    char chunk[65536];
+    size_t nbytes=0, nwritten=0;
+
+    *return_nbytes=0;
+    int fd=save_image(raveio,fname,sizeof(fname),&nbytes);
+    if (fd == -1) return(EXIT_FAILURE);
+
+    while (nwritten < nbytes) {
+      ssize_t n=pread(fd,chunk,sizeof(chunk),(off_t)nwritten);
+      if (n <= 0) break;
+      ssize_t m=0;
+      while (m < n) {
+        ssize_t w=write(out_fd,chunk+m,(size_t)(n-m));
+        if (w <= 0) break;
+        m+=w;
+      }
+      nwritten+=(size_t)m;
+      if (m != n) break;
+    }
+    close(fd);
+    *return_nbytes=nwritten;
+    if (nwritten != nbytes) {
+      fprintf(stderr,"Error cannot write ODIM_H5 image (%ld of %ld bytes)\n",nwritten,nbytes);
+      return(EXIT_FAILURE);
+    }
+    return(EXIT_SUCCESS);
+}
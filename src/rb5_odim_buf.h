@@ -0,0 +1,13 @@
+#ifndef RB5_ODIM_BUF_H
+#define RB5_ODIM_BUF_H
+
+#include "rave_io.h"
+
+#include <stddef.h> //size_t
+
+//#############################################################################
+// function declarations
+size_t saveRaveIObuf(RaveIO_t* raveio, char **return_buffer);
+int saveRaveIOfd(RaveIO_t* raveio, int fd, size_t *return_nbytes);
+
+#endif
@@ -0,0 +1,63 @@
+/*
+ * rb5_params.c
+ *
+ * RB5 parameter registry: ODIM_H5 quantity, dual-pol flag, URP mapping,
+ * conversion and rayinfo role of every known RB5 name, looked up in O(1)
+ * through the perfect hash generated with the table (utils/gen_rb5_params.py).
+ * Parameters travel through the decoder as these integer ids.
+ *
+ * compile only: gcc -g -c rb5_params.c -o rb5_params.o
+ *
+ */
+
+#include "rb5_params.h"
+
+#define RB5_PARAMS_TABLE_DEFINE
+#include "rb5_params_table.h"
+
+static const char *conversion_names[RB5_N_CONVERSIONS]={
+    "moment_data",
+    "copy",
+    "angular"
+};
+
+//#############################################################################
+
+/* FNV-1a from RB5_PARAM_HASH_SEED, top RB5_PARAM_HASH_BITS bits, as in the generator */
+static unsigned int rb5_param_hash(const char *name) {
+    uint32_t h=RB5_PARAM_HASH_SEED;
+    while (*name != '\0') {
+        h=(h ^ (unsigned char)*name++)*16777619U;
+    }
+    return(h >> (32-RB5_PARAM_HASH_BITS));
+}
+
+/*
+ * Function name: rb5_param_id
+ * Intent: registry id of an RB5 rawdata type or rayinfo refid, one hash and
+ *         one strcmp, RB5_PARAM_UNKNOWN if not registered
+ */
+int rb5_param_id(const char *name) {
+    if (name == NULL) return(RB5_PARAM_UNKNOWN);
+    int id=rb5_param_slot[rb5_param_hash(name)];
+    if (id < 0 || strcmp(rb5_param_registry[id].name,name) != 0) return(RB5_PARAM_UNKNOWN);
+    return(id);
+}
+
+/*
+ * Function name: rb5_param_def
+ * Intent: registry row of an id, NULL for RB5_PARAM_UNKNOWN
+ */
+const strRB5_PARAM_DEF *rb5_param_def(int param_id) {
+    if (param_id < 0 || param_id >= RB5_N_PARAMS) return(NULL);
+    return(&rb5_param_registry[param_id]);
+}
+
+/*
+ * Function name: rb5_conversion_name
+ * Intent: conversion as it used to be spelled in strRB5_PARAM_INFO
+ */
+const char *rb5_conversion_name(RB5_CONVERSION conversion) {
+    if (conversion < 0 || conversion >= RB5_N_CONVERSIONS) return("unknown");
+    return(conversion_names[conversion]);
+}
@@ -0,0 +1,57 @@
+#ifndef RB5_PARAMS_H
+#define RB5_PARAMS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h> //for uint32_t
+#include <string.h>
+
+//#############################################################################
+// how raw codes become physical values, see convert_raw_to_data()
+typedef enum {
+    RB5_CONVERSION_MOMENT_DATA=0, // 0 is no data, data_range_min..max over 1..2^depth-1
+    RB5_CONVERSION_COPY,          // raw code as is
+    RB5_CONVERSION_ANGULAR,       // 360/2^depth deg per code
+    RB5_N_CONVERSIONS
+} RB5_CONVERSION;
+
+// what a rayinfo is used for, RB5_RAYINFO_NONE for rawdata types
+typedef enum {
+    RB5_RAYINFO_NONE=0,
+    RB5_RAYINFO_STARTANGLE,
+    RB5_RAYINFO_STOPANGLE,
+    RB5_RAYINFO_STARTFIXANGLE,
+    RB5_RAYINFO_STOPFIXANGLE,
+    RB5_RAYINFO_DATAFLAG,
+    RB5_RAYINFO_NUMPULSES,
+    RB5_RAYINFO_TIMESTAMP,
+    RB5_RAYINFO_TXPOWER,
+    RB5_RAYINFO_NOISEPOWERH,
+    RB5_RAYINFO_NOISEPOWERV,
+    RB5_N_RAYINFO_ROLES
+} RB5_RAYINFO_ROLE;
+
+// one row of the parameter registry, one per RB5 rawdata @type or rayinfo @refid
+typedef struct{
+    const char *name;          // RB5 name
+    const char *quantity;      // ODIM_H5 what/quantity
+    int L_DUALPOL;
+    int urp_type;              // URP mapping, -1 and "n/a" if none
+    const char *urp_name;
+    const char *urp_unit;
+    const char *urp_desc;
+    RB5_CONVERSION conversion;
+    RB5_RAYINFO_ROLE rayinfo_role;
+} strRB5_PARAM_DEF;
+
+#include "rb5_params_table.h" //generated by utils/gen_rb5_params.py: RB5_PARAM_ID, RB5_N_PARAMS
+
+#define RB5_PARAM_UNKNOWN -1 // not in the registry, e.g. a newer Rainbow 5 type
+
+//#############################################################################
+// function declarations
+int rb5_param_id(const char *name);
+const strRB5_PARAM_DEF *rb5_param_def(int param_id);
+const char *rb5_conversion_name(RB5_CONVERSION conversion);
+
+#endif
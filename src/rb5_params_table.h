@@ -0,0 +1,112 @@
+/* generated by utils/gen_rb5_params.py, do not edit */
+#ifndef RB5_PARAMS_TABLE_H
+#define RB5_PARAMS_TABLE_H
+
+// parameter ids, the row of each RB5 name in rb5_param_registry[]
+typedef enum {
+    RB5_PARAM_DBZ=0,
+    RB5_PARAM_DBZV=1,
+    RB5_PARAM_DBUZ=2,
+    RB5_PARAM_DBUZV=3,
+    RB5_PARAM_V=4,
+    RB5_PARAM_VV=5,
+    RB5_PARAM_VU=6,
+    RB5_PARAM_VVU=7,
+    RB5_PARAM_W=8,
+    RB5_PARAM_WV=9,
+    RB5_PARAM_WU=10,
+    RB5_PARAM_WVU=11,
+    RB5_PARAM_ZDR=12,
+    RB5_PARAM_ZDRU=13,
+    RB5_PARAM_PHIDP=14,
+    RB5_PARAM_UPHIDP=15,
+    RB5_PARAM_UPHIDPU=16,
+    RB5_PARAM_KDP=17,
+    RB5_PARAM_UKDP=18,
+    RB5_PARAM_UKDPU=19,
+    RB5_PARAM_RHOHV=20,
+    RB5_PARAM_RHOHVU=21,
+    RB5_PARAM_SQI=22,
+    RB5_PARAM_SQIV=23,
+    RB5_PARAM_SQIU=24,
+    RB5_PARAM_SQIVU=25,
+    RB5_PARAM_SNR=26,
+    RB5_PARAM_SNRV=27,
+    RB5_PARAM_SNRU=28,
+    RB5_PARAM_SNRVU=29,
+    RB5_PARAM_ET=30,
+    RB5_PARAM_STARTANGLE=31,
+    RB5_PARAM_STOPANGLE=32,
+    RB5_PARAM_STARTFIXANGLE=33,
+    RB5_PARAM_STOPFIXANGLE=34,
+    RB5_PARAM_DATAFLAG=35,
+    RB5_PARAM_NUMPULSES=36,
+    RB5_PARAM_TIMESTAMP=37,
+    RB5_PARAM_TXPOWER=38,
+    RB5_PARAM_NOISEPOWERH=39,
+    RB5_PARAM_NOISEPOWERV=40,
+    RB5_N_PARAMS=41
+} RB5_PARAM_ID;
+
+#define RB5_PARAM_HASH_SEED 0x811d705dU
+#define RB5_PARAM_HASH_BITS 7
+#define RB5_PARAM_HASH_SLOTS 128
+
+#endif
+
+#ifdef RB5_PARAMS_TABLE_DEFINE // rb5_params.c only
+static const strRB5_PARAM_DEF rb5_param_registry[RB5_N_PARAMS]={
+    {"dBZ",           "DBZH",          0,   2, "DBZ",    "dBZ",    "Reflectivity",                             RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"dBZv",          "DBZV",          0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"dBuZ",          "TH",            0,   1, "DBT",    "dBZ",    "Uncorrected Reflectivity",                 RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"dBuZv",         "TV",            0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"V",             "VRADH",         0,   3, "VEL",    "m/s",    "Velocity",                                 RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"Vv",            "VRADV",         0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"Vu",            "UVRADH",        0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"Vvu",           "UVRADV",        0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"W",             "WRADH",         0,   4, "WID",    "m/s",    "Width",                                    RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"Wv",            "WRADV",         0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"Wu",            "UWRADH",        0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"Wvu",           "UWRADV",        0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"ZDR",           "ZDR",           1,   5, "ZDR",    "dB",     "Differential Reflectivity",                RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"ZDRu",          "UZDR",          1,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"PhiDP",         "PHIDP",         1,  16, "PHIDP",  "deg",    "Differential Phase",                       RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"uPhiDP",        "UPHIDP",        1, 216, "UPHIDP", "deg",    "Uncorrected Differential Phase",           RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"uPhiDPu",       "UPHIDPU",       1,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"KDP",           "KDP",           1,  14, "KDP",    "deg/km", "Specific Differential Phase",              RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"uKDP",          "UKDP",          1,  14, "UKDP",   "deg/km", "Uncorrected Specific Differential Phase",  RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"uKDPu",         "UKDPU",         1,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"RhoHV",         "RHOHV",         1,  19, "RHOHV",  "",       "Correlation Coefficient",                  RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"RhoHVu",        "URHOHV",        1,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"SQI",           "SQIH",          0,  18, "SQI",    "",       "Signal Quality Index",                     RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"SQIv",          "SQIV",          0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"SQIu",          "USQIH",         0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"SQIvu",         "USQIV",         0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"SNR",           "SNRH",          0, 100, "SNR",    "",       "Signal to Noise",                          RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"SNRv",          "SNRV",          0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"SNRu",          "USNRH",         0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"SNRvu",         "USNRV",         0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_MOMENT_DATA, RB5_RAYINFO_NONE},
+    {"ET",            "CLASS",         0,  55, "HCLASS", "",       "Hydrometeor Class (was RB5 Echo Type))",   RB5_CONVERSION_COPY,        RB5_RAYINFO_NONE},
+    {"startangle",    "STARTANGLE",    0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_ANGULAR,     RB5_RAYINFO_STARTANGLE},
+    {"stopangle",     "STOPANGLE",     0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_ANGULAR,     RB5_RAYINFO_STOPANGLE},
+    {"startfixangle", "STARTFIXANGLE", 0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_ANGULAR,     RB5_RAYINFO_STARTFIXANGLE},
+    {"stopfixangle",  "STOPFIXANGLE",  0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_ANGULAR,     RB5_RAYINFO_STOPFIXANGLE},
+    {"dataflag",      "DATAFLAG",      0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_COPY,        RB5_RAYINFO_DATAFLAG},
+    {"numpulses",     "NUMPULSES",     0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_COPY,        RB5_RAYINFO_NUMPULSES},
+    {"timestamp",     "TIMESTAMP",     0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_COPY,        RB5_RAYINFO_TIMESTAMP},
+    {"txpower",       "TXPOWER",       0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_COPY,        RB5_RAYINFO_TXPOWER},
+    {"noisepowerh",   "NOISEPOWERH",   0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_COPY,        RB5_RAYINFO_NOISEPOWERH},
+    {"noisepowerv",   "NOISEPOWERV",   0,  -1, "n/a",    "n/a",    "n/a",                                      RB5_CONVERSION_COPY,        RB5_RAYINFO_NOISEPOWERV},
+};
+
+static const signed char rb5_param_slot[RB5_PARAM_HASH_SLOTS]={
+     -1, -1, -1, -1, 37, -1, 19, 35, -1, 16, -1, -1, 29, -1, -1, -1,
+     -1, -1, -1, 13, -1,  7, -1, -1, -1, -1, -1, -1, 24, 23, -1,  2,
+     30, -1, 39, 22, -1,  8,  4, -1,  6, -1,  5, 12, 20, -1,  1, 40,
+     -1,  9, 10, -1, 26, 18, -1, 15, -1, 27, 28, -1, -1, -1, -1, -1,
+     -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 36, -1, -1, -1, -1,
+     14, -1, -1, 38, -1, 33, -1, -1, -1, 34, -1, -1, 17, -1, -1, -1,
+     -1, -1, -1, 25, 21, 32, -1, 11, -1, -1, -1, -1, -1, -1, -1, -1,
+     -1, -1,  0, -1, -1,  3, 31, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+#endif
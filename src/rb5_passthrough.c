@@ -0,0 +1,340 @@
+/*
+ * rb5_passthrough.c
+ *
+ * Pass-through of RB5 rawdata blobs into ODIM_H5 (rb5_2_odim --passthrough).
+ * A BLOB is a 4-byte big-endian size followed by a zlib stream of big-endian
+ * samples, nrays x nbins, which is also what a single-chunk HDF5 dataset with
+ * the deflate filter and a big-endian integer type holds. When a sweep needs
+ * no rotation to 0 deg N, its blobs are not inflated: the RAVE object gets
+ * zeros in their place (which deflate to next to nothing in RaveIO_save()),
+ * and the compressed streams are then written over those chunks with
+ * H5Dwrite_chunk(). Datasets whose layout does not match (chunked otherwise,
+ * other filters), or whose attributes cannot be copied, get the inflated
+ * samples written instead.
+ * RaveIO_save() writes little-endian datasets, so those of 16 and 32-bit
+ * moments are created again big-endian here and the originals unlinked.
+ * HDF5 does not reuse the space they held (their deflated placeholder zeros
+ * and headers, about 1 KB per dataset) once the file is closed; h5repack the
+ * output to drop it.
+ *
+ * compile only: gcc -g -I/usr/include/libxml2 -I/usr/include/hdf5/serial -c rb5_passthrough.c -o rb5_passthrough.o
+ *
+ */
+
+#include "rb5_alloc.h"
+#include "rb5_profile.h"
+#include "rb5_passthrough.h"
+
+//#############################################################################
+
+/*
+ * Function name: init_rb5_passthrough
+ * Intent: empty collection, attach with rb5_info.passthrough=&pt
+ */
+void init_rb5_passthrough(strRB5_PASSTHROUGH *pt, int L_PVOL) {
+    memset(pt,0,sizeof(strRB5_PASSTHROUGH));
+    pt->L_PVOL=L_PVOL;
+}
+
+/*
+ * Function name: free_rb5_passthrough
+ * Intent: free the collected blobs
+ */
+void free_rb5_passthrough(strRB5_PASSTHROUGH *pt) {
+    size_t i;
+    for (i = 0; i < pt->n_blobs; i++) RAVE_FREE(pt->blob_arr[i].zblob);
+    if (pt->blob_arr != NULL) RAVE_FREE(pt->blob_arr);
+    pt->blob_arr=NULL;
+    pt->n_blobs=pt->n_alloc=0;
+}
+
+//#############################################################################
+
+/*
+ * Function name: take_rb5_passthrough_blob
+ * Intent: in place of return_param_blobid_raw(), keep the compressed blob of
+ *         an unrotated rawdata and return zeros of the same size. Returns
+ *         n_elems_data, or 0 (nothing allocated) when the blob has to be
+ *         decoded as usual.
+ */
+size_t take_rb5_passthrough_blob(strRB5_INFO *rb5_info, strRB5_PARAM_INFO *rb5_param, void **return_raw_arr) {
+
+    size_t EXIT_NULL_VAL=0;
+    strRB5_PASSTHROUGH *pt=(strRB5_PASSTHROUGH *)rb5_info->passthrough;
+    unsigned char *zblob=NULL;
+
+    if (pt == NULL || rb5_info->cache != NULL) return(EXIT_NULL_VAL);
+    if (rb5_param->iray_0degN != 0 && rb5_param->iray_0degN != (size_t)-1) return(EXIT_NULL_VAL);
+    if (rb5_param->raw_binary_depth != 8 && rb5_param->raw_binary_depth != 16 && rb5_param->raw_binary_depth != 32) return(EXIT_NULL_VAL);
+
+    size_t n_elems_data=rb5_param->nrays*rb5_param->nbins;
+    size_t nbytes=n_elems_data*rb5_param->data_bytesize;
+    if (n_elems_data == 0 || rb5_param->n_elems_data != n_elems_data) return(EXIT_NULL_VAL);
+
+    strRB5_PROFILE_MARK prof=rb5_profile_begin();
+    size_t zblob_len=get_blobid_compressed(&(*rb5_info),rb5_param->blobid,&zblob);
+    rb5_profile_end(RB5_PROFILE_BLOB_LOOKUP,prof,zblob_len);
+    if (zblob == NULL) return(EXIT_NULL_VAL);
+    size_t expectedSize=((size_t)zblob[0] << 24) | (zblob[1] << 16) | (zblob[2] << 8) | zblob[3];
+    if (zblob_len <= 4 || expectedSize != nbytes) {
+      RAVE_FREE(zblob);
+      return(EXIT_NULL_VAL);
+    }
+
+    if (pt->n_blobs == pt->n_alloc) {
+      size_t n_alloc=(pt->n_alloc == 0) ? MAX_PARAMS : 2*pt->n_alloc;
+      strRB5_PASSTHROUGH_BLOB *blob_arr=RAVE_MALLOC(n_alloc*sizeof(strRB5_PASSTHROUGH_BLOB));
+      if (blob_arr == NULL) {
+        RAVE_FREE(zblob);
+        return(EXIT_NULL_VAL);
+      }
+      if (pt->n_blobs > 0) memcpy(blob_arr,pt->blob_arr,pt->n_blobs*sizeof(strRB5_PASSTHROUGH_BLOB));
+      if (pt->blob_arr != NULL) RAVE_FREE(pt->blob_arr);
+      pt->blob_arr=blob_arr;
+      pt->n_alloc=n_alloc;
+    }
+    void *raw_arr=RAVE_MALLOC(nbytes);
+    if (raw_arr == NULL) {
+      RAVE_FREE(zblob);
+      return(EXIT_NULL_VAL);
+    }
+    memset(raw_arr,0,nbytes);
+
+    strRB5_PASSTHROUGH_BLOB *blob=&pt->blob_arr[pt->n_blobs++];
+    blob->dataset=(pt->L_PVOL) ? pt->this_slice+1 : 1;
+    snprintf(blob->quantity,sizeof(blob->quantity),"%s",map_rb5_to_h5_param(rb5_param->sparam));
+    blob->nrays=rb5_param->nrays;
+    blob->nbins=rb5_param->nbins;
+    blob->raw_binary_depth=rb5_param->raw_binary_depth;
+    blob->zblob=zblob;
+    blob->zblob_len=zblob_len;
+
+    rb5_param->size_blob=nbytes;
+    *return_raw_arr=raw_arr;
+    return(n_elems_data);
+}
+
+//#############################################################################
+
+/* /dataset<N>/data<M>/data holding quantity, 0 if none */
+static int find_quantity_dataset(hid_t file, int dataset, const char *quantity, char *path, size_t len) {
+    char group[MAX_STRING]="\0";
+    char value[MAX_STRING];
+    int m;
+
+    snprintf(group,sizeof(group),"/dataset%d",dataset);
+    if (H5Lexists(file,group,H5P_DEFAULT) <= 0) return(0);
+    for (m = 1; ; m++) {
+      snprintf(group,sizeof(group),"/dataset%d/data%d",dataset,m);
+      if (H5Lexists(file,group,H5P_DEFAULT) <= 0) return(0);
+      strcat(group,"/what");
+      if (H5Lexists(file,group,H5P_DEFAULT) <= 0 || H5Aexists_by_name(file,group,"quantity",H5P_DEFAULT) <= 0) continue;
+
+      hid_t attr=H5Aopen_by_name(file,group,"quantity",H5P_DEFAULT,H5P_DEFAULT);
+      hid_t atype=H5Aget_type(attr);
+      hid_t mtype=H5Tcopy(H5T_C_S1);
+      int L_MATCH=0;
+      if (H5Tget_class(atype) == H5T_STRING && !H5Tis_variable_str(atype) && H5Tget_size(atype) < sizeof(value)) {
+        memset(value,0,sizeof(value));
+        H5Tset_size(mtype,H5Tget_size(atype));
+        if (H5Aread(attr,mtype,value) >= 0) L_MATCH=(strcmp(value,quantity) == 0);
+      }
+      H5Tclose(mtype);
+      H5Tclose(atype);
+      H5Aclose(attr);
+      if (L_MATCH) {
+        snprintf(path,len,"/dataset%d/data%d/data",dataset,m);
+        return(1);
+      }
+    }
+}
+
+/* copies every attribute of the dataset being replaced, variable-length strings read as char * */
+static herr_t copy_attribute(hid_t loc, const char *name, const H5A_info_t *ainfo, void *op_data) {
+    hid_t dst=*(hid_t *)op_data;
+    herr_t ret=-1;
+
+    hid_t attr=H5Aopen(loc,name,H5P_DEFAULT);
+    hid_t atype=H5Aget_type(attr);
+    hid_t aspace=H5Aget_space(attr);
+    int L_VLEN_STR=(H5Tis_variable_str(atype) > 0);
+    hid_t mtype=H5Tcopy(atype);
+    if (L_VLEN_STR) { //native vlen string, HDF5 allocates the strings
+      H5Tclose(mtype);
+      mtype=H5Tcopy(H5T_C_S1);
+      H5Tset_size(mtype,H5T_VARIABLE);
+      H5Tset_cset(mtype,H5Tget_cset(atype));
+    }
+    size_t nbytes=H5Tget_size(mtype)*(size_t)H5Sget_simple_extent_npoints(aspace);
+    void *value=RAVE_MALLOC(nbytes > 0 ? nbytes : 1);
+    if (value != NULL && H5Aread(attr,mtype,value) >= 0) {
+      hid_t dattr=H5Acreate2(dst,name,atype,aspace,H5P_DEFAULT,H5P_DEFAULT);
+      if (dattr >= 0) {
+        ret=H5Awrite(dattr,mtype,value);
+        H5Aclose(dattr);
+      }
+#if H5_VERSION_GE(1,12,0)
+      if (L_VLEN_STR) H5Treclaim(mtype,aspace,H5P_DEFAULT,value);
+#else
+      if (L_VLEN_STR) H5Dvlen_reclaim(mtype,aspace,H5P_DEFAULT,value);
+#endif
+    }
+    if (value != NULL) RAVE_FREE(value);
+    H5Tclose(mtype);
+    H5Sclose(aspace);
+    H5Tclose(atype);
+    H5Aclose(attr);
+    return(ret < 0 ? -1 : 0);
+}
+
+/*
+ * same dataset with a big-endian type, so that blob samples need no swap.
+ * EXIT_SUCCESS: *dset is the new dataset, the old one closed and unlinked.
+ * EXIT_FAILURE: *dset is left as it was, or -1 if it could not be.
+ */
+static int recreate_big_endian(hid_t file, hid_t *dset_ptr, const char *path) {
+    char tmp_path[MAX_STRING]="\0";
+    snprintf(tmp_path,sizeof(tmp_path),"%s_rb5_passthrough",path);
+    hid_t dset=*dset_ptr;
+
+    hid_t dtype=H5Dget_type(dset);
+    hid_t betype=H5Tcopy(dtype);
+    hid_t space=H5Dget_space(dset);
+    hid_t dcpl=H5Dget_create_plist(dset);
+    H5Tset_order(betype,H5T_ORDER_BE);
+    hid_t newd=H5Dcreate2(file,tmp_path,betype,space,H5P_DEFAULT,dcpl,H5P_DEFAULT);
+    H5Pclose(dcpl);
+    H5Sclose(space);
+    H5Tclose(betype);
+    H5Tclose(dtype);
+    if (newd < 0) return(EXIT_FAILURE);
+
+    if (H5Aiterate2(dset,H5_INDEX_NAME,H5_ITER_INC,NULL,copy_attribute,&newd) < 0 ||
+        H5Ldelete(file,path,H5P_DEFAULT) < 0) {
+      H5Dclose(newd);
+      H5Ldelete(file,tmp_path,H5P_DEFAULT);
+      return(EXIT_FAILURE);
+    }
+    H5Dclose(dset);
+    if (H5Lmove(file,tmp_path,file,path,H5P_DEFAULT,H5P_DEFAULT) < 0) {
+      H5Dclose(newd);
+      *dset_ptr=-1;
+      return(EXIT_FAILURE);
+    }
+    *dset_ptr=newd;
+    return(EXIT_SUCCESS);
+}
+
+/* single chunk of nrays x nbins unsigned integers, deflate as the only filter */
+static int is_passthrough_layout(hid_t dset, const strRB5_PASSTHROUGH_BLOB *blob) {
+    hsize_t dims[2], chunk[2];
+    unsigned int flags, cd_values[4];
+    size_t cd_nelmts=4;
+    int L_OK=0;
+
+    hid_t space=H5Dget_space(dset);
+    hid_t dtype=H5Dget_type(dset);
+    hid_t dcpl=H5Dget_create_plist(dset);
+    if (H5Sget_simple_extent_ndims(space) == 2 &&
+        H5Sget_simple_extent_dims(space,dims,NULL) == 2 &&
+        dims[0] == blob->nrays && dims[1] == blob->nbins &&
+        H5Tget_class(dtype) == H5T_INTEGER && H5Tget_sign(dtype) == H5T_SGN_NONE &&
+        H5Tget_size(dtype) == blob->raw_binary_depth/8 &&
+        H5Pget_layout(dcpl) == H5D_CHUNKED &&
+        H5Pget_chunk(dcpl,2,chunk) == 2 && chunk[0] == dims[0] && chunk[1] == dims[1] &&
+        H5Pget_nfilters(dcpl) == 1 &&
+        H5Pget_filter2(dcpl,0,&flags,&cd_nelmts,cd_values,0,NULL,NULL) == H5Z_FILTER_DEFLATE) {
+      L_OK=1;
+    }
+    H5Pclose(dcpl);
+    H5Tclose(dtype);
+    H5Sclose(space);
+    return(L_OK);
+}
+
+/* fallback: inflate and let HDF5 convert from big-endian on write */
+static int write_inflated(hid_t dset, const strRB5_PASSTHROUGH_BLOB *blob) {
+    unsigned char *raw_arr=NULL;
+    size_t nbytes=blob->nrays*blob->nbins*(blob->raw_binary_depth/8);
+    hid_t mtype;
+    int ret=EXIT_FAILURE;
+
+    if (uncompress_this_blob(blob->zblob,&raw_arr,blob->zblob_len) != nbytes) {
+      if (raw_arr != NULL) RAVE_FREE(raw_arr);
+      return(EXIT_FAILURE);
+    }
+           if (blob->raw_binary_depth ==  8) { mtype=H5T_STD_U8BE;
+    } else if (blob->raw_binary_depth == 16) { mtype=H5T_STD_U16BE;
+    } else                                   { mtype=H5T_STD_U32BE;
+    }
+    if (H5Dwrite(dset,mtype,H5S_ALL,H5S_ALL,H5P_DEFAULT,raw_arr) >= 0) ret=EXIT_SUCCESS;
+    RAVE_FREE(raw_arr);
+    return(ret);
+}
+
+//#############################################################################
+
+/*
+ * Function name: apply_rb5_passthrough
+ * Intent: write the collected blobs into the ODIM_H5 file RaveIO_save() just
+ *         wrote, over the placeholder zeros. Returns EXIT_SUCCESS when every
+ *         blob is in place, as a raw chunk (counted in return_n_chunks) or
+ *         inflated; otherwise the file still holds placeholders and must not
+ *         be used.
+ */
+int apply_rb5_passthrough(strRB5_PASSTHROUGH *pt, const char *h5_fname, size_t *return_n_chunks) {
+
+    char path[MAX_STRING]="\0";
+    hsize_t offset[2]={0,0};
+    int ret=EXIT_SUCCESS;
+    size_t i;
+
+    *return_n_chunks=0;
+    if (pt->n_blobs == 0) return(EXIT_SUCCESS);
+
+    strRB5_PROFILE_MARK prof=rb5_profile_begin();
+    size_t nbytes=0;
+    hid_t file=H5Fopen(h5_fname,H5F_ACC_RDWR,H5P_DEFAULT);
+    if (file < 0) {
+      fprintf(stderr,"Error cannot open %s for pass-through\n", h5_fname);
+      return(EXIT_FAILURE);
+    }
+    for (i = 0; i < pt->n_blobs && ret == EXIT_SUCCESS; i++) {
+      strRB5_PASSTHROUGH_BLOB *blob=&pt->blob_arr[i];
+      if (!find_quantity_dataset(file,blob->dataset,blob->quantity,path,sizeof(path))) {
+        fprintf(stderr,"Error no dataset for %s in /dataset%d of %s\n", blob->quantity, blob->dataset, h5_fname);
+        ret=EXIT_FAILURE;
+        break;
+      }
+      hid_t dset=H5Dopen2(file,path,H5P_DEFAULT);
+      if (dset < 0) {
+        ret=EXIT_FAILURE;
+        break;
+      }
+      int L_CHUNK=is_passthrough_layout(dset,blob);
+      if (L_CHUNK && blob->raw_binary_depth > 8) {
+        hid_t dtype=H5Dget_type(dset);
+        H5T_order_t order=H5Tget_order(dtype);
+        H5Tclose(dtype);
+        if (order != H5T_ORDER_BE) L_CHUNK=(recreate_big_endian(file,&dset,path) == EXIT_SUCCESS); //else this dataset only is written inflated
+      }
+      if (dset < 0) {
+        ret=EXIT_FAILURE;
+      } else if (L_CHUNK) {
+        if (H5Dwrite_chunk(dset,H5P_DEFAULT,0,offset,blob->zblob_len-4,blob->zblob+4) >= 0) {
+          (*return_n_chunks)++;
+          nbytes+=blob->zblob_len-4;
+        } else {
+          ret=EXIT_FAILURE;
+        }
+      } else {
+        ret=write_inflated(dset,blob);
+      }
+      if (dset >= 0) H5Dclose(dset);
+    }
+    if (H5Fclose(file) < 0) ret=EXIT_FAILURE;
+    rb5_profile_end(RB5_PROFILE_PASSTHROUGH,prof,nbytes);
+
+    if (ret != EXIT_SUCCESS) fprintf(stderr,"Error cannot pass blobs through to %s\n", h5_fname);
+    return(ret);
+}
@@ -0,0 +1,38 @@
+#ifndef RB5_PASSTHROUGH_H
+#define RB5_PASSTHROUGH_H
+
+#include "rb5_utils.h"
+
+#include <hdf5.h> //H5Dwrite_chunk(), HDF5 >= 1.10.2
+
+//#############################################################################
+// one rawdata blob whose zlib stream goes into the ODIM_H5 file as is
+typedef struct{
+    int dataset;              // ODIM /dataset<N>, 1-based
+    char quantity[MAX_STRING];
+    size_t nrays;
+    size_t nbins;
+    size_t raw_binary_depth;
+    unsigned char *zblob;     // BLOB contents: 4-byte big-endian size + zlib stream of big-endian samples
+    size_t zblob_len;
+} strRB5_PASSTHROUGH_BLOB;
+
+//#############################################################################
+// collected while populating the RAVE object (placeholder zeros in its place),
+// then written over the placeholders once RaveIO_save() is done
+typedef struct{
+    int this_slice;           // slice being populated, set by populateScan()
+    int L_PVOL;               // slices map to datasets 1..n, otherwise all to dataset 1
+    size_t n_blobs;
+    size_t n_alloc;
+    strRB5_PASSTHROUGH_BLOB *blob_arr;
+} strRB5_PASSTHROUGH;
+
+//#############################################################################
+// function declarations
+void init_rb5_passthrough(strRB5_PASSTHROUGH *pt, int L_PVOL);
+size_t take_rb5_passthrough_blob(strRB5_INFO *rb5_info, strRB5_PARAM_INFO *rb5_param, void **return_raw_arr);
+int apply_rb5_passthrough(strRB5_PASSTHROUGH *pt, const char *h5_fname, size_t *return_n_chunks);
+void free_rb5_passthrough(strRB5_PASSTHROUGH *pt);
+
+#endif
@@ -0,0 +1,195 @@
+/*
+ * rb5_profile.c
+ *
+ * Phase timing and counters for the RB5 -> RAVE conversion pipeline.
+ *
+ * Each phase accumulates self time (wall clock), bytes and calls. Phases
+ * may nest (e.g. inflate inside blob lookup inside the RAVE object build),
+ * so the time already recorded by inner phases is subtracted from the outer
+ * one and the per-phase times add up to the total conversion time.
+ *
+ * With the allocation tracker on (rb5_memtrack.h), phases also split the
+ * heap counters the same way: self allocations and bytes, self retained
+ * heap, the heap high-water mark while in the phase (inner phases included)
+ * and the process peak RSS at its end.
+ *
+ * State is thread-local. When disabled, the only cost on the hot path is a
+ * test of rb5_profile_on in rb5_profile_begin() and rb5_profile_end().
+ *
+ * compile only: gcc -g -c rb5_profile.c -o rb5_profile.o
+ *
+ */
+
+#include "rb5_profile.h"
+
+__thread int rb5_profile_on=0;
+__thread double rb5_profile_accounted=0.0;
+__thread size_t rb5_profile_mem_accounted_allocs=0;
+__thread size_t rb5_profile_mem_accounted_bytes=0;
+__thread int64_t rb5_profile_mem_accounted_retained=0;
+static __thread strRB5_PROFILE_PHASE profile_phases[RB5_PROFILE_NPHASES];
+
+static const char *profile_phase_names[RB5_PROFILE_NPHASES]={
+    "gz_read",
+    "end_of_xml",
+    "xml_parse",
+    "populate_rb5_info",
+    "angles",
+    "blob_lookup",
+    "inflate",
+    "convert",
+    "reorder",
+    "qc",
+    "rave_build",
+    "save",
+    "passthrough"
+};
+
+//#############################################################################
+
+void rb5_profile_enable(int on) {
+    rb5_profile_on=(on != 0);
+}
+
+//#############################################################################
+
+void rb5_profile_reset(void) {
+    memset(profile_phases,0,sizeof(profile_phases));
+    rb5_profile_accounted=0.0;
+    rb5_profile_mem_accounted_allocs=0;
+    rb5_profile_mem_accounted_bytes=0;
+    rb5_profile_mem_accounted_retained=0;
+}
+
+//#############################################################################
+
+double rb5_profile_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec*1e-9;
+}
+
+//#############################################################################
+
+/* heap counters of a phase, self as the time: minus what inner phases recorded */
+static void record_memory(strRB5_PROFILE_PHASE *ph, strRB5_PROFILE_MARK *mark) {
+
+    size_t allocs=(rb5_memtrack.n_allocs-mark->mem.n_allocs)-(rb5_profile_mem_accounted_allocs-mark->mem_accounted_allocs);
+    size_t bytes=(rb5_memtrack.alloc_bytes-mark->mem.alloc_bytes)-(rb5_profile_mem_accounted_bytes-mark->mem_accounted_bytes);
+    int64_t retained=(rb5_memtrack.outstanding-mark->mem.outstanding)-(rb5_profile_mem_accounted_retained-mark->mem_accounted_retained);
+    ph->n_allocs+=allocs;
+    ph->alloc_bytes+=bytes;
+    ph->retained_bytes+=retained;
+    rb5_profile_mem_accounted_allocs+=allocs;
+    rb5_profile_mem_accounted_bytes+=bytes;
+    rb5_profile_mem_accounted_retained+=retained;
+
+    if(rb5_memtrack.phase_peak > ph->peak_bytes) ph->peak_bytes=rb5_memtrack.phase_peak;
+    long maxrss_kb=rb5_memtrack_maxrss_kb();
+    if(maxrss_kb > ph->maxrss_kb) ph->maxrss_kb=maxrss_kb;
+
+    //back to the enclosing phase, whose high-water mark includes this one
+    if(mark->mem.phase_peak > rb5_memtrack.phase_peak) rb5_memtrack.phase_peak=mark->mem.phase_peak;
+}
+
+//#############################################################################
+
+void rb5_profile_record(RB5_PROFILE_PHASE phase, strRB5_PROFILE_MARK *mark, size_t nbytes) {
+
+    if(phase < 0 || phase >= RB5_PROFILE_NPHASES) return;
+    if(mark->t0 == 0.0) return; //profiling was switched on mid-phase
+
+    double elapsed=rb5_profile_now()-(mark->t0);
+    double nested=rb5_profile_accounted-(mark->accounted);
+    double self=elapsed-nested;
+    if(self < 0.0) self=0.0;
+
+    profile_phases[phase].wall_sec+=self;
+    profile_phases[phase].nbytes+=nbytes;
+    profile_phases[phase].ncalls++;
+    rb5_profile_accounted+=self;
+
+    if(mark->L_MEM && rb5_memtrack_on) record_memory(&profile_phases[phase],mark);
+}
+
+//#############################################################################
+
+const char *rb5_profile_phase_name(RB5_PROFILE_PHASE phase) {
+    if(phase < 0 || phase >= RB5_PROFILE_NPHASES) return("unknown");
+    return(profile_phase_names[phase]);
+}
+
+//#############################################################################
+
+strRB5_PROFILE_PHASE rb5_profile_get(RB5_PROFILE_PHASE phase) {
+    strRB5_PROFILE_PHASE empty={0.0,0,0,0,0,0,0,0};
+    if(phase < 0 || phase >= RB5_PROFILE_NPHASES) return(empty);
+    return(profile_phases[phase]);
+}
+
+//#############################################################################
+
+void rb5_profile_dump_text(FILE *fp) {
+
+    int i;
+    double total_sec=0.0;
+    for (i = 0; i < RB5_PROFILE_NPHASES; i++) total_sec+=profile_phases[i].wall_sec;
+
+    fprintf(fp,"%-18s %12s %7s %14s %8s %10s\n","phase","wall_ms","%","bytes","calls","MB/s");
+    for (i = 0; i < RB5_PROFILE_NPHASES; i++) {
+        strRB5_PROFILE_PHASE *ph=&profile_phases[i];
+        double pct =(total_sec > 0.0) ? 100.0*ph->wall_sec/total_sec : 0.0;
+        double mbps=(ph->wall_sec > 0.0) ? (ph->nbytes/1e6)/ph->wall_sec : 0.0;
+        fprintf(fp,"%-18s %12.3f %7.1f %14zu %8zu %10.1f\n",
+            profile_phase_names[i],ph->wall_sec*1e3,pct,ph->nbytes,ph->ncalls,mbps);
+    }
+    fprintf(fp,"%-18s %12.3f\n","total",total_sec*1e3);
+
+    if(!rb5_memtrack_on) return;
+    size_t total_allocs=0, total_bytes=0;
+    fprintf(fp,"\n%-18s %10s %12s %10s %12s %10s\n","phase","allocs","alloc_MB","peak_MB","retained_MB","maxrss_MB");
+    for (i = 0; i < RB5_PROFILE_NPHASES; i++) {
+        strRB5_PROFILE_PHASE *ph=&profile_phases[i];
+        total_allocs+=ph->n_allocs;
+        total_bytes+=ph->alloc_bytes;
+        fprintf(fp,"%-18s %10zu %12.3f %10.3f %12.3f %10.1f\n",
+            profile_phase_names[i],ph->n_allocs,ph->alloc_bytes/1e6,ph->peak_bytes/1e6,
+            ph->retained_bytes/1e6,ph->maxrss_kb/1024.0);
+    }
+    fprintf(fp,"%-18s %10zu %12.3f %10.3f %12.3f %10.1f\n","total",total_allocs,total_bytes/1e6,
+        rb5_memtrack.peak/1e6,rb5_memtrack.outstanding/1e6,rb5_memtrack_maxrss_kb()/1024.0);
+    strRB5_MEMTRACK xml;
+    if(rb5_memtrack_xml(&xml))
+        fprintf(fp,"%-18s %10zu %12.3f %10.3f %12.3f  (all threads, not in the phases)\n","libxml2",xml.n_allocs,
+            xml.alloc_bytes/1e6,xml.peak/1e6,xml.outstanding/1e6);
+}
+
+//#############################################################################
+
+void rb5_profile_dump_json(FILE *fp) {
+
+    int i;
+    double total_sec=0.0;
+    for (i = 0; i < RB5_PROFILE_NPHASES; i++) total_sec+=profile_phases[i].wall_sec;
+
+    fprintf(fp,"{\"phases\": {");
+    for (i = 0; i < RB5_PROFILE_NPHASES; i++) {
+        strRB5_PROFILE_PHASE *ph=&profile_phases[i];
+        fprintf(fp,"%s\"%s\": {\"wall_sec\": %.9f, \"bytes\": %zu, \"calls\": %zu",
+            (i == 0) ? "" : ", ",profile_phase_names[i],ph->wall_sec,ph->nbytes,ph->ncalls);
+        if(rb5_memtrack_on)
+            fprintf(fp,", \"allocs\": %zu, \"alloc_bytes\": %zu, \"peak_bytes\": %lld, \"retained_bytes\": %lld, \"maxrss_kb\": %ld",
+                ph->n_allocs,ph->alloc_bytes,(long long)ph->peak_bytes,(long long)ph->retained_bytes,ph->maxrss_kb);
+        fprintf(fp,"}");
+    }
+    fprintf(fp,"}, \"total_sec\": %.9f",total_sec);
+    if(rb5_memtrack_on)
+        fprintf(fp,", \"memory\": {\"allocs\": %zu, \"alloc_bytes\": %zu, \"peak_bytes\": %lld, \"outstanding_bytes\": %lld, \"maxrss_kb\": %ld}",
+            rb5_memtrack.n_allocs,rb5_memtrack.alloc_bytes,(long long)rb5_memtrack.peak,
+            (long long)rb5_memtrack.outstanding,rb5_memtrack_maxrss_kb());
+    strRB5_MEMTRACK xml;
+    if(rb5_memtrack_on && rb5_memtrack_xml(&xml))
+        fprintf(fp,", \"libxml2_process\": {\"allocs\": %zu, \"alloc_bytes\": %zu, \"peak_bytes\": %lld, \"outstanding_bytes\": %lld}",
+            xml.n_allocs,xml.alloc_bytes,(long long)xml.peak,(long long)xml.outstanding);
+    fprintf(fp,"}\n");
+}
@@ -0,0 +1,95 @@
+#ifndef RB5_PROFILE_H
+#define RB5_PROFILE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <time.h> //clock_gettime()
+
+#include "rb5_memtrack.h"
+
+//#############################################################################
+// conversion pipeline phases, in processing order
+typedef enum {
+    RB5_PROFILE_GZ_READ=0,     // read_file_2_buffer()
+    RB5_PROFILE_END_OF_XML,    // find_buffer_end_of_xml()
+    RB5_PROFILE_XML_PARSE,     // xmlReadMemory() + xmlXPathNewContext()
+    RB5_PROFILE_POPULATE_INFO, // populate_rb5_info()
+    RB5_PROFILE_ANGLES,        // get_slice_mid_angle_readbacks(), ray angle codes and kernel
+    RB5_PROFILE_BLOB_LOOKUP,   // get_blobid_buffer(), excluding inflate
+    RB5_PROFILE_INFLATE,       // uncompress_this_blob()
+    RB5_PROFILE_CONVERT,       // convert_raw_to_data()
+    RB5_PROFILE_REORDER,       // reorder_by_iray_0degN()
+    RB5_PROFILE_QC,            // rb5_qc_moment(), with --qc only
+    RB5_PROFILE_RAVE_BUILD,    // populateObject(), excluding the phases above
+    RB5_PROFILE_SAVE,          // RaveIO_save()
+    RB5_PROFILE_PASSTHROUGH,   // apply_rb5_passthrough()
+    RB5_PROFILE_NPHASES
+} RB5_PROFILE_PHASE;
+
+typedef struct{
+    double wall_sec; //self time, nested phases are not double counted
+    size_t nbytes;
+    size_t ncalls;
+    //with rb5_memtrack_on only
+    size_t n_allocs;        //self, as wall_sec
+    size_t alloc_bytes;     //self
+    int64_t peak_bytes;     //high-water mark of outstanding heap while in the phase
+    int64_t retained_bytes; //self outstanding heap growth from start to end of the phase
+    long maxrss_kb;         //process peak RSS at the end of the phase
+} strRB5_PROFILE_PHASE;
+
+typedef struct{
+    double t0;       //wall clock at start of phase
+    double accounted; //sum of all recorded phase time at start of phase
+    int L_MEM;           //heap counters below were taken, rb5_memtrack_on at start of phase
+    strRB5_MEMTRACK mem; //heap counters at start of phase
+    size_t mem_accounted_allocs;
+    size_t mem_accounted_bytes;
+    int64_t mem_accounted_retained;
+} strRB5_PROFILE_MARK;
+
+//#############################################################################
+// per-thread state, so concurrent conversions do not mix their counters
+extern __thread int rb5_profile_on;
+extern __thread double rb5_profile_accounted;
+extern __thread size_t rb5_profile_mem_accounted_allocs;
+extern __thread size_t rb5_profile_mem_accounted_bytes;
+extern __thread int64_t rb5_profile_mem_accounted_retained;
+
+//#############################################################################
+// function declarations
+void rb5_profile_enable(int on);
+void rb5_profile_reset(void);
+double rb5_profile_now(void);
+void rb5_profile_record(RB5_PROFILE_PHASE phase, strRB5_PROFILE_MARK *mark, size_t nbytes);
+const char *rb5_profile_phase_name(RB5_PROFILE_PHASE phase);
+strRB5_PROFILE_PHASE rb5_profile_get(RB5_PROFILE_PHASE phase);
+void rb5_profile_dump_text(FILE *fp);
+void rb5_profile_dump_json(FILE *fp);
+
+//#############################################################################
+// hot-path wrappers: a single thread-local test when profiling is off
+static inline strRB5_PROFILE_MARK rb5_profile_begin(void) {
+    strRB5_PROFILE_MARK mark={0};
+    if(rb5_profile_on) {
+        mark.t0=rb5_profile_now();
+        mark.accounted=rb5_profile_accounted;
+        if(rb5_memtrack_on) {
+            mark.L_MEM=1;
+            mark.mem=rb5_memtrack;
+            mark.mem_accounted_allocs=rb5_profile_mem_accounted_allocs;
+            mark.mem_accounted_bytes=rb5_profile_mem_accounted_bytes;
+            mark.mem_accounted_retained=rb5_profile_mem_accounted_retained;
+            rb5_memtrack.phase_peak=rb5_memtrack.outstanding; //restarted for this phase, see rb5_profile_record()
+        }
+    }
+    return mark;
+}
+
+static inline void rb5_profile_end(RB5_PROFILE_PHASE phase, strRB5_PROFILE_MARK mark, size_t nbytes) {
+    if(rb5_profile_on) rb5_profile_record(phase, &mark, nbytes);
+}
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ * rb5_qc.c
+ *
+ * Quality control statistics of each moment of each sweep, counted in the
+ * one pass over the raw codes right after they are decoded (byte swapped and
+ * reordered to 0-deg N), so a QC stage does not have to read every moment of
+ * the ODIM_H5 file back: a histogram over the raw codes, the nodata and
+ * undetect fractions, min/max/mean of the echoes and the coverage of each ray.
+ *
+ * populateParam() attaches them to the moment as how/ attributes when
+ * switched on for the thread (--qc, or readRB5(..., qc=1) from Python).
+ *
+ * compile only: gcc -g -I/usr/include/libxml2 -c rb5_qc.c -o rb5_qc.o
+ *
+ */
+
+#include "rb5_qc.h"
+
+__thread int rb5_qc_on=0;
+
+//#############################################################################
+
+void rb5_qc_enable(int on) {
+    rb5_qc_on=on;
+}
+
+//#############################################################################
+
+/*
+ * Function name: rb5_qc_raw_2_value
+ * Intent: raw code in physical units, as gain and offset are written by
+ *         populateParam() (data_step, data_range_min)
+ */
+double rb5_qc_raw_2_value(const strRB5_PARAM_INFO *rb5_param, double raw) {
+    return(raw*rb5_param->data_step + rb5_param->data_range_min);
+}
+
+//#############################################################################
+
+// one ray of nbins codes of the given type; the loop is the same for all depths
+#define RB5_QC_RAYS(type) { \
+    const type *arr=(const type *)raw_arr; \
+    for (iray = 0; iray < nrays; iray++) { \
+      size_t n_echo_ray=0; \
+      const type *ray=arr+iray*nbins; \
+      for (ibin = 0; ibin < nbins; ibin++) { \
+        unsigned int code=ray[ibin]; \
+        qc->hist[code >> shift]++; \
+        if (code == 0) { \
+          qc->n_undetect++; \
+        } else if (code == nodata) { \
+          qc->n_nodata++; \
+        } else { \
+          n_echo_ray++; \
+          raw_sum+=code; \
+          if (code < raw_min) raw_min=code; \
+          if (code > raw_max) raw_max=code; \
+        } \
+      } \
+      qc->n_echo+=n_echo_ray; \
+      if (ray_coverage != NULL) ray_coverage[iray]=(double)n_echo_ray/nbins; \
+    } \
+}
+
+/*
+ * Function name: rb5_qc_moment
+ * Intent: statistics of one moment's raw codes (nrays x nbins, host order,
+ *         as return_param_blobid_raw() returns them) after convert_raw_to_data()
+ *         has set raw_binary_max; ray_coverage, nrays long, may be NULL
+ */
+int rb5_qc_moment(const strRB5_PARAM_INFO *rb5_param, const void *raw_arr, strRB5_QC_STATS *qc, double *ray_coverage) {
+
+    size_t depth=rb5_param->raw_binary_depth;
+    size_t nrays=rb5_param->nrays;
+    size_t nbins=rb5_param->nbins;
+    size_t iray, ibin;
+
+    memset(qc,0,sizeof(strRB5_QC_STATS));
+    if (raw_arr == NULL || nrays*nbins == 0 || nrays*nbins != rb5_param->n_elems_data) return(EXIT_FAILURE);
+    if (depth != 8 && depth != 16 && depth != 32) return(EXIT_FAILURE);
+
+    unsigned int nodata=(unsigned int)rb5_param->raw_binary_max;
+    unsigned int shift=depth-8;
+    unsigned int raw_min=~0U;
+    unsigned int raw_max=0;
+    double raw_sum=0.0;
+
+    qc->nrays=nrays;
+    qc->nbins=nbins;
+    qc->n_samples=nrays*nbins;
+    qc->hist_binwidth=(size_t)1 << shift;
+
+           if (depth ==  8) RB5_QC_RAYS(uint8_t)
+      else if (depth == 16) RB5_QC_RAYS(uint16_t)
+      else                  RB5_QC_RAYS(uint32_t)
+
+    qc->raw_min=qc->n_echo ? raw_min : 0;
+    qc->raw_max=raw_max;
+    qc->raw_sum=raw_sum;
+    return(EXIT_SUCCESS);
+
+}
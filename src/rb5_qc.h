@@ -0,0 +1,39 @@
+#ifndef RB5_QC_H
+#define RB5_QC_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rb5_utils.h" //strRB5_PARAM_INFO
+
+//#############################################################################
+// per-moment statistics of one sweep, counted over the raw codes as they are
+// decoded; nodata and undetect follow populateParam(): raw_binary_max and 0
+#define RB5_QC_NBINS 256 // histogram bins over raw codes, 16/32 bit codes binned by their top 8 bits
+
+typedef struct{
+    size_t nrays;
+    size_t nbins;
+    size_t n_samples;
+    size_t n_nodata;
+    size_t n_undetect;
+    size_t n_echo;              // neither nodata nor undetect
+    unsigned int raw_min;       // of the echoes, valid if n_echo
+    unsigned int raw_max;
+    double raw_sum;
+    size_t hist_binwidth;       // raw codes per histogram bin
+    size_t hist[RB5_QC_NBINS];  // all samples, nodata and undetect included
+} strRB5_QC_STATS;
+
+//#############################################################################
+// per-thread switch, set before decoding (see populateParam())
+extern __thread int rb5_qc_on;
+
+//#############################################################################
+// function declarations
+void rb5_qc_enable(int on);
+int rb5_qc_moment(const strRB5_PARAM_INFO *rb5_param, const void *raw_arr, strRB5_QC_STATS *qc, double *ray_coverage);
+double rb5_qc_raw_2_value(const strRB5_PARAM_INFO *rb5_param, double raw);
+
+#endif
@@ -0,0 +1,278 @@
+/*
+ * rb5_strategy.c
+ *
+ * Scan-strategy cache: files of the same task and Rainbow version share their
+ * XML structure and slice geometry (angles, range and angle steps, PRFs, pulse
+ * width, thresholds, radconst), only times, blob sizes and status fields change.
+ * The first file of a strategy is parsed in full and its static slice
+ * parameters are kept here; later files copy them and parse the dynamic
+ * fields only. Entries are only reused while the XML structure fingerprint
+ * matches, so a strategy that gains or loses slices or moments is re-parsed.
+ * The values of the static elements are hashed as well and checked on every
+ * hit: a recalibration (radconst), a PRF or threshold change invalidates the
+ * entry, the file is parsed in full and its statics replace the old ones.
+ *
+ * compile only: gcc -g -I/usr/include/libxml2 -c rb5_strategy.c -o rb5_strategy.o
+ *
+ */
+
+#include "rb5_strategy.h"
+
+#define COPY_SLICE_FIELD(dst,src,field) memcpy((dst)->field,(src)->field,sizeof((src)->field))
+
+static strRB5_STRATEGY strategy_arr[RB5_STRATEGY_MAX_ENTRIES];
+static size_t n_strategies=0;
+static size_t n_used=0; // LRU clock
+static size_t n_hits=0;
+static size_t n_misses=0;
+static int strategy_on=-1; // -1 until decided from RB5_STRATEGY_ENV
+static pthread_mutex_t strategy_lock=PTHREAD_MUTEX_INITIALIZER;
+
+/* elements read by populate_slice_statics(), their text and attribute values are hashed */
+static const char *static_elements[]={
+    "posangle","dynv","dynw","rangestep","start_range","stoprange",
+    "anglestep","startangle","stopangle","dynpw","pw_index","antspeed",
+    "timesamp","dualprfmode","stagger","highprf","lowprf",
+    "csr","sqi","zsqi","log","rspdphradconst","rspdpvradconst",NULL};
+
+//#############################################################################
+
+/* called with strategy_lock held */
+static int strategy_enabled(void) {
+    if (strategy_on == -1) {
+      const char *val=getenv(RB5_STRATEGY_ENV);
+      strategy_on=!(val != NULL && (strcmp(val,"off") == 0 || strcmp(val,"0") == 0));
+    }
+    return(strategy_on);
+}
+
+static void strategy_key(strRB5_INFO *rb5_info, char *key, size_t len) {
+    snprintf(key,len,"%s|%s|%s|%s|%s",
+        rb5_info->sensor_id,
+        rb5_info->history_exists ? rb5_info->history_sdfname : "",
+        rb5_info->scan_name,
+        rb5_info->scan_type,
+        rb5_info->rainbow_version);
+}
+
+/* static slice parameters one way or the other, L_TO_INFO for a hit */
+static void copy_slice_statics(strRB5_STRATEGY *strategy, strRB5_INFO *rb5_info, int L_TO_INFO) {
+    if (L_TO_INFO) {
+      COPY_SLICE_FIELD(rb5_info,strategy,angle_deg_arr);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_nyquist_vel);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_nyquist_wid);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_bin_range_res_km);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_bin_range_bgn_km);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_bin_range_end_km);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_ray_angle_res_deg);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_ray_angle_bgn_deg);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_ray_angle_end_deg);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_pw_index);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_pw_microsec);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_antspeed_deg_sec);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_antspeed_rpm);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_num_samples);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_dual_prf_mode);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_prf_stagger);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_hi_prf);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_lo_prf);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_csr_threshold);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_sqi_threshold);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_zsqi_threshold);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_log_threshold);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_radconst_h);
+      COPY_SLICE_FIELD(rb5_info,strategy,slice_radconst_v);
+    } else {
+      COPY_SLICE_FIELD(strategy,rb5_info,angle_deg_arr);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_nyquist_vel);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_nyquist_wid);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_bin_range_res_km);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_bin_range_bgn_km);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_bin_range_end_km);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_ray_angle_res_deg);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_ray_angle_bgn_deg);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_ray_angle_end_deg);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_pw_index);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_pw_microsec);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_antspeed_deg_sec);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_antspeed_rpm);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_num_samples);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_dual_prf_mode);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_prf_stagger);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_hi_prf);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_lo_prf);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_csr_threshold);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_sqi_threshold);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_zsqi_threshold);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_log_threshold);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_radconst_h);
+      COPY_SLICE_FIELD(strategy,rb5_info,slice_radconst_v);
+    }
+}
+
+static int is_static_element(const char *name, size_t len) {
+    const char **elem;
+    for (elem = static_elements; *elem != NULL; elem++) {
+      if (strlen(*elem) == len && strncmp(*elem,name,len) == 0) return(1);
+    }
+    return(0);
+}
+
+#define FNV_STEP(h,c) ((h)=((h) ^ (unsigned char)(c))*16777619U)
+
+//#############################################################################
+
+/*
+ * Function name: rb5_strategy_enable
+ * Intent: switch the cache on or off, overrides RB5_STRATEGY_ENV
+ */
+void rb5_strategy_enable(int on) {
+    pthread_mutex_lock(&strategy_lock);
+    strategy_on=(on != 0);
+    pthread_mutex_unlock(&strategy_lock);
+}
+
+/*
+ * Function name: rb5_strategy_fingerprint
+ * Intent: FNV-1a of the element and attribute names of an XML header, in
+ *         order, values and closing tags left out. Slices, moments and
+ *         rayinfos all show up as elements, their times and sizes do not.
+ *         *values (if not NULL) gets FNV-1a of the text and attribute values
+ *         of the static elements, i.e. of what a hit copies from the cache.
+ */
+uint32_t rb5_strategy_fingerprint(const char *xml, size_t xml_len, uint32_t *values) {
+    uint32_t h=2166136261U;
+    uint32_t v=2166136261U;
+    size_t i=0;
+    while (i < xml_len) {
+      if (xml[i++] != '<') continue;
+      if (i < xml_len && (xml[i] == '/' || xml[i] == '!' || xml[i] == '?')) continue; //end tag, comment or declaration
+      h=(h ^ '<')*16777619U;
+      size_t name=i;
+      while (i < xml_len && xml[i] != '>' && xml[i] != '/' && xml[i] != ' ' && xml[i] != '\t' && xml[i] != '\n' && xml[i] != '\r') i++;
+      int L_STATIC=is_static_element(&xml[name],i-name);
+      if (L_STATIC) {
+        for (size_t j = name; j < i; j++) FNV_STEP(v,xml[j]);
+      }
+      i=name;
+      while (i < xml_len && xml[i] != '>') {
+        if (xml[i] == '"' || xml[i] == '\'') { //attribute value, left out of the structure
+          char quote=xml[i++];
+          while (i < xml_len && xml[i] != quote) {
+            if (L_STATIC) FNV_STEP(v,xml[i]);
+            i++;
+          }
+          i++;
+          continue;
+        }
+        if (xml[i] != '=') FNV_STEP(h,xml[i]);
+        i++;
+      }
+      if (L_STATIC) { //text up to the next tag
+        FNV_STEP(v,'>');
+        for (i++; i < xml_len && xml[i] != '<'; i++) FNV_STEP(v,xml[i]);
+      }
+    }
+    if (values != NULL) *values=v;
+    return(h);
+}
+
+/*
+ * Function name: rb5_strategy_lookup
+ * Intent: on a hit, fill the static slice parameters of rb5_info (n_slices,
+ *         sensor, history and scan fields already populated) and return
+ *         EXIT_SUCCESS; EXIT_FAILURE means parse them and rb5_strategy_store().
+ *         An entry whose static values no longer match is not used, the
+ *         following store overwrites it.
+ */
+int rb5_strategy_lookup(strRB5_INFO *rb5_info) {
+    char key[sizeof(((strRB5_STRATEGY *)0)->key)];
+    int ret=EXIT_FAILURE;
+    size_t i;
+
+    if (rb5_info->buffer == NULL || rb5_info->n_slices == 0 || rb5_info->n_slices > MAX_SLICES) return(EXIT_FAILURE);
+    strategy_key(rb5_info,key,sizeof(key));
+    uint32_t values;
+    uint32_t fingerprint=rb5_strategy_fingerprint(rb5_info->buffer,rb5_info->byte_offset_blobspace,&values);
+
+    pthread_mutex_lock(&strategy_lock);
+    if (strategy_enabled()) {
+      for (i = 0; i < n_strategies; i++) {
+        strRB5_STRATEGY *strategy=&strategy_arr[i];
+        if (strategy->fingerprint == fingerprint && strategy->n_slices == rb5_info->n_slices && strcmp(strategy->key,key) == 0) {
+          if (strategy->values != values) break; //recalibrated or reconfigured, stale
+          copy_slice_statics(strategy,rb5_info,1);
+          strategy->last_used=++n_used;
+          ret=EXIT_SUCCESS;
+          break;
+        }
+      }
+      if (ret == EXIT_SUCCESS) n_hits++;
+      else                     n_misses++;
+    }
+    pthread_mutex_unlock(&strategy_lock);
+    return(ret);
+}
+
+/*
+ * Function name: rb5_strategy_store
+ * Intent: keep the static slice parameters of a fully parsed rb5_info,
+ *         evicting the least recently used strategy when full
+ */
+void rb5_strategy_store(strRB5_INFO *rb5_info) {
+    char key[sizeof(((strRB5_STRATEGY *)0)->key)];
+    size_t i;
+
+    if (rb5_info->buffer == NULL || rb5_info->n_slices == 0 || rb5_info->n_slices > MAX_SLICES) return;
+    strategy_key(rb5_info,key,sizeof(key));
+    uint32_t values;
+    uint32_t fingerprint=rb5_strategy_fingerprint(rb5_info->buffer,rb5_info->byte_offset_blobspace,&values);
+
+    pthread_mutex_lock(&strategy_lock);
+    if (strategy_enabled()) {
+      strRB5_STRATEGY *strategy=NULL;
+      for (i = 0; i < n_strategies && strategy == NULL; i++) { //same strategy, stale or stored by another thread meanwhile
+        if (strategy_arr[i].fingerprint == fingerprint && strcmp(strategy_arr[i].key,key) == 0) strategy=&strategy_arr[i];
+      }
+      if (strategy == NULL && n_strategies < RB5_STRATEGY_MAX_ENTRIES) strategy=&strategy_arr[n_strategies++];
+      if (strategy == NULL) {
+        strategy=&strategy_arr[0];
+        for (i = 1; i < n_strategies; i++) {
+          if (strategy_arr[i].last_used < strategy->last_used) strategy=&strategy_arr[i];
+        }
+      }
+      strcpy(strategy->key,key);
+      strategy->fingerprint=fingerprint;
+      strategy->values=values;
+      strategy->n_slices=rb5_info->n_slices;
+      strategy->last_used=++n_used;
+      copy_slice_statics(strategy,rb5_info,0);
+    }
+    pthread_mutex_unlock(&strategy_lock);
+}
+
+/*
+ * Function name: rb5_strategy_stats
+ * Intent: lookups that hit and missed, and strategies held, since start or
+ *         rb5_strategy_clear()
+ */
+void rb5_strategy_stats(size_t *hits, size_t *misses, size_t *entries) {
+    pthread_mutex_lock(&strategy_lock);
+    if (hits    != NULL) *hits=n_hits;
+    if (misses  != NULL) *misses=n_misses;
+    if (entries != NULL) *entries=n_strategies;
+    pthread_mutex_unlock(&strategy_lock);
+}
+
+/*
+ * Function name: rb5_strategy_clear
+ * Intent: forget all strategies, e.g. after a change of scan definitions
+ */
+void rb5_strategy_clear(void) {
+    pthread_mutex_lock(&strategy_lock);
+    n_strategies=0;
+    n_used=0;
+    n_hits=0;
+    n_misses=0;
+    pthread_mutex_unlock(&strategy_lock);
+}
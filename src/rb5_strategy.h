@@ -0,0 +1,61 @@
+#ifndef RB5_STRATEGY_H
+#define RB5_STRATEGY_H
+
+#include "rb5_utils.h"
+
+#include <pthread.h>
+
+// process-level cache of the static slice parameters of a scan strategy
+// (task), so that later files of the same strategy skip their XPath lookups
+// key: sensor id, sdfname (empty without <history>), scan name and type,
+// Rainbow version, plus a fingerprint of the XML structure; a hit also needs
+// the values of the static elements unchanged (recalibration, PRF, thresholds)
+#define RB5_STRATEGY_MAX_ENTRIES 64   // a network repeats a few dozen strategies
+#define RB5_STRATEGY_ENV "RB5_STRATEGY_CACHE" // RB5_STRATEGY_CACHE=off to always parse
+
+//#############################################################################
+// per slice, as in strRB5_INFO; dynamic fields (times, noise power, nrays,
+// readbacks) are always parsed
+typedef struct{
+    char key[5*MAX_STRING+8];
+    uint32_t fingerprint;     // element and attribute names of the XML header, see rb5_strategy_fingerprint()
+    uint32_t values;          // values of its static elements, checked on every hit
+    size_t n_slices;
+    size_t last_used;         // LRU stamp
+
+    float angle_deg_arr[MAX_SLICES];
+    float slice_nyquist_vel[MAX_SLICES];
+    float slice_nyquist_wid[MAX_SLICES];
+    float slice_bin_range_res_km[MAX_SLICES];
+    float slice_bin_range_bgn_km[MAX_SLICES];
+    float slice_bin_range_end_km[MAX_SLICES];
+    float slice_ray_angle_res_deg[MAX_SLICES];
+    float slice_ray_angle_bgn_deg[MAX_SLICES];
+    float slice_ray_angle_end_deg[MAX_SLICES];
+    size_t slice_pw_index[MAX_SLICES];
+    float slice_pw_microsec[MAX_SLICES];
+    float slice_antspeed_deg_sec[MAX_SLICES];
+    float slice_antspeed_rpm[MAX_SLICES];
+    size_t slice_num_samples[MAX_SLICES];
+    char slice_dual_prf_mode[MAX_STRING][MAX_SLICES];
+    char slice_prf_stagger[MAX_STRING][MAX_SLICES];
+    float slice_hi_prf[MAX_SLICES];
+    float slice_lo_prf[MAX_SLICES];
+    float slice_csr_threshold[MAX_SLICES];
+    float slice_sqi_threshold[MAX_SLICES];
+    float slice_zsqi_threshold[MAX_SLICES];
+    float slice_log_threshold[MAX_SLICES];
+    float slice_radconst_h[MAX_SLICES];
+    float slice_radconst_v[MAX_SLICES];
+} strRB5_STRATEGY;
+
+//#############################################################################
+// function declarations
+void rb5_strategy_enable(int on);
+uint32_t rb5_strategy_fingerprint(const char *xml, size_t xml_len, uint32_t *values);
+int rb5_strategy_lookup(strRB5_INFO *rb5_info);
+void rb5_strategy_store(strRB5_INFO *rb5_info);
+void rb5_strategy_stats(size_t *hits, size_t *misses, size_t *entries);
+void rb5_strategy_clear(void);
+
+#endif
@@ -0,0 +1,258 @@
+/*
+ * rb5_tarball.c
+ *
+ * Native ingestion of RB5 moment tarballs, the equivalent of
+ * rb52odim.combineRB5FromTarball(): members of a (gz-compressed) ustar
+ * tarball are streamed in a single pass, each rawdata member is decoded
+ * from memory, and its moment is merged into one PolarScan/PolarVolume
+ * (see rb5_merge.c).
+ *
+ * compile only: gcc -g -I/usr/include/libxml2 -c rb5_tarball.c -o rb5_tarball.o
+ *
+ */
+
+#include "rb5_tarball.h"
+
+//#############################################################################
+
+/* octal numeric field of a ustar header, space or NUL terminated */
+static size_t tar_octal(const char *field, size_t len) {
+    size_t value=0;
+    size_t i;
+    for (i = 0; i < len && (field[i] == ' ' || field[i] == '0'); i++);
+    for (; i < len && field[i] >= '0' && field[i] <= '7'; i++) value=(value << 3) + (field[i] - '0');
+    return value;
+}
+
+/* header checksum, with the chksum field itself counted as spaces */
+static int tar_checksum_ok(const unsigned char *header) {
+    size_t sum=0;
+    int i;
+    for (i = 0; i < TAR_BLOCK_SIZE; i++) sum+=(i >= 148 && i < 156) ? ' ' : header[i];
+    return sum == tar_octal((const char *)header+148,8);
+}
+
+/* consumes the rest of the current member, including its block padding */
+static int tar_skip_member(strRB5_TARBALL *tar) {
+    size_t padding=(TAR_BLOCK_SIZE - tar->member_size % TAR_BLOCK_SIZE) % TAR_BLOCK_SIZE;
+    size_t skip=tar->member_unread + padding;
+    tar->member_unread=0;
+    tar->member_size=0;
+    if (skip == 0) return(EXIT_SUCCESS);
+    if (gzseek(tar->fp,(z_off_t)skip,SEEK_CUR) < 0) {
+        fprintf(stderr,"Error: truncated tarball member %s\n", tar->member_name);
+        return(EXIT_FAILURE);
+    }
+    return(EXIT_SUCCESS);
+}
+
+//#############################################################################
+
+int open_rb5_tarball(const char *inp_fname, strRB5_TARBALL *tar) {
+
+    memset(tar,0,sizeof(strRB5_TARBALL));
+    tar->fp=gzopen(inp_fname, "r"); //also reads uncompressed tarballs
+    if (! tar->fp) {
+        fprintf(stderr,"gzopen of '%s' failed: %s.\n", inp_fname, strerror(errno));
+        return(EXIT_FAILURE);
+    }
+    gzbuffer(tar->fp,0x20000);
+    return(EXIT_SUCCESS);
+}
+
+//#############################################################################
+
+/*
+ * Advances to the next member header. Returns 1 if a member was found,
+ * 0 at the end of the archive and -1 on a read or format error.
+ * GNU long names ('L' members) are folded into the following header.
+ */
+int next_rb5_tarball_member(strRB5_TARBALL *tar) {
+
+    unsigned char header[TAR_BLOCK_SIZE];
+    char long_name[MAX_TAR_NAME]="\0";
+
+    while (1) {
+        if (tar_skip_member(tar) != EXIT_SUCCESS) return(-1);
+
+        int bytes_read=gzread(tar->fp,header,TAR_BLOCK_SIZE);
+        if (bytes_read == 0) return(0); //no end-of-archive blocks, tolerate
+        if (bytes_read != TAR_BLOCK_SIZE) {
+            fprintf(stderr,"Error: truncated tarball header\n");
+            return(-1);
+        }
+        if (header[0] == '\0') return(0); //end-of-archive block
+        if (!tar_checksum_ok(header)) {
+            fprintf(stderr,"Error: bad tarball header checksum, not a ustar tarball?\n");
+            return(-1);
+        }
+
+        tar->member_type=(char)header[156];
+        tar->member_size=tar_octal((const char *)header+124,12);
+        tar->member_unread=tar->member_size;
+
+        if (tar->member_type == 'L') { //GNU long name of the next member
+            size_t len=tar->member_size < MAX_TAR_NAME ? tar->member_size : MAX_TAR_NAME-1;
+            if (gzread(tar->fp,long_name,len) != (int)len) return(-1);
+            long_name[len]='\0';
+            tar->member_unread-=len;
+            continue;
+        }
+
+        if (long_name[0] != '\0') {
+            strcpy(tar->member_name,long_name);
+        } else if (memcmp(header+257,"ustar",5) == 0 && header[345] != '\0') {
+            snprintf(tar->member_name,MAX_TAR_NAME,"%.155s/%.100s",(char *)header+345,(char *)header);
+        } else {
+            snprintf(tar->member_name,MAX_TAR_NAME,"%.100s",(char *)header);
+        }
+        return(1);
+    }
+}
+
+//#############################################################################
+
+/*
+ * Reads the current member into a NUL-terminated malloc() buffer, to be
+ * handed to getRaveIObuf() which frees it. Returns the member size, 0 on error.
+ */
+size_t read_rb5_tarball_member(strRB5_TARBALL *tar, char **return_buffer) {
+
+    size_t EXIT_NULL_VAL=0;
+    size_t buffer_len=tar->member_unread;
+    strRB5_PROFILE_MARK prof=rb5_profile_begin();
+
+    char *buffer=rb5_mem_malloc(sizeof(char)*(buffer_len+1));
+    if (buffer == NULL) {
+        fprintf(stderr,"Error: cannot allocate %ld bytes for %s\n", buffer_len, tar->member_name);
+        return(EXIT_NULL_VAL);
+    }
+    if (gzread(tar->fp,buffer,buffer_len) != (int)buffer_len) {
+        fprintf(stderr,"Error while reading tarball member %s\n", tar->member_name);
+        rb5_mem_free(buffer);
+        return(EXIT_NULL_VAL);
+    }
+    buffer[buffer_len]='\0';
+    tar->member_unread=0;
+
+    *return_buffer=buffer;
+    rb5_profile_end(RB5_PROFILE_GZ_READ,prof,buffer_len);
+    return(buffer_len);
+}
+
+//#############################################################################
+
+void close_rb5_tarball(strRB5_TARBALL *tar) {
+
+    if (tar->fp) gzclose(tar->fp);
+    tar->fp=NULL;
+}
+
+//#############################################################################
+
+/* same conventions as rb52odim.parse_tarball_member_name() */
+void parse_rb5_tarball_member_name(const char *name, strRB5_TARBALL_MEMBER *mb) {
+
+    char path[MAX_TAR_NAME]="\0";
+    char *elem_arr[MAX_NSTRINGS];
+    int nELEMs=0;
+
+    memset(mb,0,sizeof(strRB5_TARBALL_MEMBER));
+    snprintf(path,MAX_TAR_NAME,"%s",name);
+
+    char *saveptr=NULL; //strtok_r(), tarballs are read on concurrent threads
+    char *token=strtok_r(path,"/",&saveptr);
+    while (token != NULL && nELEMs < MAX_NSTRINGS) {
+        elem_arr[nELEMs++]=token;
+        token=strtok_r(NULL,"/",&saveptr);
+    }
+    if (nELEMs == 0) return;
+
+    //strip 'sSITE_' prefix, not part of tarball member syntax
+    char *basefile=strrchr(elem_arr[nELEMs-1],'_');
+    basefile=basefile ? basefile+1 : elem_arr[nELEMs-1];
+    snprintf(mb->basefile,MAX_STRING,"%s",basefile);
+
+    char *dot=strchr(mb->basefile,'.');
+    if (dot != NULL) {
+        snprintf(mb->scan_type,MAX_STRING,"%s",dot+1);
+        if (dot-mb->basefile > 16) snprintf(mb->sparam,MAX_STRING,"%.*s",(int)(dot-mb->basefile-16),mb->basefile+16);
+    }
+
+    if (nELEMs >= 2) snprintf(mb->rb5_date,MAX_STRING,"%s",elem_arr[nELEMs-2]);
+    if (nELEMs >= 3) {
+        char *sdf=elem_arr[nELEMs-3];
+        size_t sdf_len=strlen(sdf);
+        size_t typ_len=strlen(mb->scan_type);
+        if (sdf_len < typ_len || strcmp(sdf+sdf_len-typ_len,mb->scan_type) != 0) {
+            snprintf(mb->rb5_ppdf,MAX_STRING,"%s",sdf); //check for ppdf, sdf unknown until decode
+        } else {
+            snprintf(mb->rb5_sdf,MAX_STRING,"%s",sdf);
+        }
+    }
+    if (nELEMs >= 4) snprintf(mb->rb5_site,MAX_STRING,"%s",elem_arr[nELEMs-4]);
+    if (nELEMs >= 5) snprintf(mb->rb5_ftype,MAX_STRING,"%s",elem_arr[nELEMs-5]);
+}
+
+//#############################################################################
+
+/*
+ * Function name: getRaveIOFromTarball
+ * Intent: Decode all rawdata members of an RB5 moment tarball and merge them
+ * into one scan or volume. The object is NULL if any member fails.
+ */
+RaveIO_t* getRaveIOFromTarball(const char* ifile) {
+
+    RaveIO_t* raveio = RAVE_OBJECT_NEW(&RaveIO_TYPE);
+    RaveCoreObject* big_obj = NULL;
+    strRB5_TARBALL tar;
+    strRB5_TARBALL_MEMBER mb;
+    int found = 0;
+    int ret = 1;
+
+    if (open_rb5_tarball(ifile,&tar) != EXIT_SUCCESS) return raveio;
+
+    while (ret && (found = next_rb5_tarball_member(&tar)) == 1) {
+        if (tar.member_type != '0' && tar.member_type != '\0') continue; //regular files only
+        parse_rb5_tarball_member_name(tar.member_name,&mb);
+
+        //XAH DPATC_replay: Special filter out for ZPHI_ITER_DEFAULT.dpatc & ZDR
+        if (strcmp(mb.rb5_ftype,"rawdata") != 0) continue;
+        if ((strcmp(mb.rb5_ppdf,"ZPHI_ITER_DEFAULT.dpatc") == 0) && (strcmp(mb.sparam,"ZDR") == 0)) continue;
+
+        char *rb5_buffer=NULL;
+        size_t buffer_len=read_rb5_tarball_member(&tar,&rb5_buffer);
+        if (buffer_len == 0) {
+            ret = 0;
+            break;
+        }
+        if (isRainbow5buf(&rb5_buffer)) {
+            fprintf(stderr,"Error: %s is not a proper RB5 buffer\n", tar.member_name);
+            rb5_mem_free(rb5_buffer);
+            ret = 0;
+            break;
+        }
+
+        RaveIO_t* member_rio = getRaveIObuf(tar.member_name,&rb5_buffer,buffer_len); //frees rb5_buffer
+        RaveCoreObject* object = RaveIO_getObject(member_rio);
+
+        if (RAVE_OBJECT_CHECK_TYPE(object, &PolarVolume_TYPE) &&
+            (big_obj == NULL || RAVE_OBJECT_CHECK_TYPE(big_obj, &PolarVolume_TYPE))) {
+            ret = mergeVolumeParameters((PolarVolume_t**)&big_obj,(PolarVolume_t*)object,mb.rb5_ppdf);
+        } else if (RAVE_OBJECT_CHECK_TYPE(object, &PolarScan_TYPE) &&
+            (big_obj == NULL || RAVE_OBJECT_CHECK_TYPE(big_obj, &PolarScan_TYPE))) {
+            ret = mergeScanParameter((PolarScan_t**)&big_obj,(PolarScan_t*)object,mb.rb5_ppdf);
+        } else {
+            fprintf(stderr,"Error: cannot merge tarball member %s\n", tar.member_name);
+            ret = 0;
+        }
+        RAVE_OBJECT_RELEASE(object);
+        RAVE_OBJECT_RELEASE(member_rio);
+    }
+    close_rb5_tarball(&tar);
+
+    if (ret && found >= 0 && big_obj != NULL) RaveIO_setObject(raveio, big_obj);
+    RAVE_OBJECT_RELEASE(big_obj);
+
+    return raveio;
+}
@@ -0,0 +1,44 @@
+#ifndef RB5_TARBALL_H
+#define RB5_TARBALL_H
+
+#include "rb52odim.h"
+#include "rb5_merge.h"
+
+#define TAR_BLOCK_SIZE 512
+#define MAX_TAR_NAME MAX_PATH_STRING
+
+//#############################################################################
+// single-pass reader over a (gz-compressed) ustar tarball
+typedef struct{
+    gzFile fp;
+    char member_name[MAX_TAR_NAME]; // prefix/name of the current member
+    char member_type;               // ustar typeflag of the current member
+    size_t member_size;
+    size_t member_unread;           // bytes of the current member not yet consumed
+} strRB5_TARBALL;
+
+//#############################################################################
+// tarball member path, as parsed by rb52odim.parse_tarball_member_name()
+// e.g. rawdata/XAH/DOPVOL1_A.azi/2015-12-09/2015120916500500dBZ.azi
+typedef struct{
+    char basefile[MAX_STRING];
+    char sparam[MAX_STRING];
+    char scan_type[MAX_STRING];
+    char rb5_date[MAX_STRING];
+    char rb5_sdf[MAX_STRING];
+    char rb5_ppdf[MAX_STRING];
+    char rb5_site[MAX_STRING];
+    char rb5_ftype[MAX_STRING];
+} strRB5_TARBALL_MEMBER;
+
+//#############################################################################
+// function declarations
+int open_rb5_tarball(const char *inp_fname, strRB5_TARBALL *tar);
+int next_rb5_tarball_member(strRB5_TARBALL *tar);
+size_t read_rb5_tarball_member(strRB5_TARBALL *tar, char **return_buffer);
+void close_rb5_tarball(strRB5_TARBALL *tar);
+void parse_rb5_tarball_member_name(const char *name, strRB5_TARBALL_MEMBER *mb);
+
+RaveIO_t* getRaveIOFromTarball(const char* ifile);
+
+#endif
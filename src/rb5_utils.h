@@ -1,5 +1,9 @@
-#include <stdint.h> //for uint8_t, uint16_t, uint32_t
+#ifndef RB5_UTILS_H
+#define RB5_UTILS_H
+
+#include <stdint.h> //for uint8_t, uint16_t, uint32_t, int64_t
 #include <stdio.h>
+#include <float.h> //for FLT_MAX
 #include <ctype.h> //for toupper()
 #include <stdlib.h>
 #include <string.h>
@@ -12,10 +16,13 @@
 #include <libxml/xpath.h>
 #include <libxml/xpathInternals.h>
 
+#include "rb5_params.h" //parameter registry
+
 #define L_DEBUG_OUTPUT_1 0
 #define L_DEBUG_OUTPUT_2 0
 
 #define MAX_STRING 256
+#define MAX_PATH_STRING 1024 // input names, e.g. tarball member paths
 #define MAX_NSTRINGS 32
 #define MAX_SLICES 32
 #define MAX_PARAMS MAX_NSTRINGS
@@ -26,15 +33,17 @@
 #define MINIMUM_RAINBOW_VERSION "5.43.10" //wrt CAX1 delivery (sensorinfo attribs have been updated)
 
 typedef struct{
-    char inp_fullfile[MAX_STRING];
+    char inp_fullfile[MAX_PATH_STRING];
     char inp_file_basename[MAX_STRING];
-    char inp_file_dirname[MAX_STRING];
+    char inp_file_dirname[MAX_PATH_STRING];
     char inp_file_data_type[MAX_STRING];
     char *buffer;
     size_t buffer_len;
     xmlDoc *doc;
     xmlXPathContextPtr xpathCtx;
     size_t byte_offset_blobspace;
+    void *cache; //strRB5_CACHE (see rb5_cache.h) serving decoded blobs, NULL to decode from buffer
+    void *passthrough; //strRB5_PASSTHROUGH (see rb5_passthrough.h) collecting blobs to copy into HDF5 as is, NULL to decode all
 
     char rainbow_version[MAX_STRING];
     char xml_block_name[MAX_STRING];
@@ -67,6 +76,10 @@ typedef struct{
     char slice_iso8601_bgn    [MAX_STRING][MAX_SLICES];
     char slice_iso8601_end_est[MAX_STRING][MAX_SLICES];
     char slice_iso8601_end    [MAX_STRING][MAX_SLICES];
+    int64_t slice_epoch_ms_bgn_low[MAX_SLICES]; //parsed once from slice_iso8601_*, see time_utils.h
+    int64_t slice_epoch_ms_bgn    [MAX_SLICES];
+    int64_t slice_epoch_ms_end_est[MAX_SLICES];
+    int64_t slice_epoch_ms_end    [MAX_SLICES];
     double slice_dur_secs_est[MAX_SLICES];
     double slice_dur_secs    [MAX_SLICES];
     float angle_deg_arr[MAX_SLICES];
@@ -104,6 +117,7 @@ typedef struct{
     size_t n_elems_data[MAX_SLICES];
     size_t iray_0degN[MAX_SLICES];
 
+    //views into slice_angle_block, see get_slice_mid_angle_readbacks()
     float* slice_moving_angle_start_arr[MAX_SLICES];
     float* slice_moving_angle_stop_arr[MAX_SLICES];
     float* slice_fixed_angle_start_arr[MAX_SLICES];
@@ -111,16 +125,20 @@ typedef struct{
 
     float* slice_moving_angle_arr[MAX_SLICES];
     float* slice_fixed_angle_arr[MAX_SLICES];
+    float* slice_angle_block[MAX_SLICES]; //RB5_N_RAY_ANGLES*nrays, the only allocation; NULL until then, memset() strRB5_INFO where it is set up
 
     size_t n_rayinfos;
     size_t n_rawdatas;
     char rayinfo_name_arr[MAX_STRING][MAX_PARAMS];
     char rawdata_name_arr[MAX_STRING][MAX_PARAMS];
+    int rayinfo_idx_by_role[RB5_N_RAYINFO_ROLES]; //index into rayinfo_name_arr, -1 if absent
+    int rawdata_idx_by_param[RB5_N_PARAMS];       //index into rawdata_name_arr, -1 if absent
 } strRB5_INFO;
 
 typedef struct{
     char xpath_bgn[MAX_STRING];
     char sparam[MAX_STRING];
+    int param_id; //registry id of sparam, RB5_PARAM_UNKNOWN if not registered
     char iso8601[MAX_STRING];
     size_t blobid;
     size_t size_blob;
@@ -136,7 +154,7 @@ typedef struct{
     size_t nbins;
     size_t iray_0degN;
 
-    char conversion[MAX_STRING];
+    RB5_CONVERSION conversion;
     float data_range_min;
     float data_range_max;
     float data_range_width;
@@ -151,12 +169,36 @@ typedef struct{
     char desc[MAX_STRING];
 } strURPDATA;
 
+//#############################################################################
+// per-slice ray angle readbacks, RB5_N_RAY_ANGLES arrays of nrays floats one
+// after the other in strRB5_INFO.slice_angle_block
+typedef enum {
+    RB5_RAY_MOVING_START=0,
+    RB5_RAY_MOVING_STOP,
+    RB5_RAY_FIXED_START,
+    RB5_RAY_FIXED_STOP,
+    RB5_RAY_MOVING_MID,
+    RB5_RAY_FIXED_MID,
+    RB5_N_RAY_ANGLES
+} RB5_RAY_ANGLE;
+
+// slice constants of rb5_ray_angle_kernel(), decided once instead of per ray
+typedef struct{
+    int L_READBACK[RB5_RAY_MOVING_MID];     // start/stop slot holds decoded readbacks, else the default below
+    float wrap_above[RB5_RAY_MOVING_MID];   // readbacks above it are negative angles (-360), RHI moving and PPI fixed
+    float moving_stop_res;                // no stopangle: start + ray angle resolution
+    float fixed_default;                  // no startfixangle/stopfixangle: the slice angle
+    float precision_factor;               // readbacks rounded to 1/precision_factor deg
+} strRB5_RAY_ANGLE_KERNEL;
+
 //#############################################################################
 // function declarations
 //#############################################################################
 size_t uncompress_this_blob(unsigned char *buf, unsigned char** return_uncompressed_blob, size_t compressed_size_blob);
+size_t get_blobid_compressed(strRB5_INFO *rb5_info, int req_blobid, unsigned char** return_compressed_blob);
 size_t get_blobid_buffer(strRB5_INFO *rb5_info, int req_blobid, unsigned char** return_uncompressed_blob);
 void convert_raw_to_data(strRB5_PARAM_INFO *rb5_param, void **input_raw_arr, float **return_data_arr);
+void swap_blob_to_raw(const unsigned char *blob_buffer, size_t size_blob, size_t raw_binary_depth, void *raw_arr);
 size_t return_param_blobid_raw(strRB5_INFO *rb5_info, strRB5_PARAM_INFO* rb5_param, void **return_raw_arr);
 char *map_rb5_to_h5_param(char *sparam);
 int is_rb5_param_dualpol(char *sparam);
@@ -166,8 +208,13 @@ char *get_xpath_slice_attrib(const xmlXPathContextPtr xpathCtx, size_t this_slic
 int populate_rb5_info(strRB5_INFO *rb5_info, int L_VERBOSE);
 strRB5_PARAM_INFO get_rb5_param_info(strRB5_INFO *rb5_info, char *xpath_bgn, int L_VERBOSE);
 size_t find_in_string_arr(char arr[][MAX_NSTRINGS], size_t n, char *match);
+int find_rb5_rayinfo(strRB5_INFO *rb5_info, RB5_RAYINFO_ROLE role);
+int find_rb5_rawdata(strRB5_INFO *rb5_info, char *sparam);
 void dump_strRB5_PARAM_INFO(strRB5_PARAM_INFO rb5_param);
 void get_slice_iray_0degN(strRB5_INFO *rb5_info, int req_slice);
 void reorder_by_iray_0degN(strRB5_PARAM_INFO *rb5_param, void **input_raw_arr);
 int get_slice_end_iso8601(strRB5_INFO *rb5_info, int req_slice);
+void rb5_ray_angle_kernel(const strRB5_RAY_ANGLE_KERNEL *kernel, size_t nrays, float *block);
 int get_slice_mid_angle_readbacks(strRB5_INFO *rb5_info, int req_slice);
+
+#endif
@@ -0,0 +1,556 @@
+/*
+ * rb5_watch.c
+ *
+ * Directory-watching ingest for rb5_2_odim --watch: files landing in the
+ * input directory (inotify IN_CLOSE_WRITE or IN_MOVED_TO) are queued to a
+ * bounded pool of worker threads, decoded with getRaveIO() and written to
+ * the output directory via a temporary file and rename(), so that readers
+ * never see a partial ODIM_H5 file.
+ *
+ * Each worker keeps its parsed radar table warm across files (see
+ * rb52odim_keep_warm()) and the libxml2 globals are set up once.
+ *
+ * With a memory budget, the decode working set of each file is estimated
+ * from its header when queued, and workers take the oldest file whose
+ * estimate still fits in what is left of the budget. Small files flow past
+ * a large one until it has waited RB5_WATCH_MAX_BYPASS times, then the
+ * budget drains for it. A file over the whole budget is converted alone.
+ *
+ * With a cycle (--cycle SEC), the queue is kept newest scan first, so that
+ * after an outage the current products recover before the backlog. Scans
+ * older than the newest queued by more than the cycle are backfill, which
+ * only a share of the workers may convert at once; the others stay free
+ * for files of the current cycle.
+ *
+ * The same pool converts a list of files (rb5_2_odim -i ... --out), see
+ * rb5_watch_batch(). There nothing more can land, so backfill takes every
+ * worker once the current cycle is done.
+ *
+ * compile only: gcc -g -I/usr/include/libxml2 -c rb5_watch.c -o rb5_watch.o
+ *
+ */
+
+#include "rb5_watch.h"
+#include "rb5_inflate.h"
+#include "rb5_latency.h"
+#include "rb5_index.h" //read_rb5_index_entry()
+
+#include <sys/inotify.h>
+#include <limits.h> //NAME_MAX
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+
+static volatile sig_atomic_t L_WATCH_STOP=0;
+
+static void watch_stop_handler(int signum) {
+    (void)signum;
+    L_WATCH_STOP=1;
+}
+
+static double watch_now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC,&ts);
+    return(ts.tv_sec+ts.tv_nsec/1e9);
+}
+
+//#############################################################################
+
+/* queue order with a cycle: newest scan first, then landing order */
+static int watch_job_cmp(const void *a, const void *b) {
+    const strRB5_WATCH_JOB *ja=(const strRB5_WATCH_JOB *)a;
+    const strRB5_WATCH_JOB *jb=(const strRB5_WATCH_JOB *)b;
+    if (ja->epoch_ms != jb->epoch_ms) return((ja->epoch_ms > jb->epoch_ms) ? -1 : 1);
+    return((ja->seq < jb->seq) ? -1 : (ja->seq > jb->seq));
+}
+
+/* older than the current cycle, with the lock held */
+static int watch_job_backfill(const strRB5_WATCH_QUEUE *q, const strRB5_WATCH_JOB *job) {
+    return(q->cycle_ms > 0 && job->epoch_ms < q->newest_epoch_ms-q->cycle_ms);
+}
+
+/* blocks while the queue is full, returns 0 once the queue is stopped */
+static int watch_queue_push(strRB5_WATCH_QUEUE *q, const strRB5_WATCH_JOB *job) {
+    size_t i;
+    pthread_mutex_lock(&q->lock);
+    while (q->count == RB5_WATCH_QUEUE_LEN && !q->L_STOP) pthread_cond_wait(&q->not_full,&q->lock);
+    if (q->L_STOP) {
+        pthread_mutex_unlock(&q->lock);
+        return(0);
+    }
+    i=q->count;
+    if (q->cycle_ms > 0) { //insert in order, from the tail
+        while (i > 0 && watch_job_cmp(job,&q->jobs[(q->head+i-1) % RB5_WATCH_QUEUE_LEN]) < 0) {
+            q->jobs[(q->head+i) % RB5_WATCH_QUEUE_LEN]=q->jobs[(q->head+i-1) % RB5_WATCH_QUEUE_LEN];
+            i--;
+        }
+        if (job->epoch_ms > q->newest_epoch_ms) q->newest_epoch_ms=job->epoch_ms;
+    }
+    q->jobs[(q->head+i) % RB5_WATCH_QUEUE_LEN]=*job;
+    q->count++;
+    pthread_cond_signal(&q->not_empty);
+    pthread_mutex_unlock(&q->lock);
+    return(1);
+}
+
+/*
+ * position (from head) of the job to convert next, with the lock held: the
+ * first in queue order that fits in the memory budget, unless one before it
+ * has been bypassed too often; the first when nothing runs. Backfill waits
+ * while its share of the workers is taken, unless the batch has nothing
+ * current left. -1 to wait.
+ */
+static long watch_queue_pick(const strRB5_WATCH_QUEUE *q) {
+    size_t i;
+    if (q->count == 0) return(-1);
+    int L_BACKFILL_FULL=(q->cycle_ms > 0 && q->n_backfill_running >= q->backfill_workers &&
+                         (q->L_LIVE || q->n_running > q->n_backfill_running || !watch_job_backfill(q,&q->jobs[q->head])));
+    for (i = 0; i < q->count; i++) {
+        const strRB5_WATCH_JOB *job=&q->jobs[(q->head+i) % RB5_WATCH_QUEUE_LEN];
+        if (L_BACKFILL_FULL && watch_job_backfill(q,job)) return(-1); //and so is the rest of the queue
+        if (q->budget_bytes == 0 || q->n_running == 0) return((long)i);
+        if (q->admitted_bytes+job->est_bytes <= q->budget_bytes) return((long)i);
+        if (job->n_bypassed >= RB5_WATCH_MAX_BYPASS) return(-1); //budget drains for this one
+    }
+    return(-1);
+}
+
+/* blocks until a job is admitted, returns 0 once the queue is stopped and drained */
+static int watch_queue_pop(strRB5_WATCH_QUEUE *q, strRB5_WATCH_JOB *job) {
+    long pick;
+    size_t i;
+    pthread_mutex_lock(&q->lock);
+    while ((pick=watch_queue_pick(q)) < 0 && !(q->count == 0 && q->L_STOP)) pthread_cond_wait(&q->not_empty,&q->lock);
+    if (pick < 0) {
+        pthread_mutex_unlock(&q->lock);
+        return(0);
+    }
+    for (i = 0; i < (size_t)pick; i++) q->jobs[(q->head+i) % RB5_WATCH_QUEUE_LEN].n_bypassed++;
+    *job=q->jobs[(q->head+pick) % RB5_WATCH_QUEUE_LEN];
+    for (i = pick; i > 0; i--) { //close the gap, older jobs keep their order
+        q->jobs[(q->head+i) % RB5_WATCH_QUEUE_LEN]=q->jobs[(q->head+i-1) % RB5_WATCH_QUEUE_LEN];
+    }
+    q->head=(q->head+1) % RB5_WATCH_QUEUE_LEN;
+    q->count--;
+    q->admitted_bytes+=job->est_bytes;
+    q->n_running++;
+    job->L_BACKFILL=watch_job_backfill(q,job);
+    if (job->L_BACKFILL) q->n_backfill_running++;
+    pthread_cond_signal(&q->not_full);
+    pthread_mutex_unlock(&q->lock);
+    return(1);
+}
+
+/* job converted, its budget is free for waiting ones */
+static void watch_queue_done(strRB5_WATCH_QUEUE *q, const strRB5_WATCH_JOB *job) {
+    pthread_mutex_lock(&q->lock);
+    q->admitted_bytes-=job->est_bytes;
+    q->n_running--;
+    if (job->L_BACKFILL) q->n_backfill_running--;
+    pthread_cond_broadcast(&q->not_empty);
+    pthread_mutex_unlock(&q->lock);
+}
+
+static void watch_queue_stop(strRB5_WATCH_QUEUE *q) {
+    pthread_mutex_lock(&q->lock);
+    q->L_STOP=1;
+    pthread_cond_broadcast(&q->not_empty);
+    pthread_cond_broadcast(&q->not_full);
+    pthread_mutex_unlock(&q->lock);
+}
+
+//#############################################################################
+
+void init_rb5_watch_options(strRB5_WATCH_OPTIONS *opts) {
+    memset(opts,0,sizeof(strRB5_WATCH_OPTIONS));
+    opts->nworkers=1;
+    opts->backfill_share=RB5_WATCH_BACKFILL_SHARE;
+}
+
+/* bytes of the decoded file, from the gzip trailer (ISIZE) if compressed, 0 on error */
+static size_t watch_decoded_file_bytes(const char *inp_fname) {
+    unsigned char magic[2], isize[4];
+    struct stat fstat_buf;
+    size_t bytes=0;
+    if (stat(inp_fname,&fstat_buf) != 0) return(0);
+    FILE *fp=fopen(inp_fname,"rb");
+    if (fp == NULL) return(0);
+    bytes=(size_t)fstat_buf.st_size;
+    if (bytes > 18 && fread(magic,1,2,fp) == 2 && magic[0] == 0x1f && magic[1] == 0x8b &&
+        fseek(fp,-4L,SEEK_END) == 0 && fread(isize,1,4,fp) == 4) {
+        bytes=((size_t)isize[3] << 24) | ((size_t)isize[2] << 16) | ((size_t)isize[1] << 8) | isize[0];
+    }
+    fclose(fp);
+    return(bytes);
+}
+
+/*
+ * Function name: rb5_watch_estimate_bytes
+ * Intent: peak decode working set of an RB5 file from its XML header alone:
+ *         the decoded file buffer, the DOM, the decoded moments and the RAVE
+ *         object holding them. 0 if the header cannot be read.
+ */
+static size_t watch_entry_bytes(const char *inp_fname, const strRB5_INDEX_ENTRY *entry) {
+    size_t moment_bytes=0;
+    size_t i;
+    for (i = 0; i < entry->n_moments; i++) moment_bytes+=entry->moment_bytes[i];
+    return(RB5_WATCH_EST_BASE_BYTES+watch_decoded_file_bytes(inp_fname)+
+           RB5_WATCH_EST_XML_FACTOR*entry->xml_bytes+RB5_WATCH_EST_MOMENT_FACTOR*moment_bytes);
+}
+
+size_t rb5_watch_estimate_bytes(const char *inp_fname) {
+    strRB5_INDEX_ENTRY entry;
+    if (read_rb5_index_entry(inp_fname,&entry) != EXIT_SUCCESS) return(0);
+    return(watch_entry_bytes(inp_fname,&entry));
+}
+
+//#############################################################################
+
+/*
+ * <out_dir>/<input basename without .gz>.h5, and a hidden temporary name
+ * in the same directory so that rename() is atomic.
+ */
+int rb5_watch_output_name(const char *out_dir, const char *inp_fname, unsigned long seq, char *ofile, char *tmpfile, size_t len) {
+
+    char base[MAX_STRING]="\0";
+    const char *slash=strrchr(inp_fname,'/');
+    snprintf(base,MAX_STRING,"%s",slash ? slash+1 : inp_fname);
+    size_t base_len=strlen(base);
+    if (base_len > 3 && strcmp(base+base_len-3,".gz") == 0) base[base_len-3]='\0';
+
+    if ((size_t)snprintf(ofile,len,"%s/%s.h5",out_dir,base) >= len ||
+        (size_t)snprintf(tmpfile,len,"%s/.%s.h5.%lu.tmp",out_dir,base,seq) >= len) {
+        fprintf(stderr,"Error: output path too long for %s\n", inp_fname);
+        return(EXIT_FAILURE);
+    }
+    return(EXIT_SUCCESS);
+}
+
+//#############################################################################
+
+static void watch_count_failed(strRB5_WATCH *watch) {
+    pthread_mutex_lock(&watch->log_lock);
+    watch->n_failed++;
+    pthread_mutex_unlock(&watch->log_lock);
+}
+
+int rb5_watch_convert(strRB5_WATCH *watch, const strRB5_WATCH_JOB *job) {
+
+    char ofile[2*MAX_STRING]="\0";
+    char tmpfile[2*MAX_STRING]="\0";
+    int ret = 0;
+
+    if (isRainbow5(job->path) != 0) {
+        fprintf(stderr,"Skipping %s: not an RB5 raw file\n", job->path);
+        watch_count_failed(watch);
+        return(EXIT_FAILURE);
+    }
+    if (rb5_watch_output_name(watch->out_dir,job->path,job->seq,ofile,tmpfile,sizeof(ofile)) != EXIT_SUCCESS) {
+        watch_count_failed(watch);
+        return(EXIT_FAILURE);
+    }
+
+    rb5_profile_reset();
+    rb5_memtrack_reset();
+    rb5_latency_begin(job->t_landed_wall);
+    RaveIO_t* raveio = getRaveIO(job->path);
+    RaveCoreObject* object = RaveIO_getObject(raveio);
+    if (object != NULL) {
+        rb5_latency_mark_decoded();
+        strRB5_PROFILE_MARK prof=rb5_profile_begin();
+        pthread_mutex_lock(&watch->save_lock);
+        ret = RaveIO_save(raveio, tmpfile);
+        pthread_mutex_unlock(&watch->save_lock);
+        struct stat ostat;
+        rb5_profile_end(RB5_PROFILE_SAVE,prof,(stat(tmpfile,&ostat) == 0) ? (size_t)ostat.st_size : 0);
+        RaveIO_close(raveio);
+    }
+    RAVE_OBJECT_RELEASE(object);
+    RAVE_OBJECT_RELEASE(raveio);
+
+    if (!ret || rename(tmpfile,ofile) != 0) {
+        fprintf(stderr,"Error cannot convert file = %s\n", job->path);
+        unlink(tmpfile);
+        watch_count_failed(watch);
+        return(EXIT_FAILURE);
+    }
+    rb5_latency_mark_written();
+
+    pthread_mutex_lock(&watch->log_lock);
+    watch->n_ok++;
+    fprintf(stdout,"Created : %s (%.1f ms after landing%s)\n", ofile, (watch_now_sec()-job->t_landed)*1e3, job->L_BACKFILL ? ", backfill" : "");
+    fflush(stdout);
+    if (watch->opts.L_PROFILE) {
+        if (watch->opts.L_PROFILE_JSON) rb5_profile_dump_json(stderr);
+        else                       rb5_profile_dump_text(stderr);
+    }
+    rb5_latency_finish(job->path,ofile,stderr);
+    pthread_mutex_unlock(&watch->log_lock);
+    return(EXIT_SUCCESS);
+}
+
+//#############################################################################
+
+static void* watch_worker(void *arg) {
+
+    strRB5_WATCH *watch=(strRB5_WATCH *)arg;
+    strRB5_WATCH_JOB job;
+
+    rb52odim_keep_warm(1);
+    rb5_profile_enable(watch->opts.L_PROFILE); //per thread
+    rb5_memtrack_enable(watch->opts.L_MEMTRACK);
+    rb5_qc_enable(watch->opts.L_QC);
+    while (watch_queue_pop(&watch->queue,&job)) {
+        rb5_watch_convert(watch,&job);
+        watch_queue_done(&watch->queue,&job);
+    }
+    rb52odim_keep_warm(0);
+    rb5_inflate_cleanup();
+    return(NULL);
+}
+
+//#############################################################################
+
+/* skip hidden files, which includes our own temporaries, and ODIM_H5 outputs */
+static int watch_wanted(const char *name) {
+    size_t len=strlen(name);
+    if (name[0] == '.') return(0);
+    if (len > 3 && strcmp(name+len-3,".h5") == 0) return(0);
+    return(1);
+}
+
+//#############################################################################
+
+/* working set estimate if there is a memory budget, scan start if there is a cycle, from one header read */
+static void watch_read_header(const strRB5_WATCH *watch, strRB5_WATCH_JOB *job) {
+    strRB5_INDEX_ENTRY entry;
+    job->est_bytes=0;
+    job->epoch_ms=0;
+    job->L_BACKFILL=0;
+    job->n_bypassed=0;
+    if (watch->opts.mem_budget_bytes == 0 && watch->opts.cycle_sec == 0) return;
+    if (read_rb5_index_entry(job->path,&entry) != EXIT_SUCCESS) return;
+    if (watch->opts.mem_budget_bytes > 0) job->est_bytes=watch_entry_bytes(job->path,&entry);
+    if (watch->opts.cycle_sec > 0) job->epoch_ms=entry.epoch_ms;
+}
+
+/* queues a job, see watch_read_header() */
+static void watch_submit(strRB5_WATCH *watch, strRB5_WATCH_JOB *job) {
+    watch_read_header(watch,job);
+    watch_queue_push(&watch->queue,job);
+}
+
+/* watch state and worker threads, NULL on error; then the caller submits jobs */
+static strRB5_WATCH *watch_start(const char *out_dir, const strRB5_WATCH_OPTIONS *opts, int L_LIVE, pthread_t *workers, int *nstarted) {
+
+    struct stat dstat;
+    int i;
+
+    *nstarted=0;
+    if (stat(out_dir,&dstat) != 0 || !S_ISDIR(dstat.st_mode)) {
+        fprintf(stderr,"Error: %s is not a directory\n", out_dir);
+        return(NULL);
+    }
+
+    strRB5_WATCH *watch=(strRB5_WATCH *)RAVE_MALLOC(sizeof(strRB5_WATCH));
+    if (watch == NULL) {
+        fprintf(stderr,"Error: cannot allocate watch state\n");
+        return(NULL);
+    }
+    memset(watch,0,sizeof(strRB5_WATCH));
+    snprintf(watch->out_dir,MAX_STRING,"%s",out_dir);
+    watch->opts=*opts;
+    if (watch->opts.nworkers < 1) watch->opts.nworkers=1;
+    if (watch->opts.nworkers > RB5_WATCH_MAX_WORKERS) watch->opts.nworkers=RB5_WATCH_MAX_WORKERS;
+    watch->queue.budget_bytes=opts->mem_budget_bytes;
+    watch->queue.cycle_ms=(int64_t)opts->cycle_sec*1000;
+    watch->queue.backfill_workers=(size_t)(watch->opts.nworkers*opts->backfill_share/100);
+    if (watch->queue.backfill_workers < 1) watch->queue.backfill_workers=1;
+    watch->queue.L_LIVE=L_LIVE;
+    pthread_mutex_init(&watch->queue.lock,NULL);
+    pthread_cond_init(&watch->queue.not_empty,NULL);
+    pthread_cond_init(&watch->queue.not_full,NULL);
+    pthread_mutex_init(&watch->save_lock,NULL);
+    pthread_mutex_init(&watch->log_lock,NULL);
+
+    xmlInitParser(); //once, before any worker parses
+    for (i = 0; i < watch->opts.nworkers; i++) {
+        if (pthread_create(&workers[i],NULL,watch_worker,watch) != 0) break;
+        (*nstarted)++;
+    }
+    if (*nstarted == 0) fprintf(stderr,"Error: cannot start worker threads\n");
+    return(watch);
+}
+
+/* converts what is queued, stops the workers and frees the watch state */
+static void watch_finish(strRB5_WATCH *watch, pthread_t *workers, int nstarted, size_t *n_ok, size_t *n_failed) {
+
+    int i;
+
+    watch_queue_stop(&watch->queue);
+    for (i = 0; i < nstarted; i++) pthread_join(workers[i],NULL);
+    xmlCleanupParser();
+
+    *n_ok=watch->n_ok;
+    *n_failed=watch->n_failed;
+    pthread_mutex_destroy(&watch->queue.lock);
+    pthread_cond_destroy(&watch->queue.not_empty);
+    pthread_cond_destroy(&watch->queue.not_full);
+    pthread_mutex_destroy(&watch->save_lock);
+    pthread_mutex_destroy(&watch->log_lock);
+    RAVE_FREE(watch);
+}
+
+static void watch_print_started(const char *what, const strRB5_WATCH *watch, int nstarted) {
+    char budget[MAX_STRING]="\0";
+    char cycle[MAX_STRING]="\0";
+    if (watch->opts.mem_budget_bytes > 0) {
+        snprintf(budget,MAX_STRING,", %ld MB memory budget", watch->opts.mem_budget_bytes >> 20);
+    }
+    if (watch->opts.cycle_sec > 0) {
+        snprintf(cycle,MAX_STRING,", newest first, backfill beyond %d s on %ld", watch->opts.cycle_sec, watch->queue.backfill_workers);
+    }
+    fprintf(stdout,"%s (%d workers%s%s)\n", what, nstarted, budget, cycle);
+    fflush(stdout);
+}
+
+//#############################################################################
+
+/*
+ * Function name: rb5_watch
+ * Intent: Convert every RB5 file landing in in_dir to ODIM_H5 in out_dir,
+ * until SIGINT or SIGTERM. Queued files are finished before returning.
+ */
+int rb5_watch(const char *in_dir, const char *out_dir, const strRB5_WATCH_OPTIONS *opts) {
+
+    struct stat dstat;
+    char what[3*MAX_STRING];
+    size_t n_ok=0, n_failed=0;
+
+    if (stat(in_dir,&dstat) != 0 || !S_ISDIR(dstat.st_mode)) {
+        fprintf(stderr,"Error: %s is not a directory\n", in_dir);
+        return(EXIT_FAILURE);
+    }
+
+    int fd=inotify_init1(IN_CLOEXEC);
+    if (fd < 0 || inotify_add_watch(fd,in_dir,IN_CLOSE_WRITE|IN_MOVED_TO) < 0) {
+        fprintf(stderr,"Error: cannot watch %s: %s\n", in_dir, strerror(errno));
+        if (fd >= 0) close(fd);
+        return(EXIT_FAILURE);
+    }
+
+    pthread_t workers[RB5_WATCH_MAX_WORKERS];
+    int nstarted=0;
+    strRB5_WATCH *watch=watch_start(out_dir,opts,1,workers,&nstarted);
+    if (watch == NULL) {
+        close(fd);
+        return(EXIT_FAILURE);
+    }
+
+    struct sigaction sa;
+    memset(&sa,0,sizeof(sa));
+    sa.sa_handler=watch_stop_handler; //no SA_RESTART, poll() returns EINTR
+    sigaction(SIGINT,&sa,NULL);
+    sigaction(SIGTERM,&sa,NULL);
+
+    if (nstarted == 0) L_WATCH_STOP=1;
+    snprintf(what,sizeof(what),"Watching : %s -> %s", in_dir, out_dir);
+    watch_print_started(what,watch,nstarted);
+
+    char events[64*(sizeof(struct inotify_event)+NAME_MAX+1)] __attribute__((aligned(__alignof__(struct inotify_event))));
+    unsigned long seq=0;
+    struct pollfd pfd={fd,POLLIN,0};
+    while (!L_WATCH_STOP) {
+        //the timeout only bounds the reaction to a signal racing poll(), events wake us at once
+        if (poll(&pfd,1,500) <= 0) continue;
+        ssize_t nread=read(fd,events,sizeof(events));
+        if (nread <= 0) continue;
+        double t_landed=watch_now_sec();
+        double t_landed_wall=rb5_latency_wallclock();
+
+        char *p;
+        for (p = events; p < events+nread; p += sizeof(struct inotify_event)+((struct inotify_event *)p)->len) {
+            const struct inotify_event *ev=(const struct inotify_event *)p;
+            if (ev->mask & IN_Q_OVERFLOW) {
+                fprintf(stderr,"Warning: inotify queue overflow, files may have been missed\n");
+                continue;
+            }
+            if (ev->mask & IN_IGNORED) { //watched directory is gone
+                fprintf(stderr,"Error: %s is no longer watched\n", in_dir);
+                L_WATCH_STOP=1;
+                break;
+            }
+            if (ev->len == 0 || (ev->mask & IN_ISDIR) || !watch_wanted(ev->name)) continue;
+
+            strRB5_WATCH_JOB job;
+            if ((size_t)snprintf(job.path,RB5_WATCH_PATH_LEN,"%s/%s",in_dir,ev->name) >= RB5_WATCH_PATH_LEN) {
+                fprintf(stderr,"Skipping %s: path too long\n", ev->name);
+                continue;
+            }
+            job.seq=seq++;
+            job.t_landed=t_landed;
+            job.t_landed_wall=t_landed_wall;
+            watch_submit(watch,&job);
+        }
+    }
+
+    //finish what is queued
+    watch_finish(watch,workers,nstarted,&n_ok,&n_failed);
+    close(fd);
+
+    fprintf(stdout,"Stopped : %zu files converted, %zu failed\n", n_ok, n_failed);
+    return((nstarted == 0) ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+/*
+ * Function name: rb5_watch_batch
+ * Intent: Convert a list of RB5 files to ODIM_H5 in out_dir with the worker
+ * pool of rb5_watch(), within its memory budget; with a cycle, the newest
+ * scans first. EXIT_FAILURE if any failed.
+ */
+int rb5_watch_batch(char **path_arr, size_t n_paths, const char *out_dir, const strRB5_WATCH_OPTIONS *opts) {
+
+    size_t n_ok=0, n_failed=0;
+    size_t n_jobs=0;
+    size_t i;
+
+    pthread_t workers[RB5_WATCH_MAX_WORKERS];
+    int nstarted=0;
+    strRB5_WATCH *watch=watch_start(out_dir,opts,0,workers,&nstarted);
+    if (watch == NULL) return(EXIT_FAILURE);
+
+    //headers first, the queue only orders what fits in it
+    strRB5_WATCH_JOB *job_arr=(strRB5_WATCH_JOB *)RAVE_MALLOC(n_paths*sizeof(strRB5_WATCH_JOB)+1);
+    if (job_arr == NULL) {
+        fprintf(stderr,"Error: cannot allocate %ld batch jobs\n", n_paths);
+        n_failed=n_paths;
+        n_paths=0;
+    }
+    for (i = 0; i < n_paths; i++) {
+        strRB5_WATCH_JOB *job=&job_arr[n_jobs];
+        if ((size_t)snprintf(job->path,RB5_WATCH_PATH_LEN,"%s",path_arr[i]) >= RB5_WATCH_PATH_LEN) {
+            fprintf(stderr,"Skipping %s: path too long\n", path_arr[i]);
+            n_failed++;
+            continue;
+        }
+        job->seq=i;
+        watch_read_header(watch,job);
+        n_jobs++;
+    }
+    if (opts->cycle_sec > 0 && n_jobs > 1) qsort(job_arr,n_jobs,sizeof(strRB5_WATCH_JOB),watch_job_cmp);
+    watch_print_started("Converting",watch,nstarted);
+
+    for (i = 0; i < n_jobs && nstarted > 0; i++) {
+        job_arr[i].t_landed=watch_now_sec();
+        job_arr[i].t_landed_wall=rb5_latency_wallclock();
+        watch_queue_push(&watch->queue,&job_arr[i]);
+    }
+    RAVE_FREE(job_arr);
+
+    size_t n_skipped=n_failed;
+    watch_finish(watch,workers,nstarted,&n_ok,&n_failed);
+    n_failed+=n_skipped;
+
+    fprintf(stdout,"Done : %zu files converted, %zu failed\n", n_ok, n_failed);
+    return((nstarted == 0 || n_failed > 0) ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,87 @@
+#ifndef RB5_WATCH_H
+#define RB5_WATCH_H
+
+#include "rb52odim.h"
+
+#include <pthread.h> //add -lpthread to compile
+
+#define RB5_WATCH_MAX_WORKERS 64
+#define RB5_WATCH_QUEUE_LEN 256
+#define RB5_WATCH_PATH_LEN MAX_STRING // getRaveIO() limit on input path length
+#define RB5_WATCH_MAX_BYPASS 8        // times smaller files may overtake one waiting for memory budget
+#define RB5_WATCH_BACKFILL_SHARE 50   // default percentage of workers that may convert backfill
+
+// decode working set estimate, see rb5_watch_estimate_bytes(); calibrated with rb5_2_odim --memtrack
+#define RB5_WATCH_EST_BASE_BYTES 0x100000 // radar table and libxml2 state
+#define RB5_WATCH_EST_XML_FACTOR 16       // DOM bytes per XML header byte
+#define RB5_WATCH_EST_MOMENT_FACTOR 2     // decoded blobs, then in the RAVE object
+
+//#############################################################################
+// one landed file, waiting for a worker
+typedef struct{
+    char path[RB5_WATCH_PATH_LEN];
+    unsigned long seq;  // landing order, keeps temporary output names unique
+    double t_landed; // CLOCK_MONOTONIC seconds at the inotify event
+    double t_landed_wall; // same, wall clock, for the data age (see rb5_latency.h)
+    size_t est_bytes;     // estimated decode working set, 0 if unknown or no memory budget
+    int64_t epoch_ms;     // scan start from the header, 0 if unknown or no cycle
+    int L_BACKFILL;       // admitted as backfill, set by the queue
+    unsigned n_bypassed;  // times a later job was admitted first
+} strRB5_WATCH_JOB;
+
+//#############################################################################
+// bounded queue between the inotify loop (or file list) and the worker pool,
+// in landing order, or newest scan first with a cycle; with a memory budget,
+// jobs are admitted in queue order while their estimates fit
+typedef struct{
+    strRB5_WATCH_JOB jobs[RB5_WATCH_QUEUE_LEN];
+    size_t head;
+    size_t count;
+    int L_STOP; // no more jobs, workers exit once the queue is drained
+    size_t budget_bytes;   // 0 for no limit
+    size_t admitted_bytes; // sum of est_bytes of the jobs being converted
+    size_t n_running;
+    int64_t cycle_ms;          // 0 for landing order, else scans older than the newest by more are backfill
+    int64_t newest_epoch_ms;   // newest scan queued so far
+    size_t backfill_workers;   // backfill converted at once, at most
+    size_t n_backfill_running;
+    int L_LIVE;                // files may still land (--watch), keep the backfill share when idle
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+} strRB5_WATCH_QUEUE;
+
+//#############################################################################
+// rb5_2_odim --watch and batch options, see init_rb5_watch_options()
+typedef struct{
+    int nworkers;
+    int L_PROFILE;      // per-file phase profile to stderr
+    int L_PROFILE_JSON;
+    int L_MEMTRACK;     // heap counters in the profile
+    int L_QC;           // per-moment QC statistics as how/ attributes, see rb5_qc.c
+    size_t mem_budget_bytes; // estimated decode working sets converted at once, 0 for no limit
+    int cycle_sec;           // newest first, with scans this much older than the newest as backfill; 0 for landing order
+    int backfill_share;      // percentage of workers that may convert backfill, at least one
+} strRB5_WATCH_OPTIONS;
+
+//#############################################################################
+typedef struct{
+    char out_dir[MAX_STRING];
+    strRB5_WATCH_OPTIONS opts;
+    strRB5_WATCH_QUEUE queue;
+    pthread_mutex_t save_lock; // HDF5 is not thread-safe, RaveIO_save() one at a time
+    pthread_mutex_t log_lock;
+    size_t n_ok;
+    size_t n_failed;
+} strRB5_WATCH;
+
+//#############################################################################
+// function declarations
+void init_rb5_watch_options(strRB5_WATCH_OPTIONS *opts);
+size_t rb5_watch_estimate_bytes(const char *inp_fname);
+int rb5_watch_output_name(const char *out_dir, const char *inp_fname, unsigned long seq, char *ofile, char *tmpfile, size_t len);
+int rb5_watch_convert(strRB5_WATCH *watch, const strRB5_WATCH_JOB *job);
+int rb5_watch(const char *in_dir, const char *out_dir, const strRB5_WATCH_OPTIONS *opts);
+int rb5_watch_batch(char **path_arr, size_t n_paths, const char *out_dir, const strRB5_WATCH_OPTIONS *opts);
+
+#endif
@@ -0,0 +1,124 @@
+// compile: gcc -g -Wall rb5_compact.c test_rb5_compact.c -o test_rb5_compact
+
+// check: valgrind --leak-check=full ./test_rb5_compact
+
+#include "rb5_compact.h"
+
+#define NRAYS 6
+#define NBINS 40
+
+//#############################################################################
+/* round trip of nrays x nbins codes, returns the compact size or 0 on mismatch */
+static size_t round_trip(const char *label, const void *raw_arr, size_t depth, uint32_t fill0, uint32_t fill1) {
+
+    size_t size_raw=NRAYS*NBINS*depth/8;
+    size_t size_compact=0;
+    unsigned char *compact=rb5_compact_encode(raw_arr,NRAYS,NBINS,depth,fill0,fill1,&size_compact);
+    if (compact == NULL) {
+      fprintf(stdout,"  FAIL %s: not encoded\n",label); return(0);
+    }
+    void *back=calloc(1,size_raw);
+    int ret=rb5_compact_decode(compact,size_compact,back,size_raw);
+    if (ret != EXIT_SUCCESS || memcmp(back,raw_arr,size_raw) != 0) {
+      fprintf(stdout,"  FAIL %s: round trip\n",label); size_compact=0;
+    }
+    free(back);
+    free(compact);
+    return(size_compact);
+
+}
+
+//#############################################################################
+/* clear air: mostly undetect and nodata, returns number of mismatches */
+static int check_clear_air(void) {
+
+    int nbad=0;
+    uint8_t raw8[NRAYS*NBINS];
+    uint16_t raw16[NRAYS*NBINS];
+    uint32_t raw32[NRAYS*NBINS];
+    size_t i;
+    for (i = 0; i < NRAYS*NBINS; i++) {
+      size_t ibin=i%NBINS;
+      uint32_t code=(ibin < 3) ? 100+i%7 : (ibin < 30) ? 0 : 255; // echo, undetect, not radiated
+      if (i/NBINS == 2 && ibin == 10) code=255; // short run within undetect
+      raw8[i]=(uint8_t)code;
+      raw16[i]=(uint16_t)(code == 255 ? 65535 : code);
+      raw32[i]=(code == 255 ? 0xffffffff : code);
+    }
+    size_t size8=round_trip("8 bit",raw8,8,0,255);
+    size_t size16=round_trip("16 bit",raw16,16,0,65535);
+    size_t size32=round_trip("32 bit",raw32,32,0,0xffffffff);
+    if (size8 == 0 || size16 == 0 || size32 == 0) return(1);
+
+    strRB5_COMPACT_HEADER header;
+    unsigned char *compact=rb5_compact_encode(raw8,NRAYS,NBINS,8,0,255,&size8);
+    if (rb5_compact_header(compact,size8,&header) != EXIT_SUCCESS || header.stored != RB5_COMPACT_RLE) {
+      fprintf(stdout,"  FAIL clear air not run-length encoded\n"); nbad++;
+    }
+    if (size8 >= sizeof(raw8) || size32 >= sizeof(raw32)/4) {
+      fprintf(stdout,"  FAIL clear air not smaller: %ld %ld\n",size8,size32); nbad++;
+    }
+    free(compact);
+    return(nbad);
+
+}
+
+//#############################################################################
+/* codes without runs are kept as they are, returns number of mismatches */
+static int check_noise(void) {
+
+    int nbad=0;
+    uint8_t raw8[NRAYS*NBINS];
+    size_t i;
+    for (i = 0; i < NRAYS*NBINS; i++) raw8[i]=(uint8_t)((i*37+11)%251);
+    size_t size8=round_trip("noise",raw8,8,0,255);
+    if (size8 != sizeof(strRB5_COMPACT_HEADER)+sizeof(raw8)) {
+      fprintf(stdout,"  FAIL noise size %ld\n",size8); nbad++;
+    }
+    memset(raw8,0,sizeof(raw8)); // all undetect, fill codes never seen are harmless
+    size8=round_trip("undetect",raw8,8,0,0);
+    if (size8 == 0 || size8 > sizeof(strRB5_COMPACT_HEADER)+NRAYS*sizeof(uint32_t)) {
+      fprintf(stdout,"  FAIL undetect size %ld\n",size8); nbad++;
+    }
+    return(nbad);
+
+}
+
+//#############################################################################
+/* damaged buffers and sizes that do not match are refused, returns number of mismatches */
+static int check_refused(void) {
+
+    int nbad=0;
+    uint8_t raw8[NRAYS*NBINS]={0};
+    uint8_t back[NRAYS*NBINS];
+    size_t size8=0;
+    if (rb5_compact_encode(raw8,NRAYS,NBINS,12,0,255,&size8) != NULL) {
+      fprintf(stdout,"  FAIL 12 bit accepted\n"); nbad++;
+    }
+    unsigned char *compact=rb5_compact_encode(raw8,NRAYS,NBINS,8,0,255,&size8);
+    if (rb5_compact_decode(compact,size8,back,sizeof(back)-1) != EXIT_FAILURE) {
+      fprintf(stdout,"  FAIL size mismatch accepted\n"); nbad++;
+    }
+    if (rb5_compact_decode(compact,size8-1,back,sizeof(back)) != EXIT_FAILURE) {
+      fprintf(stdout,"  FAIL truncated buffer accepted\n"); nbad++;
+    }
+    compact[sizeof(strRB5_COMPACT_HEADER)]=0xff; // token count beyond the ray
+    if (rb5_compact_decode(compact,size8,back,sizeof(back)) != EXIT_FAILURE) {
+      fprintf(stdout,"  FAIL damaged token accepted\n"); nbad++;
+    }
+    free(compact);
+    return(nbad);
+
+}
+
+//#############################################################################
+int main(int argc, char *argv[]) {
+
+    int nbad=0;
+    nbad+=check_clear_air();
+    nbad+=check_noise();
+    nbad+=check_refused();
+    fprintf(stdout,"%s\n",nbad ? "FAILED" : "OK");
+    return(nbad ? EXIT_FAILURE : EXIT_SUCCESS);
+
+}
@@ -0,0 +1,89 @@
+// compile: gcc -g -Wall -I/usr/include/libxml2 rb5_index.c xml_utils.c time_utils.c rb5_profile.c rb5_memtrack.c rb5_inflate.c test_rb5_index.c -lxml2 -lz -lm -lpthread -o test_rb5_index
+// run from src/: ./test_rb5_index
+
+// check: valgrind --leak-check=full ./test_rb5_index
+
+#include "rb5_index.h"
+
+#define TEST_ORG "../test/org/"
+
+//#############################################################################
+/* header-only entry vs known values and vs the END XML offset of the whole file */
+static int check_entry(char *inp_fname, char *sensor_id, char *iso8601, char *scan_type, char *scan_name,
+                       size_t n_slices, float angle_deg_0, char *moment, size_t moment_bytes) {
+
+    int nbad=0;
+    strRB5_INDEX_ENTRY entry, parsed;
+    char line[RB5_INDEX_LINE_LEN];
+    int64_t epoch_ms;
+
+    fprintf(stdout,"%s\n",inp_fname);
+    if (read_rb5_index_entry(inp_fname,&entry) != EXIT_SUCCESS) {
+      fprintf(stdout,"  FAIL read\n");
+      return(1);
+    }
+    func_iso8601_2_epoch_ms(iso8601,&epoch_ms);
+    if (strcmp(entry.sensor_id,sensor_id) != 0) { fprintf(stdout,"  FAIL sensor_id %s\n",entry.sensor_id); nbad++; }
+    if (entry.epoch_ms != epoch_ms)             { fprintf(stdout,"  FAIL datetime\n"); nbad++; }
+    if (strcmp(entry.scan_type,scan_type) != 0) { fprintf(stdout,"  FAIL scan_type %s\n",entry.scan_type); nbad++; }
+    if (strcmp(entry.scan_name,scan_name) != 0) { fprintf(stdout,"  FAIL scan_name %s\n",entry.scan_name); nbad++; }
+    if (entry.n_slices != n_slices)             { fprintf(stdout,"  FAIL n_slices %ld\n",entry.n_slices); nbad++; }
+    if (entry.angle_deg_arr[0] != angle_deg_0)  { fprintf(stdout,"  FAIL angle %f\n",entry.angle_deg_arr[0]); nbad++; }
+    if (entry.n_moments != 1 || strcmp(entry.moment_arr[0],moment) != 0 || entry.moment_bytes[0] != moment_bytes) {
+      fprintf(stdout,"  FAIL moment %s:%ld\n",entry.moment_arr[0],entry.moment_bytes[0]); nbad++;
+    }
+
+    char *buffer=NULL;
+    size_t buffer_len=read_file_2_buffer(inp_fname,&buffer);
+    char *header=NULL;
+    size_t header_len=read_rb5_header_2_buffer(inp_fname,&header);
+    if (buffer_len == 0 || entry.xml_bytes != find_buffer_end_of_xml(buffer) || header_len >= buffer_len) {
+      fprintf(stdout,"  FAIL xml_bytes %ld, read %ld of %ld\n",entry.xml_bytes,header_len,buffer_len); nbad++;
+    }
+    close_file_buffer(buffer);
+    rb5_mem_free(header);
+
+    if (format_rb5_index_entry(&entry,line,RB5_INDEX_LINE_LEN) != EXIT_SUCCESS ||
+        parse_rb5_index_line(line,&parsed) != EXIT_SUCCESS ||
+        memcmp(&entry,&parsed,sizeof(strRB5_INDEX_ENTRY)) != 0) {
+      fprintf(stdout,"  FAIL round trip %s\n",line); nbad++;
+    }
+
+    strRB5_INDEX_QUERY query;
+    init_rb5_index_query(&query);
+    query.sensor_id=sensor_id;
+    query.moment=moment;
+    query.epoch_ms_bgn=epoch_ms;
+    query.epoch_ms_end=epoch_ms+1;
+    if (!match_rb5_index_entry(&parsed,&query)) { fprintf(stdout,"  FAIL match\n"); nbad++; }
+    query.epoch_ms_bgn=epoch_ms+1;
+    query.epoch_ms_end=INT64_MAX;
+    if (match_rb5_index_entry(&parsed,&query))  { fprintf(stdout,"  FAIL match time\n"); nbad++; }
+    init_rb5_index_query(&query);
+    query.moment="XYZ";
+    if (match_rb5_index_entry(&parsed,&query))  { fprintf(stdout,"  FAIL match moment\n"); nbad++; }
+
+    return(nbad);
+}
+
+//#############################################################################
+int main(int argc,char *argv[]) {
+
+    int nbad=0;
+    int ncheck=0;
+    strRB5_INDEX_ENTRY entry;
+
+    nbad+=check_entry(TEST_ORG "CASRA_2017121520000300dBZ.vol.gz","CASRA","2017-12-15 20:00:03.307","vol","PVOL6S",
+                      17,24.4,"dBZ",3351600); ncheck++; //bins vary by slice
+    nbad+=check_entry(TEST_ORG "2016081612320300dBZ.azi","XSO","2016-08-16 12:32:03.205","azi","STDop1_A",
+                      1,0.5,"dBZ",720*400); ncheck++;
+    fprintf(stdout,"not RB5\n"); ncheck++;
+    if (read_rb5_index_entry(TEST_ORG "caxah_dopvol1a_20151209T1650Z.azi.tar.gz",&entry) == EXIT_SUCCESS) {
+      fprintf(stdout,"  FAIL tarball accepted\n"); nbad++;
+    }
+
+    fprintf(stdout,"%d failures in %d checks\n",nbad,ncheck);
+    xmlCleanupParser();
+    return(nbad ? EXIT_FAILURE : EXIT_SUCCESS);
+
+}
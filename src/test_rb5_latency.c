@@ -0,0 +1,119 @@
+// compile: gcc -g -Wall -I/usr/include/libxml2 rb5_latency.c time_utils.c test_rb5_latency.c -lm -lpthread -o test_rb5_latency
+
+// check: valgrind --leak-check=full ./test_rb5_latency
+
+#include "rb5_latency.h"
+
+#include <math.h> //fabs()
+#include <unistd.h> //unlink()
+
+//#############################################################################
+/* one file with three sweeps ending 10, 20 and 30 s before it was seen */
+static void convert_one(double t_seen, double decode_sec, double write_sec) {
+
+    strRB5_INFO rb5_info;
+    memset(&rb5_info,0,sizeof(rb5_info));
+    rb5_info.n_slices=3;
+    rb5_info.slice_epoch_ms_end[0]=(int64_t)((t_seen-30.0)*1e3);
+    rb5_info.slice_epoch_ms_end[1]=(int64_t)((t_seen-20.0)*1e3);
+    rb5_info.slice_epoch_ms_end[2]=(int64_t)((t_seen-10.0)*1e3);
+
+    rb5_latency_begin(t_seen);
+    rb5_latency_note_sweeps(&rb5_info);
+    rb5_latency_file.t_decoded=t_seen+decode_sec;
+    rb5_latency_file.t_written=t_seen+decode_sec+write_sec;
+
+}
+
+//#############################################################################
+/* ages of a single file, returns number of mismatches */
+static int check_single(void) {
+
+    int nbad=0;
+    double p50, p95, p99;
+    rb5_latency_clear();
+    convert_one(1.5e9,2.0,1.0);
+    if (rb5_latency_file.acq_end_ms != (int64_t)((1.5e9-10.0)*1e3)) {
+      fprintf(stdout,"  FAIL acquisition end %lld\n",(long long)rb5_latency_file.acq_end_ms); nbad++;
+    }
+    if (rb5_latency_finish("in.vol","out.h5",stdout) != EXIT_SUCCESS) {
+      fprintf(stdout,"  FAIL finish\n"); nbad++;
+    }
+    rb5_latency_quantiles(RB5_LATENCY_SEEN,&p50,&p95,&p99);
+    if (fabs(p50-10.0) > 1e-3) {
+      fprintf(stdout,"  FAIL seen %.3f\n",p50); nbad++;
+    }
+    rb5_latency_quantiles(RB5_LATENCY_WRITTEN,&p50,&p95,&p99);
+    if (fabs(p50-13.0) > 1e-3) {
+      fprintf(stdout,"  FAIL written %.3f\n",p50); nbad++;
+    }
+    rb5_latency_quantiles(RB5_LATENCY_SWEEP_WRITTEN,&p50,&p95,&p99);
+    if (fabs(p50-23.0) > 1e-3 || fabs(p99-33.0) > 1e-3) {
+      fprintf(stdout,"  FAIL sweep_written %.3f %.3f\n",p50,p99); nbad++;
+    }
+    //nothing noted, nothing recorded
+    rb5_latency_begin(1.5e9);
+    if (rb5_latency_finish("bad.vol","bad.h5",NULL) != EXIT_FAILURE) {
+      fprintf(stdout,"  FAIL finish without sweeps\n"); nbad++;
+    }
+    return(nbad);
+
+}
+
+//#############################################################################
+/* p50/p95/p99 over 1..100 s decode times, returns number of mismatches */
+static int check_quantiles(void) {
+
+    int nbad=0;
+    int i;
+    double p50, p95, p99;
+    rb5_latency_clear();
+    for (i = 1; i <= 100; i++) {
+      convert_one(1.5e9,(double)i,0.0);
+      rb5_latency_finish("in.vol","out.h5",NULL);
+    }
+    rb5_latency_quantiles(RB5_LATENCY_DECODED,&p50,&p95,&p99);
+    if (fabs(p50-60.0) > 1e-3 || fabs(p95-105.0) > 1e-3 || fabs(p99-109.0) > 1e-3) {
+      fprintf(stdout,"  FAIL quantiles %.3f %.3f %.3f\n",p50,p95,p99); nbad++;
+    }
+    return(nbad);
+
+}
+
+//#############################################################################
+/* Prometheus text file of the quantile run, returns number of mismatches */
+static int check_prometheus(const char *path) {
+
+    int nbad=0;
+    char line[MAX_STRING];
+    int L_INF=0, L_COUNT=0, L_P99=0;
+    if (rb5_latency_write_prometheus(path) != EXIT_SUCCESS) {
+      fprintf(stdout,"  FAIL write %s\n",path); return(1);
+    }
+    FILE *fp=fopen(path,"r");
+    while (fp != NULL && fgets(line,sizeof(line),fp) != NULL) {
+      if (strcmp(line,"rb52odim_data_age_seconds_bucket{stage=\"decoded\",le=\"+Inf\"} 100\n") == 0) L_INF=1;
+      if (strcmp(line,"rb52odim_data_age_seconds_count{stage=\"sweep_written\"} 300\n") == 0) L_COUNT=1;
+      if (strcmp(line,"rb52odim_data_age_quantile_seconds{stage=\"decoded\",quantile=\"0.99\"} 109.000\n") == 0) L_P99=1;
+    }
+    if (fp != NULL) fclose(fp);
+    if (!L_INF || !L_COUNT || !L_P99) {
+      fprintf(stdout,"  FAIL %s content %d %d %d\n",path,L_INF,L_COUNT,L_P99); nbad++;
+    }
+    unlink(path);
+    return(nbad);
+
+}
+
+//#############################################################################
+int main(int argc, char *argv[]) {
+
+    int nbad=0;
+    rb5_latency_enable(1,NULL);
+    nbad+=check_single();
+    nbad+=check_quantiles();
+    nbad+=check_prometheus("test_rb5_latency.prom");
+    fprintf(stdout,"%s\n",nbad ? "FAILED" : "OK");
+    return(nbad ? EXIT_FAILURE : EXIT_SUCCESS);
+
+}
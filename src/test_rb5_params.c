@@ -0,0 +1,84 @@
+// compile: gcc -g -Wall rb5_params.c test_rb5_params.c -o test_rb5_params
+
+// check: valgrind --leak-check=full ./test_rb5_params
+
+#include "rb5_params.h"
+
+//#############################################################################
+/* every registry name hashes back to its own row, returns number of mismatches */
+static int check_round_trip(void) {
+
+    int nbad=0;
+    int id;
+    for (id = 0; id < RB5_N_PARAMS; id++) {
+      const strRB5_PARAM_DEF *def=rb5_param_def(id);
+      if (rb5_param_id(def->name) != id) {
+        fprintf(stdout,"  FAIL round trip %s (%d)\n",def->name,id); nbad++;
+      }
+    }
+    return(nbad);
+
+}
+
+//#############################################################################
+/* lookalikes and unregistered names must miss, returns number of hits */
+static int check_unknown(void) {
+
+    int nbad=0;
+    char *unknown_arr[]={"", "dbz", "DBZ", "dBZ ", "dBZvv", "stopafixngle", "PHIDP", "noisepower"};
+    size_t i;
+    for (i = 0; i < sizeof(unknown_arr)/sizeof(unknown_arr[0]); i++) {
+      if (rb5_param_id(unknown_arr[i]) != RB5_PARAM_UNKNOWN) {
+        fprintf(stdout,"  FAIL unknown \"%s\" found\n",unknown_arr[i]); nbad++;
+      }
+    }
+    if (rb5_param_def(RB5_PARAM_UNKNOWN) != NULL) {
+      fprintf(stdout,"  FAIL rb5_param_def(RB5_PARAM_UNKNOWN)\n"); nbad++;
+    }
+    return(nbad);
+
+}
+
+//#############################################################################
+/* a few rows as the old strcmp chains had them */
+static int check_rows(void) {
+
+    int nbad=0;
+    const strRB5_PARAM_DEF *def;
+
+    def=rb5_param_def(rb5_param_id("dBZ"));
+    if (strcmp(def->quantity,"DBZH") != 0 || def->L_DUALPOL || def->urp_type != 2 ||
+        def->conversion != RB5_CONVERSION_MOMENT_DATA || def->rayinfo_role != RB5_RAYINFO_NONE) {
+      fprintf(stdout,"  FAIL dBZ\n"); nbad++;
+    }
+    def=rb5_param_def(rb5_param_id("uPhiDP"));
+    if (strcmp(def->quantity,"UPHIDP") != 0 || !def->L_DUALPOL || def->urp_type != 216) {
+      fprintf(stdout,"  FAIL uPhiDP\n"); nbad++;
+    }
+    def=rb5_param_def(rb5_param_id("ET"));
+    if (strcmp(def->quantity,"CLASS") != 0 || def->conversion != RB5_CONVERSION_COPY) {
+      fprintf(stdout,"  FAIL ET\n"); nbad++;
+    }
+    def=rb5_param_def(rb5_param_id("stopfixangle"));
+    if (def->conversion != RB5_CONVERSION_ANGULAR || def->rayinfo_role != RB5_RAYINFO_STOPFIXANGLE) {
+      fprintf(stdout,"  FAIL stopfixangle\n"); nbad++;
+    }
+    def=rb5_param_def(rb5_param_id("timestamp"));
+    if (def->conversion != RB5_CONVERSION_COPY || def->rayinfo_role != RB5_RAYINFO_TIMESTAMP || def->urp_type != -1) {
+      fprintf(stdout,"  FAIL timestamp\n"); nbad++;
+    }
+    return(nbad);
+
+}
+
+//#############################################################################
+int main(int argc, char *argv[]) {
+
+    int nbad=0;
+    nbad+=check_round_trip();
+    nbad+=check_unknown();
+    nbad+=check_rows();
+    fprintf(stdout,"%d parameters, %d slots, %s\n",RB5_N_PARAMS,RB5_PARAM_HASH_SLOTS,nbad ? "FAILED" : "OK");
+    return(nbad ? EXIT_FAILURE : EXIT_SUCCESS);
+
+}
@@ -0,0 +1,124 @@
+// compile: gcc -g -Wall -I/usr/include/libxml2 rb5_qc.c test_rb5_qc.c -o test_rb5_qc
+
+// check: valgrind --leak-check=full ./test_rb5_qc
+
+#include "rb5_qc.h"
+
+#include <math.h> //fabs()
+
+#define NRAYS 4
+#define NBINS 5
+
+//#############################################################################
+/* a moment as populateParam() has it after convert_raw_to_data() */
+static strRB5_PARAM_INFO make_param(size_t depth) {
+
+    strRB5_PARAM_INFO rb5_param;
+    memset(&rb5_param,0,sizeof(rb5_param));
+    rb5_param.raw_binary_depth=depth;
+    rb5_param.raw_binary_max=((size_t)1 << depth)-1;
+    rb5_param.nrays=NRAYS;
+    rb5_param.nbins=NBINS;
+    rb5_param.n_elems_data=NRAYS*NBINS;
+    rb5_param.data_step=0.5;
+    rb5_param.data_range_min=-32.0;
+    return(rb5_param);
+
+}
+
+//#############################################################################
+/* 8 bit: undetect, nodata and echoes counted per ray, returns number of mismatches */
+static int check_8bit(void) {
+
+    int nbad=0;
+    strRB5_QC_STATS qc;
+    double ray_coverage[NRAYS];
+    uint8_t raw[NRAYS*NBINS]={
+        0,   0,   0,   0,   0,   // no echo
+        10,  20,  0,   255, 0,   // two echoes, one nodata
+        100, 100, 100, 100, 100, // full
+        255, 255, 255, 255, 255  // not radiated
+    };
+    strRB5_PARAM_INFO rb5_param=make_param(8);
+    if (rb5_qc_moment(&rb5_param,raw,&qc,ray_coverage) != EXIT_SUCCESS) {
+      fprintf(stdout,"  FAIL 8 bit\n"); return(1);
+    }
+    if (qc.n_samples != 20 || qc.n_undetect != 7 || qc.n_nodata != 6 || qc.n_echo != 7) {
+      fprintf(stdout,"  FAIL counts %ld %ld %ld %ld\n",qc.n_samples,qc.n_undetect,qc.n_nodata,qc.n_echo); nbad++;
+    }
+    if (qc.raw_min != 10 || qc.raw_max != 100 || fabs(qc.raw_sum-530.0) > 1e-9) {
+      fprintf(stdout,"  FAIL min/max/sum %u %u %.1f\n",qc.raw_min,qc.raw_max,qc.raw_sum); nbad++;
+    }
+    if (qc.hist_binwidth != 1 || qc.hist[0] != 7 || qc.hist[10] != 1 || qc.hist[100] != 5 || qc.hist[255] != 6) {
+      fprintf(stdout,"  FAIL histogram\n"); nbad++;
+    }
+    if (fabs(ray_coverage[0]) > 1e-9 || fabs(ray_coverage[1]-0.4) > 1e-9 ||
+        fabs(ray_coverage[2]-1.0) > 1e-9 || fabs(ray_coverage[3]) > 1e-9) {
+      fprintf(stdout,"  FAIL ray coverage %.2f %.2f %.2f %.2f\n",ray_coverage[0],ray_coverage[1],ray_coverage[2],ray_coverage[3]); nbad++;
+    }
+    if (fabs(rb5_qc_raw_2_value(&rb5_param,qc.raw_max)-18.0) > 1e-9) {
+      fprintf(stdout,"  FAIL physical max %.2f\n",rb5_qc_raw_2_value(&rb5_param,qc.raw_max)); nbad++;
+    }
+    return(nbad);
+
+}
+
+//#############################################################################
+/* 16 bit: codes binned by their top 8 bits, returns number of mismatches */
+static int check_16bit(void) {
+
+    int nbad=0;
+    strRB5_QC_STATS qc;
+    uint16_t raw[NRAYS*NBINS];
+    size_t i;
+    for (i = 0; i < NRAYS*NBINS; i++) raw[i]=(uint16_t)(i*256+1);
+    raw[NRAYS*NBINS-1]=65535;
+    strRB5_PARAM_INFO rb5_param=make_param(16);
+    if (rb5_qc_moment(&rb5_param,raw,&qc,NULL) != EXIT_SUCCESS) {
+      fprintf(stdout,"  FAIL 16 bit\n"); return(1);
+    }
+    if (qc.hist_binwidth != 256 || qc.hist[0] != 1 || qc.hist[18] != 1 || qc.hist[255] != 1 || qc.n_nodata != 1 || qc.n_echo != 19) {
+      fprintf(stdout,"  FAIL 16 bit histogram\n"); nbad++;
+    }
+    if (qc.raw_min != 1 || qc.raw_max != 18*256+1) {
+      fprintf(stdout,"  FAIL 16 bit min/max %u %u\n",qc.raw_min,qc.raw_max); nbad++;
+    }
+    return(nbad);
+
+}
+
+//#############################################################################
+/* arrays that do not match the moment are refused, returns number of mismatches */
+static int check_refused(void) {
+
+    int nbad=0;
+    strRB5_QC_STATS qc;
+    uint8_t raw[NRAYS*NBINS]={0};
+    strRB5_PARAM_INFO rb5_param=make_param(8);
+    if (rb5_qc_moment(&rb5_param,NULL,&qc,NULL) != EXIT_FAILURE) {
+      fprintf(stdout,"  FAIL no data accepted\n"); nbad++;
+    }
+    rb5_param.n_elems_data=NRAYS*NBINS-1;
+    if (rb5_qc_moment(&rb5_param,raw,&qc,NULL) != EXIT_FAILURE) {
+      fprintf(stdout,"  FAIL size mismatch accepted\n"); nbad++;
+    }
+    rb5_param=make_param(8);
+    rb5_param.raw_binary_depth=12;
+    if (rb5_qc_moment(&rb5_param,raw,&qc,NULL) != EXIT_FAILURE) {
+      fprintf(stdout,"  FAIL 12 bit accepted\n"); nbad++;
+    }
+    return(nbad);
+
+}
+
+//#############################################################################
+int main(int argc, char *argv[]) {
+
+    int nbad=0;
+    nbad+=check_8bit();
+    nbad+=check_16bit();
+    nbad+=check_refused();
+    fprintf(stdout,"%s\n",nbad ? "FAILED" : "OK");
+    return(nbad ? EXIT_FAILURE : EXIT_SUCCESS);
+
+}
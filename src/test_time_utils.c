@@ -1,4 +1,5 @@
 // compile: gcc -g -Wall time_utils.c test_time_utils.c -lm -o test_time_utils
+// benchmark: gcc -O2 -Wall time_utils.c test_time_utils.c -lm -o test_time_utils && ./test_time_utils 1000000
 
 // check: valgrind --leak-check=full ./test_time_utils
 
@@ -11,6 +12,112 @@
 
 #include "time_utils.h"
 
+//#############################################################################
+static double elapsed_sec(struct timespec *t0) {
+
+    struct timespec t1;
+    clock_gettime(CLOCK_MONOTONIC,&t1);
+    return((t1.tv_sec-t0->tv_sec)+(t1.tv_nsec-t0->tv_nsec)/1e9);
+
+}
+
+//#############################################################################
+/* epoch ms core vs the string functions, returns number of mismatches */
+static int check_epoch_ms(char *iso8601) {
+
+    int nbad=0;
+    int64_t epoch_ms;
+    char buf[MAX_ISO8601_STRING+1];
+    char ref[MAX_ISO8601_STRING+1];
+
+    if (func_iso8601_2_epoch_ms(iso8601,&epoch_ms) != EXIT_SUCCESS) {
+      fprintf(stdout,"  FAIL parse %s\n",iso8601);
+      return(1);
+    }
+    if (func_epoch_ms_2_systime(epoch_ms) != func_iso8601_2_systime(iso8601)) {
+      fprintf(stdout,"  FAIL systime %s\n",iso8601); nbad++;
+    }
+    strcpy(ref,func_iso8601_2_yyyymmdd(iso8601));
+    if (strcmp(func_epoch_ms_2_yyyymmdd(epoch_ms,buf),ref)) {
+      fprintf(stdout,"  FAIL yyyymmdd %s: %s != %s\n",iso8601,buf,ref); nbad++;
+    }
+    strcpy(ref,func_iso8601_2_hhmmss(iso8601));
+    if (strcmp(func_epoch_ms_2_hhmmss(epoch_ms,buf),ref)) {
+      fprintf(stdout,"  FAIL hhmmss %s: %s != %s\n",iso8601,buf,ref); nbad++;
+    }
+    //round trip is exact, the double systime path can lose a millisec (.136 -> .135)
+    strcpy(ref,iso8601);
+    ref[10]=' ';
+    if (strcmp(func_epoch_ms_2_iso8601(epoch_ms,buf),ref)) {
+      fprintf(stdout,"  FAIL iso8601 %s: %s != %s\n",iso8601,buf,ref); nbad++;
+    }
+    strcpy(ref,func_iso8601_2_yyyymmddhhmmss(func_add_nsecs_2_iso8601(iso8601,100)));
+    func_epoch_ms_2_iso8601(func_add_nsecs_2_epoch_ms(epoch_ms,100),buf);
+    if (strcmp(func_iso8601_2_yyyymmddhhmmss(buf),ref)) {
+      fprintf(stdout,"  FAIL + 100secs %s: %s != %s\n",iso8601,buf,ref); nbad++;
+    }
+    return(nbad);
+
+}
+
+//#############################################################################
+/* per-slice work of the decoder: parse, start/end date & time, end = bgn + n_secs */
+static void bench_epoch_ms(char *iso8601, long niter, size_t nrays) {
+
+    struct timespec t0;
+    volatile char sink=0;
+    long k;
+    size_t i;
+    char yyyymmdd[MAX_YYYYMMDD_STRING];
+    char hhmmss[MAX_HHMMSS_STRING];
+    char iso8601_end[MAX_ISO8601_STRING+1];
+
+    clock_gettime(CLOCK_MONOTONIC,&t0);
+    for (k = 0; k < niter; k++) {
+      strcpy(iso8601_end,func_add_nsecs_2_iso8601(iso8601,23.456));
+      sink^=func_iso8601_2_yyyymmdd(iso8601)[7];
+      sink^=func_iso8601_2_hhmmss(iso8601)[5];
+      sink^=func_iso8601_2_yyyymmdd(iso8601_end)[7];
+      sink^=func_iso8601_2_hhmmss(iso8601_end)[5];
+    }
+    double sec_str=elapsed_sec(&t0);
+
+    clock_gettime(CLOCK_MONOTONIC,&t0);
+    for (k = 0; k < niter; k++) {
+      int64_t epoch_ms, epoch_ms_end;
+      func_iso8601_2_epoch_ms(iso8601,&epoch_ms);
+      epoch_ms_end=func_add_nsecs_2_epoch_ms(epoch_ms,23.456);
+      sink^=func_epoch_ms_2_yyyymmdd(epoch_ms,yyyymmdd)[7];
+      sink^=func_epoch_ms_2_hhmmss(epoch_ms,hhmmss)[5];
+      sink^=func_epoch_ms_2_yyyymmdd(epoch_ms_end,yyyymmdd)[7];
+      sink^=func_epoch_ms_2_hhmmss(epoch_ms_end,hhmmss)[5];
+    }
+    double sec_ms=elapsed_sec(&t0);
+
+    fprintf(stdout, "%25s : %ld iterations\n", "per-slice times", niter);
+    fprintf(stdout, "%25s = %8.1f ns/slice\n", "string round-trips", sec_str/niter*1e9);
+    fprintf(stdout, "%25s = %8.1f ns/slice (x%.1f)\n", "epoch ms", sec_ms/niter*1e9, sec_str/sec_ms);
+
+    //how/startazT of one slice
+    float  *offset_ms=malloc(nrays*sizeof(float));
+    double *startazT =malloc(nrays*sizeof(double));
+    for (i = 0; i < nrays; i++) offset_ms[i]=i*64.;
+    int64_t epoch_ms_0;
+    func_iso8601_2_epoch_ms(iso8601,&epoch_ms_0);
+    long nslices=niter/10 > 0 ? niter/10 : 1;
+    clock_gettime(CLOCK_MONOTONIC,&t0);
+    for (k = 0; k < nslices; k++) {
+      func_epoch_ms_offsets_2_systime(epoch_ms_0,offset_ms,nrays,startazT);
+      sink^=(char)startazT[k % nrays];
+    }
+    double sec_rays=elapsed_sec(&t0);
+    fprintf(stdout, "%25s = %8.2f ns/ray (%zu rays)\n", "startazT", sec_rays/nslices/nrays*1e9, nrays);
+    free(offset_ms);
+    free(startazT);
+
+}
+
+//#############################################################################
 int main(int argc, char **argv) {
 
     char blank_iso8601_string[MAX_ISO8601_STRING+1]="\0";
@@ -30,5 +137,52 @@ int main(int argc, char **argv) {
     fprintf(stdout, fmt_s, "-> hhmmss", func_iso8601_2_hhmmss(iso8601));
     fprintf(stdout, fmt_s, "-> urpvalid",func_iso8601_2_urpvalid(iso8601,1,5));
 
-    return(1);
+    int64_t epoch_ms;
+    char buf[MAX_ISO8601_STRING+1];
+    func_iso8601_2_epoch_ms(iso8601,&epoch_ms);
+    fprintf(stdout, "%25s = %lld\n", "-> epoch_ms", (long long)epoch_ms);
+    fprintf(stdout, fmt_s, "-> epoch_ms -> iso8601", func_epoch_ms_2_iso8601(epoch_ms,buf));
+    fprintf(stdout, fmt_s, "+ 100secs", func_epoch_ms_2_iso8601(func_add_nsecs_2_epoch_ms(epoch_ms,100),buf));
+
+    //datetimehighaccuracy-like strings, incl. leap day, year & day ends, no millisecs
+    char *check_arr[]={
+      "2016-09-16 16:25:56.789",
+      "2016-09-16T16:25:56.789",
+      "2015-12-09 16:50:06.136",
+      "2017-12-15 20:00:03",
+      "2016-02-29 23:59:59.999",
+      "2019-12-31 23:59:59.001",
+      "2000-03-01 00:00:00.500",
+      "1970-01-01 00:00:00",
+      "2038-01-19 03:14:08.250",
+    };
+    int ncheck=sizeof(check_arr)/sizeof(check_arr[0]);
+    int nbad=0;
+    int i;
+    for (i = 0; i < ncheck; i++) nbad+=check_epoch_ms(check_arr[i]);
+    fprintf(stdout, "%25s = %d/%d\n", "epoch_ms checks failed", nbad, ncheck);
+
+    //out of range fields fail the parse, rather than carrying into the next day
+    char *reject_arr[]={
+      "2016-13-26 14:31:14",
+      "2016-09-00 14:31:14",
+      "2016-09-26 24:00:00",
+      "2016-09-26 14:60:00",
+      "2016-09-26 14:31:61",
+      "2016-09-26 14:3a:14",
+      "2016-09-26",
+    };
+    int nreject=sizeof(reject_arr)/sizeof(reject_arr[0]);
+    int nbad_reject=0;
+    for (i = 0; i < nreject; i++) {
+      if (func_iso8601_2_epoch_ms(reject_arr[i],&epoch_ms) == EXIT_SUCCESS) {
+        fprintf(stdout,"  FAIL accepted %s\n",reject_arr[i]); nbad_reject++;
+      }
+    }
+    fprintf(stdout, "%25s = %d/%d\n", "epoch_ms rejects failed", nbad_reject, nreject);
+    nbad+=nbad_reject;
+
+    if (argc > 1) bench_epoch_ms(iso8601,atol(argv[1]),360);
+
+    return(nbad ? EXIT_FAILURE : EXIT_SUCCESS);
 }
@@ -5,6 +5,15 @@
  *
  * compile only: gcc -g -c time_utils.c -o time_utils.o
  * 
+ * 2026-10-19:      gmtime_r() in the systime formatters, decodes run on concurrent threads
+ * 2026-10-19:      int64 epoch-millisecond core, for once-per-slice parsing in the decoder,
+ *                  - func_iso8601_2_epoch_ms(), hand-written parser, no sscanf()/timegm()
+ *                  - func_days_from_civil()
+ *                  - func_epoch_ms_2_tm_struct()
+ *                  - func_epoch_ms_2_systime()
+ *                  - func_add_nsecs_2_epoch_ms()
+ *                  - func_epoch_ms_2_iso8601(), _yyyymmdd(), _hhmmss(), into caller buffers
+ *                  - func_epoch_ms_offsets_2_systime(), per-ray timestamps
  * 2023-02-03:  PR  simpify strftime input for iso8601, casting (double)systime to (long int)time_t truncates millisec
  * 2022-01-13:  PR  use timegm() instead of mktime() to use UTC not OS local timezone (TZ env var)
  *                  tm_struct should not round by millisec, for (iso8601 -> systime -> iso8601)
@@ -75,9 +84,10 @@ double func_iso8601_2_systime(char *iso8601) {
 //#############################################################################
 char* func_systime_2_iso8601(double systime) {
 
-    static char this_iso8601_string[MAX_ISO8601_STRING+1]="\0";
+    static __thread char this_iso8601_string[MAX_ISO8601_STRING+1]="\0";
     time_t systime_t=systime;
-    strftime(this_iso8601_string,MAX_ISO8601_STRING,"%Y-%m-%d %H:%M:%S",gmtime(&systime_t));
+    struct tm tm_utc; //gmtime_r(), decodes run concurrently
+    strftime(this_iso8601_string,MAX_ISO8601_STRING,"%Y-%m-%d %H:%M:%S",gmtime_r(&systime_t,&tm_utc));
 
     //add millisecs
     int milli=(systime-floor(systime))*1000.;
@@ -94,10 +104,11 @@ char* func_systime_2_iso8601(double systime) {
 //#############################################################################
 char* func_iso8601_2_yyyymmddhhmmss(char* iso8601) {
 
-    static char this_iso8601_string[MAX_ISO8601_STRING+1]="\0";
+    static __thread char this_iso8601_string[MAX_ISO8601_STRING+1]="\0";
     double systime=func_iso8601_2_systime(iso8601);
     time_t systime_t=systime;
-    strftime(this_iso8601_string,MAX_ISO8601_STRING,"%Y%m%d%H%M%S",gmtime(&systime_t));
+    struct tm tm_utc; //gmtime_r(), decodes run concurrently
+    strftime(this_iso8601_string,MAX_ISO8601_STRING,"%Y%m%d%H%M%S",gmtime_r(&systime_t,&tm_utc));
     return(this_iso8601_string);
 
 }
@@ -105,10 +116,11 @@ char* func_iso8601_2_yyyymmddhhmmss(char* iso8601) {
 //#############################################################################
 char* func_iso8601_2_yyyymmdd(char* iso8601) {
 
-    static char this_iso8601_string[MAX_ISO8601_STRING+1]="\0";
+    static __thread char this_iso8601_string[MAX_ISO8601_STRING+1]="\0";
     double systime=func_iso8601_2_systime(iso8601);
     time_t systime_t=systime;
-    strftime(this_iso8601_string,MAX_ISO8601_STRING,"%Y%m%d",gmtime(&systime_t));
+    struct tm tm_utc; //gmtime_r(), decodes run concurrently
+    strftime(this_iso8601_string,MAX_ISO8601_STRING,"%Y%m%d",gmtime_r(&systime_t,&tm_utc));
     return(this_iso8601_string);
 
 }
@@ -116,10 +128,11 @@ char* func_iso8601_2_yyyymmdd(char* iso8601) {
 //#############################################################################
 char* func_iso8601_2_hhmmss(char* iso8601) {
 
-    static char this_iso8601_string[MAX_ISO8601_STRING+1]="\0";
+    static __thread char this_iso8601_string[MAX_ISO8601_STRING+1]="\0";
     double systime=func_iso8601_2_systime(iso8601);
     time_t systime_t=systime;
-    strftime(this_iso8601_string,MAX_ISO8601_STRING,"%H%M%S",gmtime(&systime_t));
+    struct tm tm_utc; //gmtime_r(), decodes run concurrently
+    strftime(this_iso8601_string,MAX_ISO8601_STRING,"%H%M%S",gmtime_r(&systime_t,&tm_utc));
     return(this_iso8601_string);
 
 }
@@ -145,8 +158,9 @@ char* func_iso8601_2_urpvalid(char* inp_iso8601, int L_ROUNDING, int minute_res)
 //    fprintf(stdout,"out_iso8601 = %s\n",func_systime_2_iso8601(out_systime));
 //    fprintf(stdout,"\n");
 
-    static char this_iso8601_string[MAX_ISO8601_STRING+1]="\0";
-    strftime(this_iso8601_string,MAX_ISO8601_STRING,"%Y%m%d%H%M",gmtime(&out_systime));
+    static __thread char this_iso8601_string[MAX_ISO8601_STRING+1]="\0";
+    struct tm tm_utc; //gmtime_r(), decodes run concurrently
+    strftime(this_iso8601_string,MAX_ISO8601_STRING,"%Y%m%d%H%M",gmtime_r(&out_systime,&tm_utc));
     return(this_iso8601_string);
 
 }
@@ -158,3 +172,190 @@ char* func_add_nsecs_2_iso8601(char* iso8601, double n_secs) {
 
 }
 
+
+//#############################################################################
+/* fixed-width run of decimal digits, -1 if any is not a digit */
+static int parse_digits(const char *p, int n) {
+
+    int value=0;
+    int i;
+    for (i = 0; i < n; i++) {
+      if (p[i] < '0' || p[i] > '9') return(-1);
+      value=value*10+(p[i]-'0');
+    }
+    return(value);
+
+}
+
+//#############################################################################
+/* "YYYY-mm-dd HH:MM:SS[.nnn]", any date/time delimiter (' ' or 'T') */
+int func_iso8601_2_epoch_ms(const char *iso8601, int64_t *epoch_ms) {
+
+    *epoch_ms=0;
+    if (strlen(iso8601) < 19 || iso8601[4] != '-' || iso8601[7] != '-' ||
+        iso8601[13] != ':' || iso8601[16] != ':') return(EXIT_FAILURE);
+
+    int year  =parse_digits(iso8601   ,4);
+    int month =parse_digits(iso8601+ 5,2);
+    int day   =parse_digits(iso8601+ 8,2);
+    int hour  =parse_digits(iso8601+11,2);
+    int minute=parse_digits(iso8601+14,2);
+    int second=parse_digits(iso8601+17,2);
+    if (year < 0 || month < 1 || month > 12 || day < 1 || day > 31 ||
+        hour < 0 || hour > 23 || minute < 0 || minute > 59 ||
+        second < 0 || second > 60) return(EXIT_FAILURE); //60: leap second
+
+    //fraction of a second, milliseconds resolution
+    int milli=0;
+    if (iso8601[19] == '.') {
+      const char *p=iso8601+20;
+      int scale=100;
+      for (; *p >= '0' && *p <= '9'; p++) {
+        milli+=(*p-'0')*scale;
+        scale/=10;
+      }
+    }
+
+    int64_t days=func_days_from_civil(year,month,day);
+    *epoch_ms=((days*24+hour)*60+minute)*60000+second*1000+milli;
+    return(EXIT_SUCCESS);
+
+}
+
+//#############################################################################
+/* days since 1970-01-01 of a proleptic Gregorian date (H. Hinnant's algorithm) */
+int64_t func_days_from_civil(int year, int month, int day) {
+
+    int64_t y=year-(month <= 2);
+    int64_t era=(y >= 0 ? y : y-399)/400;
+    int64_t yoe=y-era*400;                                  //[0, 399]
+    int64_t doy=(153*(month+(month > 2 ? -3 : 9))+2)/5+day-1; //[0, 365]
+    int64_t doe=yoe*365+yoe/4-yoe/100+doy;                  //[0, 146096]
+    return(era*146097+doe-719468);
+
+}
+
+//#############################################################################
+void func_epoch_ms_2_tm_struct(int64_t epoch_ms, struct tm *tm_info, int *milli) {
+
+    int64_t secs=epoch_ms/1000;
+    int64_t ms  =epoch_ms%1000;
+    if (ms < 0) { ms+=1000; secs-=1; }
+    int64_t days=secs/86400;
+    int64_t sod =secs%86400;
+    if (sod < 0) { sod+=86400; days-=1; }
+
+    //civil_from_days
+    int64_t z=days+719468;
+    int64_t era=(z >= 0 ? z : z-146096)/146097;
+    int64_t doe=z-era*146097;
+    int64_t yoe=(doe-doe/1460+doe/36524-doe/146096)/365;
+    int64_t doy=doe-(365*yoe+yoe/4-yoe/100);
+    int64_t mp=(5*doy+2)/153;
+    int64_t d=doy-(153*mp+2)/5+1;
+    int64_t m=mp+(mp < 10 ? 3 : -9);
+    int64_t y=yoe+era*400+(m <= 2);
+
+    memset(tm_info,0,sizeof(struct tm));
+    tm_info->tm_year=y-1900;
+    tm_info->tm_mon =m-1;
+    tm_info->tm_mday=d;
+    tm_info->tm_hour=sod/3600;
+    tm_info->tm_min =(sod/60)%60;
+    tm_info->tm_sec =sod%60;
+    if (milli != NULL) *milli=ms;
+
+}
+
+//#############################################################################
+/* same value as func_iso8601_2_systime(), whole seconds + millisecs/1000. */
+double func_epoch_ms_2_systime(int64_t epoch_ms) {
+
+    int64_t ms=epoch_ms%1000;
+    if (ms < 0) ms+=1000;
+    return((double)((epoch_ms-ms)/1000)+ms/1000.);
+
+}
+
+//#############################################################################
+int64_t func_add_nsecs_2_epoch_ms(int64_t epoch_ms, double n_secs) {
+
+    return(epoch_ms+(int64_t)floor(n_secs*1000.+0.5));
+
+}
+
+//#############################################################################
+/* fixed-width, zero-padded decimal digits, returns the end of the run */
+static char* put_digits(char *p, int value, int n) {
+
+    int i;
+    for (i = n-1; i >= 0; i--) {
+      p[i]='0'+value%10;
+      value/=10;
+    }
+    return(p+n);
+
+}
+
+//#############################################################################
+/* buf of at least MAX_ISO8601_STRING, ".nnn" only if non-zero, as func_systime_2_iso8601() */
+char* func_epoch_ms_2_iso8601(int64_t epoch_ms, char *buf) {
+
+    struct tm tm_info;
+    int milli;
+    func_epoch_ms_2_tm_struct(epoch_ms,&tm_info,&milli);
+    char *p=buf;
+    p=put_digits(p,tm_info.tm_year+1900,4); *p++='-';
+    p=put_digits(p,tm_info.tm_mon+1    ,2); *p++='-';
+    p=put_digits(p,tm_info.tm_mday     ,2); *p++=' ';
+    p=put_digits(p,tm_info.tm_hour     ,2); *p++=':';
+    p=put_digits(p,tm_info.tm_min      ,2); *p++=':';
+    p=put_digits(p,tm_info.tm_sec      ,2);
+    if (milli != 0) {
+      *p++='.';
+      p=put_digits(p,milli,3);
+    }
+    *p='\0';
+    return(buf);
+
+}
+
+//#############################################################################
+/* buf of at least MAX_YYYYMMDD_STRING */
+char* func_epoch_ms_2_yyyymmdd(int64_t epoch_ms, char *buf) {
+
+    struct tm tm_info;
+    func_epoch_ms_2_tm_struct(epoch_ms,&tm_info,NULL);
+    char *p=buf;
+    p=put_digits(p,tm_info.tm_year+1900,4);
+    p=put_digits(p,tm_info.tm_mon+1    ,2);
+    p=put_digits(p,tm_info.tm_mday     ,2);
+    *p='\0';
+    return(buf);
+
+}
+
+//#############################################################################
+/* buf of at least MAX_HHMMSS_STRING */
+char* func_epoch_ms_2_hhmmss(int64_t epoch_ms, char *buf) {
+
+    struct tm tm_info;
+    func_epoch_ms_2_tm_struct(epoch_ms,&tm_info,NULL);
+    char *p=buf;
+    p=put_digits(p,tm_info.tm_hour,2);
+    p=put_digits(p,tm_info.tm_min ,2);
+    p=put_digits(p,tm_info.tm_sec ,2);
+    *p='\0';
+    return(buf);
+
+}
+
+//#############################################################################
+/* systime[i] = systime(epoch_ms_0) + offset_ms[i]/1000., e.g. rayinfo <timestamp> */
+void func_epoch_ms_offsets_2_systime(int64_t epoch_ms_0, const float *restrict offset_ms, size_t n, double *restrict systime) {
+
+    const double systime_0=func_epoch_ms_2_systime(epoch_ms_0);
+    size_t i;
+    for (i = 0; i < n; i++) systime[i]=(double)offset_ms[i]/1000.+systime_0;
+
+}
@@ -1,12 +1,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h> //for int64_t
 
 #include <time.h>
 #include <math.h> //add -lm to compile
 
 #define DUMMY_ISO8601_STRING "YYYY-mm-dd HH:MM:SS.nnn"
 #define MAX_ISO8601_STRING sizeof(DUMMY_ISO8601_STRING)
+#define MAX_YYYYMMDD_STRING sizeof("YYYYmmdd")
+#define MAX_HHMMSS_STRING sizeof("HHMMSS")
 
 //#############################################################################
 // function declarations
@@ -18,3 +21,14 @@ char* func_iso8601_2_yyyymmdd(char* iso8601);
 char* func_iso8601_2_hhmmss(char* iso8601);
 char* func_iso8601_2_urpvalid(char* inp_iso8601, int L_ROUNDING, int minute_res);
 char* func_add_nsecs_2_iso8601(char* iso8601, double n_secs);
+
+// integer epoch milliseconds (UTC), parsed once, formatted at the output boundary
+int func_iso8601_2_epoch_ms(const char *iso8601, int64_t *epoch_ms);
+int64_t func_days_from_civil(int year, int month, int day);
+void func_epoch_ms_2_tm_struct(int64_t epoch_ms, struct tm *tm_info, int *milli);
+double func_epoch_ms_2_systime(int64_t epoch_ms);
+int64_t func_add_nsecs_2_epoch_ms(int64_t epoch_ms, double n_secs);
+char* func_epoch_ms_2_iso8601(int64_t epoch_ms, char *buf);
+char* func_epoch_ms_2_yyyymmdd(int64_t epoch_ms, char *buf);
+char* func_epoch_ms_2_hhmmss(int64_t epoch_ms, char *buf);
+void func_epoch_ms_offsets_2_systime(int64_t epoch_ms_0, const float *offset_ms, size_t n, double *systime);
@@ -8,6 +8,10 @@
  */
 
 #include "xml_utils.h"
+#include "rb5_profile.h"
+#include "rb5_inflate.h"
+
+#include <sys/stat.h> //fstat()
 
 #define L_DEBUG_OUTPUT_xml 0
 
@@ -131,7 +135,8 @@ char *return_xpath_value(const xmlXPathContextPtr xpathCtx, char *xpath){
 //#############################################################################
 
 //2018-May-25: Added gzopen() & gzread() handling
-size_t read_file_2_buffer(char *inp_fname, char **return_buffer){
+/* gzread() fallback of read_file_2_buffer(), e.g. for multi-member gzip files */
+static size_t gzread_file_2_buffer(char *inp_fname, char **return_buffer){
 
     size_t EXIT_NULL_VAL=0;
 
@@ -155,6 +160,11 @@ size_t read_file_2_buffer(char *inp_fname, char **return_buffer){
         bytes_read = gzread (fp, chunk, chunk_len - 1);
 //        chunk[bytes_read] = '\0';
 //        printf ("%s", chunk);
+        if (bytes_read < 0) { //e.g. a damaged gzip trailer, -1 is no short read
+            fprintf (stderr, "Error: %s.\n", gzerror (fp, & err));
+            gzclose (fp);
+            return(EXIT_NULL_VAL);
+        }
         buffer_len += bytes_read;
         if (bytes_read < chunk_len - 1) {
             if (gzeof (fp)) {
@@ -173,7 +183,7 @@ size_t read_file_2_buffer(char *inp_fname, char **return_buffer){
 
     /* Allocate our buffer to that size. */
     if(L_DEBUG_OUTPUT_xml) fprintf(stdout,"buffer_len = %ld\n",buffer_len);
-    buffer=malloc(sizeof(char)*(buffer_len));
+    buffer=rb5_mem_malloc(sizeof(char)*(buffer_len));
 
     /* Go back to the start of the file. */
     if (gzseek(fp,0L,SEEK_SET) != 0) {
@@ -192,7 +202,67 @@ size_t read_file_2_buffer(char *inp_fname, char **return_buffer){
     gzclose (fp);
 
     *return_buffer=buffer;
+    return(buffer_len);
+}
+
+//#############################################################################
+
+size_t read_file_2_buffer(char *inp_fname, char **return_buffer){
 
+    size_t EXIT_NULL_VAL=0;
+
+    char *buffer=NULL;
+    size_t buffer_len=0;
+    unsigned char *file_buffer=NULL;
+    struct stat file_stat;
+    strRB5_PROFILE_MARK prof=rb5_profile_begin();
+
+    //read the file as is in one go
+    FILE *fp=fopen(inp_fname,"rb");
+    if (fp == NULL) {
+        fprintf (stderr, "fopen of '%s' failed: %s.\n", inp_fname, strerror (errno));
+        return(EXIT_NULL_VAL);
+    }
+    int L_STAT=(fstat(fileno(fp),&file_stat) == 0);
+    if (L_STAT && S_ISDIR(file_stat.st_mode)) {
+        fprintf (stderr, "read of '%s' failed: %s.\n", inp_fname, strerror (EISDIR));
+        fclose(fp);
+        return(EXIT_NULL_VAL);
+    }
+    size_t file_len=(L_STAT && S_ISREG(file_stat.st_mode)) ? (size_t)file_stat.st_size : 0;
+    if (file_len > 0) file_buffer=rb5_mem_malloc(file_len);
+    if (file_buffer == NULL || fread(file_buffer,1,file_len,fp) != file_len) {
+        fclose(fp);
+        if (file_buffer != NULL) rb5_mem_free(file_buffer);
+        buffer_len=gzread_file_2_buffer(inp_fname,&buffer); //empty, special or unreadable file
+        *return_buffer=buffer;
+        rb5_profile_end(RB5_PROFILE_GZ_READ,prof,buffer_len);
+        return(buffer_len);
+    }
+    fclose(fp);
+
+    //gzip: inflate in one call to the size in its trailer (ISIZE)
+    if (file_len > 18 && file_buffer[0] == 0x1f && file_buffer[1] == 0x8b) {
+        size_t isize=((size_t)file_buffer[file_len-1] << 24) |
+                     ((size_t)file_buffer[file_len-2] << 16) |
+                     ((size_t)file_buffer[file_len-3] <<  8) |
+                     ((size_t)file_buffer[file_len-4]      );
+        //ISIZE is untrusted (and mod 2^32), no larger than deflate can expand to
+        if (isize > (file_len-18)*GZIP_MAX_RATIO) isize=0;
+        buffer_len=isize;
+        buffer=(isize > 0) ? rb5_mem_malloc(isize) : NULL;
+        if (buffer == NULL || rb5_gunzip((unsigned char *)buffer,&buffer_len,file_buffer,file_len) != Z_OK || buffer_len != isize) {
+            if (buffer != NULL) rb5_mem_free(buffer);
+            buffer_len=gzread_file_2_buffer(inp_fname,&buffer); //multi-member, over 4 GB or bad ISIZE
+        }
+        rb5_mem_free(file_buffer);
+    } else {
+        buffer=(char *)file_buffer;
+        buffer_len=file_len;
+    }
+
+    *return_buffer=buffer;
+    rb5_profile_end(RB5_PROFILE_GZ_READ,prof,buffer_len);
     return(buffer_len);
 }
 
@@ -200,20 +270,24 @@ size_t read_file_2_buffer(char *inp_fname, char **return_buffer){
 
 void close_file_buffer(char *buffer){
 
-    if(buffer != NULL) free(buffer);
+    if(buffer != NULL) rb5_mem_free(buffer);
 }
 
 //#############################################################################
 
 size_t find_buffer_end_of_xml(char *buffer){
     
+    strRB5_PROFILE_MARK prof=rb5_profile_begin();
+    size_t offset;
     char substring[]="<!-- END XML -->";
     char *match=strstr(buffer,substring);
     if(match == 0){
-        return strlen(buffer);
+        offset=strlen(buffer);
     } else {
-        return match-buffer+strlen(substring)+1; //count trailing \n
+        offset=match-buffer+strlen(substring)+1; //count trailing \n
     }
+    rb5_profile_end(RB5_PROFILE_END_OF_XML,prof,offset);
+    return offset;
 }
 
 //#############################################################################
@@ -238,10 +312,12 @@ int open_xml_buffer(strXML_FILE_INFO *xml_info){
     xml_info->byte_offset_end_of_xml=find_buffer_end_of_xml(xml_info->buffer);
 
     // parse the XML and get the DOM
+    strRB5_PROFILE_MARK prof=rb5_profile_begin();
     xml_info->doc=xmlReadMemory(xml_info->buffer, xml_info->byte_offset_end_of_xml, "noname.xml", NULL, 0);
 
     // create xpath evaluation context
     xml_info->xpathCtx = xmlXPathNewContext(xml_info->doc);
+    rb5_profile_end(RB5_PROFILE_XML_PARSE,prof,xml_info->byte_offset_end_of_xml);
     if(xml_info->xpathCtx == NULL) {
         fprintf(stderr,"Error: unable to create new XPath context\n");
         close_xml_buffer(&(*xml_info));
@@ -1,3 +1,6 @@
+#ifndef XML_UTILS_H
+#define XML_UTILS_H
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -11,9 +14,11 @@
 #include <errno.h>
 
 #define MAX_STRING 256
+#define MAX_PATH_STRING 1024 // input names, as in rb5_utils.h
+#define GZIP_MAX_RATIO 1032 // deflate expands at most ~1032:1, bounds the gzip ISIZE trailer
 
 typedef struct{
-    char inp_fullfile[MAX_STRING];
+    char inp_fullfile[MAX_PATH_STRING];
     char *buffer;
     size_t buffer_len;
     size_t byte_offset_end_of_xml;
@@ -35,3 +40,5 @@ size_t find_buffer_end_of_xml(char *buffer);
 
 int open_xml_buffer(strXML_FILE_INFO *xml_info);
 void close_xml_buffer(strXML_FILE_INFO *xml_info);
+
+#endif
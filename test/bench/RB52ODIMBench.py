@@ -0,0 +1,314 @@
+'''
+Copyright (C) 2016 The Crown (i.e. Her Majesty the Queen in Right of Canada)
+
+This file is an add-on to RAVE.
+
+RAVE is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+RAVE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with RAVE.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------*/
+
+rb52odim decode benchmarks
+
+Times the C decode path (src/rb5_2_odim) and the Python readRB5,
+combineRB5FromTarball and combineRB5Tarballs2Pvol paths over the test/org
+corpus, cold (input evicted from the page cache before every run) and warm
+(one untimed run, then timed runs). Every case runs in its own process so
+that peak RSS is per case.
+
+Results are printed as a table and written as JSON, so that runs can be
+compared between commits.
+
+@file
+@author rb52odim contributors
+@date 2026-10-19
+'''
+import sys, os, glob, json, time, math, platform, subprocess, resource, tempfile
+
+SCRIPTPATH = os.path.dirname(os.path.abspath(__file__))
+TOPDIR = os.path.abspath(os.path.join(SCRIPTPATH, '..', '..'))
+
+CORPUS = os.path.join(TOPDIR, 'test', 'org')
+C_BIN = os.path.join(TOPDIR, 'src', 'rb5_2_odim')
+OUTPUT = os.path.join(TOPDIR, 'test', 'new', 'bench_results.json')
+
+PATHS = ['c_rb5_2_odim', 'py_readRB5', 'py_combineRB5FromTarball', 'py_combineRB5Tarballs2Pvol']
+MODES = ['cold', 'warm']
+
+
+## Lists the RB5 files and tarballs of a corpus directory
+# @param string directory
+# @returns tuple of (list of RB5 files, list of tarballs)
+def listCorpus(corpus):
+    tarballs, rb5files = [], []
+    for f in sorted(glob.glob(os.path.join(corpus, '**', '*'), recursive=True)):
+        if not os.path.isfile(f): continue
+        base = os.path.basename(f)
+        if base.endswith('.tar.gz') or base.endswith('.tar'):
+            tarballs.append(f)
+        elif base.split('.')[-1] in ('vol', 'azi', 'ele') or base.split('.')[-2:-1] in (['vol'], ['azi'], ['ele']):
+            rb5files.append(f)
+    return rb5files, tarballs
+
+
+## Evicts files from the page cache, best effort
+# @param list of file names
+def dropCache(files):
+    if not hasattr(os, 'posix_fadvise'): return
+    for f in files:
+        try:
+            fd = os.open(f, os.O_RDONLY)
+            try:
+                os.fsync(fd)
+            except OSError:
+                pass
+            os.posix_fadvise(fd, 0, 0, os.POSIX_FADV_DONTNEED)
+            os.close(fd)
+        except OSError:
+            pass
+
+
+## Nearest-rank percentile
+# @param list of floats
+# @param float percentile in [0,100]
+# @returns float
+def percentile(values, p):
+    if not values: return None
+    s = sorted(values)
+    k = max(0, int(math.ceil(p / 100.0 * len(s))) - 1)
+    return s[k]
+
+
+## Summarizes the timed runs of one case
+# @param list of (seconds, bytes) tuples, one per unit of work
+# @param int peak RSS in kB
+# @param int number of failed runs
+# @returns dictionary
+def summarize(runs, maxrss_kb, nfailed):
+    lat = [r[0] for r in runs]
+    total_sec = sum(lat)
+    total_bytes = sum(r[1] for r in runs)
+    return {
+        'n': len(runs),
+        'failed': nfailed,
+        'total_sec': total_sec,
+        'files_per_sec': len(runs) / total_sec if total_sec > 0 else None,
+        'MB_per_sec': total_bytes / 1e6 / total_sec if total_sec > 0 else None,
+        'p50_ms': percentile(lat, 50) * 1e3 if lat else None,
+        'p99_ms': percentile(lat, 99) * 1e3 if lat else None,
+        'peak_rss_kB': maxrss_kb,
+    }
+
+
+## Runs the C decoder once per file, measuring each child with wait4()
+# @param list of RB5 files
+# @param string cold or warm
+# @param int number of timed repetitions
+# @param string rb5_2_odim binary
+# @returns dictionary
+def benchC(files, mode, repeat, c_bin):
+    runs, maxrss, nfailed = [], 0, 0
+    tmpdir = tempfile.mkdtemp(prefix='rb5bench')
+    ofile = os.path.join(tmpdir, 'bench.h5')
+    devnull = open(os.devnull, 'w')
+
+    def once(f):
+        t0 = time.perf_counter()
+        p = subprocess.Popen([c_bin, '-i', f, '-o', ofile], stdout=devnull, stderr=devnull)
+        _, status, ru = os.wait4(p.pid, 0)
+        return time.perf_counter() - t0, ru.ru_maxrss, os.path.isfile(ofile)
+
+    for f in files:
+        if mode == 'warm': once(f)
+        for i in range(repeat):
+            if mode == 'cold': dropCache([f])
+            if os.path.isfile(ofile): os.remove(ofile)
+            sec, rss, ok = once(f)
+            maxrss = max(maxrss, rss)
+            if ok: runs.append((sec, os.path.getsize(f)))
+            else: nfailed += 1
+    devnull.close()
+    if os.path.isfile(ofile): os.remove(ofile)
+    os.rmdir(tmpdir)
+    return summarize(runs, maxrss, nfailed)
+
+
+## Runs one Python path in this process (called in a worker process)
+# @param string path name, one of PATHS
+# @param list of input files
+# @param string cold or warm
+# @param int number of timed repetitions
+# @returns dictionary
+def benchPython(path, files, mode, repeat):
+    import _rb52odim
+    if path != 'py_readRB5':
+        import rb52odim
+
+    if path == 'py_readRB5':
+        units = [[f] for f in files]
+        def work(u):
+            rio = _rb52odim.readRB5(u[0])
+            return rio is not None and rio.object is not None
+    elif path == 'py_combineRB5FromTarball':
+        units = [[f] for f in files]
+        def work(u):
+            rio = rb52odim.combineRB5FromTarball(u[0], None, return_rio=True)
+            return rio is not None and rio.object is not None
+    elif path == 'py_combineRB5Tarballs2Pvol':
+        units = [files] if files else []
+        def work(u):
+            rio = rb52odim.combineRB5Tarballs2Pvol(u, None, return_rio=True)
+            return rio is not None and rio.object is not None
+    else:
+        raise ValueError("unknown path %s" % path)
+
+    runs, nfailed = [], 0
+    for u in units:
+        nbytes = sum(os.path.getsize(f) for f in u)
+        if mode == 'warm':
+            try: work(u)
+            except Exception: pass
+        for i in range(repeat):
+            if mode == 'cold': dropCache(u)
+            t0 = time.perf_counter()
+            try:
+                ok = work(u)
+            except Exception:
+                ok = False
+            sec = time.perf_counter() - t0
+            if ok: runs.append((sec, nbytes))
+            else: nfailed += 1
+    maxrss = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    return summarize(runs, maxrss, nfailed)
+
+
+## Runs one Python case in a fresh interpreter, so that peak RSS is per case
+# @returns dictionary or None if the worker failed
+def spawnPython(path, files, mode, repeat):
+    cmd = [sys.executable, os.path.abspath(__file__), '--worker', path,
+           '--mode', mode, '--repeat', str(repeat)] + files
+    p = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+    try:
+        return json.loads(p.stdout.decode().strip().splitlines()[-1])
+    except (ValueError, IndexError):
+        return None
+
+
+## Identifies the tree being benchmarked
+# @returns string
+def gitRevision():
+    try:
+        out = subprocess.run(['git', '-C', TOPDIR, 'rev-parse', '--short', 'HEAD'],
+                             stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+        return out.stdout.decode().strip() or None
+    except OSError:
+        return None
+
+
+## Prints the results table
+def printTable(results):
+    fmt = "%-28s %-5s %6s %8s %10s %10s %10s %10s %12s"
+    print(fmt % ('path', 'mode', 'n', 'failed', 'files/s', 'MB/s', 'p50_ms', 'p99_ms', 'peak_rss_kB'))
+    num = lambda v, f: (f % v) if v is not None else '-'
+    for r in results:
+        s = r['stats']
+        if s is None:
+            print(fmt % (r['path'], r['mode'], '-', '-', '-', '-', '-', '-', '-'))
+            continue
+        print(fmt % (r['path'], r['mode'], s['n'], s['failed'],
+                     num(s['files_per_sec'], '%.2f'), num(s['MB_per_sec'], '%.2f'),
+                     num(s['p50_ms'], '%.2f'), num(s['p99_ms'], '%.2f'), s['peak_rss_kB']))
+
+
+def main(options):
+    rb5files, tarballs = listCorpus(options.corpus)
+    for d in options.synthetic or []:
+        more_rb5, more_tar = listCorpus(d)
+        rb5files += more_rb5
+        tarballs += more_tar
+
+    paths = options.paths.split(',') if options.paths else PATHS
+    modes = options.modes.split(',') if options.modes else MODES
+
+    results = []
+    for path in paths:
+        for mode in modes:
+            if path == 'c_rb5_2_odim':
+                if not os.access(options.c_bin, os.X_OK):
+                    sys.stderr.write("Skipping %s: %s not built (make -C src -f Makefile.w_rb5_2_odim_main)\n" % (path, options.c_bin))
+                    continue
+                stats = benchC(rb5files, mode, options.repeat, options.c_bin)
+            elif path == 'py_readRB5':
+                stats = spawnPython(path, rb5files, mode, options.repeat)
+            else:
+                stats = spawnPython(path, tarballs, mode, options.repeat)
+            results.append({'path': path, 'mode': mode, 'stats': stats})
+
+    printTable(results)
+
+    report = {
+        'revision': gitRevision(),
+        'date': time.strftime('%Y-%m-%dT%H:%M:%SZ', time.gmtime()),
+        'host': platform.node(),
+        'machine': platform.machine(),
+        'python': platform.python_version(),
+        'corpus': [options.corpus] + (options.synthetic or []),
+        'repeat': options.repeat,
+        'results': results,
+    }
+    odir = os.path.dirname(options.output)
+    if odir and not os.path.isdir(odir): os.makedirs(odir)
+    with open(options.output, 'w') as fd:
+        json.dump(report, fd, indent=1)
+    print("Created : %s" % options.output)
+
+
+if __name__ == '__main__':
+    from optparse import OptionParser, SUPPRESS_HELP
+
+    usage = "usage: %prog [-c <corpus dir>] [-s <synthetic dir>] [-n <repeat>] [-o <results.json>] [h]"
+    parser = OptionParser(usage=usage)
+
+    parser.add_option("-c", "--corpus", dest="corpus", default=CORPUS,
+                      help="Directory of RB5 files and tarballs. Defaults to test/org.")
+
+    parser.add_option("-s", "--synthetic", dest="synthetic", action="append",
+                      help="Additional directory of (e.g. synthetic) RB5 files, may be repeated.")
+
+    parser.add_option("-n", "--repeat", dest="repeat", type="int", default=3,
+                      help="Timed repetitions per file. Defaults to 3.")
+
+    parser.add_option("-o", "--output", dest="output", default=OUTPUT,
+                      help="JSON results file. Defaults to test/new/bench_results.json.")
+
+    parser.add_option("-b", "--bin", dest="c_bin", default=C_BIN,
+                      help="rb5_2_odim binary. Defaults to src/rb5_2_odim.")
+
+    parser.add_option("-p", "--paths", dest="paths",
+                      help="Comma-separated subset of %s." % ','.join(PATHS))
+
+    parser.add_option("-m", "--modes", dest="modes",
+                      help="Comma-separated subset of %s." % ','.join(MODES))
+
+    # internal: run one Python case and print its summary as JSON
+    parser.add_option("--worker", dest="worker", help=SUPPRESS_HELP)
+    parser.add_option("--mode", dest="mode", default="warm", help=SUPPRESS_HELP)
+
+    (options, args) = parser.parse_args()
+
+    if options.worker:
+        print(json.dumps(benchPython(options.worker, args, options.mode, options.repeat)))
+        sys.exit(0)
+
+    if 'RB52ODIMCONFIG' not in os.environ:
+        os.environ['RB52ODIMCONFIG'] = os.path.join(TOPDIR, 'config')
+    main(options)
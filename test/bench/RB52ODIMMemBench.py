@@ -0,0 +1,222 @@
+'''
+Copyright (C) 2016 The Crown (i.e. Her Majesty the Queen in Right of Canada)
+
+This file is an add-on to RAVE.
+
+RAVE is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+RAVE is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with RAVE.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------*/
+
+rb52odim volume merge memory benchmark
+
+Measures the peak RSS of combining the ten CASRA_2017121520000300*.vol.gz
+moment files into one volume:
+
+  clone   the former compileVolumeFromVolumes(): clone() the first volume,
+          including its moment data, then removeScan() until it is empty
+  shell   compileVolumeFromVolumes() with volumeShell(), which copies only
+          the top-level metadata of the first volume
+  native  readRB5(), decoding and merging one file at a time in C
+  compact each single-moment volume kept as a CompactVolume as soon as it is
+          decoded, then compileVolumeFromVolumes(), as a reprocessing job
+          queueing volumes before merging them would
+
+The single-moment volumes are decoded before the measurement starts for
+clone and shell, so their growth is that of the merge alone. For native and
+compact, decoding is part of the merge; compact also reports the bytes its
+queue held (held_kB). Every case runs in its own process.
+
+@file
+@author rb52odim contributors
+@date 2026-10-19
+'''
+import sys, os, glob, json, time, platform, subprocess, resource
+
+SCRIPTPATH = os.path.dirname(os.path.abspath(__file__))
+TOPDIR = os.path.abspath(os.path.join(SCRIPTPATH, '..', '..'))
+
+FILES = os.path.join(TOPDIR, 'test', 'org', 'CASRA_2017121520000300*.vol.gz')
+OUTPUT = os.path.join(TOPDIR, 'test', 'new', 'bench_memory.json')
+
+CASES = ['clone', 'shell', 'native', 'compact']
+
+
+## Reads a memory field of /proc/self/status
+# @param string field name, e.g. VmRSS or VmHWM
+# @returns int kB, or None if not available
+def procStatus(field):
+    try:
+        with open('/proc/self/status') as fd:
+            for line in fd:
+                if line.startswith(field + ':'):
+                    return int(line.split()[1])
+    except (IOError, OSError, ValueError):
+        pass
+    return None
+
+
+## Resets the peak RSS (VmHWM) of this process, Linux only
+# @returns True if the peak was reset
+def resetPeak():
+    try:
+        with open('/proc/self/clear_refs', 'w') as fd:
+            fd.write('5')
+        return True
+    except (IOError, OSError):
+        return False
+
+
+## The former compileVolumeFromVolumes() host: clone, then strip all scans
+# @param PolarVolumeCore object
+# @returns PolarVolumeCore object without scans
+def cloneAndStrip(template):
+    volume = template.clone()
+    while 1:
+        try:
+            volume.removeScan(0)
+        except:
+            break
+    return volume
+
+
+## Runs one case in this process (called in a worker process)
+# @param string case name, one of CASES
+# @param list of input files
+# @returns dictionary
+def benchCase(case, files):
+    import rb52odim
+
+    volumes = None
+    held = None
+    if case in ('clone', 'shell'):
+        volumes = rb52odim.readParameterFiles(files)
+    peak_reset = resetPeak()
+    rss0 = procStatus('VmRSS')
+
+    t0 = time.perf_counter()
+    if case == 'clone':
+        saved = rb52odim.volumeShell
+        rb52odim.volumeShell = cloneAndStrip
+        try:
+            pvol = rb52odim.compileVolumeFromVolumes(volumes)
+        finally:
+            rb52odim.volumeShell = saved
+    elif case == 'shell':
+        pvol = rb52odim.compileVolumeFromVolumes(volumes)
+    elif case == 'native':
+        pvol = rb52odim.readRB5(files).object
+    elif case == 'compact':
+        volumes = [rb52odim.CompactVolume(v) for ifile in sorted(files, key=lambda s: s.lower())
+                   for v in rb52odim.readParameterFiles([ifile])] # compacted one file at a time
+        held = sum(v.nbytes() for v in volumes)
+        pvol = rb52odim.compileVolumeFromVolumes(volumes)
+    else:
+        raise ValueError("unknown case %s" % case)
+    sec = time.perf_counter() - t0
+
+    hwm = procStatus('VmHWM')
+    return {
+        'nscans': pvol.getNumberOfScans() if pvol is not None else 0,
+        'sec': sec,
+        'rss_before_kB': rss0,
+        'peak_rss_kB': resource.getrusage(resource.RUSAGE_SELF).ru_maxrss,
+        'merge_peak_kB': (hwm - rss0) if (peak_reset and hwm is not None and rss0 is not None) else None,
+        'held_kB': (held // 1024) if held is not None else None,
+    }
+
+
+## Runs one case in a fresh interpreter
+# @returns dictionary or None if the worker failed
+def spawnCase(case, files):
+    cmd = [sys.executable, os.path.abspath(__file__), '--worker', case] + files
+    p = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+    try:
+        return json.loads(p.stdout.decode().strip().splitlines()[-1])
+    except (ValueError, IndexError):
+        return None
+
+
+## Prints the results table
+def printTable(results):
+    fmt = "%-8s %7s %10s %14s %14s %14s"
+    print(fmt % ('case', 'nscans', 'sec', 'rss_before_kB', 'merge_peak_kB', 'peak_rss_kB'))
+    num = lambda v, f: (f % v) if v is not None else '-'
+    for r in results:
+        s = r['stats']
+        if s is None:
+            print(fmt % (r['case'], '-', '-', '-', '-', '-'))
+            continue
+        print(fmt % (r['case'], s['nscans'], num(s['sec'], '%.3f'), num(s['rss_before_kB'], '%d'),
+                     num(s['merge_peak_kB'], '%d'), s['peak_rss_kB']))
+
+
+def main(options):
+    files = sorted(glob.glob(options.files))
+    if not files:
+        sys.stderr.write("No input files match %s\n" % options.files)
+        sys.exit(1)
+    cases = options.cases.split(',') if options.cases else CASES
+
+    results = []
+    for case in cases:
+        for i in range(options.repeat):
+            results.append({'case': case, 'stats': spawnCase(case, files)})
+
+    printTable(results)
+
+    report = {
+        'date': time.strftime('%Y-%m-%dT%H:%M:%SZ', time.gmtime()),
+        'host': platform.node(),
+        'machine': platform.machine(),
+        'python': platform.python_version(),
+        'files': files,
+        'results': results,
+    }
+    odir = os.path.dirname(options.output)
+    if odir and not os.path.isdir(odir): os.makedirs(odir)
+    with open(options.output, 'w') as fd:
+        json.dump(report, fd, indent=1)
+    print("Created : %s" % options.output)
+
+
+if __name__ == '__main__':
+    from optparse import OptionParser, SUPPRESS_HELP
+
+    usage = "usage: %prog [-f <file glob>] [-c <cases>] [-n <repeat>] [-o <results.json>] [h]"
+    parser = OptionParser(usage=usage)
+
+    parser.add_option("-f", "--files", dest="files", default=FILES,
+                      help="Glob of single-moment RB5 volume files. Defaults to the ten CASRA_2017121520000300 moments in test/org.")
+
+    parser.add_option("-c", "--cases", dest="cases",
+                      help="Comma-separated subset of %s." % ','.join(CASES))
+
+    parser.add_option("-n", "--repeat", dest="repeat", type="int", default=1,
+                      help="Runs per case, each in its own process. Defaults to 1.")
+
+    parser.add_option("-o", "--output", dest="output", default=OUTPUT,
+                      help="JSON results file. Defaults to test/new/bench_memory.json.")
+
+    # internal: run one case and print its result as JSON
+    parser.add_option("--worker", dest="worker", help=SUPPRESS_HELP)
+
+    (options, args) = parser.parse_args()
+
+    if 'RB52ODIMCONFIG' not in os.environ:
+        os.environ['RB52ODIMCONFIG'] = os.path.join(TOPDIR, 'config')
+
+    if options.worker:
+        print(json.dumps(benchCase(options.worker, args)))
+        sys.exit(0)
+
+    main(options)
@@ -23,7 +23,7 @@ rb52odim unit tests
 @author Daniel Michelson and Peter Rodriguez, Environment and Climate Change Cananda
 @date 2016-08-17
 '''
-import os, unittest, types, glob
+import os, unittest, types, glob, tarfile, shutil
 import _rave
 import _raveio
 import _polarscan
@@ -148,6 +148,7 @@ class rb52odimTest(unittest.TestCase):
     GOOD_RB5_AZI = "../org/2016081612320300dBZ.azi" #volume version="5.43.11"
     NEW_H5_VOL = "../new/2016092614304000dBZ.vol.new.h5"
     NEW_H5_AZI = "../new/2016081612320300dBZ.azi.new.h5"
+    NEW_RB5_VOL = "../new/2016092614304000dBZ.vol" # copy, next to which a decoded-blob cache is written
     REF_H5_VOL = "../ref/2016092614304000dBZ.vol.ref.h5"  # Assumes that these reference files are ODIM compliant
     REF_H5_AZI = "../ref/2016081612320300dBZ.azi.ref.h5"
 
@@ -220,6 +221,8 @@ class rb52odimTest(unittest.TestCase):
         rio = _rb52odim.readRB5(self.CORRUPT_RB5_VOL)
         self.assertIsNone(rio.object)
         self.assertTrue(rio.objectType is _rave.Rave_ObjectType_UNDEFINED)
+        # with statistics there is no half-empty tuple, the read raises
+        self.assertRaises(IOError, _rb52odim.readRB5, self.CORRUPT_RB5_VOL, True)
 
     def testSingleRB5Corrupt(self):
         rio = rb52odim.singleRB5(self.CORRUPT_RB5_VOL, return_rio=True)
@@ -231,6 +234,34 @@ class rb52odimTest(unittest.TestCase):
         self.assertIsNone(rio.object)
         self.assertTrue(rio.objectType is _rave.Rave_ObjectType_UNDEFINED)
 
+    def testModuleReadRB5BadDate(self):
+        # a slice date that does not parse fails the read, rather than becoming 1970
+        with open(self.GOOD_RB5_VOL, 'rb') as fd:
+            data = fd.read()
+        i = data.index(b'time="14:31:14" date="2016-09-26"')
+        data = data[:i] + data[i:].replace(b'date="2016-09-26"', b'date="2016-13-26"', 1)
+        bad_vol = self.NEW_RB5_VOL + '.baddate.vol'
+        with open(bad_vol, 'wb') as fd:
+            fd.write(data)
+        rio = _rb52odim.readRB5(bad_vol)
+        os.remove(bad_vol)
+        self.assertIsNone(rio.object)
+        self.assertTrue(rio.objectType is _rave.Rave_ObjectType_UNDEFINED)
+
+    def testModuleReadRB5BadGzipTrailer(self):
+        # an ISIZE no deflate stream can reach is not allocated, the read fails
+        gz = sorted(glob.glob(self.CASRA_AZI))[0]
+        with open(gz, 'rb') as fd:
+            data = bytearray(fd.read())
+        data[-4:] = b'\xff\xff\xff\x7f'
+        bad_gz = self.NEW_RB5_VOL + '.badisize.azi.gz'
+        with open(bad_gz, 'wb') as fd:
+            fd.write(data)
+        rio = _rb52odim.readRB5(bad_gz)
+        os.remove(bad_gz)
+        self.assertIsNone(rio.object)
+        self.assertTrue(rio.objectType is _rave.Rave_ObjectType_UNDEFINED)
+
     def testReadRB5Azi(self):
         rio = _rb52odim.readRB5(self.GOOD_RB5_AZI)
         self.assertTrue(rio.objectType is _rave.Rave_ObjectType_SCAN)
@@ -251,6 +282,210 @@ class rb52odimTest(unittest.TestCase):
             ref_scan = ref_pvol.getScan(i)
             validateScan(self, scan, ref_scan)
 
+    def testReadRB5Stats(self):
+        rio, stats = _rb52odim.readRB5(self.GOOD_RB5_VOL, True)
+        self.assertTrue(rio.objectType is _rave.Rave_ObjectType_PVOL)
+        for phase in ['gz_read', 'end_of_xml', 'xml_parse', 'populate_rb5_info', 'angles',
+                      'blob_lookup', 'inflate', 'convert', 'reorder', 'rave_build']:
+            self.assertTrue(stats[phase]['calls'] > 0)
+            self.assertTrue(stats[phase]['wall_sec'] >= 0.0)
+        self.assertEqual(stats['inflate']['calls'], stats['blob_lookup']['calls'])
+        self.assertEqual(stats['save']['calls'], 0)
+        # profiling is switched off again afterwards
+        rio = _rb52odim.readRB5(self.GOOD_RB5_VOL)
+        self.assertTrue(rio.objectType is _rave.Rave_ObjectType_PVOL)
+
+    def testReadRB5MemTrack(self):
+        rio, stats = _rb52odim.readRB5(self.GOOD_RB5_VOL, False, False, True)
+        self.assertTrue(rio.objectType is _rave.Rave_ObjectType_PVOL)
+        for phase in ['gz_read', 'xml_parse', 'inflate', 'convert']:
+            self.assertTrue(stats[phase]['allocs'] > 0)
+            self.assertTrue(stats[phase]['peak_bytes'] > 0)
+        self.assertTrue(stats['gz_read']['alloc_bytes'] >= os.path.getsize(self.GOOD_RB5_VOL))
+        self.assertEqual(sum(stats[p]['allocs'] for p in stats if p != 'memory'), stats['memory']['allocs'])
+        self.assertTrue(stats['memory']['peak_bytes'] >= stats['inflate']['peak_bytes'])
+        self.assertTrue(stats['memory']['maxrss_kb'] > 0)
+        # tracking is switched off again afterwards
+        rio, stats = _rb52odim.readRB5(self.GOOD_RB5_VOL, True)
+        self.assertFalse('memory' in stats)
+
+    def testReadRB5Qc(self):
+        pvol = _rb52odim.readRB5(self.GOOD_RB5_VOL, False, False, False, True).object
+        for i in range(pvol.getNumberOfScans()):
+            scan = pvol.getScan(i)
+            for quantity in scan.getParameterNames():
+                param = scan.getParameter(quantity)
+                data = param.getData().astype(np.int64)
+                echo = (data != param.undetect) & (data != param.nodata)
+                shift = 8 * (param.getData().dtype.itemsize - 1)
+                self.assertAlmostEqual(param.getAttribute('how/qc_nodata_fraction'), np.mean(data == param.nodata))
+                self.assertAlmostEqual(param.getAttribute('how/qc_undetect_fraction'), np.mean(data == param.undetect))
+                self.assertAlmostEqual(param.getAttribute('how/qc_coverage'), np.mean(echo))
+                self.assertTrue(np.array_equal(param.getAttribute('how/qc_histogram'),
+                                               np.bincount((data >> shift).ravel(), minlength=256)))
+                self.assertTrue(np.allclose(param.getAttribute('how/qc_ray_coverage'), echo.mean(axis=1)))
+                if echo.any():
+                    self.assertAlmostEqual(param.getAttribute('how/qc_max'), data[echo].max() * param.gain + param.offset, 4)
+                    self.assertAlmostEqual(param.getAttribute('how/qc_mean'), data[echo].mean() * param.gain + param.offset, 4)
+        # switched off again afterwards
+        param = _rb52odim.readRB5(self.GOOD_RB5_VOL).object.getScan(0).getParameter('DBZH')
+        self.assertFalse('how/qc_coverage' in param.getAttributeNames())
+
+    def testCompactParam(self):
+        scan = _rb52odim.readRB5(self.GOOD_RB5_VOL).object.getScan(0)
+        for quantity in scan.getParameterNames():
+            param = scan.getParameter(quantity)
+            scan.removeParameter(quantity)
+            data = param.getData().copy()
+            compact = _rb52odim.compactParam(param)
+            self.assertTrue(len(compact) < data.nbytes)
+            self.assertEqual(param.getData().shape, (1, 1))
+            _rb52odim.expandParam(param, compact)
+            self.assertTrue(np.array_equal(param.getData(), data))
+            self.assertRaises(ValueError, _rb52odim.expandParam, param, compact[:-1])
+
+    def testReadArrays_vs_ReadRB5(self):
+        arrays = _rb52odim.read_arrays(self.GOOD_RB5_VOL, True)
+        pvol = _rb52odim.readRB5(self.GOOD_RB5_VOL).object
+        self.assertEqual(len(arrays['sweeps']), pvol.getNumberOfScans())
+        self.assertEqual(arrays['metadata']['scan_type'], 'vol')
+        for i, sweep in enumerate(arrays['sweeps']):
+            scan = pvol.getScan(i)
+            self.assertEqual(sweep['metadata']['a1gate'], scan.a1gate)
+            self.assertEqual(sweep['metadata']['starttime'], scan.starttime)
+            for how in ['startazA', 'stopazA', 'startelA', 'stopelA', 'startazT']:
+                self.assertTrue(np.allclose(sweep[how], scan.getAttribute('how/' + how)))
+            for quantity, moment in sweep['moments'].items():
+                param = scan.getParameter(quantity)
+                self.assertTrue(np.array_equal(moment['data'], param.getData()))
+                self.assertEqual(moment['gain'], param.gain)
+                self.assertEqual(moment['offset'], param.offset)
+                self.assertEqual(moment['nodata'], param.nodata)
+                self.assertEqual(moment['physical'].dtype, np.float32)
+        # arrays outlive the dictionary holding them
+        data = arrays['sweeps'][0]['moments']['DBZH']['data']
+        del arrays
+        self.assertEqual(data.shape, (pvol.getScan(0).nrays, pvol.getScan(0).nbins))
+
+    def testReadArraysCorrupt(self):
+        self.assertRaises(IOError, _rb52odim.read_arrays, self.CORRUPT_RB5_VOL)
+
+    def testReadRB5Cache(self):
+        shutil.copy(self.GOOD_RB5_VOL, self.NEW_RB5_VOL)
+        ref_pvol = _raveio.open(self.REF_H5_VOL).object
+        for attempt in ['cold', 'warm']:
+            rio = _rb52odim.readRB5(self.NEW_RB5_VOL, False, True)
+            self.assertTrue(os.path.isfile(self.NEW_RB5_VOL + '.rb5c'))
+            pvol = rio.object
+            self.assertEqual(pvol.getNumberOfScans(), ref_pvol.getNumberOfScans())
+            validateTopLevel(self, pvol, ref_pvol)
+            for i in range(pvol.getNumberOfScans()):
+                validateScan(self, pvol.getScan(i), ref_pvol.getScan(i))
+        arrays = _rb52odim.read_arrays(self.NEW_RB5_VOL, False, True)
+        ref_arrays = _rb52odim.read_arrays(self.GOOD_RB5_VOL)
+        for sweep, ref_sweep in zip(arrays['sweeps'], ref_arrays['sweeps']):
+            self.assertTrue(np.array_equal(sweep['moments']['DBZH']['data'], ref_sweep['moments']['DBZH']['data']))
+            self.assertTrue(np.array_equal(sweep['startazT'], ref_sweep['startazT']))
+        # a new mtime invalidates the cache, it is written again
+        cache_ino = os.stat(self.NEW_RB5_VOL + '.rb5c').st_ino
+        st = os.stat(self.NEW_RB5_VOL)
+        os.utime(self.NEW_RB5_VOL, ns=(st.st_atime_ns, st.st_mtime_ns + 1))
+        rio = _rb52odim.readRB5(self.NEW_RB5_VOL, False, True)
+        self.assertNotEqual(os.stat(self.NEW_RB5_VOL + '.rb5c').st_ino, cache_ino)
+        validateScan(self, rio.object.getScan(0), ref_pvol.getScan(0))
+        os.remove(self.NEW_RB5_VOL + '.rb5c')
+        os.remove(self.NEW_RB5_VOL)
+
+    def testAioRead(self):
+        import asyncio
+        async def readAll(reader):
+            files = [self.GOOD_RB5_VOL, self.GOOD_RB5_AZI, self.GOOD_RB5_VOL]
+            rios = await asyncio.gather(*[reader.read(f) for f in files])
+            with open(self.GOOD_RB5_VOL, 'rb') as fd:
+                rios.append(await reader.read(fd.read(), name=self.GOOD_RB5_VOL))
+            # one worker: cancelled reads still queued are never decoded
+            tasks = [asyncio.ensure_future(reader.read(self.GOOD_RB5_VOL)) for i in range(4)]
+            await asyncio.sleep(0)
+            for task in tasks[1:]:
+                task.cancel()
+            results = await asyncio.gather(*tasks, return_exceptions=True)
+            return rios, results
+        loop = asyncio.new_event_loop()
+        reader = rb52odim.aio.Reader(1)
+        try:
+            rios, results = loop.run_until_complete(readAll(reader))
+        finally:
+            reader.close()
+            loop.close()
+        ref_pvol = _raveio.open(self.REF_H5_VOL).object
+        for rio in [rios[0], rios[2], rios[3], results[0]]:
+            self.assertTrue(rio.objectType is _rave.Rave_ObjectType_PVOL)
+            validateTopLevel(self, rio.object, ref_pvol)
+            for i in range(ref_pvol.getNumberOfScans()):
+                validateScan(self, rio.object.getScan(i), ref_pvol.getScan(i))
+        self.assertTrue(rios[1].objectType is _rave.Rave_ObjectType_SCAN)
+        for result in results[1:]:
+            self.assertTrue(isinstance(result, asyncio.CancelledError))
+
+    def testAioReadConcurrent(self):
+        # decodes running at once, GIL released, must match sequential reads
+        import asyncio
+        files = sorted(glob.glob(self.CASRA_AZI)) + [self.GOOD_RB5_VOL, self.GOOD_RB5_AZI]
+        files = files * 3
+        async def readAll(reader):
+            return await asyncio.gather(*[reader.read(f) for f in files])
+        loop = asyncio.new_event_loop()
+        reader = rb52odim.aio.Reader(8)
+        try:
+            rios = loop.run_until_complete(readAll(reader))
+        finally:
+            reader.close()
+            loop.close()
+        for ifile, rio in zip(files, rios):
+            ref_rio = _rb52odim.readRB5(ifile)
+            obj, ref = rio.object, ref_rio.object
+            self.assertEqual(rio.objectType, ref_rio.objectType)
+            if ref_rio.objectType is _rave.Rave_ObjectType_PVOL:
+                validateTopLevel(self, obj, ref)
+                self.assertEqual(obj.getNumberOfScans(), ref.getNumberOfScans())
+                for i in range(ref.getNumberOfScans()):
+                    validateScan(self, obj.getScan(i), ref.getScan(i))
+            else:
+                validateScan(self, obj, ref)
+
+    def testReadRB5StrategyCache(self):
+        _rb52odim.strategy_stats(True)
+        ref_pvol = _raveio.open(self.REF_H5_VOL).object
+        for attempt in ['parsed', 'cached']:
+            pvol = _rb52odim.readRB5(self.GOOD_RB5_VOL).object
+            self.assertEqual(pvol.getNumberOfScans(), ref_pvol.getNumberOfScans())
+            validateTopLevel(self, pvol, ref_pvol)
+            for i in range(pvol.getNumberOfScans()):
+                validateScan(self, pvol.getScan(i), ref_pvol.getScan(i))
+        stats = _rb52odim.strategy_stats(True)
+        self.assertEqual(stats['misses'], 1)
+        self.assertEqual(stats['hits'], 1)
+        self.assertEqual(stats['entries'], 1)
+
+    def testReadRB5StrategyCacheRecalibrated(self):
+        # same strategy, new radconst: the cached statics are not reused
+        with open(self.GOOD_RB5_VOL, 'rb') as fd:
+            data = fd.read()
+        data = data.replace(b'<rspdphradconst>78.423 73.025', b'<rspdphradconst>78.423 72.025')
+        recal_vol = self.NEW_RB5_VOL + '.recal.vol'
+        with open(recal_vol, 'wb') as fd:
+            fd.write(data)
+        _rb52odim.strategy_stats(True)
+        ref_scan = _rb52odim.readRB5(self.GOOD_RB5_VOL).object.getScan(0)
+        new_scan = _rb52odim.readRB5(recal_vol).object.getScan(0)
+        os.remove(recal_vol)
+        self.assertAlmostEqual(ref_scan.getAttribute('how/radconstH'), 73.025, 3)
+        self.assertAlmostEqual(new_scan.getAttribute('how/radconstH'), 72.025, 3)
+        stats = _rb52odim.strategy_stats(True)
+        self.assertEqual(stats['misses'], 2)
+        self.assertEqual(stats['hits'], 0)
+        self.assertEqual(stats['entries'], 1)
+
     def testSingleRB5Azi(self):
         rb52odim.singleRB5(self.GOOD_RB5_AZI,out_fullfile=self.NEW_H5_AZI)
         new_rio = _raveio.open(self.NEW_H5_AZI)
@@ -275,6 +510,20 @@ class rb52odimTest(unittest.TestCase):
             validateScan(self, new_scan, ref_scan)
         os.remove(self.NEW_H5_VOL)
 
+    def testSingleRB5VolBytes(self):
+        image = rb52odim.singleRB5(self.GOOD_RB5_VOL, return_bytes=True)
+        self.assertTrue(isinstance(image, bytes))
+        self.assertEqual(image[:8], b'\x89HDF\r\n\x1a\n')
+        with open(self.NEW_H5_VOL, 'wb') as fd:
+            fd.write(image)
+        new_pvol = _raveio.open(self.NEW_H5_VOL).object
+        ref_pvol = _raveio.open(self.REF_H5_VOL).object
+        self.assertEqual(new_pvol.getNumberOfScans(), ref_pvol.getNumberOfScans())
+        validateTopLevel(self, new_pvol, ref_pvol)
+        for i in range(new_pvol.getNumberOfScans()):
+            validateScan(self, new_pvol.getScan(i), ref_pvol.getScan(i))
+        os.remove(self.NEW_H5_VOL)
+
     def testTimeDowngradeRB5Vol(self):
         rb52odim.singleRB5(self.INP_RB5_TIME_DOWNGRADE,out_fullfile=self.NEW_H5_TIME_DOWNGRADE)
         new_rio = _raveio.open(self.NEW_H5_TIME_DOWNGRADE)
@@ -325,6 +574,26 @@ class rb52odimTest(unittest.TestCase):
         validateTopLevel(self, new_scan, ref_scan)
         validateScan(self, new_scan, ref_scan)
 
+    def testReadRB5tarball_vs_PythonMerge(self):
+        # the native reader must match the member-by-member Python merge
+        new_rio = _rb52odim.readRB5tarball(self.RB5_TARBALL_DOPVOL1A)
+        self.assertTrue(new_rio.objectType is _rave.Rave_ObjectType_SCAN)
+        tar = tarfile.open(self.RB5_TARBALL_DOPVOL1A)
+        ref_scan = None
+        for member in tar.getmembers():
+            mb = rb52odim.parse_tarball_member_name(member.name)
+            if mb['rb5_ftype'] != "rawdata": continue
+            rb5_buffer = tar.extractfile(member).read()
+            rio = _rb52odim.readRB5buf(member.name, rb5_buffer, len(rb5_buffer))
+            ref_scan = rb52odim.compile_big_scan(ref_scan, rio.object, mb)
+        new_scan = new_rio.object
+        self.assertEqual(new_scan.getParameterNames(), ref_scan.getParameterNames())
+        validateTopLevel(self, new_scan, ref_scan)
+        validateScan(self, new_scan, ref_scan)
+
+    def testReadRB5tarballNotATarball(self):
+        self.assertRaises(IOError, _rb52odim.readRB5tarball, self.GOOD_RB5_VOL)
+
     def testMergeOdimScans2Pvol(self):
         rb52odim.combineRB5FromTarball(self.RB5_TARBALL_DOPVOL1A, self.NEW_H5_TARBALL_DOPVOL1A)
         rb52odim.combineRB5FromTarball(self.RB5_TARBALL_DOPVOL1B, self.NEW_H5_TARBALL_DOPVOL1B)
@@ -349,6 +618,93 @@ class rb52odimTest(unittest.TestCase):
         os.remove(self.NEW_H5_TARBALL_DOPVOL1C)
         os.remove(self.NEW_H5_MERGED_PVOL)
 
+    def testVolumeAssemblerComplete(self):
+        assembler = rb52odim.VolumeAssembler(tasks={'DOPVOL': 3}, interval=5,
+                                             taskmap={'DOPVOL1_A': 'DOPVOL',
+                                                      'DOPVOL1_B': 'DOPVOL',
+                                                      'DOPVOL1_C': 'DOPVOL'})
+        ifiles = [self.RB5_TARBALL_DOPVOL1A,
+                  self.RB5_TARBALL_DOPVOL1B,
+                  self.RB5_TARBALL_DOPVOL1C]
+        # nothing is emitted until the last sweep has arrived
+        for ifile in ifiles[:2]:
+            rio = rb52odim.combineRB5FromTarball(ifile, None, return_rio=True)
+            self.assertEqual(assembler.add(rio), [])
+        rio = rb52odim.combineRB5FromTarball(ifiles[2], None, return_rio=True)
+        emitted = assembler.add(rio)
+        self.assertEqual(len(emitted), 1)
+        self.assertEqual(assembler.pending(), 0)
+        new_rio, complete = emitted[0]
+        self.assertTrue(complete)
+        self.assertTrue(new_rio.objectType is _rave.Rave_ObjectType_PVOL)
+        new_pvol = new_rio.object
+        self.assertEqual(new_pvol.getNumberOfScans(), 3)
+        self.assertEqual(new_pvol.getAttribute('how/task'), 'DOPVOL')
+        self.assertEqual(new_pvol.date, '20151209')
+        self.assertEqual(new_pvol.time, '165000')
+        for i in range(len(ifiles)):
+            validateMergedPvol(self, new_pvol, i, ifiles[i])
+
+    def testVolumeAssemblerTimeout(self):
+        now = [0.0]
+        assembler = rb52odim.VolumeAssembler(tasks={'DOPVOL': 3}, interval=5,
+                                             taskmap=lambda task: 'DOPVOL',
+                                             timeout=60.0, clock=lambda: now[0])
+        for ifile in [self.RB5_TARBALL_DOPVOL1A, self.RB5_TARBALL_DOPVOL1B]:
+            rio = rb52odim.combineRB5FromTarball(ifile, None, return_rio=True)
+            self.assertEqual(assembler.add(rio), [])
+        now[0] = 30.0
+        self.assertEqual(assembler.poll(), [])
+        now[0] = 61.0
+        emitted = assembler.poll()
+        self.assertEqual(len(emitted), 1)
+        new_rio, complete = emitted[0]
+        self.assertFalse(complete)
+        self.assertEqual(new_rio.object.getNumberOfScans(), 2)
+        # the missing sweep is too late for its volume
+        rio = rb52odim.combineRB5FromTarball(self.RB5_TARBALL_DOPVOL1C, None, return_rio=True)
+        self.assertEqual(assembler.add(rio), [])
+        self.assertEqual(assembler.pending(), 0)
+
+    def testVolumeAssemblerLateAfterTimeout(self):
+        now = [0.0]
+        assembler = rb52odim.VolumeAssembler(tasks={'DOPVOL': 3}, interval=5,
+                                             taskmap=lambda task: 'DOPVOL',
+                                             timeout=60.0, clock=lambda: now[0])
+        for ifile in [self.RB5_TARBALL_DOPVOL1A, self.RB5_TARBALL_DOPVOL1B]:
+            rio = rb52odim.combineRB5FromTarball(ifile, None, return_rio=True)
+            self.assertEqual(assembler.add(rio), [])
+        now[0] = 61.0
+        self.assertEqual(len(assembler.poll()), 1)
+        # a timeout later the volume is still known, its last sweep starts no second one
+        now[0] = 200.0
+        self.assertEqual(assembler.poll(), [])
+        rio = rb52odim.combineRB5FromTarball(self.RB5_TARBALL_DOPVOL1C, None, return_rio=True)
+        with self.assertLogs('rb52odim', level='WARNING'):
+            self.assertEqual(assembler.add(rio), [])
+        self.assertEqual(assembler.pending(), 0)
+        now[0] = 1000.0
+        self.assertEqual(assembler.poll(), [])
+        self.assertEqual(assembler.flush(), [])
+
+    def testVolumeAssemblerCompact(self):
+        assembler = rb52odim.VolumeAssembler(tasks={'DOPVOL': 3}, interval=5,
+                                             taskmap=lambda task: 'DOPVOL', compact=True)
+        ifiles = [self.RB5_TARBALL_DOPVOL1A,
+                  self.RB5_TARBALL_DOPVOL1B,
+                  self.RB5_TARBALL_DOPVOL1C]
+        for ifile in ifiles[:2]:
+            rio = rb52odim.combineRB5FromTarball(ifile, None, return_rio=True)
+            self.assertEqual(assembler.add(rio), [])
+        self.assertTrue(assembler.nbytes() > 0)
+        rio = rb52odim.combineRB5FromTarball(ifiles[2], None, return_rio=True)
+        emitted = assembler.add(rio)
+        self.assertEqual(len(emitted), 1)
+        new_rio, complete = emitted[0]
+        self.assertTrue(complete)
+        for i in range(len(ifiles)):
+            validateMergedPvol(self, new_rio.object, i, ifiles[i])
+
     def testCombineRB5Tarballs2Pvol(self):
         ifiles = [self.RB5_TARBALL_DOPVOL1A,
                   self.RB5_TARBALL_DOPVOL1B, 
@@ -387,6 +743,12 @@ class rb52odimTest(unittest.TestCase):
         self.assertTrue(newd, refd)
         self.assertTrue(newt, reft)
 
+    def testFloorDT(self):
+        # DOPVOL1_C of the 16:50 cycle, which roundDT() moves to 16:55
+        newd, newt = rb52odim.floorDT('20151209', '165238', 5)
+        self.assertEqual(newd, '20151209')
+        self.assertEqual(newt, '165000')
+
     # Somewhat construed way of testing readParameterFiles()
     def testReadParameters(self):
         scan = rb52odim.readParameterFiles([self.CASRA_AZI_dBZ])[0]
@@ -412,6 +774,14 @@ class rb52odimTest(unittest.TestCase):
         ref = _raveio.open(self.REF_CASRA_H5_SCAN).object
         validateScan(self, oscan, ref)
 
+    def testVolumeShell(self):
+        template = rb52odim.readRB5("../org/CASRA_2017121520000300dBZ.vol.gz").object
+        nscans = template.getNumberOfScans()
+        shell = rb52odim.volumeShell(template)
+        self.assertEqual(shell.getNumberOfScans(), 0)
+        self.assertEqual(template.getNumberOfScans(), nscans)
+        validateTopLevel(self, shell, template)
+
     def testCompileVolumeFromVolumes(self):
         volumes = rb52odim.readParameterFiles(glob.glob(self.CASRA_VOL))
         ovolume = rb52odim.compileVolumeFromVolumes(volumes)
@@ -423,6 +793,18 @@ class rb52odimTest(unittest.TestCase):
             oscan.date, oscan.time = rscan.date, rscan.time # times are not aligned until the pvol is written to disk, so this is a workaround
             validateScan(self, oscan, rscan)
 
+    def testCompileVolumeFromCompactVolumes(self):
+        files = glob.glob(self.CASRA_VOL)
+        compile_pvol = rb52odim.compileVolumeFromVolumes(rb52odim.readParameterFiles(files))
+        volumes = [rb52odim.CompactVolume(v) for v in rb52odim.readParameterFiles(files)]
+        for volume in volumes:
+            self.assertEqual(volume.volume.getScan(0).getParameterNames(), [])
+            self.assertTrue(volume.nbytes() > 0)
+        ovolume = rb52odim.compileVolumeFromVolumes(volumes)
+        validateTopLevel(self, ovolume, compile_pvol)
+        for i in range(ovolume.getNumberOfScans()):
+            validateScan(self, ovolume.getScan(i), compile_pvol.getScan(i))
+
     def testReadRB5(self):
         rio = rb52odim.readRB5([self.CASRA_AZI_dBZ])
         self.assertTrue(rio.objectType, _rave.Rave_ObjectType_SCAN)
@@ -431,6 +813,22 @@ class rb52odimTest(unittest.TestCase):
         rio = rb52odim.readRB5(self.CASRA_AZI_dBZ)
         self.assertTrue(rio.objectType, _rave.Rave_ObjectType_SCAN)
 
+    def testReadRB5_vs_CompileVolumeFromVolumes(self):
+        # the native merge must match the Python clone-and-merge
+        files = glob.glob(self.CASRA_VOL)
+        volumes = rb52odim.readParameterFiles(files)
+        compile_pvol = rb52odim.compileVolumeFromVolumes(volumes)
+        rio = rb52odim.readRB5(files)
+        self.assertTrue(rio.objectType is _rave.Rave_ObjectType_PVOL)
+        merged_pvol = rio.object
+        validateTopLevel(self, merged_pvol, compile_pvol)
+        self.assertEqual(merged_pvol.getNumberOfScans(), compile_pvol.getNumberOfScans())
+        for i in range(compile_pvol.getNumberOfScans()):
+            merged_scan = merged_pvol.getScan(i)
+            compile_scan = compile_pvol.getScan(i)
+            self.assertEqual(merged_scan.getParameterNames(), compile_scan.getParameterNames())
+            validateScan(self, merged_scan, compile_scan)
+
     def testCompileVolumeFromVolumes_vs_CombineRB5FilesReturnRIO(self):
         files = glob.glob(self.CASRA_VOL) #unsorted
         ifiles = sorted(files, key=lambda s: s.lower())  # case-insensitive sort
@@ -0,0 +1,50 @@
+#!/bin/sh
+############################################################
+# Description: Script that runs the decode benchmarks over the
+# test/org corpus, optionally with synthetic scaled-up files, the
+# volume merge memory benchmark, the inflate backends, or the decode
+# primitives one by one
+#
+# Author(s):   rb52odim contributors
+#
+# Copyright:   The Crown (i.e. Her Majesty the Queen in Right of Canada), 2016
+#
+# History:     2026-10-19 Created
+############################################################
+SCRIPTPATH="$( cd -- "$(dirname "$0")" >/dev/null 2>&1 ; pwd -P )"
+
+RES=255
+
+if [ $# -gt 0 -a "$1" = "synthetic" ]; then
+  shift
+  SYNDIR="${SCRIPTPATH}/../test/new/synthetic"
+  RAYS=${BENCH_RAYS:-2}
+  BINS=${BENCH_BINS:-2}
+  SLICES=${BENCH_SLICES:-2}
+  mkdir -p "$SYNDIR"
+  for f in "${SCRIPTPATH}"/../test/org/CASRA_*.vol.gz; do
+    b=`basename "$f" .vol.gz`
+    "$SCRIPTPATH/run_python_script.sh" "${SCRIPTPATH}/../utils/rb5_synthetic.py" "${SCRIPTPATH}/../utils" -i "$f" -o "${SYNDIR}/${b}_r${RAYS}b${BINS}s${SLICES}.vol.gz" -r $RAYS -b $BINS -s $SLICES || exit $?
+  done
+  "$SCRIPTPATH/run_python_script.sh" "${SCRIPTPATH}/../test/bench/RB52ODIMBench.py" "${SCRIPTPATH}/../test/bench" -s "$SYNDIR" "$@"
+  RES=$?
+elif [ $# -gt 0 -a "$1" = "memory" ]; then
+  shift
+  "$SCRIPTPATH/run_python_script.sh" "${SCRIPTPATH}/../test/bench/RB52ODIMMemBench.py" "${SCRIPTPATH}/../test/bench" "$@"
+  RES=$?
+elif [ $# -gt 0 -a "$1" = "inflate" ]; then
+  shift
+  mkdir -p "${SCRIPTPATH}/../test/new"
+  "${SCRIPTPATH}/../src/bench_inflate" -j "${SCRIPTPATH}/../test/new/bench_inflate.json" "$@" "${SCRIPTPATH}/../test/org"
+  RES=$?
+elif [ $# -gt 0 -a "$1" = "kernels" ]; then
+  shift
+  mkdir -p "${SCRIPTPATH}/../test/new"
+  "${SCRIPTPATH}/../src/bench_kernels" -j "${SCRIPTPATH}/../test/new/bench_kernels.json" "$@" "${SCRIPTPATH}/../test/org"
+  RES=$?
+else
+  "$SCRIPTPATH/run_python_script.sh" "${SCRIPTPATH}/../test/bench/RB52ODIMBench.py" "${SCRIPTPATH}/../test/bench" "$@"
+  RES=$?
+fi
+
+exit $RES
@@ -11,6 +11,7 @@
 # History:  2009-10-22 Created by Anders Henja
 #       2016-06-10 Modified by Daniel Michelson for rave_ec
 #       2020-08-31 Peter Rodriguez, add PYTHON_BIN check 
+#       2026-10-19 pass any further arguments on to the script
 ############################################################
 SCRIPTPATH="$( cd -- "$(dirname "$0")" >/dev/null 2>&1 ; pwd -P )"
 
@@ -77,16 +78,18 @@ else
   export PYTHONPATH="${ECPATH}"
 fi
 
-# Syntax: run_python_script <pyscript> [<dir> - if script should be executed in a particular directory]
+# Syntax: run_python_script <pyscript> [<dir> - if script should be executed in a particular directory] [<script args>...]
 
 NARGS=$#
 PYSCRIPT=
 DIRNAME=
 if [ $NARGS -eq 1 ]; then
   PYSCRIPT=`$PYTHON_BIN -c "import os;print(os.path.abspath(\"$1\"))"`
-elif [ $NARGS -eq 2 ]; then
+  shift 1
+elif [ $NARGS -ge 2 ]; then
   PYSCRIPT=`$PYTHON_BIN -c "import os;print(os.path.abspath(\"$1\"))"`
   DIRNAME="$2"
+  shift 2
 elif [ $NARGS -eq 0 ]; then
   # Do nothing
   PYSCRIPT=
@@ -101,7 +104,7 @@ if [ "$DIRNAME" != "" ]; then
 fi
 
 if [ "$PYSCRIPT" != "" ]; then
-  $PYTHON_BIN "$PYSCRIPT"
+  $PYTHON_BIN "$PYSCRIPT" "$@"
 else
   $PYTHON_BIN
 fi
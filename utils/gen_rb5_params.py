@@ -0,0 +1,148 @@
+#!/usr/bin/env python
+'''
+Copyright (C) 2016 The Crown (i.e. Her Majesty the Queen in Right of Canada)
+
+This file is an add-on to RAVE.
+
+RAVE is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+RAVE and this software are distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with RAVE.  If not, see <http://www.gnu.org/licenses/>.
+
+'''
+## Generates src/rb5_params_table.h, the RB5 parameter registry: one row per
+#  RB5 rawdata type or rayinfo refid, with its ODIM_H5 quantity, dual-pol
+#  flag, URP mapping, conversion and rayinfo role, and a perfect hash of the
+#  names for O(1) lookup in src/rb5_params.c. Edit REGISTRY below and rerun:
+#  python utils/gen_rb5_params.py > src/rb5_params_table.h
+
+##
+# @file
+# @author rb52odim contributors
+# @date 2026-10-19
+
+import sys
+
+## hash slots, a power of 2, taken from the top SLOT_BITS of the hash
+SLOT_BITS = 7
+SLOTS = 1 << SLOT_BITS
+
+## references:
+#  RB5_FileFormat_5510.pdf, 2.2.3.4.1 Array "datamap", pg 21-22, "Data types"
+#  RB5_UserGuide_5430.pdf, 4.10.2.4 Data Types, pg 81-82
+#  ~/Projects/IRIS/sigmet/include/sigtypes.h, /apps/urp/build/include/drpdecode.h (URP)
+#  (name, ODIM quantity, dual-pol, (URP type, name, unit, description), conversion, rayinfo role)
+NO_URP = (-1, "n/a", "n/a", "n/a")
+REGISTRY = [
+    ("dBZ",     "DBZH",    0, (2, "DBZ", "dBZ", "Reflectivity"), "MOMENT_DATA", "NONE"),
+    ("dBZv",    "DBZV",    0, NO_URP, "MOMENT_DATA", "NONE"),
+    ("dBuZ",    "TH",      0, (1, "DBT", "dBZ", "Uncorrected Reflectivity"), "MOMENT_DATA", "NONE"),
+    ("dBuZv",   "TV",      0, NO_URP, "MOMENT_DATA", "NONE"),
+    ("V",       "VRADH",   0, (3, "VEL", "m/s", "Velocity"), "MOMENT_DATA", "NONE"),
+    ("Vv",      "VRADV",   0, NO_URP, "MOMENT_DATA", "NONE"),
+    ("Vu",      "UVRADH",  0, NO_URP, "MOMENT_DATA", "NONE"),
+    ("Vvu",     "UVRADV",  0, NO_URP, "MOMENT_DATA", "NONE"),
+    ("W",       "WRADH",   0, (4, "WID", "m/s", "Width"), "MOMENT_DATA", "NONE"),
+    ("Wv",      "WRADV",   0, NO_URP, "MOMENT_DATA", "NONE"),
+    ("Wu",      "UWRADH",  0, NO_URP, "MOMENT_DATA", "NONE"),
+    ("Wvu",     "UWRADV",  0, NO_URP, "MOMENT_DATA", "NONE"),
+
+    ("ZDR",     "ZDR",     1, (5, "ZDR", "dB", "Differential Reflectivity"), "MOMENT_DATA", "NONE"),
+    ("ZDRu",    "UZDR",    1, NO_URP, "MOMENT_DATA", "NONE"),
+    ("PhiDP",   "PHIDP",   1, (16, "PHIDP", "deg", "Differential Phase"), "MOMENT_DATA", "NONE"),
+    ("uPhiDP",  "UPHIDP",  1, (216, "UPHIDP", "deg", "Uncorrected Differential Phase"), "MOMENT_DATA", "NONE"), #New URP decree 2017-Sep-12; was 16
+    ("uPhiDPu", "UPHIDPU", 1, NO_URP, "MOMENT_DATA", "NONE"),
+    ("KDP",     "KDP",     1, (14, "KDP", "deg/km", "Specific Differential Phase"), "MOMENT_DATA", "NONE"),
+    ("uKDP",    "UKDP",    1, (14, "UKDP", "deg/km", "Uncorrected Specific Differential Phase"), "MOMENT_DATA", "NONE"),
+    ("uKDPu",   "UKDPU",   1, NO_URP, "MOMENT_DATA", "NONE"),
+    ("RhoHV",   "RHOHV",   1, (19, "RHOHV", "", "Correlation Coefficient"), "MOMENT_DATA", "NONE"),
+    ("RhoHVu",  "URHOHV",  1, NO_URP, "MOMENT_DATA", "NONE"),
+
+    ("SQI",     "SQIH",    0, (18, "SQI", "", "Signal Quality Index"), "MOMENT_DATA", "NONE"),
+    ("SQIv",    "SQIV",    0, NO_URP, "MOMENT_DATA", "NONE"),
+    ("SQIu",    "USQIH",   0, NO_URP, "MOMENT_DATA", "NONE"),
+    ("SQIvu",   "USQIV",   0, NO_URP, "MOMENT_DATA", "NONE"),
+    ("SNR",     "SNRH",    0, (100, "SNR", "", "Signal to Noise"), "MOMENT_DATA", "NONE"),
+    ("SNRv",    "SNRV",    0, NO_URP, "MOMENT_DATA", "NONE"),
+    ("SNRu",    "USNRH",   0, NO_URP, "MOMENT_DATA", "NONE"),
+    ("SNRvu",   "USNRV",   0, NO_URP, "MOMENT_DATA", "NONE"),
+
+    ("ET",      "CLASS",   0, (55, "HCLASS", "", "Hydrometeor Class (was RB5 Echo Type))"), "COPY", "NONE"), #Hydrometeor Class (1 byte)
+
+    ("startangle",    "STARTANGLE",    0, NO_URP, "ANGULAR", "STARTANGLE"),
+    ("stopangle",     "STOPANGLE",     0, NO_URP, "ANGULAR", "STOPANGLE"),
+    ("startfixangle", "STARTFIXANGLE", 0, NO_URP, "ANGULAR", "STARTFIXANGLE"),
+    ("stopfixangle",  "STOPFIXANGLE",  0, NO_URP, "ANGULAR", "STOPFIXANGLE"),
+    ("dataflag",      "DATAFLAG",      0, NO_URP, "COPY",    "DATAFLAG"),
+    ("numpulses",     "NUMPULSES",     0, NO_URP, "COPY",    "NUMPULSES"),
+    ("timestamp",     "TIMESTAMP",     0, NO_URP, "COPY",    "TIMESTAMP"),
+    ("txpower",       "TXPOWER",       0, NO_URP, "COPY",    "TXPOWER"),
+    ("noisepowerh",   "NOISEPOWERH",   0, NO_URP, "COPY",    "NOISEPOWERH"),
+    ("noisepowerv",   "NOISEPOWERV",   0, NO_URP, "COPY",    "NOISEPOWERV"),
+]
+
+## FNV-1a from a seed, as rb5_param_hash() in src/rb5_params.c
+def fnv1a(seed, name):
+    h = seed
+    for c in name.encode('ascii'):
+        h = ((h ^ c) * 16777619) & 0xffffffff
+    return h
+
+def slot(seed, name):
+    return fnv1a(seed, name) >> (32 - SLOT_BITS)
+
+## first seed from the FNV offset basis on that puts every name in its own slot
+def find_seed(names):
+    seed = 2166136261
+    while True:
+        slots = set(slot(seed, n) for n in names)
+        if len(slots) == len(names):
+            return seed
+        seed = (seed + 1) & 0xffffffff
+
+def cstr(s):
+    return '"%s"' % s.replace('\\', '\\\\').replace('"', '\\"')
+
+def main():
+    names = [row[0] for row in REGISTRY]
+    assert len(set(names)) == len(names) and len(names) < 128
+    seed = find_seed(names)
+    slot_arr = [-1] * SLOTS
+    for i, n in enumerate(names):
+        slot_arr[slot(seed, n)] = i
+
+    out = sys.stdout
+    out.write("/* generated by utils/gen_rb5_params.py, do not edit */\n")
+    out.write("#ifndef RB5_PARAMS_TABLE_H\n#define RB5_PARAMS_TABLE_H\n\n")
+    out.write("// parameter ids, the row of each RB5 name in rb5_param_registry[]\n")
+    out.write("typedef enum {\n")
+    for i, n in enumerate(names):
+        out.write("    RB5_PARAM_%s=%d,\n" % (n.upper(), i))
+    out.write("    RB5_N_PARAMS=%d\n} RB5_PARAM_ID;\n\n" % len(names))
+    out.write("#define RB5_PARAM_HASH_SEED 0x%08xU\n" % seed)
+    out.write("#define RB5_PARAM_HASH_BITS %d\n" % SLOT_BITS)
+    out.write("#define RB5_PARAM_HASH_SLOTS %d\n\n" % SLOTS)
+    out.write("#endif\n\n")
+
+    out.write("#ifdef RB5_PARAMS_TABLE_DEFINE // rb5_params.c only\n")
+    out.write("static const strRB5_PARAM_DEF rb5_param_registry[RB5_N_PARAMS]={\n")
+    for (name, quantity, dualpol, urp, conversion, role) in REGISTRY:
+        out.write("    {%-16s %-16s %d, %3d, %-9s %-9s %-43s RB5_CONVERSION_%-12s RB5_RAYINFO_%s},\n" % (
+            cstr(name)+",", cstr(quantity)+",", dualpol, urp[0], cstr(urp[1])+",", cstr(urp[2])+",",
+            cstr(urp[3])+",", conversion+",", role))
+    out.write("};\n\n")
+    out.write("static const signed char rb5_param_slot[RB5_PARAM_HASH_SLOTS]={")
+    for i, v in enumerate(slot_arr):
+        out.write("%s%3d%s" % ("\n    " if i % 16 == 0 else "", v, "," if i < SLOTS-1 else "\n"))
+    out.write("};\n#endif\n")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,222 @@
+#!/usr/bin/env python
+'''
+Copyright (C) 2016 The Crown (i.e. Her Majesty the Queen in Right of Canada)
+
+This file is an add-on to RAVE.
+
+RAVE is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+RAVE and this software are distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+See the GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with RAVE.  If not, see <http://www.gnu.org/licenses/>.
+
+'''
+## Command-line utility that scales up a Rainbow 5 file to production sizes
+#  for benchmarking: more rays per sweep, more bins per ray, more sweeps.
+#  Moment data are replicated, ray angles and timestamps are interpolated,
+#  so the result decodes like a real file of that size.
+
+##
+# @file
+# @author rb52odim contributors
+# @date 2026-10-19
+
+import sys, os, re, gzip, zlib, struct
+import xml.etree.ElementTree as ET
+import numpy as np
+
+END_XML = b'<!-- END XML -->'
+BLOB_HEADER = re.compile(rb'<BLOB blobid="(\d+)" size="(\d+)" compression="(\w+)">\n')
+
+## must not exceed MAX_SLICES in src/rb5_utils.h
+MAX_SLICES = 32
+
+## rayinfo arrays that are interpolated within a ray, everything else is repeated
+INTERPOLATED_RAYINFO = ['startangle', 'stopangle', 'timestamp']
+ANGLE_RAYINFO = ['startangle', 'stopangle']
+
+DTYPES = {8:'>u1', 16:'>u2', 32:'>u4'}
+
+
+## Reads an RB5 file (optionally gzipped)
+# @param string input file name
+# @returns tuple of (XML string, dictionary of uncompressed blobs keyed by blobid)
+def readRB5(ifile):
+    with open(ifile, 'rb') as fd:
+        buf = fd.read()
+    if buf[:2] == b'\x1f\x8b':
+        buf = gzip.decompress(buf)
+    iend = buf.find(END_XML)
+    if iend < 0:
+        raise IOError("%s is not a proper RB5 raw file" % ifile)
+    xml = buf[:iend].decode('utf-8')
+    blobs = {}
+    pos = iend + len(END_XML) + 1
+    while True:
+        m = BLOB_HEADER.search(buf, pos)
+        if not m: break
+        blobid, size = int(m.group(1)), int(m.group(2))
+        payload = buf[m.end():m.end()+size]
+        expected = struct.unpack('>I', payload[:4])[0]
+        blobs[blobid] = zlib.decompress(payload[4:])
+        if len(blobs[blobid]) != expected:
+            raise IOError("blobid %d: inflated %d bytes, expected %d" % (blobid, len(blobs[blobid]), expected))
+        pos = m.end() + size
+    return xml, blobs
+
+
+## Writes an RB5 file, gzipped if the file name ends with .gz
+# @param string output file name
+# @param string XML
+# @param list of (blobid, uncompressed bytes) tuples
+def writeRB5(ofile, xml, blobs):
+    out = [xml.encode('utf-8'), b'\n', END_XML, b'\n']
+    for blobid, data in blobs:
+        payload = struct.pack('>I', len(data)) + zlib.compress(data, 6)
+        out.append(b'<BLOB blobid="%d" size="%d" compression="qt">\n' % (blobid, len(payload)))
+        out.append(payload)
+        out.append(b'\n</BLOB>\n')
+    buf = b''.join(out)
+    if ofile.endswith('.gz'):
+        buf = gzip.compress(buf, 6)
+    with open(ofile, 'wb') as fd:
+        fd.write(buf)
+
+
+## Scales one rayinfo array from nrays to nrays*rays_factor rays
+# @param numpy array of raw codes
+# @param string rayinfo refid
+# @param int depth in bits
+# @param int rays_factor
+# @returns numpy array
+def scaleRayinfo(arr, refid, depth, rays_factor):
+    if rays_factor == 1: return arr
+    if refid not in INTERPOLATED_RAYINFO:
+        return np.repeat(arr, rays_factor)
+    wrap = 1 << depth
+    a = arr.astype(np.int64)
+    step = np.empty_like(a)
+    step[:-1] = a[1:] - a[:-1]
+    step[-1] = step[-2] if len(a) > 1 else 0
+    if refid in ANGLE_RAYINFO:
+        step = (step + wrap//2) % wrap - wrap//2  # shortest way around 0-deg N
+    frac = np.arange(rays_factor, dtype=np.int64)
+    out = a[:,None] + (step[:,None] * frac[None,:]) // rays_factor
+    if refid in ANGLE_RAYINFO: out %= wrap
+    return out.reshape(-1).astype(arr.dtype)
+
+
+## Scales the numeric text of a slice element, if the slice has it
+# @param Element slice
+# @param string tag
+# @param float divisor
+def scaleSliceText(slice, tag, divisor):
+    el = slice.find(tag)
+    if el is not None and el.text:
+        el.text = '%g' % (float(el.text) / divisor)
+
+
+## Scales an RB5 file
+# @param string XML
+# @param dictionary of uncompressed blobs
+# @param int rays_factor
+# @param int bins_factor
+# @param int slices_factor
+# @returns tuple of (XML string, list of (blobid, uncompressed bytes))
+def scaleRB5(xml, blobs, rays_factor=1, bins_factor=1, slices_factor=1):
+    root = ET.fromstring(xml)
+    scan = root.find('scan')
+    slices = scan.findall('slice')
+
+    nslices = len(slices) * slices_factor
+    if nslices > MAX_SLICES:
+        sys.stderr.write("Limiting to %d slices (MAX_SLICES)\n" % MAX_SLICES)
+        nslices = MAX_SLICES
+
+    pristine = [ET.tostring(s) for s in slices]
+    out_blobs = []
+    new_slices = []
+    for islice in range(nslices):
+        copy = islice >= len(slices)
+        slice = ET.fromstring(pristine[islice % len(slices)])
+        if copy:
+            # nudge the copies so that elevations stay distinct
+            posangle = slice.find('posangle')
+            if posangle is None:
+                posangle = ET.SubElement(slice, 'posangle')
+                posangle.text = slices[0].find('posangle').text
+            posangle.text = '%.2f' % (float(posangle.text) + 0.01 * (islice // len(slices)))
+        slice.set('refid', str(islice))
+        scaleSliceText(slice, 'anglestep', rays_factor)
+        scaleSliceText(slice, 'rangestep', bins_factor)
+
+        for el in slice.find('slicedata'):
+            if el.tag not in ('rayinfo', 'rawdata'): continue
+            depth = int(el.get('depth'))
+            nrays = int(el.get('rays'))
+            arr = np.frombuffer(blobs[int(el.get('blobid'))], dtype=DTYPES[depth])
+            if el.tag == 'rayinfo':
+                arr = scaleRayinfo(arr, el.get('refid'), depth, rays_factor)
+            else:
+                nbins = int(el.get('bins'))
+                arr = arr.reshape(nrays, nbins)
+                arr = np.repeat(np.repeat(arr, rays_factor, axis=0), bins_factor, axis=1)
+                el.set('bins', str(nbins * bins_factor))
+            el.set('rays', str(nrays * rays_factor))
+            blobid = len(out_blobs)
+            el.set('blobid', str(blobid))
+            out_blobs.append((blobid, np.ascontiguousarray(arr).tobytes()))
+        new_slices.append(slice)
+
+    for slice in slices:
+        scan.remove(slice)
+    for slice in new_slices:
+        scan.append(slice)
+    numele = scan.find('pargroup/numele')
+    if numele is not None:
+        numele.text = str(nslices)
+
+    return ET.tostring(root, encoding='unicode'), out_blobs
+
+
+if __name__=="__main__":
+    from optparse import OptionParser
+
+    usage = "usage: %prog -i <input RB5 file> -o <output RB5 file> [-r <rays factor>] [-b <bins factor>] [-s <slices factor>] [h]"
+    usage += "\nScales up a Rainbow 5 file for benchmarking. Output is gzipped if its name ends with .gz"
+    parser = OptionParser(usage=usage)
+
+    parser.add_option("-i", "--input", dest="ifile",
+                      help="Input Rainbow 5 file name.")
+
+    parser.add_option("-o", "--output", dest="ofile",
+                      help="Output Rainbow 5 file name.")
+
+    parser.add_option("-r", "--rays", dest="rays", type="int", default=1,
+                      help="Multiply the number of rays per sweep by this factor. Defaults to 1.")
+
+    parser.add_option("-b", "--bins", dest="bins", type="int", default=1,
+                      help="Multiply the number of bins per ray by this factor. Defaults to 1.")
+
+    parser.add_option("-s", "--slices", dest="slices", type="int", default=1,
+                      help="Multiply the number of sweeps by this factor, up to %d sweeps. Defaults to 1." % MAX_SLICES)
+
+    (options, args) = parser.parse_args()
+
+    if not options.ifile or not options.ofile:
+        parser.print_help()
+        sys.exit(1)
+    if min(options.rays, options.bins, options.slices) < 1:
+        parser.error("scaling factors must be >= 1")
+
+    xml, blobs = readRB5(options.ifile)
+    xml, blobs = scaleRB5(xml, blobs, options.rays, options.bins, options.slices)
+    writeRB5(options.ofile, xml, blobs)
+    print("Created : %s" % options.ofile)